@@ -0,0 +1,157 @@
+#include "benchmark_runner.h"
+#include "debug.h"
+
+#include "chrono"
+#include "algorithm"
+#include "cmath"
+#include "fstream"
+#include "iostream"
+#include "iomanip"
+#include "cstdlib"
+
+namespace undicht {
+
+    namespace benchmarks {
+
+        bool BenchmarkRunner::init(int argc, char** argv) {
+            /// @return false, if the command line arguments were invalid
+
+            for(int i = 1; i < argc; i++) {
+
+                std::string arg = argv[i];
+                size_t separator = arg.find('=');
+                std::string key = arg.substr(0, separator);
+                std::string value = (separator != std::string::npos) ? arg.substr(separator + 1) : "";
+
+                if(!key.compare("--filter")) {
+                    _filter = value;
+                } else if(!key.compare("--json")) {
+                    _json_file = value;
+                } else if(!key.compare("--samples")) {
+                    _samples = std::max(1, std::atoi(value.c_str()));
+                } else if(!key.compare("--warmup")) {
+                    _warmup_samples = std::max(0, std::atoi(value.c_str()));
+                } else if(!key.compare("--min-time")) {
+                    _min_sample_time_ms = std::max(0.0, std::atof(value.c_str()));
+                } else {
+                    UND_ERROR << "unknown benchmark argument: " << arg << "\n";
+                    return false;
+                }
+
+            }
+
+            return true;
+        }
+
+        void BenchmarkRunner::runBatch(const std::string& name, const std::function<void(uint64_t iterations)>& batch) {
+            /// @brief measures a function that executes the benchmarked code iterations times
+
+            if(_filter.size() && (name.find(_filter) == std::string::npos)) return;
+
+            // finding the number of iterations that take at least the min sample time
+            const double min_sample_time_ns = _min_sample_time_ms * 1000000.0;
+            uint64_t iterations = 1;
+            while((measureBatch(batch, iterations) < min_sample_time_ns) && (iterations < (1ull << 40)))
+                iterations *= 2;
+
+            for(uint32_t i = 0; i < _warmup_samples; i++)
+                measureBatch(batch, iterations);
+
+            std::vector<double> sample_times(_samples);
+            for(double& time : sample_times)
+                time = measureBatch(batch, iterations) / iterations;
+
+            std::sort(sample_times.begin(), sample_times.end());
+
+            Result result;
+            result._name = name;
+            result._iterations = iterations;
+            result._samples = _samples;
+            result._min_ns = sample_times.front();
+            result._max_ns = sample_times.back();
+            result._median_ns = (_samples % 2) ? sample_times[_samples / 2] : (sample_times[_samples / 2 - 1] + sample_times[_samples / 2]) / 2.0;
+
+            for(double time : sample_times) result._mean_ns += time / _samples;
+            for(double time : sample_times) result._std_dev_ns += (time - result._mean_ns) * (time - result._mean_ns) / _samples;
+            result._std_dev_ns = std::sqrt(result._std_dev_ns);
+
+            _results.push_back(result);
+
+            writeTable(std::cout, _results.size() - 1);
+        }
+
+        const std::vector<BenchmarkRunner::Result>& BenchmarkRunner::getResults() const {
+
+            return _results;
+        }
+
+        void BenchmarkRunner::writeTable(std::ostream& out) const {
+            /// @brief prints the results as a table
+
+            for(size_t i = 0; i < _results.size(); i++)
+                writeTable(out, i);
+
+        }
+
+        bool BenchmarkRunner::writeJson() const {
+            /// @brief writes the results to the json file passed via --json (if there was one)
+            /// @return false, if the file could not be written
+
+            if(_json_file.empty()) return true;
+
+            std::ofstream file(_json_file, std::ios::trunc);
+            if(!file.is_open()) {
+                UND_ERROR << "failed to open the benchmark result file: " << _json_file << "\n";
+                return false;
+            }
+
+            writeJson(file);
+
+            return true;
+        }
+
+        void BenchmarkRunner::writeJson(std::ostream& out) const {
+
+            out << "{\n";
+            out << "  \"context\": {\"samples\": " << _samples << ", \"warmup_samples\": " << _warmup_samples << ", \"min_sample_time_ms\": " << _min_sample_time_ms << "},\n";
+            out << "  \"benchmarks\": [\n";
+
+            out << std::fixed << std::setprecision(3);
+            for(size_t i = 0; i < _results.size(); i++) {
+
+                const Result& r = _results[i];
+                out << "    {\"name\": \"" << r._name << "\", \"iterations\": " << r._iterations << ", \"samples\": " << r._samples;
+                out << ", \"min_ns\": " << r._min_ns << ", \"median_ns\": " << r._median_ns << ", \"mean_ns\": " << r._mean_ns;
+                out << ", \"max_ns\": " << r._max_ns << ", \"std_dev_ns\": " << r._std_dev_ns << "}";
+                out << ((i + 1 < _results.size()) ? ",\n" : "\n");
+            }
+
+            out << "  ]\n";
+            out << "}\n";
+        }
+
+        ///////////////////////////////////////////// protected functions /////////////////////////////////////////////
+
+        double BenchmarkRunner::measureBatch(const std::function<void(uint64_t iterations)>& batch, uint64_t iterations) const {
+            /// @return the time it took to run the batch in nanoseconds
+
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            batch(iterations);
+            std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+            return std::chrono::duration<double, std::nano>(end - start).count();
+        }
+
+        void BenchmarkRunner::writeTable(std::ostream& out, size_t result) const {
+
+            const Result& r = _results[result];
+            out << std::left << std::setw(48) << r._name << std::right << std::fixed << std::setprecision(1);
+            out << " median " << std::setw(12) << r._median_ns << " ns";
+            out << "   min " << std::setw(12) << r._min_ns << " ns";
+            out << "   std dev " << std::setw(6) << (r._mean_ns > 0.0 ? 100.0 * r._std_dev_ns / r._mean_ns : 0.0) << " %";
+            out << "   (" << r._samples << " x " << r._iterations << " iterations)\n";
+        }
+
+    } // benchmarks
+
+} // undicht
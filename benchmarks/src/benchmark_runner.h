@@ -0,0 +1,101 @@
+#ifndef BENCHMARK_RUNNER_H
+#define BENCHMARK_RUNNER_H
+
+#include "cstdint"
+#include "string"
+#include "vector"
+#include "functional"
+#include "iosfwd"
+
+namespace undicht {
+
+    namespace benchmarks {
+
+        class BenchmarkRunner {
+            /** @brief measures how long small pieces of code take to run
+             * every benchmark is calibrated first (the iterations per sample get doubled until a sample takes at least the min sample time),
+             * then warmed up and then measured in multiple samples, of which min / median / mean / max and the standard deviation get reported
+             * command line arguments:
+             *   --filter=<text>   only runs benchmarks with the text in their name
+             *   --samples=<n>     number of measured samples per benchmark
+             *   --warmup=<n>      number of samples that get discarded before measuring
+             *   --min-time=<ms>   minimum duration of a single sample
+             *   --json=<file>     writes the results to a json file (to compare them across releases) */
+
+          public:
+
+            struct Result {
+                std::string _name;
+                uint64_t _iterations = 0; // per sample
+                uint32_t _samples = 0;
+                // time per iteration
+                double _min_ns = 0.0;
+                double _median_ns = 0.0;
+                double _mean_ns = 0.0;
+                double _max_ns = 0.0;
+                double _std_dev_ns = 0.0;
+            };
+
+          protected:
+
+            std::vector<Result> _results;
+
+            std::string _filter;
+            std::string _json_file;
+            uint32_t _samples = 20;
+            uint32_t _warmup_samples = 3;
+            double _min_sample_time_ms = 10.0;
+
+          public:
+
+            /// @return false, if the command line arguments were invalid
+            bool init(int argc, char** argv);
+
+            /// @brief measures the function (unless it gets filtered out)
+            template<typename Function>
+            void run(const std::string& name, Function function) {
+
+                runBatch(name, [&function](uint64_t iterations) {
+                    for(uint64_t i = 0; i < iterations; i++) function();
+                });
+            }
+
+            /// @brief measures a function that executes the benchmarked code iterations times
+            void runBatch(const std::string& name, const std::function<void(uint64_t iterations)>& batch);
+
+            const std::vector<Result>& getResults() const;
+
+            /// @brief prints the results as a table
+            void writeTable(std::ostream& out) const;
+
+            /// @brief writes the results to the json file passed via --json (if there was one)
+            /// @return false, if the file could not be written
+            bool writeJson() const;
+            void writeJson(std::ostream& out) const;
+
+          protected:
+
+            /// @return the time it took to run the batch in nanoseconds
+            double measureBatch(const std::function<void(uint64_t iterations)>& batch, uint64_t iterations) const;
+
+            /// @brief prints a single row of the result table
+            void writeTable(std::ostream& out, size_t result) const;
+
+        };
+
+        /// @brief keeps the compiler from optimizing away the computation of the value
+        template<typename T>
+        inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+#else
+            static volatile const void* sink;
+            sink = &value;
+#endif
+        }
+
+    } // benchmarks
+
+} // undicht
+
+#endif // BENCHMARK_RUNNER_H
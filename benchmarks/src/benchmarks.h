@@ -0,0 +1,23 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "benchmark_runner.h"
+
+namespace undicht {
+
+    namespace benchmarks {
+
+        // JobSystem, LinearArena, LatencyHistogram, Profiler and Logger (only needs the core library)
+        void runCoreBenchmarks(BenchmarkRunner& runner);
+
+        // XmlFile, BinaryDataFile and the vertex processing of the SceneLoader
+        void runToolsBenchmarks(BenchmarkRunner& runner);
+
+        // NodeAnimation, Node, SceneGroup and UniformBuffer
+        void runSceneBenchmarks(BenchmarkRunner& runner);
+
+    } // benchmarks
+
+} // undicht
+
+#endif // BENCHMARKS_H
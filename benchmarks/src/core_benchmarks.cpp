@@ -0,0 +1,99 @@
+#include "benchmarks.h"
+
+#include "job_system.h"
+#include "linear_arena.h"
+#include "latency_histogram.h"
+#include "profiler.h"
+#include "debug.h"
+
+#include "cstdio"
+#include "vector"
+
+namespace undicht {
+
+    namespace benchmarks {
+
+        void runCoreBenchmarks(BenchmarkRunner& runner) {
+
+            // JobSystem
+            JobSystem job_system;
+            job_system.init();
+
+            std::vector<float> values(65536, 1.0f);
+
+            runner.run("JobSystem::parallelFor (65536 elements, batches of 1024)", [&] {
+                job_system.parallelFor(values.size(), 1024, [&](uint32_t begin, uint32_t end) {
+                    for(uint32_t i = begin; i < end; i++)
+                        values[i] = values[i] * 0.5f + 1.0f;
+                });
+                doNotOptimize(values.data());
+            });
+
+            job_system.cleanUp();
+
+            // LinearArena
+            LinearArena arena;
+            arena.init(64 * 1024);
+
+            runner.run("LinearArena::allocate (256 allocations + reset)", [&] {
+                for(int i = 0; i < 256; i++)
+                    doNotOptimize(arena.allocate<float>(16));
+                arena.reset();
+            });
+
+            arena.cleanUp();
+
+            // FrameVector (compared to a std::vector with the same contents)
+            runner.run("FrameVector::push_back (1024 elements)", [] {
+                FrameVector<uint32_t> vector;
+                for(uint32_t i = 0; i < 1024; i++)
+                    vector.push_back(i);
+                doNotOptimize(vector.data());
+                FrameArena::nextFrame();
+            });
+
+            runner.run("std::vector::push_back (1024 elements)", [] {
+                std::vector<uint32_t> vector;
+                for(uint32_t i = 0; i < 1024; i++)
+                    vector.push_back(i);
+                doNotOptimize(vector.data());
+            });
+
+            // LatencyHistogram
+            LatencyHistogram histogram;
+            uint64_t value = 0;
+
+            runner.run("LatencyHistogram::record", [&] {
+                histogram.record(value++ * 2654435761u % 1000000);
+            });
+
+            // Profiler (enabled, the tasks get stored in the ring buffer of the thread)
+            bool profiler_enabled = Profiler::isEnabled();
+            Profiler::enableProfiler(true);
+
+            runner.run("Profiler (task start + end)", [] {
+                Profiler profiler("benchmark");
+            });
+
+            Profiler::enableProfiler(profiler_enabled);
+
+            // Logger (writing to a temporary file instead of the console)
+            std::FILE* log_file = std::tmpfile();
+            if(log_file) {
+
+                Logger::setOutput(log_file);
+
+                runner.run("UND_LOG (short message)", [&] {
+                    UND_LOG << "benchmark message " << value++ << "\n";
+                });
+
+                Logger::flush();
+                Logger::setOutput(nullptr);
+                std::fclose(log_file);
+            }
+
+        }
+
+    } // benchmarks
+
+} // undicht
@@ -0,0 +1,20 @@
+#include "benchmarks.h"
+
+
+using namespace undicht;
+using namespace benchmarks;
+
+// measures the cpu hot paths of the core library
+// (builds without the graphics and tools libraries, so it can run on machines without vulkan or assimp)
+
+int main(int argc, char** argv) {
+
+    BenchmarkRunner runner;
+    if(!runner.init(argc, argv)) return 1;
+
+    runCoreBenchmarks(runner);
+
+    if(!runner.writeJson()) return 1;
+
+    return 0;
+}
@@ -0,0 +1,22 @@
+#include "benchmarks.h"
+
+
+using namespace undicht;
+using namespace benchmarks;
+
+// measures the cpu hot paths of the engine (doesnt need a gpu or a window)
+// run with --json=<file> to store the results, so that they can be compared across releases
+
+int main(int argc, char** argv) {
+
+    BenchmarkRunner runner;
+    if(!runner.init(argc, argv)) return 1;
+
+    runCoreBenchmarks(runner);
+    runToolsBenchmarks(runner);
+    runSceneBenchmarks(runner);
+
+    if(!runner.writeJson()) return 1;
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include "benchmarks.h"
+
+#include "scene/node_animation.h"
+#include "scene/node.h"
+#include "scene/scene_group.h"
+#include "renderer/vulkan/uniform_buffer.h"
+#include "types.h"
+
+#include "string"
+#include "vector"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace undicht {
+
+    namespace benchmarks {
+
+        using namespace graphics;
+
+        class UniformBufferBenchmark : public vulkan::UniformBuffer {
+            // exposing the offset calculation of the UniformBuffer
+          public:
+            using vulkan::UniformBuffer::calcOffsets;
+        };
+
+        void addChildNodes(Node& parent, uint32_t depth, uint32_t children_per_node) {
+
+            if(!depth) return;
+
+            for(uint32_t i = 0; i < children_per_node; i++) {
+                Node& child = parent.addChildNode(parent.getName() + "_" + std::to_string(i));
+                child.setLocalTransformation(glm::translate(glm::mat4(1.0f), glm::vec3(float(i), 1.0f, 0.0f)));
+                addChildNodes(child, depth - 1, children_per_node);
+            }
+
+        }
+
+        void addChildBones(Bone& parent, uint32_t& bone_count, uint32_t depth, uint32_t children_per_bone) {
+
+            if(!depth) return;
+
+            for(uint32_t i = 0; i < children_per_bone; i++) {
+                Bone* child = parent.addChildBone("bone" + std::to_string(bone_count++));
+                addChildBones(*child, bone_count, depth - 1, children_per_bone);
+            }
+
+        }
+
+        void runSceneBenchmarks(BenchmarkRunner& runner) {
+
+            // NodeAnimation
+            NodeAnimation node_animation;
+            for(int i = 0; i < 200; i++) {
+                double time = i * 0.1;
+                node_animation.addPositionKey(time, glm::vec3(float(i), 0.0f, 0.0f));
+                node_animation.addRotationKey(time, glm::angleAxis(float(time), glm::vec3(0.0f, 1.0f, 0.0f)));
+                node_animation.addScaleKey(time, glm::vec3(1.0f));
+            }
+
+            double animation_time = 0.0;
+            runner.run("NodeAnimation::getTransfMat (200 keys)", [&] {
+                animation_time += 0.013;
+                if(animation_time > 20.0) animation_time = 0.0;
+                doNotOptimize(node_animation.getTransfMat(animation_time));
+            });
+
+            // Node
+            Node root_node;
+            root_node.init();
+            root_node.setName("root");
+            addChildNodes(root_node, 4, 8); // 4681 nodes
+
+            runner.run("Node::updateGlobalTransformation (4681 nodes)", [&] {
+                root_node.updateGlobalTransformation(glm::mat4(1.0f));
+                doNotOptimize(root_node.getGlobalTransformation());
+            });
+
+            root_node.cleanUp();
+
+            // SceneGroup
+            SceneGroup scene_group;
+            scene_group.init();
+
+            uint32_t bone_count = 0;
+            for(int i = 0; i < 4; i++) {
+                Skeleton& skeleton = scene_group.addSkeleton("skeleton" + std::to_string(i));
+                skeleton.getRootBone().setName("bone" + std::to_string(bone_count++));
+                addChildBones(skeleton.getRootBone(), bone_count, 3, 4); // 85 bones per skeleton
+            }
+
+            std::vector<std::string> bone_names;
+            for(uint32_t i = 0; i < bone_count; i += 7)
+                bone_names.push_back("bone" + std::to_string(i));
+
+            size_t next_bone = 0;
+            runner.run("SceneGroup::getBone (340 bones)", [&] {
+                doNotOptimize(scene_group.getBone(bone_names[next_bone]));
+                next_bone = (next_bone + 1) % bone_names.size();
+            });
+
+            scene_group.cleanUp();
+
+            // UniformBuffer
+            BufferLayout node_layout(std::vector<FixedType>(101, UND_MAT4F)); // model matrix + bone matrices
+            BufferLayout mixed_layout({UND_FLOAT32, UND_VEC3F, UND_VEC2F, UND_MAT4F, UND_INT32, UND_VEC4F, UND_FLOAT32, UND_VEC3F});
+
+            runner.run("UniformBuffer::calcOffsets (101 mat4)", [&] {
+                doNotOptimize(UniformBufferBenchmark::calcOffsets(node_layout));
+            });
+
+            runner.run("UniformBuffer::calcOffsets (8 mixed types)", [&] {
+                doNotOptimize(UniformBufferBenchmark::calcOffsets(mixed_layout));
+            });
+
+        }
+
+    } // benchmarks
+
+} // undicht
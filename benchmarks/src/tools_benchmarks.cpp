@@ -0,0 +1,215 @@
+#include "benchmarks.h"
+
+#include "xml/xml_file.h"
+#include "binary_data/binary_data_file.h"
+#include "scene_loader/scene_loader.h"
+#include "scene_loader/mesh_optimizer.h"
+#include "scene_loader/mesh_simplifier.h"
+#include "job_system.h"
+
+#include "fstream"
+#include "string"
+#include "vector"
+#include "algorithm"
+#include "random"
+#include "filesystem"
+
+namespace undicht {
+
+    namespace benchmarks {
+
+        using namespace tools;
+
+        // the files read and written by the benchmarks (stored in a temporary directory, which gets removed afterwards)
+        const std::string BENCHMARK_DIRECTORY = "undicht_benchmarks";
+        const std::string XML_BENCHMARK_FILE = "benchmark_scene.xml";
+        const std::string BINARY_BENCHMARK_FILE = "benchmark_data.bin";
+
+        class SceneLoaderBenchmark : public SceneLoader {
+            // exposing the vertex processing of the SceneLoader
+          public:
+            using SceneLoader::processAssimpVertices;
+        };
+
+        void writeXmlBenchmarkFile(const std::string& file_name, int node_count) {
+
+            std::ofstream file(file_name, std::ios::trunc);
+
+            file << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+            file << "<scene name=\"benchmark\">\n";
+
+            for(int i = 0; i < node_count; i++) {
+                file << "    <node name=\"node" << i << "\" parent=\"node" << i / 4 << "\">\n";
+                file << "        <mesh file=\"mesh" << i << ".obj\" material=\"material" << i % 16 << "\"/>\n";
+                file << "        <transform>1 0 0 " << i << " 0 1 0 0 0 0 1 0 0 0 0 1</transform>\n";
+                file << "    </node>\n";
+            }
+
+            file << "</scene>\n";
+        }
+
+        void createBenchmarkGrid(uint32_t size, std::vector<float>& vertices, std::vector<uint32_t>& indices) {
+            // a grid of size * size quads with 5 floats per vertex (position + uv)
+            // every triangle uses its own vertices and the triangles are shuffled (like an unoptimized export)
+
+            std::vector<uint32_t> triangles;
+
+            for(uint32_t y = 0; y < size; y++) {
+                for(uint32_t x = 0; x < size; x++) {
+
+                    const uint32_t corners[6][2] = {{x, y}, {x + 1, y}, {x, y + 1}, {x, y + 1}, {x + 1, y}, {x + 1, y + 1}};
+
+                    for(int i = 0; i < 6; i++) {
+                        float u = float(corners[i][0]), v = float(corners[i][1]);
+                        vertices.insert(vertices.end(), {u, v, 0.0f, u / size, v / size});
+                    }
+
+                    triangles.push_back(triangles.size());
+                    triangles.push_back(triangles.size());
+                }
+            }
+
+            std::shuffle(triangles.begin(), triangles.end(), std::mt19937(42));
+
+            for(uint32_t triangle : triangles)
+                indices.insert(indices.end(), {3 * triangle, 3 * triangle + 1, 3 * triangle + 2});
+
+        }
+
+        aiMesh* createBenchmarkMesh(uint32_t vertex_count, uint32_t bone_count, uint32_t bones_per_vertex) {
+            /// @return a skinned mesh with positions, uvs, normals and tangents (deleting the mesh deletes all its arrays)
+
+            aiMesh* mesh = new aiMesh();
+            mesh->mNumVertices = vertex_count;
+            mesh->mVertices = new aiVector3D[vertex_count];
+            mesh->mNormals = new aiVector3D[vertex_count];
+            mesh->mTangents = new aiVector3D[vertex_count];
+            mesh->mBitangents = new aiVector3D[vertex_count];
+            mesh->mTextureCoords[0] = new aiVector3D[vertex_count];
+            mesh->mNumUVComponents[0] = 2;
+
+            for(uint32_t i = 0; i < vertex_count; i++) {
+                mesh->mVertices[i] = aiVector3D(float(i % 64), float(i / 64), 0.0f);
+                mesh->mNormals[i] = aiVector3D(0.0f, 0.0f, 1.0f);
+                mesh->mTangents[i] = aiVector3D(1.0f, 0.0f, 0.0f);
+                mesh->mBitangents[i] = aiVector3D(0.0f, 1.0f, 0.0f);
+                mesh->mTextureCoords[0][i] = aiVector3D((i % 64) / 64.0f, (i / 64) / 64.0f, 0.0f);
+            }
+
+            // every vertex is influenced by bones_per_vertex neighbouring bones
+            mesh->mNumBones = bone_count;
+            mesh->mBones = new aiBone*[bone_count];
+
+            for(uint32_t b = 0; b < bone_count; b++) {
+
+                std::vector<aiVertexWeight> weights;
+                for(uint32_t v = 0; v < vertex_count; v++)
+                    if(((v + bone_count - b) % bone_count) < bones_per_vertex)
+                        weights.push_back(aiVertexWeight(v, 1.0f / bones_per_vertex));
+
+                aiBone* bone = new aiBone();
+                bone->mName = aiString("bone" + std::to_string(b));
+                bone->mNumWeights = weights.size();
+                bone->mWeights = new aiVertexWeight[weights.size()];
+                std::copy(weights.begin(), weights.end(), bone->mWeights);
+
+                mesh->mBones[b] = bone;
+            }
+
+            return mesh;
+        }
+
+        void runToolsBenchmarks(BenchmarkRunner& runner) {
+
+            std::error_code error;
+            std::filesystem::path directory = std::filesystem::temp_directory_path(error) / BENCHMARK_DIRECTORY;
+            std::filesystem::create_directories(directory, error);
+
+            const std::string xml_file_name = (directory / XML_BENCHMARK_FILE).string();
+            const std::string binary_file_name = (directory / BINARY_BENCHMARK_FILE).string();
+
+            // XmlFile
+            writeXmlBenchmarkFile(xml_file_name, 1000);
+            runner.run("XmlFile::open (1000 nodes)", [&] {
+                XmlFile file;
+                doNotOptimize(file.open(xml_file_name));
+            });
+
+            // BinaryDataFile
+            BinaryDataFile binary_file;
+            binary_file.open(binary_file_name);
+            binary_file.newBinaryFile(); // creating the file
+
+            std::vector<char> store_data(4096, 'u');
+            std::vector<char> read_data;
+
+            runner.run("BinaryDataFile::store (4 KB)", [&] {
+                uint64_t location = binary_file.store(store_data.data(), store_data.size());
+                binary_file.free(location);
+            });
+
+            uint64_t location = binary_file.store(store_data.data(), store_data.size());
+            runner.run("BinaryDataFile::read (4 KB)", [&] {
+                doNotOptimize(binary_file.read(location, read_data));
+            });
+
+            binary_file.close();
+            std::filesystem::remove_all(directory, error);
+
+            // SceneLoader
+            SceneLoaderBenchmark scene_loader;
+            aiMesh* mesh = createBenchmarkMesh(4096, 32, 4);
+            std::vector<ai_real> vertex_data;
+
+            runner.run("SceneLoader::processAssimpVertices (4096 vertices, 32 bones)", [&] {
+                vertex_data.clear();
+                scene_loader.processAssimpVertices(mesh, true, vertex_data);
+                doNotOptimize(vertex_data.data());
+            });
+
+            delete mesh;
+
+            // large meshes get processed in parallel
+            JobSystem job_system;
+            job_system.init();
+            scene_loader.setJobSystem(job_system);
+            mesh = createBenchmarkMesh(65536, 64, 4);
+
+            runner.run("SceneLoader::processAssimpVertices (65536 vertices, 64 bones, parallel)", [&] {
+                vertex_data.clear();
+                scene_loader.processAssimpVertices(mesh, true, vertex_data);
+                doNotOptimize(vertex_data.data());
+            });
+
+            delete mesh;
+            job_system.cleanUp();
+
+            // MeshOptimizer
+            MeshOptimizer mesh_optimizer;
+            std::vector<float> grid_vertices, vertices;
+            std::vector<uint32_t> grid_indices, indices;
+            createBenchmarkGrid(128, grid_vertices, grid_indices);
+
+            runner.run("MeshOptimizer::optimize (128x128 grid, unwelded)", [&] {
+                vertices = grid_vertices;
+                indices = grid_indices;
+                doNotOptimize(mesh_optimizer.optimize(vertices, 5, indices, true));
+            });
+
+            // MeshSimplifier (on the welded grid)
+            MeshSimplifier mesh_simplifier;
+            std::vector<float> welded_vertices;
+            std::vector<uint32_t> welded_indices;
+            createBenchmarkGrid(64, welded_vertices, welded_indices);
+            mesh_optimizer.optimize(welded_vertices, 5, welded_indices, true);
+
+            runner.run("MeshSimplifier::generateLODs (64x64 grid)", [&] {
+                indices = welded_indices;
+                doNotOptimize(mesh_simplifier.generateLODs(welded_vertices, 5, 2, indices).size());
+            });
+
+        }
+
+    } // benchmarks
+
+} // undicht
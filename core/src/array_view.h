@@ -0,0 +1,48 @@
+#ifndef ARRAY_VIEW_H
+#define ARRAY_VIEW_H
+
+#include "cstddef"
+#include "vector"
+#include "array"
+#include "initializer_list"
+
+namespace undicht {
+
+    template<typename T>
+    class ArrayView {
+        /** @brief a non owning view of contiguous elements (i.e. a std::vector, a std::array or an initializer list)
+         * use it for function parameters that only read the elements,
+         * so that callers passing a {...} list dont have to allocate a vector
+         * the viewed elements have to outlive the view (initializer lists only live until the end of the statement) */
+
+      protected:
+
+        const T* _data = nullptr;
+        size_t _size = 0;
+
+      public:
+
+        ArrayView() = default;
+        ArrayView(const T* data, size_t size) : _data(data), _size(size) {}
+        ArrayView(std::initializer_list<T> list) : _data(list.begin()), _size(list.size()) {}
+
+        template<typename Allocator>
+        ArrayView(const std::vector<T, Allocator>& vector) : _data(vector.data()), _size(vector.size()) {}
+
+        template<size_t N>
+        ArrayView(const std::array<T, N>& array) : _data(array.data()), _size(N) {}
+
+        const T* data() const { return _data; }
+        size_t size() const { return _size; }
+        bool empty() const { return !_size; }
+
+        const T* begin() const { return _data; }
+        const T* end() const { return _data + _size; }
+
+        const T& operator[](size_t i) const { return _data[i]; }
+
+    };
+
+} // undicht
+
+#endif // ARRAY_VIEW_H
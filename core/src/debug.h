@@ -4,13 +4,17 @@
 #include <iostream>
 #include <chrono>
 
+#include "logger.h"
+
 // macros for logging and debugging
+// the messages are written asynchronously by the Logger (see logger.h),
+// call undicht::Logger::flush() before aborting the program
 
-#define UND_ERROR std::cout << "ERROR: " <<  " from " << __FILE__ << " : " << __LINE__ << "\n    "
+#define UND_ERROR UND_LOG_STREAM(UND_LOG_LEVEL_ERROR)
 
-#define UND_WARNING std::cout << "WARNING: " << " from " << __FILE__ << "\n    "
+#define UND_WARNING UND_LOG_STREAM(UND_LOG_LEVEL_WARNING)
 
-#define UND_LOG std::cout << std::flush << "Note: " <<  millis() << " ms\n    "
+#define UND_LOG UND_LOG_STREAM(UND_LOG_LEVEL_NOTE)
 
 namespace undicht {
 
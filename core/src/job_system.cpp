@@ -0,0 +1,261 @@
+#include "job_system.h"
+#include "profiler.h"
+
+#include "string"
+#include "algorithm"
+
+namespace undicht {
+
+    // the job system the calling thread is a worker of
+    thread_local const JobSystem* s_current_job_system = nullptr;
+    thread_local uint32_t s_current_worker = 0;
+
+    ///////////////////////////////////////////// JobCounter /////////////////////////////////////////////
+
+    bool JobCounter::isDone() const {
+        /// @return true, if all jobs started with the counter finished
+
+        // the counter may be destroyed once this returns true,
+        // so the thread that finished the last job has to be done releasing the waiting jobs
+        return !_count.load(std::memory_order_acquire) && !_releasing.load(std::memory_order_acquire);
+    }
+
+    ///////////////////////////////////////////// JobSystem /////////////////////////////////////////////
+
+    void JobSystem::init(uint32_t worker_count) {
+        /// @param worker_count number of worker threads (0: one less than the number of hardware threads)
+
+        if(!worker_count) worker_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+        _running.store(true);
+
+        for(uint32_t i = 0; i < worker_count + 1; i++)
+            _queues.emplace_back(std::make_unique<JobQueue>());
+
+        for(uint32_t i = 0; i < worker_count; i++)
+            _workers.emplace_back(&JobSystem::workerThread, this, i);
+
+    }
+
+    void JobSystem::cleanUp() {
+        /// @brief waits for all queued jobs to finish and stops the workers
+
+        {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _running.store(false);
+        }
+        _wake_up.notify_all();
+
+        // the workers execute the remaining jobs before they stop
+        for(std::thread& worker : _workers)
+            worker.join();
+
+        // jobs that were queued by the last jobs
+        Job job;
+        while(findJob(_workers.size(), job))
+            executeJob(job);
+
+        _workers.clear();
+        _queues.clear();
+
+    }
+
+    void JobSystem::run(const std::function<void()>& job, JobCounter* counter, JobCounter* dependency) {
+        /** @brief queues a job
+         * @param counter (optional) gets incremented now and decremented once the job finished
+         * @param dependency (optional) the job gets queued once the dependency counter reaches zero */
+
+        if(counter) counter->_count.fetch_add(1, std::memory_order_relaxed);
+
+        if(dependency) {
+            std::lock_guard<std::mutex> lock(dependency->_waiting_jobs_mutex);
+
+            if(dependency->_count.load(std::memory_order_acquire)) {
+                // gets queued by the thread finishing the last job of the dependency
+                dependency->_waiting_jobs.push_back({job, counter});
+                return;
+            }
+
+        }
+
+        pushJob({job, counter});
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t begin, uint32_t end)>& job, JobCounter* counter) {
+        /** @brief splits the range [0, count) into batches, which are executed as separate jobs
+         * @param job called with the [begin, end) range of a batch
+         * @param counter (optional) the counter is incremented by the number of batches */
+
+        if(!batch_size) batch_size = 1;
+
+        for(uint32_t begin = 0; begin < count; begin += batch_size) {
+
+            uint32_t end = std::min(begin + batch_size, count);
+            run([job, begin, end](){ job(begin, end); }, counter);
+        }
+
+    }
+
+    void JobSystem::parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t begin, uint32_t end)>& job) {
+        /// @brief splits the range into batches and waits for all of them to finish
+
+        JobCounter counter;
+        parallelFor(count, batch_size, job, &counter);
+        wait(counter);
+    }
+
+    void JobSystem::wait(JobCounter& counter) {
+        /// @brief executes queued jobs until the counter reaches zero
+
+        uint32_t worker_id = getCurrentWorker();
+        Job job;
+
+        while(!counter.isDone()) {
+
+            if(findJob(worker_id, job))
+                executeJob(job);
+            else
+                std::this_thread::yield(); // the remaining jobs are being executed by other threads
+
+        }
+
+    }
+
+    uint32_t JobSystem::getWorkerCount() const {
+
+        return _workers.size();
+    }
+
+    uint32_t JobSystem::getCurrentWorker() const {
+        /// @return the index of the calling thread, if it is a worker of this system (getWorkerCount() otherwise)
+
+        if(s_current_job_system == this) return s_current_worker;
+
+        return _workers.size();
+    }
+
+    ///////////////////////////////////////////// non public functions /////////////////////////////////////////////
+
+    void JobSystem::workerThread(uint32_t worker_id) {
+
+        s_current_job_system = this;
+        s_current_worker = worker_id;
+        Profiler::setThreadName(("job worker " + std::to_string(worker_id)).c_str());
+
+        Job job;
+
+        while(true) {
+
+            if(findJob(worker_id, job)) {
+                executeJob(job);
+                continue;
+            }
+
+            if(!_running.load()) break;
+
+            // sleeping until new jobs get queued
+            // (incrementing the sleeping workers before checking for jobs, so that pushJob() cant miss this worker)
+            _sleeping_workers.fetch_add(1);
+            {
+                std::unique_lock<std::mutex> lock(_sleep_mutex);
+                _wake_up.wait(lock, [this](){ return _queued_jobs.load() || !_running.load(); });
+            }
+            _sleeping_workers.fetch_sub(1);
+
+        }
+
+    }
+
+    void JobSystem::pushJob(Job&& job) {
+
+        JobQueue& queue = *_queues.at(getCurrentWorker());
+
+        {
+            std::lock_guard<std::mutex> lock(queue._mutex);
+            queue._jobs.push_back(std::move(job));
+        }
+
+        _queued_jobs.fetch_add(1);
+
+        if(_sleeping_workers.load()) {
+            std::lock_guard<std::mutex> lock(_sleep_mutex);
+            _wake_up.notify_one();
+        }
+
+    }
+
+    bool JobSystem::popJob(uint32_t queue_id, Job& job) {
+        /// @brief takes a job from the given queue (newest first for the own queue, oldest first when stealing)
+
+        JobQueue& queue = *_queues.at(queue_id);
+        std::lock_guard<std::mutex> lock(queue._mutex);
+
+        if(queue._jobs.empty()) return false;
+
+        if((queue_id == getCurrentWorker()) && (queue_id < _workers.size())) {
+            // the newest job is the most likely to still have its data in the cache
+            job = std::move(queue._jobs.back());
+            queue._jobs.pop_back();
+        } else {
+            job = std::move(queue._jobs.front());
+            queue._jobs.pop_front();
+        }
+
+        _queued_jobs.fetch_sub(1);
+
+        return true;
+    }
+
+    bool JobSystem::findJob(uint32_t worker_id, Job& job) {
+        /// @brief looks for a job in the own queue, the shared queue and the queues of the other workers
+
+        if(!_queued_jobs.load()) return false;
+
+        uint32_t queue_count = _queues.size();
+
+        if(popJob(worker_id, job)) return true;
+        if(popJob(queue_count - 1, job)) return true;
+
+        // stealing from the other workers
+        for(uint32_t i = 1; i < queue_count - 1; i++) {
+
+            uint32_t victim = (worker_id + i) % (queue_count - 1);
+            if((victim != worker_id) && popJob(victim, job)) return true;
+        }
+
+        return false;
+    }
+
+    void JobSystem::executeJob(Job& job) {
+
+        job._function();
+        finishJob(job._counter);
+
+        job._function = nullptr; // releasing the captured data
+    }
+
+    void JobSystem::finishJob(JobCounter* counter) {
+
+        if(!counter) return;
+
+        counter->_releasing.fetch_add(1);
+
+        if(counter->_count.fetch_sub(1) == 1) {
+            // queueing the jobs that depended on the counter
+            std::vector<JobCounter::WaitingJob> released_jobs;
+
+            {
+                std::lock_guard<std::mutex> lock(counter->_waiting_jobs_mutex);
+                released_jobs.swap(counter->_waiting_jobs);
+            }
+
+            for(JobCounter::WaitingJob& waiting_job : released_jobs)
+                pushJob({std::move(waiting_job._function), waiting_job._counter});
+
+        }
+
+        counter->_releasing.fetch_sub(1); // the last access to the counter
+
+    }
+
+} // undicht
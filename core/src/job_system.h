@@ -0,0 +1,126 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "cstdint"
+#include "vector"
+#include "deque"
+#include "functional"
+#include "atomic"
+#include "mutex"
+#include "condition_variable"
+#include "thread"
+#include "memory"
+
+namespace undicht {
+
+    class JobSystem;
+
+    class JobCounter {
+        /** @brief counts the unfinished jobs that were started with the counter
+         * can be waited on (JobSystem::wait()) or used as a dependency for other jobs,
+         * which only get queued once the counter reaches zero
+         * the counter has to stay alive until all jobs using it finished */
+
+      protected:
+
+        friend JobSystem;
+
+        struct WaitingJob {
+            std::function<void()> _function;
+            JobCounter* _counter;
+        };
+
+        std::atomic<uint32_t> _count{0};
+        std::atomic<uint32_t> _releasing{0}; // threads that are still accessing the counter after decrementing it
+        std::mutex _waiting_jobs_mutex;
+        std::vector<WaitingJob> _waiting_jobs; // jobs depending on this counter
+
+      public:
+
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        /// @return true, if all jobs started with the counter finished
+        bool isDone() const;
+
+    };
+
+    class JobSystem {
+        /** @brief runs jobs on a pool of worker threads
+         * every worker has its own job queue, new jobs get pushed to the queue of the thread starting them
+         * workers execute the newest jobs of their own queue first and steal the oldest jobs of the others when they run out
+         * jobs started from threads that are not workers of this system go into a shared queue
+         * threads waiting for a JobCounter help executing jobs instead of blocking */
+
+      protected:
+
+        struct Job {
+            std::function<void()> _function;
+            JobCounter* _counter = nullptr;
+        };
+
+        struct JobQueue {
+            std::mutex _mutex;
+            std::deque<Job> _jobs;
+        };
+
+        std::vector<std::thread> _workers;
+        std::vector<std::unique_ptr<JobQueue>> _queues; // one per worker + the shared queue (last)
+
+        std::atomic<bool> _running{false};
+        std::atomic<uint32_t> _queued_jobs{0};
+        std::atomic<uint32_t> _sleeping_workers{0};
+        std::mutex _sleep_mutex;
+        std::condition_variable _wake_up;
+
+      public:
+
+        /// @param worker_count number of worker threads (0: one less than the number of hardware threads)
+        void init(uint32_t worker_count = 0);
+
+        /// @brief waits for all queued jobs to finish and stops the workers
+        void cleanUp();
+
+        /** @brief queues a job
+         * @param counter (optional) gets incremented now and decremented once the job finished
+         * @param dependency (optional) the job gets queued once the dependency counter reaches zero */
+        void run(const std::function<void()>& job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+
+        /** @brief splits the range [0, count) into batches, which are executed as separate jobs
+         * @param job called with the [begin, end) range of a batch
+         * @param counter (optional) the counter is incremented by the number of batches */
+        void parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t begin, uint32_t end)>& job, JobCounter* counter);
+
+        /// @brief splits the range into batches and waits for all of them to finish
+        void parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t begin, uint32_t end)>& job);
+
+        /// @brief executes queued jobs until the counter reaches zero
+        void wait(JobCounter& counter);
+
+        uint32_t getWorkerCount() const;
+
+        /// @return the index of the calling thread, if it is a worker of this system (getWorkerCount() otherwise)
+        uint32_t getCurrentWorker() const;
+
+      protected:
+        // non public functions
+
+        void workerThread(uint32_t worker_id);
+
+        void pushJob(Job&& job);
+
+        /// @brief takes a job from the given queue (newest first for the own queue, oldest first when stealing)
+        bool popJob(uint32_t queue_id, Job& job);
+
+        /// @brief looks for a job in the own queue, the shared queue and the queues of the other workers
+        bool findJob(uint32_t worker_id, Job& job);
+
+        void executeJob(Job& job);
+        void finishJob(JobCounter* counter);
+
+    };
+
+} // undicht
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,130 @@
+#include "latency_histogram.h"
+
+#ifdef _MSC_VER
+#include "intrin.h"
+#endif
+
+namespace undicht {
+
+    LatencyHistogram::LatencyHistogram() {
+
+        reset();
+    }
+
+    void LatencyHistogram::record(uint64_t value) {
+
+        _buckets[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t min = _min.load(std::memory_order_relaxed);
+        while((value < min) && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed));
+
+        uint64_t max = _max.load(std::memory_order_relaxed);
+        while((value > max) && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
+
+    }
+
+    void LatencyHistogram::reset() {
+
+        for(std::atomic<uint32_t>& bucket : _buckets)
+            bucket.store(0, std::memory_order_relaxed);
+
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _min.store(UINT64_MAX, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    LatencyHistogram::Stats LatencyHistogram::getStats() const {
+        /// @brief calculates the statistics from the current state of the histogram
+        /// (while other threads are recording values, the result might be slightly inconsistent)
+
+        Stats stats;
+        stats._count = _count.load(std::memory_order_relaxed);
+
+        if(!stats._count) return stats;
+
+        stats._min = _min.load(std::memory_order_relaxed);
+        stats._max = _max.load(std::memory_order_relaxed);
+        stats._mean = double(_sum.load(std::memory_order_relaxed)) / stats._count;
+        stats._p50 = getPercentile(0.50);
+        stats._p95 = getPercentile(0.95);
+        stats._p99 = getPercentile(0.99);
+
+        return stats;
+    }
+
+    uint64_t LatencyHistogram::getPercentile(double fraction) const {
+        /// @return the value below which the given fraction (0.0 to 1.0) of the recorded values lie
+
+        uint64_t count = _count.load(std::memory_order_relaxed);
+        if(!count) return 0;
+
+        // the rank of the value we are looking for (at least 1)
+        uint64_t rank = uint64_t(fraction * count + 0.5);
+        if(rank < 1) rank = 1;
+
+        uint64_t min = _min.load(std::memory_order_relaxed);
+        uint64_t max = _max.load(std::memory_order_relaxed);
+        uint64_t cumulative = 0;
+
+        for(uint32_t i = 0; i < BUCKET_COUNT; i++) {
+
+            cumulative += _buckets[i].load(std::memory_order_relaxed);
+
+            if(cumulative >= rank) {
+                // using the middle of the bucket, but staying within the recorded range
+                uint64_t value = getBucketMin(i) + (getBucketMax(i) - getBucketMin(i)) / 2;
+                if(value < min) value = min;
+                if(value > max) value = max;
+                return value;
+            }
+
+        }
+
+        return max;
+    }
+
+    /////////////////////////////////////////// protected functions ///////////////////////////////////////////
+
+    uint32_t LatencyHistogram::getBucket(uint64_t value) {
+
+        if(value < SUB_BUCKETS) return uint32_t(value);
+
+        // index of the highest set bit
+#ifdef _MSC_VER
+        unsigned long exponent;
+        _BitScanReverse64(&exponent, value);
+#else
+        uint32_t exponent = 63 - __builtin_clzll(value);
+#endif
+
+        if(exponent > MAX_EXPONENT) return BUCKET_COUNT - 1;
+
+        uint32_t sub_bucket = (value >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+
+        return SUB_BUCKETS + (exponent - SUB_BUCKET_BITS) * SUB_BUCKETS + sub_bucket;
+    }
+
+    uint64_t LatencyHistogram::getBucketMin(uint32_t bucket) {
+
+        if(bucket < SUB_BUCKETS) return bucket;
+
+        uint32_t exponent = (bucket - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+        uint32_t sub_bucket = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+
+        return uint64_t(SUB_BUCKETS + sub_bucket) << (exponent - SUB_BUCKET_BITS);
+    }
+
+    uint64_t LatencyHistogram::getBucketMax(uint32_t bucket) {
+
+        if(bucket < SUB_BUCKETS) return bucket;
+
+        uint32_t exponent = (bucket - SUB_BUCKETS) / SUB_BUCKETS + SUB_BUCKET_BITS;
+        uint32_t sub_bucket = (bucket - SUB_BUCKETS) % SUB_BUCKETS;
+
+        return (uint64_t(SUB_BUCKETS + sub_bucket + 1) << (exponent - SUB_BUCKET_BITS)) - 1;
+    }
+
+} // undicht
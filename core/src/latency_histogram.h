@@ -0,0 +1,63 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include "cstdint"
+#include "atomic"
+
+namespace undicht {
+
+    class LatencyHistogram {
+      /** @brief a fixed size histogram with logarithmic buckets (8 buckets per power of two)
+       * recording a value is lock free and can be done from multiple threads at once
+       * percentiles are accurate to within ~6% of the value, the memory use is constant */
+
+      public:
+
+        const static uint32_t SUB_BUCKET_BITS = 3;
+        const static uint32_t SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        const static uint32_t MAX_EXPONENT = 47; // values >= 2^48 get clamped into the last bucket
+        const static uint32_t BUCKET_COUNT = SUB_BUCKETS + (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+        struct Stats {
+            uint64_t _count = 0;
+            uint64_t _min = 0;
+            uint64_t _max = 0;
+            double _mean = 0.0;
+            uint64_t _p50 = 0;
+            uint64_t _p95 = 0;
+            uint64_t _p99 = 0;
+        };
+
+      protected:
+
+        std::atomic<uint32_t> _buckets[BUCKET_COUNT];
+        std::atomic<uint64_t> _count;
+        std::atomic<uint64_t> _sum;
+        std::atomic<uint64_t> _min;
+        std::atomic<uint64_t> _max;
+
+      public:
+
+        LatencyHistogram();
+
+        void record(uint64_t value);
+        void reset();
+
+        /// @brief calculates the statistics from the current state of the histogram
+        /// (while other threads are recording values, the result might be slightly inconsistent)
+        Stats getStats() const;
+
+        /// @return the value below which the given fraction (0.0 to 1.0) of the recorded values lie
+        uint64_t getPercentile(double fraction) const;
+
+      protected:
+
+        uint32_t static getBucket(uint64_t value);
+        uint64_t static getBucketMin(uint32_t bucket);
+        uint64_t static getBucketMax(uint32_t bucket);
+
+    };
+
+} // undicht
+
+#endif // LATENCY_HISTOGRAM_H
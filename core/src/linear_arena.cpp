@@ -0,0 +1,151 @@
+#include "linear_arena.h"
+
+#include "cstdlib"
+#include "algorithm"
+
+namespace undicht {
+
+    ///////////////////////////////////////////// LinearArena /////////////////////////////////////////////
+
+    LinearArena::~LinearArena() {
+
+        cleanUp();
+    }
+
+    void LinearArena::init(size_t byte_size) {
+
+        cleanUp();
+
+        _block = (uint8_t*)std::malloc(byte_size);
+        _block_size = byte_size;
+        _offset = 0;
+    }
+
+    void LinearArena::cleanUp() {
+
+        for(uint8_t* block : _overflow_blocks)
+            std::free(block);
+
+        _overflow_blocks.clear();
+        _overflow_size = 0;
+        _overflow_offset = 0;
+        _overflow_block_size = 0;
+
+        std::free(_block);
+        _block = nullptr;
+        _block_size = 0;
+        _offset = 0;
+    }
+
+    void* LinearArena::allocate(size_t byte_size, size_t alignment) {
+        /// @return memory for byte_size bytes, aligned to alignment (which has to be a power of two)
+
+        // aligning the address (not just the offset), since malloc only guarantees alignof(std::max_align_t)
+        uintptr_t address = ((uintptr_t)_block + _offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t offset = address - (uintptr_t)_block;
+
+        if(_block && _overflow_blocks.empty() && (offset + byte_size <= _block_size)) {
+            _offset = offset + byte_size;
+            return (void*)address;
+        }
+
+        return allocateOverflow(byte_size, alignment);
+    }
+
+    void LinearArena::reset() {
+        /// @brief releases all allocations made since the last reset (no destructors are called)
+
+        if(_overflow_blocks.size()) {
+            // growing the block, so that the next frame fits into it
+            size_t new_size = _block_size + _overflow_size;
+            init(new_size);
+        }
+
+        _offset = 0;
+    }
+
+    size_t LinearArena::getUsedSize() const {
+        /// @return the number of bytes allocated since the last reset
+
+        size_t full_overflow_blocks = _overflow_size - _overflow_block_size;
+
+        return _offset + full_overflow_blocks + _overflow_offset;
+    }
+
+    size_t LinearArena::getCapacity() const {
+
+        return _block_size + _overflow_size;
+    }
+
+    ///////////////////////////////////////////// non public functions /////////////////////////////////////////////
+
+    void* LinearArena::allocateOverflow(size_t byte_size, size_t alignment) {
+
+        if(_overflow_blocks.size()) {
+            // trying to fit the allocation into the last overflow block
+            uint8_t* block = _overflow_blocks.back();
+            uintptr_t address = ((uintptr_t)block + _overflow_offset + alignment - 1) & ~(uintptr_t)(alignment - 1);
+            size_t offset = address - (uintptr_t)block;
+
+            if(offset + byte_size <= _overflow_block_size) {
+                _overflow_offset = offset + byte_size;
+                return (void*)address;
+            }
+
+        }
+
+        // allocating a new block (at least as big as everything allocated so far)
+        size_t block_size = std::max(_block_size + _overflow_size, byte_size + alignment);
+        uint8_t* block = (uint8_t*)std::malloc(block_size);
+
+        _overflow_blocks.push_back(block);
+        _overflow_size += block_size;
+        _overflow_block_size = block_size;
+
+        uintptr_t address = ((uintptr_t)block + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        _overflow_offset = (address - (uintptr_t)block) + byte_size;
+
+        return (void*)address;
+    }
+
+    ///////////////////////////////////////////// FrameArena /////////////////////////////////////////////
+
+    std::atomic<uint64_t> FrameArena::s_frame{0};
+
+    LinearArena& FrameArena::get() {
+        /// @return the arena of the calling thread
+
+        struct ThreadArena {
+            LinearArena _arena;
+            uint64_t _frame = 0;
+
+            ThreadArena() {
+                _arena.init(INITIAL_SIZE);
+                _frame = s_frame.load(std::memory_order_relaxed);
+            }
+        };
+
+        thread_local ThreadArena thread_arena;
+
+        // resetting the arena the first time it is used in a new frame
+        uint64_t frame = s_frame.load(std::memory_order_relaxed);
+        if(thread_arena._frame != frame) {
+            thread_arena._arena.reset();
+            thread_arena._frame = frame;
+        }
+
+        return thread_arena._arena;
+    }
+
+    void FrameArena::nextFrame() {
+        /// @brief marks the beginning of a new frame (called by the FrameManager)
+
+        s_frame.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t FrameArena::getFrame() {
+
+        return s_frame.load(std::memory_order_relaxed);
+    }
+
+} // undicht
@@ -0,0 +1,133 @@
+#ifndef LINEAR_ARENA_H
+#define LINEAR_ARENA_H
+
+#include "cstdint"
+#include "cstddef"
+#include "vector"
+#include "atomic"
+
+namespace undicht {
+
+    class LinearArena {
+        /** @brief hands out memory by incrementing an offset into a preallocated block
+         * individual allocations cant be freed, instead all of them get released at once by reset()
+         * if the block runs out of memory, additional blocks get allocated,
+         * on the next reset() they get merged into one block big enough for all of them,
+         * so once the arena has grown to the peak usage, allocating never calls malloc again
+         * not thread safe (see FrameArena for per thread arenas) */
+
+      protected:
+
+        uint8_t* _block = nullptr;
+        size_t _block_size = 0;
+        size_t _offset = 0;
+
+        std::vector<uint8_t*> _overflow_blocks; // allocated when the block was full
+        size_t _overflow_size = 0; // total size of the overflow blocks
+        size_t _overflow_offset = 0; // offset into the last overflow block
+        size_t _overflow_block_size = 0; // size of the last overflow block
+
+      public:
+
+        LinearArena() = default;
+        LinearArena(const LinearArena&) = delete;
+        LinearArena& operator=(const LinearArena&) = delete;
+        ~LinearArena();
+
+        void init(size_t byte_size);
+        void cleanUp();
+
+        /// @return memory for byte_size bytes, aligned to alignment (which has to be a power of two)
+        void* allocate(size_t byte_size, size_t alignment = alignof(std::max_align_t));
+
+        template<typename T>
+        T* allocate(size_t count) {
+            return (T*)allocate(count * sizeof(T), alignof(T));
+        }
+
+        /// @brief releases all allocations made since the last reset (no destructors are called)
+        void reset();
+
+        /// @return the number of bytes allocated since the last reset
+        size_t getUsedSize() const;
+        size_t getCapacity() const;
+
+      protected:
+
+        void* allocateOverflow(size_t byte_size, size_t alignment);
+
+    };
+
+    class FrameArena {
+        /** @brief every thread gets its own LinearArena for memory that is only needed during the current frame
+         * the arena of a thread gets reset the first time it is used after nextFrame() was called,
+         * so memory from the frame arena must not be used after the frame it was allocated in
+         * (and jobs using it have to be finished before the next frame begins) */
+
+      public:
+
+        const static size_t INITIAL_SIZE = 256 * 1024; // bytes, the arenas grow if they need more
+
+      protected:
+
+        static std::atomic<uint64_t> s_frame;
+
+      public:
+
+        /// @return the arena of the calling thread
+        static LinearArena& get();
+
+        /// @brief marks the beginning of a new frame (called by the FrameManager)
+        void static nextFrame();
+
+        uint64_t static getFrame();
+
+    };
+
+    template<typename T>
+    class ArenaAllocator {
+        /** @brief allocator to use stl containers with a LinearArena
+         * deallocating does nothing, the memory gets released when the arena is reset */
+
+      public:
+
+        using value_type = T;
+
+        LinearArena* _arena;
+
+      public:
+
+        /// @brief uses the frame arena of the calling thread
+        ArenaAllocator() : _arena(&FrameArena::get()) {}
+        ArenaAllocator(LinearArena& arena) : _arena(&arena) {}
+
+        template<typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : _arena(other._arena) {}
+
+        T* allocate(size_t count) {
+            return _arena->allocate<T>(count);
+        }
+
+        void deallocate(T* /*ptr*/, size_t /*count*/) {
+            // freed when the arena gets reset
+        }
+
+        template<typename U>
+        bool operator==(const ArenaAllocator<U>& other) const {
+            return _arena == other._arena;
+        }
+
+        template<typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const {
+            return _arena != other._arena;
+        }
+
+    };
+
+    /// @brief a vector allocating its memory from the frame arena of the thread creating it
+    template<typename T>
+    using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+} // undicht
+
+#endif // LINEAR_ARENA_H
@@ -0,0 +1,506 @@
+#include "logger.h"
+#include "debug.h"
+
+#include "mutex"
+#include "condition_variable"
+#include "thread"
+#include "chrono"
+#include "charconv"
+#include "cstdio"
+#include "cstring"
+#include "algorithm"
+
+namespace undicht {
+
+    ///////////////////////////////////////////// LogStream /////////////////////////////////////////////
+
+    LogStream::LogStream(uint32_t level, const char* file, uint32_t line) : _level(level), _file(file), _line(line) {
+
+    }
+
+    LogStream::~LogStream() {
+
+        if(_truncated) {
+            // marking the end of the truncated message
+            std::memcpy(_message + MAX_MESSAGE_LENGTH - 4, "...\n", 4);
+        }
+
+        Logger::write(_level, _file, _line, _message, _length);
+    }
+
+    LogStream& LogStream::operator<<(const char* str) {
+
+        if(!str) str = "(null)";
+
+        append(str, std::strlen(str));
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(const std::string& str) {
+
+        append(str.data(), str.size());
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(std::string_view str) {
+
+        append(str.data(), str.size());
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(char c) {
+
+        append(&c, 1);
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(signed char c) {
+
+        return *this << char(c);
+    }
+
+    LogStream& LogStream::operator<<(unsigned char c) {
+
+        return *this << char(c);
+    }
+
+    LogStream& LogStream::operator<<(bool value) {
+
+        return *this << (value ? '1' : '0');
+    }
+
+    LogStream& LogStream::operator<<(short value) {
+
+        return *this << (long long)value;
+    }
+
+    LogStream& LogStream::operator<<(unsigned short value) {
+
+        return *this << (unsigned long long)value;
+    }
+
+    LogStream& LogStream::operator<<(int value) {
+
+        return *this << (long long)value;
+    }
+
+    LogStream& LogStream::operator<<(unsigned int value) {
+
+        return *this << (unsigned long long)value;
+    }
+
+    LogStream& LogStream::operator<<(long value) {
+
+        return *this << (long long)value;
+    }
+
+    LogStream& LogStream::operator<<(unsigned long value) {
+
+        return *this << (unsigned long long)value;
+    }
+
+    LogStream& LogStream::operator<<(long long value) {
+
+        char buffer[24];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        append(buffer, result.ptr - buffer);
+
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(unsigned long long value) {
+
+        char buffer[24];
+        std::to_chars_result result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        append(buffer, result.ptr - buffer);
+
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(float value) {
+
+        return *this << (double)value;
+    }
+
+    LogStream& LogStream::operator<<(double value) {
+
+        // %g matches the default formatting of std::ostream
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+        if(length > 0) append(buffer, std::min<uint32_t>(length, sizeof(buffer) - 1));
+
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(long double value) {
+
+        char buffer[48];
+        int length = std::snprintf(buffer, sizeof(buffer), "%Lg", value);
+        if(length > 0) append(buffer, std::min<uint32_t>(length, sizeof(buffer) - 1));
+
+        return *this;
+    }
+
+    LogStream& LogStream::operator<<(const void* ptr) {
+
+        char buffer[32];
+        int length = std::snprintf(buffer, sizeof(buffer), "%p", ptr);
+        if(length > 0) append(buffer, std::min<uint32_t>(length, sizeof(buffer) - 1));
+
+        return *this;
+    }
+
+    void LogStream::append(const char* data, uint32_t length) {
+
+        uint32_t space = MAX_MESSAGE_LENGTH - _length;
+
+        if(length > space) {
+            length = space;
+            _truncated = true;
+        }
+
+        std::memcpy(_message + _length, data, length);
+        _length += length;
+    }
+
+    ///////////////////////////////////////////// Logger /////////////////////////////////////////////
+
+    namespace {
+
+        struct RecordHeader {
+            // stored in front of every message in the thread buffers
+            uint64_t _sequence;
+            const char* _file;
+            long _time; // millis()
+            uint32_t _level;
+            uint32_t _line;
+            uint32_t _length; // of the message
+            uint32_t _size; // of the whole record (header + message + padding)
+        };
+
+        enum DrainState : uint32_t {
+            NOT_STARTED,
+            RUNNING,
+            STOPPED, // after the drain thread stopped (during the programs exit), messages are written synchronously
+        };
+
+        std::mutex s_logger_mutex; // guards the list of thread buffers and the state of the drain thread
+        std::condition_variable s_drain_requested;
+        std::condition_variable s_drain_finished;
+        std::atomic<uint32_t> s_drain_state{NOT_STARTED};
+        std::atomic<bool> s_drain_sleeping{false}; // the next logged message has to wake up the drain thread
+        uint64_t s_drain_pass = 0; // number of finished drain passes
+        uint64_t s_requested_pass = 0;
+        bool s_stop_draining = false;
+
+        void copyToRing(char* ring, uint64_t position, const void* data, uint32_t size) {
+
+            uint32_t offset = position % Logger::THREAD_BUFFER_SIZE;
+            uint32_t first_part = std::min(size, Logger::THREAD_BUFFER_SIZE - offset);
+
+            std::memcpy(ring + offset, data, first_part);
+            std::memcpy(ring, (const char*)data + first_part, size - first_part);
+        }
+
+        void copyFromRing(const char* ring, uint64_t position, void* data, uint32_t size) {
+
+            uint32_t offset = position % Logger::THREAD_BUFFER_SIZE;
+            uint32_t first_part = std::min(size, Logger::THREAD_BUFFER_SIZE - offset);
+
+            std::memcpy(data, ring + offset, first_part);
+            std::memcpy((char*)data + first_part, ring, size - first_part);
+        }
+
+    } // anonymous namespace
+
+    struct Logger::ThreadBuffer {
+        // single producer (the owning thread), single consumer (the drain thread) ring buffer
+        std::atomic<uint64_t> _write_pos{0};
+        std::atomic<uint64_t> _read_pos{0};
+        std::atomic<bool> _has_owner{true}; // once the owning thread exited, the buffer can be reused by a new thread
+        char _data[THREAD_BUFFER_SIZE];
+    };
+
+    struct Logger::ThreadBufferOwner {
+        // releases the buffer when the thread exits
+        ThreadBuffer* _buffer = nullptr;
+
+        ~ThreadBufferOwner() {
+            if(_buffer) _buffer->_has_owner.store(false, std::memory_order_release);
+        }
+    };
+
+    struct Logger::DrainThread {
+        // destroying the static object at the programs exit stops the thread
+        // the buffers are reused by every drain pass, they live until the last pass (in the destructor) finished
+        std::thread _thread;
+        std::vector<ThreadBuffer*> _buffers;
+        std::vector<uint64_t> _end_positions;
+        std::string _out;
+        uint64_t _reported_dropped_count = 0;
+
+        DrainThread() {
+            s_drain_state.store(RUNNING, std::memory_order_release);
+            _thread = std::thread(&Logger::drainThread, this);
+        }
+
+        ~DrainThread() {
+            {
+                std::lock_guard<std::mutex> lock(s_logger_mutex);
+                s_stop_draining = true;
+            }
+            s_drain_requested.notify_one();
+            _thread.join();
+
+            s_drain_state.store(STOPPED, std::memory_order_release);
+            drain(*this); // messages that got logged while the thread was stopping
+        }
+    };
+
+    std::vector<std::unique_ptr<Logger::ThreadBuffer>> Logger::s_thread_buffers;
+    thread_local Logger::ThreadBufferOwner Logger::s_thread_buffer;
+    std::atomic<uint64_t> Logger::s_sequence{0};
+    std::atomic<uint64_t> Logger::s_dropped_count{0};
+    std::atomic<std::FILE*> Logger::s_output{nullptr}; // nullptr: stdout
+
+    void Logger::write(uint32_t level, const char* file, uint32_t line, const char* message, uint32_t length) {
+        /// @brief copies the message into the calling threads buffer (called by LogStream)
+
+        if(s_drain_state.load(std::memory_order_acquire) == NOT_STARTED) {
+            // starting the drain thread the first time a message is logged
+            static DrainThread drain_thread;
+        }
+
+        if(s_drain_state.load(std::memory_order_acquire) == STOPPED) {
+            std::string out;
+            format(out, level, file, line, millis(), message, length);
+
+            std::lock_guard<std::mutex> lock(s_logger_mutex);
+            std::FILE* output = s_output.load(std::memory_order_relaxed);
+            std::fwrite(out.data(), 1, out.size(), output ? output : stdout);
+            std::fflush(output ? output : stdout);
+            return;
+        }
+
+        ThreadBuffer* buffer = getThreadBuffer();
+        uint32_t size = (sizeof(RecordHeader) + length + 7) & ~7u;
+        uint64_t write_pos = buffer->_write_pos.load(std::memory_order_relaxed);
+
+        while(THREAD_BUFFER_SIZE - (write_pos - buffer->_read_pos.load(std::memory_order_acquire)) < size) {
+
+            if((level < UND_LOG_LEVEL_ERROR) || (s_drain_state.load(std::memory_order_acquire) != RUNNING)) {
+                s_dropped_count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            flush(); // errors dont get dropped
+        }
+
+        RecordHeader header;
+        header._sequence = s_sequence.fetch_add(1, std::memory_order_relaxed);
+        header._file = file;
+        header._time = millis();
+        header._level = level;
+        header._line = line;
+        header._length = length;
+        header._size = size;
+
+        copyToRing(buffer->_data, write_pos, &header, sizeof(RecordHeader));
+        copyToRing(buffer->_data, write_pos + sizeof(RecordHeader), message, length);
+
+        // the drain thread stores s_drain_sleeping before checking the write positions,
+        // so either it sees the message or this thread sees that it has to be woken up (both sides are sequentially consistent)
+        buffer->_write_pos.store(write_pos + size, std::memory_order_seq_cst);
+
+        if(s_drain_sleeping.load(std::memory_order_seq_cst) && s_drain_sleeping.exchange(false, std::memory_order_seq_cst)) {
+            // locking the mutex, so that the notification cant get lost between the drain threads check and its wait
+            std::lock_guard<std::mutex> lock(s_logger_mutex);
+            s_drain_requested.notify_one();
+        }
+
+    }
+
+    void Logger::flush() {
+        /// @brief waits until all messages logged before the call were written
+
+        if(s_drain_state.load(std::memory_order_acquire) != RUNNING) return;
+
+        std::unique_lock<std::mutex> lock(s_logger_mutex);
+
+        // the pass that is currently running might have started before the call
+        uint64_t target_pass = s_drain_pass + 2;
+        s_requested_pass = std::max(s_requested_pass, target_pass);
+        s_drain_requested.notify_one();
+
+        s_drain_finished.wait(lock, [&](){
+            return (s_drain_pass >= target_pass) || s_stop_draining;
+        });
+
+    }
+
+    uint64_t Logger::getDroppedCount() {
+        /// @return the number of messages that were dropped because the threads buffer was full
+
+        return s_dropped_count.load(std::memory_order_relaxed);
+    }
+
+    void Logger::setOutput(std::FILE* file) {
+        /// @brief the file the messages get written to (stdout by default or if file is nullptr), call flush() before changing it
+
+        s_output.store(file, std::memory_order_relaxed);
+    }
+
+    ///////////////////////////////////////////// protected Logger functions /////////////////////////////////////////////
+
+    Logger::ThreadBuffer* Logger::getThreadBuffer() {
+
+        if(s_thread_buffer._buffer) return s_thread_buffer._buffer;
+
+        std::lock_guard<std::mutex> lock(s_logger_mutex);
+
+        // reusing the buffer of a thread that exited
+        for(std::unique_ptr<ThreadBuffer>& buffer : s_thread_buffers) {
+
+            if(buffer->_has_owner.load(std::memory_order_acquire)) continue;
+            if(buffer->_read_pos.load(std::memory_order_acquire) != buffer->_write_pos.load(std::memory_order_relaxed)) continue;
+
+            buffer->_has_owner.store(true, std::memory_order_relaxed);
+            s_thread_buffer._buffer = buffer.get();
+            return s_thread_buffer._buffer;
+        }
+
+        s_thread_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        s_thread_buffer._buffer = s_thread_buffers.back().get();
+
+        return s_thread_buffer._buffer;
+    }
+
+    bool Logger::hasPendingMessages() {
+        /// @return true, if a thread buffer contains messages that werent written yet
+        /// (s_logger_mutex has to be locked)
+
+        for(std::unique_ptr<ThreadBuffer>& buffer : s_thread_buffers)
+            if(buffer->_write_pos.load(std::memory_order_seq_cst) != buffer->_read_pos.load(std::memory_order_relaxed))
+                return true;
+
+        return false;
+    }
+
+    void Logger::drain(DrainThread& drain_thread) {
+        /// @brief writes all messages currently stored in the thread buffers (using the buffers of the drain thread)
+        /// (only called by one thread at a time)
+
+        std::vector<ThreadBuffer*>& buffers = drain_thread._buffers;
+        std::vector<uint64_t>& end_positions = drain_thread._end_positions;
+        std::string& out = drain_thread._out;
+        char message[LogStream::MAX_MESSAGE_LENGTH];
+
+        buffers.clear();
+        out.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(s_logger_mutex);
+            for(std::unique_ptr<ThreadBuffer>& buffer : s_thread_buffers)
+                buffers.push_back(buffer.get());
+        }
+
+        // messages logged after this point are written in the next pass
+        end_positions.resize(buffers.size());
+        for(uint32_t i = 0; i < buffers.size(); i++)
+            end_positions.at(i) = buffers.at(i)->_write_pos.load(std::memory_order_acquire);
+
+        while(true) {
+
+            // writing the messages of all threads in the order they were logged
+            uint32_t next_buffer = 0;
+            RecordHeader next_header;
+            next_header._sequence = UINT64_MAX;
+
+            for(uint32_t i = 0; i < buffers.size(); i++) {
+
+                uint64_t read_pos = buffers.at(i)->_read_pos.load(std::memory_order_relaxed);
+                if(read_pos == end_positions.at(i)) continue;
+
+                RecordHeader header;
+                copyFromRing(buffers.at(i)->_data, read_pos, &header, sizeof(RecordHeader));
+
+                if(header._sequence < next_header._sequence) {
+                    next_header = header;
+                    next_buffer = i;
+                }
+
+            }
+
+            if(next_header._sequence == UINT64_MAX) break;
+
+            ThreadBuffer* buffer = buffers.at(next_buffer);
+            uint64_t read_pos = buffer->_read_pos.load(std::memory_order_relaxed);
+            copyFromRing(buffer->_data, read_pos + sizeof(RecordHeader), message, next_header._length);
+            buffer->_read_pos.store(read_pos + next_header._size, std::memory_order_release);
+
+            format(out, next_header._level, next_header._file, next_header._line, next_header._time, message, next_header._length);
+        }
+
+        uint64_t dropped_count = s_dropped_count.load(std::memory_order_relaxed);
+        if(dropped_count > drain_thread._reported_dropped_count) {
+            int length = std::snprintf(message, sizeof(message), "the logger dropped %llu messages (the threads log buffer was full)\n", (unsigned long long)(dropped_count - drain_thread._reported_dropped_count));
+            format(out, UND_LOG_LEVEL_WARNING, __FILE__, __LINE__, millis(), message, std::min<uint32_t>(length, sizeof(message) - 1));
+            drain_thread._reported_dropped_count = dropped_count;
+        }
+
+        if(out.size()) {
+            std::FILE* output = s_output.load(std::memory_order_relaxed);
+            std::fwrite(out.data(), 1, out.size(), output ? output : stdout);
+            std::fflush(output ? output : stdout);
+        }
+
+    }
+
+    void Logger::drainThread(DrainThread* drain_thread) {
+
+        std::unique_lock<std::mutex> lock(s_logger_mutex);
+
+        while(true) {
+
+            // sleeping until a message gets logged (see write()) or a pass is requested by flush()
+            s_drain_sleeping.store(true, std::memory_order_seq_cst);
+            s_drain_requested.wait(lock, [](){
+                return hasPendingMessages() || (s_requested_pass > s_drain_pass) || s_stop_draining;
+            });
+            s_drain_sleeping.store(false, std::memory_order_relaxed);
+
+            bool stop = s_stop_draining;
+
+            lock.unlock();
+            drain(*drain_thread);
+            lock.lock();
+
+            s_drain_pass++;
+            s_drain_finished.notify_all();
+
+            if(stop) break;
+        }
+
+    }
+
+    void Logger::format(std::string& out, uint32_t level, const char* file, uint32_t line, long time, const char* message, uint32_t length) {
+
+        if(level >= UND_LOG_LEVEL_ERROR) {
+            out += "ERROR:  from ";
+            out += file;
+            out += " : ";
+            out += std::to_string(line);
+        } else if(level == UND_LOG_LEVEL_WARNING) {
+            out += "WARNING:  from ";
+            out += file;
+        } else {
+            out += "Note: ";
+            out += std::to_string(time);
+            out += " ms";
+        }
+
+        out += "\n    ";
+        out.append(message, length);
+    }
+
+} // undicht
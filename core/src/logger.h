@@ -0,0 +1,155 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include "cstdint"
+#include "string"
+#include "string_view"
+#include "sstream"
+#include "type_traits"
+#include "atomic"
+#include "memory"
+#include "vector"
+#include "cstdio"
+
+// log levels (messages below UND_MIN_LOG_LEVEL get removed at compile time)
+#define UND_LOG_LEVEL_NOTE 0
+#define UND_LOG_LEVEL_WARNING 1
+#define UND_LOG_LEVEL_ERROR 2
+#define UND_LOG_LEVEL_NONE 3
+
+#ifndef UND_MIN_LOG_LEVEL
+#define UND_MIN_LOG_LEVEL UND_LOG_LEVEL_NOTE
+#endif
+
+// the arguments of a removed logging statement are not evaluated
+#define UND_LOG_STREAM(level) \
+    ((level) < UND_MIN_LOG_LEVEL) ? (void)0 : ::undicht::LogVoidify() & ::undicht::LogStream((level), __FILE__, __LINE__)
+
+namespace undicht {
+
+    class LogStream {
+        /** @brief formats a single log message into a buffer on the stack
+         * at the end of the logging statement (when the stream gets destructed),
+         * the message is handed to the Logger, which writes it out on a background thread */
+      public:
+
+        const static uint32_t MAX_MESSAGE_LENGTH = 1024; // longer messages get truncated
+
+      protected:
+
+        uint32_t _level;
+        const char* _file;
+        uint32_t _line;
+        uint32_t _length = 0;
+        bool _truncated = false;
+        char _message[MAX_MESSAGE_LENGTH];
+
+      public:
+
+        LogStream(uint32_t level, const char* file, uint32_t line);
+        ~LogStream();
+
+        LogStream& operator<<(const char* str);
+        LogStream& operator<<(const std::string& str);
+        LogStream& operator<<(std::string_view str);
+        LogStream& operator<<(char c);
+        LogStream& operator<<(signed char c);
+        LogStream& operator<<(unsigned char c);
+        LogStream& operator<<(bool value);
+        LogStream& operator<<(short value);
+        LogStream& operator<<(unsigned short value);
+        LogStream& operator<<(int value);
+        LogStream& operator<<(unsigned int value);
+        LogStream& operator<<(long value);
+        LogStream& operator<<(unsigned long value);
+        LogStream& operator<<(long long value);
+        LogStream& operator<<(unsigned long long value);
+        LogStream& operator<<(float value);
+        LogStream& operator<<(double value);
+        LogStream& operator<<(long double value);
+        LogStream& operator<<(const void* ptr);
+
+        /// @brief enums are logged as numbers, other types via their std::ostream operator (slower, allocates)
+        template<typename T>
+        LogStream& operator<<(const T& value) {
+
+            if constexpr(std::is_enum_v<T>) {
+                return *this << static_cast<std::underlying_type_t<T>>(value);
+            } else if constexpr(std::is_convertible_v<const T&, const char*>) {
+                return *this << static_cast<const char*>(value); // i.e. non const char arrays
+            } else {
+                std::ostringstream stream;
+                stream << value;
+                return *this << stream.str();
+            }
+
+        }
+
+      protected:
+
+        void append(const char* data, uint32_t length);
+
+    };
+
+    struct LogVoidify {
+        // used by UND_LOG_STREAM to turn the stream expression into a void expression
+        // (& binds weaker than <<, but stronger than ?:)
+        void operator&(const LogStream&) {}
+    };
+
+    class Logger {
+        /** @brief writes log messages asynchronously
+         * each thread copies its messages into its own lock free ring buffer,
+         * a background thread drains the buffers (in the order the messages were logged) and writes them to stdout
+         * the background thread sleeps until a message gets logged (only the first message after it went to sleep wakes it up)
+         * if a threads buffer is full, notes and warnings get dropped (and counted), errors wait for free space */
+
+      public:
+
+        const static uint32_t THREAD_BUFFER_SIZE = 64 * 1024; // bytes
+
+      protected:
+
+        struct ThreadBuffer;
+        struct ThreadBufferOwner;
+        struct DrainThread;
+
+        static std::vector<std::unique_ptr<ThreadBuffer>> s_thread_buffers;
+        static thread_local ThreadBufferOwner s_thread_buffer;
+        static std::atomic<uint64_t> s_sequence; // orders the messages of all threads
+        static std::atomic<uint64_t> s_dropped_count;
+        static std::atomic<std::FILE*> s_output;
+
+      public:
+
+        /// @brief copies the message into the calling threads buffer (called by LogStream)
+        void static write(uint32_t level, const char* file, uint32_t line, const char* message, uint32_t length);
+
+        /// @brief waits until all messages logged before the call were written
+        void static flush();
+
+        /// @return the number of messages that were dropped because the threads buffer was full
+        uint64_t static getDroppedCount();
+
+        /// @brief the file the messages get written to (stdout by default or if file is nullptr), call flush() before changing it
+        void static setOutput(std::FILE* file);
+
+      protected:
+
+        static ThreadBuffer* getThreadBuffer();
+
+        /// @return true, if a thread buffer contains messages that werent written yet
+        bool static hasPendingMessages();
+
+        /// @brief writes all messages currently stored in the thread buffers (using the buffers of the drain thread)
+        void static drain(DrainThread& drain_thread);
+
+        void static drainThread(DrainThread* drain_thread);
+
+        void static format(std::string& out, uint32_t level, const char* file, uint32_t line, long time, const char* message, uint32_t length);
+
+    };
+
+} // undicht
+
+#endif // LOGGER_H
@@ -0,0 +1,120 @@
+#include "mapped_file.h"
+#include "config.h"
+
+#ifdef PLATFORM_WINDOWS
+#include "windows.h"
+#else
+#include "sys/mman.h"
+#include "sys/stat.h"
+#include "fcntl.h"
+#include "unistd.h"
+#endif
+
+namespace undicht {
+
+    MappedFile::~MappedFile() {
+
+        close();
+    }
+
+    bool MappedFile::open(const std::string& file_name) {
+        /// @return false, if the file could not be opened or mapped
+
+        close();
+
+#ifdef PLATFORM_WINDOWS
+
+        HANDLE file = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if(file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER size;
+        if(!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            return false;
+        }
+
+        _file_handle = file;
+        _size = size_t(size.QuadPart);
+        _is_open = true;
+
+        if(!_size) return true; // empty files cant be mapped
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(!mapping) {
+            close();
+            return false;
+        }
+
+        _mapping_handle = mapping;
+        _data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+#else
+
+        int file = ::open(file_name.c_str(), O_RDONLY);
+        if(file < 0) return false;
+
+        struct stat file_stat;
+        if(fstat(file, &file_stat)) {
+            ::close(file);
+            return false;
+        }
+
+        _size = size_t(file_stat.st_size);
+        _is_open = true;
+
+        if(_size) {
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file, 0);
+            _data = (data != MAP_FAILED) ? (const uint8_t*)data : nullptr;
+        }
+
+        // the mapping stays valid after closing the file descriptor
+        ::close(file);
+
+#endif
+
+        if(_size && !_data) {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void MappedFile::close() {
+
+#ifdef PLATFORM_WINDOWS
+
+        if(_data) UnmapViewOfFile(_data);
+        if(_mapping_handle) CloseHandle((HANDLE)_mapping_handle);
+        if(_file_handle) CloseHandle((HANDLE)_file_handle);
+
+#else
+
+        if(_data) munmap((void*)_data, _size);
+
+#endif
+
+        _data = nullptr;
+        _size = 0;
+        _is_open = false;
+        _file_handle = nullptr;
+        _mapping_handle = nullptr;
+    }
+
+    bool MappedFile::isOpen() const {
+
+        return _is_open;
+    }
+
+    const uint8_t* MappedFile::getData() const {
+        /// @return nullptr, if the file is empty (or not open)
+
+        return _data;
+    }
+
+    size_t MappedFile::getSize() const {
+
+        return _size;
+    }
+
+} // undicht
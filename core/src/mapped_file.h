@@ -0,0 +1,47 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include "cstdint"
+#include "cstddef"
+#include "string"
+
+namespace undicht {
+
+    class MappedFile {
+        /** @brief maps a file into memory (read only)
+         * the contents can be accessed without reading them into a buffer first,
+         * the os only loads the pages that actually get accessed
+         * the data stays valid until close() is called */
+
+      protected:
+
+        const uint8_t* _data = nullptr;
+        size_t _size = 0;
+        bool _is_open = false;
+
+        // windows file and file mapping handles
+        void* _file_handle = nullptr;
+        void* _mapping_handle = nullptr;
+
+      public:
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        /// @return false, if the file could not be opened or mapped
+        bool open(const std::string& file_name);
+        void close();
+
+        bool isOpen() const;
+
+        /// @return nullptr, if the file is empty (or not open)
+        const uint8_t* getData() const;
+        size_t getSize() const;
+
+    };
+
+} // undicht
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,304 @@
+#include "memory_tracker.h"
+#include "config.h"
+
+#include "ostream"
+#include "iomanip"
+#include "new"
+#include "cstdlib"
+#include "algorithm"
+
+#ifdef UND_TRACK_ALLOCATIONS
+#include "malloc.h"
+#endif
+
+namespace undicht {
+
+    MemoryTracker::Counters MemoryTracker::s_thread_counters[MAX_THREAD_SLOTS];
+    std::atomic<uint32_t> MemoryTracker::s_thread_count{0};
+    std::atomic<uint64_t> MemoryTracker::s_current_bytes{0};
+    std::atomic<uint64_t> MemoryTracker::s_peak_bytes{0};
+    std::atomic<uint64_t> MemoryTracker::s_frame_peak_bytes{0};
+
+    MemoryTracker::Counters MemoryTracker::s_device_counters;
+    std::atomic<uint64_t> MemoryTracker::s_device_current_bytes{0};
+    std::atomic<uint64_t> MemoryTracker::s_device_peak_bytes{0};
+
+    MemoryTracker::Stats MemoryTracker::s_frame_start;
+    MemoryTracker::Stats MemoryTracker::s_last_frame;
+
+    static void updateMax(std::atomic<uint64_t>& max, uint64_t value) {
+
+        uint64_t old_max = max.load(std::memory_order_relaxed);
+        while((value > old_max) && !max.compare_exchange_weak(old_max, value, std::memory_order_relaxed));
+    }
+
+    bool MemoryTracker::isTrackingHeap() {
+        /// @return true, if the operator new / delete hooks are compiled in
+
+#ifdef UND_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void MemoryTracker::recordAllocation(size_t byte_size) {
+
+        Counters& counters = getThreadCounters();
+        counters._allocations.fetch_add(1, std::memory_order_relaxed);
+        counters._allocated_bytes.fetch_add(byte_size, std::memory_order_relaxed);
+
+        uint64_t current = s_current_bytes.fetch_add(byte_size, std::memory_order_relaxed) + byte_size;
+        updateMax(s_peak_bytes, current);
+        updateMax(s_frame_peak_bytes, current);
+    }
+
+    void MemoryTracker::recordFree(size_t byte_size) {
+
+        Counters& counters = getThreadCounters();
+        counters._frees.fetch_add(1, std::memory_order_relaxed);
+        counters._freed_bytes.fetch_add(byte_size, std::memory_order_relaxed);
+
+        s_current_bytes.fetch_sub(byte_size, std::memory_order_relaxed);
+    }
+
+    void MemoryTracker::recordDeviceAllocation(size_t byte_size) {
+
+        s_device_counters._allocations.fetch_add(1, std::memory_order_relaxed);
+        s_device_counters._allocated_bytes.fetch_add(byte_size, std::memory_order_relaxed);
+
+        uint64_t current = s_device_current_bytes.fetch_add(byte_size, std::memory_order_relaxed) + byte_size;
+        updateMax(s_device_peak_bytes, current);
+    }
+
+    void MemoryTracker::recordDeviceFree(size_t byte_size) {
+
+        s_device_counters._frees.fetch_add(1, std::memory_order_relaxed);
+        s_device_counters._freed_bytes.fetch_add(byte_size, std::memory_order_relaxed);
+        s_device_current_bytes.fetch_sub(byte_size, std::memory_order_relaxed);
+    }
+
+    MemoryTracker::Stats MemoryTracker::getThreadStats() {
+        /// @return the heap allocations made by the calling thread
+
+        Counters& counters = getThreadCounters();
+
+        Stats stats;
+        stats._allocations = counters._allocations.load(std::memory_order_relaxed);
+        stats._frees = counters._frees.load(std::memory_order_relaxed);
+        stats._allocated_bytes = counters._allocated_bytes.load(std::memory_order_relaxed);
+        stats._freed_bytes = counters._freed_bytes.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    MemoryTracker::Stats MemoryTracker::getTotalStats() {
+        /// @return the heap allocations of all threads
+
+        Stats stats;
+
+        for(Counters& counters : s_thread_counters) {
+            stats._allocations += counters._allocations.load(std::memory_order_relaxed);
+            stats._frees += counters._frees.load(std::memory_order_relaxed);
+            stats._allocated_bytes += counters._allocated_bytes.load(std::memory_order_relaxed);
+            stats._freed_bytes += counters._freed_bytes.load(std::memory_order_relaxed);
+        }
+
+        stats._current_bytes = s_current_bytes.load(std::memory_order_relaxed);
+        stats._peak_bytes = s_peak_bytes.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    MemoryTracker::Stats MemoryTracker::getDeviceStats() {
+        /// @return the gpu memory allocated via vma
+
+        Stats stats;
+        stats._allocations = s_device_counters._allocations.load(std::memory_order_relaxed);
+        stats._frees = s_device_counters._frees.load(std::memory_order_relaxed);
+        stats._allocated_bytes = s_device_counters._allocated_bytes.load(std::memory_order_relaxed);
+        stats._freed_bytes = s_device_counters._freed_bytes.load(std::memory_order_relaxed);
+        stats._current_bytes = s_device_current_bytes.load(std::memory_order_relaxed);
+        stats._peak_bytes = s_device_peak_bytes.load(std::memory_order_relaxed);
+
+        return stats;
+    }
+
+    void MemoryTracker::markFrame() {
+        /** @brief ends the current frame (called by Profiler::markFrame())
+         * the allocations since the last call become the stats of the last frame */
+
+        Stats total = getTotalStats();
+
+        s_last_frame._allocations = total._allocations - s_frame_start._allocations;
+        s_last_frame._frees = total._frees - s_frame_start._frees;
+        s_last_frame._allocated_bytes = total._allocated_bytes - s_frame_start._allocated_bytes;
+        s_last_frame._freed_bytes = total._freed_bytes - s_frame_start._freed_bytes;
+        s_last_frame._current_bytes = total._current_bytes;
+        s_last_frame._peak_bytes = s_frame_peak_bytes.exchange(total._current_bytes, std::memory_order_relaxed);
+
+        s_frame_start = total;
+    }
+
+    MemoryTracker::Stats MemoryTracker::getFrameStats() {
+        /// @return the heap allocations made (by all threads) during the last complete frame
+
+        return s_last_frame;
+    }
+
+    void MemoryTracker::writeStats(std::ostream& out) {
+        /// @brief writes a table with the heap allocations of every thread
+
+        out << std::left << std::setw(10) << "thread" << std::right
+            << std::setw(14) << "allocations" << std::setw(14) << "frees"
+            << std::setw(16) << "allocated KB" << std::setw(16) << "freed KB" << "\n";
+
+        uint32_t thread_count = std::min(s_thread_count.load(std::memory_order_relaxed), uint32_t(MAX_THREAD_SLOTS));
+
+        for(uint32_t i = 0; i < thread_count; i++) {
+
+            Counters& counters = s_thread_counters[i];
+            out << std::left << std::setw(10) << i << std::right
+                << std::setw(14) << counters._allocations.load(std::memory_order_relaxed)
+                << std::setw(14) << counters._frees.load(std::memory_order_relaxed)
+                << std::setw(16) << counters._allocated_bytes.load(std::memory_order_relaxed) / 1024
+                << std::setw(16) << counters._freed_bytes.load(std::memory_order_relaxed) / 1024 << "\n";
+        }
+
+        Stats device = getDeviceStats();
+        out << std::left << std::setw(10) << "gpu" << std::right
+            << std::setw(14) << device._allocations << std::setw(14) << device._frees
+            << std::setw(16) << device._allocated_bytes / 1024 << std::setw(16) << device._freed_bytes / 1024 << "\n";
+
+    }
+
+    ///////////////////////////////////////////// protected functions /////////////////////////////////////////////
+
+    MemoryTracker::Counters& MemoryTracker::getThreadCounters() {
+
+        return s_thread_counters[getThreadSlot()];
+    }
+
+    uint32_t MemoryTracker::getThreadSlot() {
+
+        // plain thread local integer, so that getting the slot doesnt allocate
+        thread_local uint32_t thread_slot = UINT32_MAX;
+
+        if(thread_slot == UINT32_MAX)
+            thread_slot = std::min(s_thread_count.fetch_add(1, std::memory_order_relaxed), uint32_t(MAX_THREAD_SLOTS - 1));
+
+        return thread_slot;
+    }
+
+} // undicht
+
+#ifdef UND_TRACK_ALLOCATIONS
+
+//////////////////////////////////////// global operator new / delete hooks ////////////////////////////////////////
+
+namespace {
+
+    size_t getAllocationSize(void* ptr) {
+
+#ifdef PLATFORM_WINDOWS
+        return _msize(ptr);
+#else
+        return malloc_usable_size(ptr);
+#endif
+    }
+
+    void* trackedAlloc(size_t size) {
+
+        void* ptr = std::malloc(size ? size : 1);
+        if(ptr) undicht::MemoryTracker::recordAllocation(getAllocationSize(ptr));
+
+        return ptr;
+    }
+
+    void* trackedAlignedAlloc(size_t size, size_t alignment) {
+
+#ifdef PLATFORM_WINDOWS
+        void* ptr = _aligned_malloc(size ? size : 1, alignment);
+        if(ptr) undicht::MemoryTracker::recordAllocation(_aligned_msize(ptr, alignment, 0));
+#else
+        void* ptr = nullptr;
+        if(posix_memalign(&ptr, std::max(alignment, sizeof(void*)), size ? size : 1)) ptr = nullptr;
+        if(ptr) undicht::MemoryTracker::recordAllocation(getAllocationSize(ptr));
+#endif
+
+        return ptr;
+    }
+
+    void trackedFree(void* ptr) {
+
+        if(!ptr) return;
+
+        undicht::MemoryTracker::recordFree(getAllocationSize(ptr));
+        std::free(ptr);
+    }
+
+    void trackedAlignedFree(void* ptr, [[maybe_unused]] size_t alignment) {
+
+        if(!ptr) return;
+
+#ifdef PLATFORM_WINDOWS
+        undicht::MemoryTracker::recordFree(_aligned_msize(ptr, alignment, 0));
+        _aligned_free(ptr);
+#else
+        trackedFree(ptr);
+#endif
+    }
+
+    void* newOrThrow(size_t size) {
+
+        void* ptr = trackedAlloc(size);
+
+        while(!ptr) {
+            std::new_handler handler = std::get_new_handler();
+            if(!handler) throw std::bad_alloc();
+            handler();
+            ptr = trackedAlloc(size);
+        }
+
+        return ptr;
+    }
+
+    void* alignedNewOrThrow(size_t size, size_t alignment) {
+
+        void* ptr = trackedAlignedAlloc(size, alignment);
+
+        while(!ptr) {
+            std::new_handler handler = std::get_new_handler();
+            if(!handler) throw std::bad_alloc();
+            handler();
+            ptr = trackedAlignedAlloc(size, alignment);
+        }
+
+        return ptr;
+    }
+
+} // anonymous namespace
+
+void* operator new(size_t size) { return newOrThrow(size); }
+void* operator new[](size_t size) { return newOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return alignedNewOrThrow(size, size_t(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return alignedNewOrThrow(size, size_t(alignment)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAlignedAlloc(size, size_t(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return trackedAlignedAlloc(size, size_t(alignment)); }
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, std::align_val_t alignment) noexcept { trackedAlignedFree(ptr, size_t(alignment)); }
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { trackedAlignedFree(ptr, size_t(alignment)); }
+void operator delete(void* ptr, size_t, std::align_val_t alignment) noexcept { trackedAlignedFree(ptr, size_t(alignment)); }
+void operator delete[](void* ptr, size_t, std::align_val_t alignment) noexcept { trackedAlignedFree(ptr, size_t(alignment)); }
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { trackedAlignedFree(ptr, size_t(alignment)); }
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { trackedAlignedFree(ptr, size_t(alignment)); }
+
+#endif // UND_TRACK_ALLOCATIONS
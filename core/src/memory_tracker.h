@@ -0,0 +1,94 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include "cstdint"
+#include "cstddef"
+#include "atomic"
+#include "iosfwd"
+
+namespace undicht {
+
+    class MemoryTracker {
+        /** @brief counts heap and gpu memory allocations
+         * heap allocations are only counted if the global operator new / delete hooks are compiled in
+         * (cmake option UND_TRACK_ALLOCATIONS), gpu memory is counted via the allocation callbacks of vma
+         * every thread counts its allocations into its own slot (without locking)
+         * the Profiler records the allocations of each frame as counters in markFrame() */
+
+      public:
+
+        const static uint32_t MAX_THREAD_SLOTS = 64; // threads beyond this number share the last slot
+
+        struct Stats {
+            uint64_t _allocations = 0;
+            uint64_t _frees = 0;
+            uint64_t _allocated_bytes = 0;
+            uint64_t _freed_bytes = 0;
+            uint64_t _current_bytes = 0; // only for getTotalStats(), memory can be freed by a different thread
+            uint64_t _peak_bytes = 0; // only for getTotalStats() / getFrameStats()
+        };
+
+      protected:
+
+        struct Counters {
+            std::atomic<uint64_t> _allocations{0};
+            std::atomic<uint64_t> _frees{0};
+            std::atomic<uint64_t> _allocated_bytes{0};
+            std::atomic<uint64_t> _freed_bytes{0};
+        };
+
+        static Counters s_thread_counters[MAX_THREAD_SLOTS];
+        static std::atomic<uint32_t> s_thread_count;
+        static std::atomic<uint64_t> s_current_bytes;
+        static std::atomic<uint64_t> s_peak_bytes;
+        static std::atomic<uint64_t> s_frame_peak_bytes;
+
+        static Counters s_device_counters;
+        static std::atomic<uint64_t> s_device_current_bytes;
+        static std::atomic<uint64_t> s_device_peak_bytes;
+
+        static Stats s_frame_start; // totals at the start of the last frame
+        static Stats s_last_frame; // the stats of the last complete frame
+
+      public:
+
+        /// @return true, if the operator new / delete hooks are compiled in
+        bool static isTrackingHeap();
+
+        // called by the operator new / delete hooks
+        void static recordAllocation(size_t byte_size);
+        void static recordFree(size_t byte_size);
+
+        // called by the vma callbacks
+        void static recordDeviceAllocation(size_t byte_size);
+        void static recordDeviceFree(size_t byte_size);
+
+        /// @return the heap allocations made by the calling thread
+        Stats static getThreadStats();
+
+        /// @return the heap allocations of all threads
+        Stats static getTotalStats();
+
+        /// @return the gpu memory allocated via vma
+        Stats static getDeviceStats();
+
+        /** @brief ends the current frame (called by Profiler::markFrame())
+         * the allocations since the last call become the stats of the last frame */
+        void static markFrame();
+
+        /// @return the heap allocations made (by all threads) during the last complete frame
+        Stats static getFrameStats();
+
+        /// @brief writes a table with the heap allocations of every thread
+        void static writeStats(std::ostream& out);
+
+      protected:
+
+        static Counters& getThreadCounters();
+        uint32_t static getThreadSlot();
+
+    };
+
+} // undicht
+
+#endif // MEMORY_TRACKER_H
@@ -1,18 +1,147 @@
 #include "profiler.h"
+#include "memory_tracker.h"
 #include "fstream"
 #include "debug.h"
-#include "set"
-#include "iterator"
+#include "mutex"
+#include "chrono"
+#include "cstring"
+#include "algorithm"
+#include "iomanip"
 
 namespace undicht {
 
-    std::vector<Profiler::Task> Profiler::s_tasks;
-    bool Profiler::s_globally_enabled = false;
+    //////////////////////////////////////// interned task names ////////////////////////////////////////
 
-    Profiler::Profiler(const std::string& task_name) {
+    struct TaskName {
+        std::atomic<uint64_t> _hash; // 0 means the slot is unused
+        char _name[Profiler::MAX_TASK_NAME_LENGTH];
+    };
+
+    static TaskName s_task_names[Profiler::MAX_TASK_NAMES];
+    static std::mutex s_task_name_mutex; // only locked when a new name gets added
+
+    static uint64_t hashTaskName(const char* task_name) {
+        // FNV-1a over the (possibly truncated) name
+
+        uint64_t hash = 14695981039346656037ull;
+
+        for(uint32_t i = 0; (i < Profiler::MAX_TASK_NAME_LENGTH - 1) && task_name[i]; i++) {
+            hash ^= (uint8_t)task_name[i];
+            hash *= 1099511628211ull;
+        }
+
+        return hash ? hash : 1;
+    }
+
+    //////////////////////////////////////// per thread buffers ////////////////////////////////////////
+
+    struct Profiler::ThreadBuffer {
+        // a slot of the ring buffer, the exporting thread can read it while the owning thread overwrites it
+        // (the fields are relaxed atomics, a copy is only valid if the sequence didnt change while it was made)
+        struct Slot {
+            std::atomic<uint64_t> _sequence{0}; // position of the stored task + 1 (0 while the slot is written)
+            std::atomic<uint32_t> _type;
+            std::atomic<uint32_t> _name_id;
+            std::atomic<uint32_t> _thread_id;
+            std::atomic<uint32_t> _depth;
+            std::atomic<uint64_t> _start_time;
+            std::atomic<uint64_t> _end_time;
+        };
+
+        uint32_t _thread_id = 0;
+        uint32_t _depth = 0; // number of currently active tasks on the thread
+        std::atomic<uint64_t> _write_count = 0; // total number of tasks written (the ring position is _write_count % THREAD_BUFFER_SIZE)
+        Slot _slots[THREAD_BUFFER_SIZE];
+
+        // used by the trace export (guarded by s_thread_buffer_mutex)
+        char _name[MAX_TASK_NAME_LENGTH] = {};
+        bool _name_written = false;
+        uint64_t _read_count = 0;
+
+        void write(const Task& task) {
+            // only the owning thread writes to the buffer, readers synchronize via _write_count and the slot sequence
+
+            uint64_t position = _write_count.load(std::memory_order_relaxed);
+            Slot& slot = _slots[position % THREAD_BUFFER_SIZE];
+
+            slot._sequence.store(0, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot._type.store(uint32_t(task._type), std::memory_order_relaxed);
+            slot._name_id.store(task._name_id, std::memory_order_relaxed);
+            slot._thread_id.store(task._thread_id, std::memory_order_relaxed);
+            slot._depth.store(task._depth, std::memory_order_relaxed);
+            slot._start_time.store(task._start_time, std::memory_order_relaxed);
+            slot._end_time.store(task._end_time, std::memory_order_relaxed);
+
+            slot._sequence.store(position + 1, std::memory_order_release);
+            _write_count.store(position + 1, std::memory_order_release);
+        }
+
+        bool read(uint64_t position, Task& task) const {
+            /// @return false, if the task was overwritten before or while it was copied
+
+            const Slot& slot = _slots[position % THREAD_BUFFER_SIZE];
+
+            if(slot._sequence.load(std::memory_order_acquire) != position + 1) return false;
+
+            task._type = TaskType(slot._type.load(std::memory_order_relaxed));
+            task._name_id = slot._name_id.load(std::memory_order_relaxed);
+            task._thread_id = slot._thread_id.load(std::memory_order_relaxed);
+            task._depth = slot._depth.load(std::memory_order_relaxed);
+            task._start_time = slot._start_time.load(std::memory_order_relaxed);
+            task._end_time = slot._end_time.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+
+            return slot._sequence.load(std::memory_order_relaxed) == position + 1;
+        }
+    };
+
+    static std::mutex s_thread_buffer_mutex;
+
+    // trace export (guarded by s_thread_buffer_mutex)
+    static std::ofstream s_trace_file;
+    static uint64_t s_trace_event_count = 0;
+    static uint64_t s_dropped_task_count = 0;
+
+    // periodic statistics dump (only accessed from markFrame())
+    static std::string s_stats_dump_file;
+    static uint64_t s_stats_dump_interval = 0; // nanoseconds
+    static uint64_t s_last_stats_dump = 0;
+    static uint64_t s_last_frame_marker = 0;
+
+    std::atomic<bool> Profiler::s_globally_enabled = false;
+    std::atomic<bool> Profiler::s_aggregation_enabled = false;
+    std::atomic<LatencyHistogram*> Profiler::s_histograms[MAX_TASK_NAMES] = {};
+    struct Profiler::ThreadBufferOwner {
+        // returns the buffer to the free list when the thread exits (after its tasks were written to an open trace)
+        ThreadBuffer* _buffer = nullptr;
+
+        ~ThreadBufferOwner() {
+
+            if(!_buffer) return;
+
+            std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+            if(s_trace_file.is_open()) flushThreadBuffer(*_buffer);
+            s_free_thread_buffers.push_back(_buffer);
+        }
+    };
+
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::s_thread_buffers;
+    std::vector<Profiler::ThreadBuffer*> Profiler::s_free_thread_buffers;
+    thread_local Profiler::ThreadBufferOwner Profiler::s_thread_buffer;
+
+    //////////////////////////////////////// profiler ////////////////////////////////////////
+
+    Profiler::Profiler(const char* task_name) {
 
         start(task_name);
+    }
+
+    Profiler::Profiler(const std::string& task_name) {
 
+        start(task_name.c_str());
     }
 
     Profiler::~Profiler() {
@@ -20,32 +149,61 @@ namespace undicht {
         if(_is_active) end();
 
     }
-    
+
+    void Profiler::start(const char* task_name) {
+
+        end();
+
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+
+        start(getTaskNameID(task_name));
+    }
+
     void Profiler::start(const std::string& task_name) {
 
+        start(task_name.c_str());
+    }
+
+    void Profiler::start(uint32_t task_name_id) {
+
         end();
 
-        if(!s_globally_enabled) return;
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+        if(task_name_id >= MAX_TASK_NAMES) return;
 
-        _task_id = s_tasks.size();
-        s_tasks.emplace_back(Task());
-        Task& task = s_tasks.back();
-        task._name = task_name;
-        task._start_time = micros();
+        getThreadBuffer()->_depth++;
 
+        _name_id = task_name_id;
+        _start_time = getTime();
         _is_active = true;
 
     }
 
     void Profiler::end() {
 
-        if(!s_globally_enabled || !_is_active) return;
-
-        Task& task = s_tasks.at(_task_id);
-        task._end_time = micros();
+        if(!_is_active) return;
 
         _is_active = false;
 
+        ThreadBuffer* buffer = getThreadBuffer();
+        buffer->_depth--;
+
+        // tasks that were started before the profiler got disabled are dropped
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+
+        Task task;
+        task._type = TaskType::SCOPE;
+        task._name_id = _name_id;
+        task._thread_id = buffer->_thread_id;
+        task._depth = buffer->_depth;
+        task._start_time = _start_time;
+        task._end_time = getTime();
+
+        buffer->write(task);
+
+        if(s_aggregation_enabled.load(std::memory_order_relaxed))
+            recordDuration(_name_id, task._end_time - _start_time);
+
     }
 
     void Profiler::enableProfiler(bool enable) {
@@ -53,37 +211,478 @@ namespace undicht {
         s_globally_enabled = enable;
     }
 
-    void Profiler::writeToCsvFile(const std::string& file_name) {
+    bool Profiler::isEnabled() {
+
+        return s_globally_enabled;
+    }
 
-        std::ofstream csv_file(file_name);
+    void Profiler::setThreadName(const char* name) {
+        /// @brief name the calling thread (shown in the trace viewer)
 
-        if(!csv_file.is_open()) {
-            UND_ERROR << "failed to write to file " << file_name << "\n";
-            return;
+        ThreadBuffer* buffer = getThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+        std::strncpy(buffer->_name, name, MAX_TASK_NAME_LENGTH - 1);
+        buffer->_name_written = false;
+    }
+
+    uint32_t Profiler::createTrack(const char* name) {
+        /// @brief creates a track for tasks that are not timed by Profiler objects on the calling thread (i.e. gpu timings)
+        /// @return the id of the track (shown as a thread in the trace viewer)
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+        s_thread_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer* track = s_thread_buffers.back().get();
+        track->_thread_id = s_thread_buffers.size() - 1;
+        std::strncpy(track->_name, name, MAX_TASK_NAME_LENGTH - 1);
+
+        return track->_thread_id;
+    }
+
+    void Profiler::recordTask(uint32_t track_id, uint32_t task_name_id, uint32_t depth, uint64_t start_time, uint64_t end_time) {
+        /// @brief records a task that was timed elsewhere into a track (only one thread should record into a track at a time)
+        /// @param start_time, end_time in nanoseconds, relative to getTime()
+
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+        if(task_name_id >= MAX_TASK_NAMES) return;
+
+        ThreadBuffer* track = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+            if(track_id < s_thread_buffers.size()) track = s_thread_buffers.at(track_id).get();
+        }
+
+        if(!track) return;
+
+        Task task;
+        task._type = TaskType::SCOPE;
+        task._name_id = task_name_id;
+        task._thread_id = track_id;
+        task._depth = depth;
+        task._start_time = start_time;
+        task._end_time = end_time;
+
+        track->write(task);
+
+        if(s_aggregation_enabled.load(std::memory_order_relaxed))
+            recordDuration(task_name_id, end_time - start_time);
+
+    }
+
+    void Profiler::recordCounter(const char* counter_name, int64_t value) {
+        /// @brief records the current value of a counter on the calling thread (shown as a counter track in the trace)
+
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+
+        recordCounter(getTaskNameID(counter_name), value);
+    }
+
+    void Profiler::recordCounter(uint32_t counter_name_id, int64_t value) {
+
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+        if(counter_name_id >= MAX_TASK_NAMES) return;
+
+        ThreadBuffer* buffer = getThreadBuffer();
+        Task task;
+        task._type = TaskType::COUNTER;
+        task._name_id = counter_name_id;
+        task._thread_id = buffer->_thread_id;
+        task._depth = buffer->_depth;
+        task._start_time = getTime();
+        task._end_time = uint64_t(value);
+
+        buffer->write(task);
+    }
+
+    void Profiler::markFrame() {
+        /// @brief marks the start of a new frame (shown as a global instant event in the trace)
+        /// if a trace file is open, the tasks recorded since the last frame marker get written to it
+        /// the memory allocations of the last frame are recorded as counters
+
+        MemoryTracker::markFrame();
+
+        if(!s_globally_enabled.load(std::memory_order_relaxed)) return;
+
+        static const uint32_t frame_name_id = getTaskNameID("frame");
+
+        ThreadBuffer* buffer = getThreadBuffer();
+        Task task;
+        task._type = TaskType::FRAME_MARKER;
+        task._name_id = frame_name_id;
+        task._thread_id = buffer->_thread_id;
+        task._depth = buffer->_depth;
+        task._start_time = getTime();
+        task._end_time = task._start_time;
+
+        buffer->write(task);
+
+        if(s_aggregation_enabled.load(std::memory_order_relaxed)) {
+
+            static const uint32_t frame_time_id = getTaskNameID("frame time");
+            if(s_last_frame_marker) recordDuration(frame_time_id, task._start_time - s_last_frame_marker);
+
+            if(s_stats_dump_interval && (task._start_time - s_last_stats_dump >= s_stats_dump_interval)) {
+                std::ofstream dump_file(s_stats_dump_file, std::ios::app);
+                dump_file << "\nstatistics at " << task._start_time / 1000000 << " ms\n";
+                writeTaskStats(dump_file);
+                s_last_stats_dump = task._start_time;
+            }
+
+        }
+
+        s_last_frame_marker = task._start_time;
+
+        if(MemoryTracker::isTrackingHeap()) {
+            MemoryTracker::Stats frame_stats = MemoryTracker::getFrameStats();
+            recordCounter("heap allocations per frame", frame_stats._allocations);
+            recordCounter("heap bytes allocated per frame", frame_stats._allocated_bytes);
+            recordCounter("heap bytes in use", frame_stats._current_bytes);
+        }
+
+        recordCounter("device memory in use", MemoryTracker::getDeviceStats()._current_bytes);
+
+        if(isTraceOpen()) flushTrace();
+    }
+
+    uint32_t Profiler::getTaskNameID(const char* task_name) {
+        /// @brief interns the task name (thread safe)
+        /// @return the id of the name, or INVALID_ID if the name table is full
+
+        const uint64_t hash = hashTaskName(task_name);
+        const uint32_t first_slot = hash % MAX_TASK_NAMES;
+
+        // lock free lookup of names that were already added
+        for(uint32_t i = 0; i < MAX_TASK_NAMES; i++) {
+
+            TaskName& slot = s_task_names[(first_slot + i) % MAX_TASK_NAMES];
+            uint64_t slot_hash = slot._hash.load(std::memory_order_acquire);
+
+            if(!slot_hash) break; // the name was not added yet
+
+            if((slot_hash == hash) && !std::strncmp(slot._name, task_name, MAX_TASK_NAME_LENGTH - 1))
+                return (first_slot + i) % MAX_TASK_NAMES;
         }
 
-        // finding tasks with unique names
-        std::set<std::string> unique_task_names;
+        // adding the name (another thread could have added it in the meantime)
+        std::lock_guard<std::mutex> lock(s_task_name_mutex);
 
-        for(const Task& t : s_tasks)
-            unique_task_names.insert(t._name);
+        for(uint32_t i = 0; i < MAX_TASK_NAMES; i++) {
 
-        // storing the table header in the .csv file
-        csv_file << "task,id,start millis,end millis,duration micros" << std::endl;
+            TaskName& slot = s_task_names[(first_slot + i) % MAX_TASK_NAMES];
+            uint64_t slot_hash = slot._hash.load(std::memory_order_acquire);
 
-        // storing the timings for all tasks in the .csv file
-        for(const Task& t : s_tasks) {
-            
-            csv_file << "\"" << t._name << "\"" << ",";
-            csv_file << std::distance(unique_task_names.begin(), unique_task_names.find(t._name)) << ",";
-            csv_file << t._start_time / 1000 << "." << (t._start_time / 100) % 10 << (t._start_time / 10) % 10  << t._start_time % 10 << ","; // convert to millis
-            csv_file << t._end_time / 1000 << "." << (t._end_time / 100) % 10 << (t._end_time / 10) % 10  << t._end_time % 10 << ",";; // convert to millis
-            csv_file << t._end_time - t._start_time << std::endl;
-        
+            if(!slot_hash) {
+                std::strncpy(slot._name, task_name, MAX_TASK_NAME_LENGTH - 1);
+                slot._name[MAX_TASK_NAME_LENGTH - 1] = 0;
+                slot._hash.store(hash, std::memory_order_release);
+                return (first_slot + i) % MAX_TASK_NAMES;
+            }
+
+            if((slot_hash == hash) && !std::strncmp(slot._name, task_name, MAX_TASK_NAME_LENGTH - 1))
+                return (first_slot + i) % MAX_TASK_NAMES;
         }
 
-        csv_file.close();
+        return INVALID_ID;
+    }
+
+    const char* Profiler::getTaskName(uint32_t name_id) {
+
+        if(name_id >= MAX_TASK_NAMES) return "";
+
+        return s_task_names[name_id]._name;
+    }
+
+    uint64_t Profiler::getTime() {
+        /// @return nanoseconds since the first call to this function (monotonic)
+
+        using namespace std::chrono;
+        static const steady_clock::time_point first_time = steady_clock::now();
+
+        return duration_cast<nanoseconds>(steady_clock::now() - first_time).count();
+    }
+
+    void Profiler::collectTasks(std::vector<Task>& tasks) {
+        /// @brief copies all tasks currently stored in the thread buffers, sorted by their start time
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+        for(const std::unique_ptr<ThreadBuffer>& buffer : s_thread_buffers) {
+
+            uint64_t write_count = buffer->_write_count.load(std::memory_order_acquire);
+            uint64_t first = (write_count > THREAD_BUFFER_SIZE) ? write_count - THREAD_BUFFER_SIZE : 0;
+
+            // tasks that get overwritten while they are copied are skipped
+            Task task;
+            for(uint64_t i = first; i < write_count; i++)
+                if(buffer->read(i, task)) tasks.push_back(task);
+
+        }
+
+        std::sort(tasks.begin(), tasks.end(), [](const Task& a, const Task& b){return a._start_time < b._start_time;});
+
+    }
+
+    //////////////////////////////////////// trace export ////////////////////////////////////////
+
+    static void writeTraceTime(std::ofstream& file, uint64_t nanos) {
+        // the trace format uses microseconds
+
+        file << nanos / 1000 << "." << (nanos / 100) % 10 << (nanos / 10) % 10 << nanos % 10;
+    }
+
+    static void writeTraceString(std::ofstream& file, const char* str) {
+        // escaping the characters that would break the json string
+
+        file << "\"";
+
+        for(const char* c = str; *c; c++) {
+            if((*c == '"') || (*c == '\\')) file << '\\';
+            if((uint8_t)*c >= 0x20) file << *c;
+        }
+
+        file << "\"";
+    }
+
+    static void beginTraceEvent(std::ofstream& file) {
+
+        if(s_trace_event_count++) file << ",\n";
+    }
+
+    bool Profiler::beginTrace(const std::string& file_name) {
+        /** @brief opens a trace file in the Chrome Trace Event (json) format
+         * from then on, recorded tasks get written to the file incrementally (see flushTrace()),
+         * so they dont have to stay in memory for the whole capture
+         * nested tasks are stored as complete events ("ph":"X"), which the viewers nest by their time spans
+         * @return false, if the file could not be opened */
+
+        if(isTraceOpen()) endTrace();
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+        s_trace_file.open(file_name);
+
+        if(!s_trace_file.is_open()) {
+            UND_ERROR << "failed to open trace file " << file_name << "\n";
+            return false;
+        }
+
+        s_trace_event_count = 0;
+        s_dropped_task_count = 0;
+        s_trace_file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        // tasks recorded before the trace was opened are not part of it
+        for(std::unique_ptr<ThreadBuffer>& buffer : s_thread_buffers) {
+            buffer->_read_count = buffer->_write_count.load(std::memory_order_acquire);
+            buffer->_name_written = false;
+        }
+
+        return true;
+    }
+
+    void Profiler::flushTrace() {
+        /// @brief writes all tasks recorded since the last flush to the trace file
+        /// tasks that got overwritten in the ring buffers before they could be flushed are counted as dropped
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+        if(!s_trace_file.is_open()) return;
+
+        for(std::unique_ptr<ThreadBuffer>& buffer : s_thread_buffers)
+            flushThreadBuffer(*buffer);
+
+        s_trace_file.flush();
+    }
+
+    void Profiler::endTrace() {
+        /// @brief flushes the remaining tasks and closes the trace file
+
+        flushTrace();
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+        if(!s_trace_file.is_open()) return;
+
+        s_trace_file << "\n]}\n";
+        s_trace_file.close();
+
+        if(s_dropped_task_count)
+            UND_WARNING << "the profiler dropped " << s_dropped_task_count << " tasks that were overwritten before they could be written to the trace file\n";
+
+    }
+
+    bool Profiler::isTraceOpen() {
+
+        std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+        return s_trace_file.is_open();
+    }
+
+    //////////////////////////////////////// aggregated statistics ////////////////////////////////////////
+
+    void Profiler::enableAggregation(bool enable) {
+        /// @brief when enabled, the durations of all finished tasks get recorded into per task name histograms
+        /// the time between two frame markers is recorded as "frame time"
+
+        s_aggregation_enabled = enable;
+    }
+
+    bool Profiler::isAggregationEnabled() {
+
+        return s_aggregation_enabled;
+    }
+
+    LatencyHistogram::Stats Profiler::getTaskStats(const char* task_name) {
+        /// @return the statistics of all durations recorded for the task (in nanoseconds)
+
+        return getTaskStats(getTaskNameID(task_name));
+    }
+
+    LatencyHistogram::Stats Profiler::getTaskStats(uint32_t task_name_id) {
+
+        if(task_name_id >= MAX_TASK_NAMES) return {};
+
+        LatencyHistogram* histogram = s_histograms[task_name_id].load(std::memory_order_acquire);
+
+        return histogram ? histogram->getStats() : LatencyHistogram::Stats();
+    }
+
+    void Profiler::resetTaskStats() {
+
+        for(std::atomic<LatencyHistogram*>& histogram : s_histograms)
+            if(histogram.load(std::memory_order_acquire)) histogram.load()->reset();
+
+    }
+
+    void Profiler::writeTaskStats(std::ostream& out) {
+        /// @brief writes a table with the statistics of all tasks (in microseconds)
+
+        out << std::left << std::setw(40) << "task" << std::right;
+        out << std::setw(10) << "count" << std::setw(12) << "min" << std::setw(12) << "mean";
+        out << std::setw(12) << "p50" << std::setw(12) << "p95" << std::setw(12) << "p99" << std::setw(12) << "max" << "\n";
+        out << std::fixed << std::setprecision(1);
+
+        for(uint32_t i = 0; i < MAX_TASK_NAMES; i++) {
+
+            LatencyHistogram::Stats stats = getTaskStats(i);
+            if(!stats._count) continue;
+
+            out << std::left << std::setw(40) << getTaskName(i) << std::right;
+            out << std::setw(10) << stats._count;
+            out << std::setw(12) << stats._min / 1000.0 << std::setw(12) << stats._mean / 1000.0;
+            out << std::setw(12) << stats._p50 / 1000.0 << std::setw(12) << stats._p95 / 1000.0 << std::setw(12) << stats._p99 / 1000.0;
+            out << std::setw(12) << stats._max / 1000.0 << "\n";
+        }
+
+        out << std::defaultfloat;
+    }
+
+    void Profiler::setTaskStatsDump(const std::string& file_name, uint32_t interval_ms) {
+        /** @brief periodically append the statistics table to a file (checked in markFrame())
+         * @param interval_ms minimum time between two dumps, 0 disables the periodic dump */
+
+        s_stats_dump_file = file_name;
+        s_stats_dump_interval = uint64_t(interval_ms) * 1000000;
+        s_last_stats_dump = getTime();
+    }
+
+    //////////////////////////////////////// protected functions ////////////////////////////////////////
+
+    Profiler::ThreadBuffer* Profiler::getThreadBuffer() {
+
+        if(!s_thread_buffer._buffer) {
+            std::lock_guard<std::mutex> lock(s_thread_buffer_mutex);
+
+            if(s_free_thread_buffers.size()) {
+                // reusing the buffer of a thread that exited (the tasks it still holds get overwritten over time)
+                ThreadBuffer* buffer = s_free_thread_buffers.back();
+                s_free_thread_buffers.pop_back();
+                buffer->_depth = 0;
+                buffer->_name[0] = 0;
+                buffer->_name_written = false;
+                s_thread_buffer._buffer = buffer;
+            } else {
+                s_thread_buffers.emplace_back(std::make_unique<ThreadBuffer>());
+                s_thread_buffer._buffer = s_thread_buffers.back().get();
+                s_thread_buffer._buffer->_thread_id = s_thread_buffers.size() - 1;
+            }
+
+        }
+
+        return s_thread_buffer._buffer;
+    }
+
+    void Profiler::flushThreadBuffer(ThreadBuffer& buffer) {
+        /// @brief writes the tasks of the buffer recorded since the last flush to the trace file (s_thread_buffer_mutex has to be locked)
+
+        if(!buffer._name_written) {
+            // thread name meta data event
+            beginTraceEvent(s_trace_file);
+            s_trace_file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer._thread_id << ",\"args\":{\"name\":";
+            writeTraceString(s_trace_file, buffer._name[0] ? buffer._name : ("thread " + std::to_string(buffer._thread_id)).c_str());
+            s_trace_file << "}}";
+            buffer._name_written = true;
+        }
+
+        uint64_t write_count = buffer._write_count.load(std::memory_order_acquire);
+
+        if(write_count - buffer._read_count > THREAD_BUFFER_SIZE) {
+            s_dropped_task_count += write_count - buffer._read_count - THREAD_BUFFER_SIZE;
+            buffer._read_count = write_count - THREAD_BUFFER_SIZE;
+        }
+
+        for(uint64_t i = buffer._read_count; i < write_count; i++) {
+
+            // the owning thread could have overwritten the task while it was copied
+            Task task;
+            if(!buffer.read(i, task)) {
+                s_dropped_task_count++;
+                continue;
+            }
+
+            beginTraceEvent(s_trace_file);
+
+            if(task._type == TaskType::FRAME_MARKER) {
+                s_trace_file << "{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":";
+                writeTraceTime(s_trace_file, task._start_time);
+                s_trace_file << ",\"pid\":1,\"tid\":" << task._thread_id << "}";
+            } else if(task._type == TaskType::COUNTER) {
+                s_trace_file << "{\"name\":";
+                writeTraceString(s_trace_file, getTaskName(task._name_id));
+                s_trace_file << ",\"ph\":\"C\",\"ts\":";
+                writeTraceTime(s_trace_file, task._start_time);
+                s_trace_file << ",\"pid\":1,\"args\":{\"value\":" << int64_t(task._end_time) << "}}";
+            } else {
+                s_trace_file << "{\"name\":";
+                writeTraceString(s_trace_file, getTaskName(task._name_id));
+                s_trace_file << ",\"ph\":\"X\",\"ts\":";
+                writeTraceTime(s_trace_file, task._start_time);
+                s_trace_file << ",\"dur\":";
+                writeTraceTime(s_trace_file, task._end_time - task._start_time);
+                s_trace_file << ",\"pid\":1,\"tid\":" << task._thread_id << "}";
+            }
+
+        }
+
+        buffer._read_count = write_count;
+    }
+
+    void Profiler::recordDuration(uint32_t task_name_id, uint64_t duration) {
+
+        if(task_name_id >= MAX_TASK_NAMES) return;
+
+        LatencyHistogram* histogram = s_histograms[task_name_id].load(std::memory_order_acquire);
+
+        if(!histogram) {
+            // allocated once per task name, if another thread was faster its histogram is used
+            LatencyHistogram* new_histogram = new LatencyHistogram;
+            if(s_histograms[task_name_id].compare_exchange_strong(histogram, new_histogram, std::memory_order_acq_rel))
+                histogram = new_histogram;
+            else
+                delete new_histogram;
+        }
 
+        histogram->record(duration);
     }
 
-} // undicht
\ No newline at end of file
+} // undicht
@@ -4,44 +4,164 @@
 #include "string"
 #include "vector"
 #include "cstdint"
+#include "atomic"
+#include "memory"
+#include "iosfwd"
+
+#include "latency_histogram.h"
 
 namespace undicht {
 
     class Profiler {
-      /** @brief this class should help with debugging the performance of a program 
+      /** @brief this class should help with debugging the performance of a program
        * a profiler object should be created at the start of a new task,
        * when the object gets destructed, the gathered data for the task is saved
        * the profiler can be globally enabled / disabled (default is off)
-       * the saved data can be exported into a .csv file for further analisation of the data
+       * the recorded tasks can be streamed into a trace file (Chrome Trace Event format),
+       * which can be opened with chrome://tracing or https://ui.perfetto.dev
+       *
+       * task names are interned into a fixed size table, so every name gets a small id
+       * each thread records its finished tasks into its own fixed size ring buffer (the oldest tasks get overwritten),
+       * so profiling a scope is thread safe and does not allocate any heap memory
+       * (the buffers of threads that exited get reused by new threads)
+       *
+       * in the aggregated mode, the duration of every finished task is also recorded into a
+       * fixed size histogram per task name, so statistics (i.e. p99 frame times) can be gathered
+       * over long runs with constant memory
       */
 
-      protected:
+      public:
+
+        const static uint32_t MAX_TASK_NAMES = 1024;
+        const static uint32_t MAX_TASK_NAME_LENGTH = 64; // including the terminating 0, longer names get truncated
+        const static uint32_t THREAD_BUFFER_SIZE = 16384; // number of tasks each thread can store before the oldest ones get overwritten
+        const static uint32_t INVALID_ID = 0xFFFFFFFF;
+
+        enum class TaskType : uint32_t {
+            SCOPE,
+            FRAME_MARKER,
+            COUNTER, // the value of the counter is stored in _end_time
+        };
 
         struct Task {
-            std::string _name;
-            uint64_t _start_time; // microseconds
-            uint64_t _end_time; // microseconds
+            TaskType _type;
+            uint32_t _name_id;
+            uint32_t _thread_id; // id of the thread buffer the task was recorded into
+            uint32_t _depth; // how many tasks were active on the thread when this one started
+            uint64_t _start_time; // nanoseconds
+            uint64_t _end_time; // nanoseconds
         };
 
-        static std::vector<Task> s_tasks;
-        static bool s_globally_enabled;
+      protected:
+
+        struct ThreadBuffer;
+        struct ThreadBufferOwner;
+
+        static std::atomic<bool> s_globally_enabled;
+        static std::atomic<bool> s_aggregation_enabled;
+        static std::atomic<LatencyHistogram*> s_histograms[MAX_TASK_NAMES]; // allocated the first time a task with the name finishes
+        static std::vector<std::unique_ptr<ThreadBuffer>> s_thread_buffers; // buffers outlive their threads, so tasks can still be exported
+        static std::vector<ThreadBuffer*> s_free_thread_buffers; // buffers of threads that exited, reused by new threads
+        static thread_local ThreadBufferOwner s_thread_buffer;
 
       protected:
 
-        uint32_t _task_id = 0;
+        uint32_t _name_id = INVALID_ID;
+        uint64_t _start_time = 0;
         bool _is_active = false;
 
       public:
 
         Profiler() = default;
+        Profiler(const char* task_name);
         Profiler(const std::string& task_name);
         ~Profiler();
 
+        /// @brief ends the previous task (if there was one) and starts a new one
+        void start(const char* task_name);
         void start(const std::string& task_name);
+        void start(uint32_t task_name_id);
         void end();
-        
+
         void static enableProfiler(bool enable);
-        void static writeToCsvFile(const std::string& file_name);
+        bool static isEnabled();
+
+        /// @brief name the calling thread (shown in the trace viewer)
+        void static setThreadName(const char* name);
+
+        /// @brief creates a track for tasks that are not timed by Profiler objects on the calling thread (i.e. gpu timings)
+        /// @return the id of the track (shown as a thread in the trace viewer)
+        uint32_t static createTrack(const char* name);
+
+        /// @brief records a task that was timed elsewhere into a track (only one thread should record into a track at a time)
+        /// @param start_time, end_time in nanoseconds, relative to getTime()
+        void static recordTask(uint32_t track_id, uint32_t task_name_id, uint32_t depth, uint64_t start_time, uint64_t end_time);
+
+        /// @brief records the current value of a counter on the calling thread (shown as a counter track in the trace)
+        void static recordCounter(const char* counter_name, int64_t value);
+        void static recordCounter(uint32_t counter_name_id, int64_t value);
+
+        /// @brief marks the start of a new frame (shown as a global instant event in the trace)
+        /// if a trace file is open, the tasks recorded since the last frame marker get written to it
+        /// the memory allocations of the last frame are recorded as counters
+        void static markFrame();
+
+        /// @brief interns the task name (thread safe)
+        /// @return the id of the name, or INVALID_ID if the name table is full
+        uint32_t static getTaskNameID(const char* task_name);
+        static const char* getTaskName(uint32_t name_id);
+
+        /// @return nanoseconds since the first call to this function (monotonic)
+        uint64_t static getTime();
+
+        /// @brief copies all tasks currently stored in the thread buffers, sorted by their start time
+        void static collectTasks(std::vector<Task>& tasks);
+
+        //////////////////////////////////////// trace export ////////////////////////////////////////
+
+        /** @brief opens a trace file in the Chrome Trace Event (json) format
+         * from then on, recorded tasks get written to the file incrementally (see flushTrace()),
+         * so they dont have to stay in memory for the whole capture
+         * nested tasks are stored as complete events ("ph":"X"), which the viewers nest by their time spans
+         * @return false, if the file could not be opened */
+        bool static beginTrace(const std::string& file_name);
+
+        /// @brief writes all tasks recorded since the last flush to the trace file
+        /// tasks that got overwritten in the ring buffers before they could be flushed are counted as dropped
+        void static flushTrace();
+
+        /// @brief flushes the remaining tasks and closes the trace file
+        void static endTrace();
+
+        bool static isTraceOpen();
+
+        //////////////////////////////////////// aggregated statistics ////////////////////////////////////////
+
+        /// @brief when enabled, the durations of all finished tasks get recorded into per task name histograms
+        /// the time between two frame markers is recorded as "frame time"
+        void static enableAggregation(bool enable);
+        bool static isAggregationEnabled();
+
+        /// @return the statistics of all durations recorded for the task (in nanoseconds)
+        LatencyHistogram::Stats static getTaskStats(const char* task_name);
+        LatencyHistogram::Stats static getTaskStats(uint32_t task_name_id);
+        void static resetTaskStats();
+
+        /// @brief writes a table with the statistics of all tasks (in microseconds)
+        void static writeTaskStats(std::ostream& out);
+
+        /** @brief periodically append the statistics table to a file (checked in markFrame())
+         * @param interval_ms minimum time between two dumps, 0 disables the periodic dump */
+        void static setTaskStatsDump(const std::string& file_name, uint32_t interval_ms);
+
+      protected:
+
+        static ThreadBuffer* getThreadBuffer();
+
+        /// @brief writes the tasks of the buffer recorded since the last flush to the trace file (s_thread_buffer_mutex has to be locked)
+        void static flushThreadBuffer(ThreadBuffer& buffer);
+
+        void static recordDuration(uint32_t task_name_id, uint64_t duration);
 
     };
 
@@ -49,4 +169,4 @@ namespace undicht {
 
 } // undicht
 
-#endif // PROFILER_H
\ No newline at end of file
+#endif // PROFILER_H
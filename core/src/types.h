@@ -14,6 +14,14 @@ namespace undicht {
         COLOR_RGBA_SRGB,
         DEPTH_BUFFER,
         DEPTH_STENCIL_BUFFER,
+        COLOR_BC1, // block compressed formats (the size is the number of bytes per 4x4 block)
+        COLOR_BC1_SRGB,
+        COLOR_BC3,
+        COLOR_BC3_SRGB,
+        COLOR_BC4, // one channel
+        COLOR_BC5, // two channels (i.e. for normal maps)
+        COLOR_BC7,
+        COLOR_BC7_SRGB,
     };
 
     class FixedType {
@@ -105,6 +113,15 @@ namespace undicht {
 #define UND_B8G8R8_SRGB FixedType(Type::COLOR_BGRA_SRGB, 1, 3)
 #define UND_B8G8R8A8_SRGB FixedType(Type::COLOR_BGRA_SRGB, 1, 4)
 
+#define UND_BC1 FixedType(Type::COLOR_BC1, 8, 1)
+#define UND_BC1_SRGB FixedType(Type::COLOR_BC1_SRGB, 8, 1)
+#define UND_BC3 FixedType(Type::COLOR_BC3, 16, 1)
+#define UND_BC3_SRGB FixedType(Type::COLOR_BC3_SRGB, 16, 1)
+#define UND_BC4 FixedType(Type::COLOR_BC4, 8, 1)
+#define UND_BC5 FixedType(Type::COLOR_BC5, 16, 1)
+#define UND_BC7 FixedType(Type::COLOR_BC7, 16, 1)
+#define UND_BC7_SRGB FixedType(Type::COLOR_BC7_SRGB, 16, 1)
+
 #define UND_DEPTH32F undicht::FixedType(Type::DEPTH_BUFFER, 4, 1)
 #define UND_DEPTH32F_STENCIL8 undicht::FixedType(Type::DEPTH_STENCIL_BUFFER, 5, 1)
 #define UND_DEPTH24F_STENCIL8 undicht::FixedType(Type::DEPTH_STENCIL_BUFFER, 4, 1)
@@ -10,6 +10,8 @@ namespace undicht {
     void BasicAppTemplate::init(const std::string& window_title, VkPresentModeKHR present_mode) {
 
         _present_mode = present_mode;
+        Profiler::setThreadName("main thread");
+        _job_system.init();
 
         Application::init(window_title, present_mode);
         FrameManager::init(getDevice());
@@ -36,6 +38,7 @@ namespace undicht {
 
         FrameManager::cleanUp();
         Application::cleanUp();
+        _job_system.cleanUp();
     }
 
     bool BasicAppTemplate::run() {
@@ -45,6 +48,7 @@ namespace undicht {
         /// @return true, as long as the application wants to run (use it like this: while(app.run()); )
 
         // the structure of a frame should look like this:
+        Profiler::markFrame();
         Profiler p;
 
         // Step 1: run code that doesnt use gpu resources while the old frame is still processed on the gpu
@@ -69,19 +73,29 @@ namespace undicht {
             getTransferCmd().beginCommandBuffer(true);
             getDrawCmd().resetCommandBuffer();
             getDrawCmd().beginCommandBuffer(true);
+            getGpuTimer().beginFrame(getTransferCmd()); // the transfer commands are executed first
+            getPipelineStatistics().beginFrame(getTransferCmd());
 
             // Step 5: record transfer commands
             p.start("record transfer commands");
+            getTransferCmd().beginTimer("transfer commands");
             transferCommands();
+            getTransferCmd().endTimer();
 
             // Step 6: record draw commands
             p.start("record draw commands");
+            getDrawCmd().beginTimer("draw commands");
+            getPipelineStatistics().begin(getDrawCmd());
             drawCommands(swap_image_id);
+            getPipelineStatistics().end(getDrawCmd());
+            getDrawCmd().endTimer();
 
             // Step 7: end command buffers
             p.start("end command buffers");
             getTransferCmd().endCommandBuffer();
             getDrawCmd().endCommandBuffer();
+            getTransferCmd().recordStatistics("transfer cmd");
+            getDrawCmd().recordStatistics("draw cmd");
 
             // Step 8: wait for previous frame to finish
             p.start("wait for previous frame to finish");
@@ -103,6 +117,11 @@ namespace undicht {
         return !getWindow().shouldClose();
     }
 
+    JobSystem& BasicAppTemplate::getJobSystem() {
+
+        return _job_system;
+    }
+
     ///////////////////////////////// internal functions (may be overwritten) /////////////////////////////////
     //////////////////////////////////////////////// settings /////////////////////////////////////////////////
         
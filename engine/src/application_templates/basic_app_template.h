@@ -5,6 +5,7 @@
 #include "vulkan_memory_allocator.h"
 #include "frame_manager.h"
 #include "core/vulkan/image.h"
+#include "job_system.h"
 
 namespace undicht {
 
@@ -20,6 +21,9 @@ namespace undicht {
         // https://gpuopen.com/vulkan-memory-allocator/
         vma::VulkanMemoryAllocator _vulkan_allocator;
 
+        // runs jobs on worker threads (shared by all subsystems of the app, so that they dont oversubscribe the cores)
+        JobSystem _job_system;
+
         // resources to render to a visible attachment of the swap chain
         vulkan::RenderPass _default_render_pass;
         std::vector<vulkan::ImageView> _visible_swap_images;
@@ -41,6 +45,8 @@ namespace undicht {
         /// @return true, as long as the application wants to run (use it like this: while(app.run()); )
         bool run();
 
+        JobSystem& getJobSystem();
+
       protected:
         // internal functions (may be overwritten)
 
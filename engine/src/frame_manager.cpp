@@ -1,5 +1,6 @@
 #include "frame_manager.h"
 #include "profiler.h"
+#include "linear_arena.h"
 #include "debug.h"
 #include "string"
 
@@ -19,6 +20,14 @@ namespace undicht {
         _draw_cmds[0].init(device.getDevice(), device.getGraphicsCmdPool());
         _draw_cmds[1].init(device.getDevice(), device.getGraphicsCmdPool());
 
+        _gpu_timer.init(device);
+        _transfer_cmds[0].setGpuTimer(&_gpu_timer);
+        _transfer_cmds[1].setGpuTimer(&_gpu_timer);
+        _draw_cmds[0].setGpuTimer(&_gpu_timer);
+        _draw_cmds[1].setGpuTimer(&_gpu_timer);
+
+        _pipeline_statistics.init(device);
+
     }
 
     void FrameManager::cleanUp() {
@@ -35,14 +44,20 @@ namespace undicht {
         _draw_cmds[0].cleanUp();
         _draw_cmds[1].cleanUp();
 
+        _gpu_timer.cleanUp();
+        _pipeline_statistics.cleanUp();
+
     }
 
     uint32_t FrameManager::prepareNextFrame(vulkan::SwapChain& swap_chain) {
         /// should be called before starting to record any command buffers for the next frame
         /// acquires a new image to render to from the swap chain
         /// resetCommandBuffer() and beginCommandBuffer() still has to be called on the transfer and draw commands
+        /// also starts a new frame for the frame arenas (releasing the memory allocated from them before)
         /// @return the id of the acquired swap image
 
+        FrameArena::nextFrame();
+
         _frame_id = getNextFrameID();
 
         _swap_images[_frame_id] = swap_chain.acquireNextSwapImage(_swap_images_ready[_frame_id].getAsSignal());
@@ -129,6 +144,7 @@ namespace undicht {
 
         _transfer_cmds[_frame_id].cleanUp();
         _transfer_cmds[_frame_id] = cmd;
+        _transfer_cmds[_frame_id].setGpuTimer(&_gpu_timer);
 
     }
 
@@ -136,6 +152,7 @@ namespace undicht {
 
         _draw_cmds[_frame_id].cleanUp();
         _draw_cmds[_frame_id] = cmd;
+        _draw_cmds[_frame_id].setGpuTimer(&_gpu_timer);
 
     }
 
@@ -151,6 +168,19 @@ namespace undicht {
         return _draw_cmds[_frame_id];
     }
 
+    vulkan::GpuTimer& FrameManager::getGpuTimer() {
+        /// @brief the gpu timer is attached to the transfer and draw command buffers
+        /// (call beginFrame() on it once the transfer command buffer was started)
+
+        return _gpu_timer;
+    }
+
+    vulkan::PipelineStatistics& FrameManager::getPipelineStatistics() {
+        /// @brief (call beginFrame() on it once the transfer command buffer was started)
+
+        return _pipeline_statistics;
+    }
+
     uint32_t FrameManager::getPreviousFrameID() const {
 
         return (_frame_id + 1) % 2;
@@ -8,6 +8,8 @@
 #include "core/vulkan/command_buffer.h"
 #include "core/vulkan/logical_device.h"
 #include "core/vulkan/swap_chain.h"
+#include "core/vulkan/gpu_timer.h"
+#include "core/vulkan/pipeline_statistics.h"
 
 namespace undicht {
 
@@ -38,6 +40,12 @@ namespace undicht {
         std::array<vulkan::CommandBuffer, 2> _transfer_cmds;
         std::array<vulkan::CommandBuffer, 2> _draw_cmds;
 
+        // measures the gpu time of sections of the frames command buffers
+        vulkan::GpuTimer _gpu_timer;
+
+        // counts the work the gpu does for the draw commands
+        vulkan::PipelineStatistics _pipeline_statistics;
+
       public:
 
         void init(const vulkan::LogicalDevice& device);
@@ -46,6 +54,7 @@ namespace undicht {
         /// should be called before starting to record any command buffers for the next frame
         /// acquires a new image to render to from the swap chain
         /// resetCommandBuffer() and beginCommandBuffer() still has to be called on the transfer and draw commands
+        /// also starts a new frame for the frame arenas (releasing the memory allocated from them before)
         /// @return the id of the acquired swap image
         uint32_t prepareNextFrame(vulkan::SwapChain& swap_chain);
 
@@ -84,6 +93,13 @@ namespace undicht {
         /// @return the draw command buffer for the frame currently in preparation
         vulkan::CommandBuffer& getDrawCmd();
 
+        /// @brief the gpu timer is attached to the transfer and draw command buffers
+        /// (call beginFrame() on it once the transfer command buffer was started)
+        vulkan::GpuTimer& getGpuTimer();
+
+        /// @brief (call beginFrame() on it once the transfer command buffer was started)
+        vulkan::PipelineStatistics& getPipelineStatistics();
+
         uint32_t getPreviousFrameID() const;
         uint32_t getCurrentFrameID() const;
         uint32_t getNextFrameID() const;
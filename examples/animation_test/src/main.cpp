@@ -2,6 +2,8 @@
 #include "renderer/vulkan/transfer_buffer.h"
 #include "scene/renderer/scene_renderer.h"
 #include "scene/scene.h"
+#include "scene/texture_streamer.h"
+#include "scene/mip_map_generator.h"
 #include "scene_loader/scene_loader.h"
 #include "3D/camera/free_camera.h"
 
@@ -22,6 +24,9 @@ class AnimationTest : public BasicAppTemplate {
     CommandBuffer _load_cmd_buffer;
     TransferBuffer _transfer_buffer;
     SceneRenderer _renderer;
+    SceneLoader _loader;
+    TextureStreamer _texture_streamer;
+    MipMapGenerator _mip_map_generator;
     Scene _scene;
 
     FreeCamera _cam;
@@ -37,21 +42,28 @@ class AnimationTest : public BasicAppTemplate {
         _load_cmd_buffer.init(getDevice().getDevice(), getDevice().getGraphicsCmdPool());
         _load_cmd_buffer.beginCommandBuffer(true);
 
-        _transfer_buffer.init(_vulkan_allocator, {getDevice().getGraphicsQueueFamily()}, 100000000); // reserve 10 Mb
+        _transfer_buffer.init(_vulkan_allocator, {getDevice().getGraphicsQueueFamily()}, 16000000); // 16 Mb, larger scenes get streamed through it
         _renderer.init(getDevice(), getSwapChain(), _vulkan_allocator);
 
-        SceneLoader loader;
-        loader.setInitObjects(getDevice(), _vulkan_allocator, _transfer_buffer, _renderer.getMaterialDescriptorCache(), _renderer.getNodeDescriptorCache(), _renderer.getMaterialSampler());
+        _loader.setInitObjects(getDevice(), _vulkan_allocator, _transfer_buffer, _renderer.getMaterialDescriptorCache(), _renderer.getNodeDescriptorCache(), _renderer.getMaterialSampler());
+        _loader.setJobSystem(getJobSystem());
+        _texture_streamer.init(_renderer.getMaterialDescriptorCache(), 256000000); // 256 Mb for the resident mip levels
+        _loader.setTextureStreamer(_texture_streamer);
+        _mip_map_generator.init(getDevice());
+        _loader.setMipMapGenerator(_mip_map_generator);
         _scene.init();
+        _transfer_buffer.enableFlushing(getDevice()); // while loading, larger scenes get streamed through the transfer buffer
         // the model.dae file (and diffuse texture) are taken from the ThinMatrix tutorial github:
         // https://github.com/TheThinMatrix/OpenGL-Animation
-        loader.importScene("res/model2.dae", _scene.addGroup("animation"));
-        loader.importScene("res/bob/boblampclean.md5mesh", _scene.addGroup("bob_lamp"));
-        loader.importScene("res/tex_cube.dae", _scene.addGroup("cube"));
-        loader.importScene("res/kos.dae", _scene.addGroup("kos"));
+        _loader.importScene("res/model2.dae", _scene.addGroup("animation"));
+        _loader.importScene("res/bob/boblampclean.md5mesh", _scene.addGroup("bob_lamp"));
+        _loader.importScene("res/tex_cube.dae", _scene.addGroup("cube"));
+        _loader.importSceneAsync("res/kos.dae", _scene, "kos"); // appears once it is loaded
         _transfer_buffer.completeTransfers(_load_cmd_buffer);
         _transfer_buffer.reset();
-        _scene.genMipMaps(_load_cmd_buffer);
+        _transfer_buffer.disableFlushing(); // the per frame transfers should never wait for the gpu
+        _scene.genMipMaps(_mip_map_generator);
+        uint32_t mip_map_batch = _mip_map_generator.generate(_load_cmd_buffer);
 
         // move and rotate the model to get a better look
         glm::mat4 model = glm::mat4(1.0f);
@@ -65,13 +77,17 @@ class AnimationTest : public BasicAppTemplate {
         _load_cmd_buffer.endCommandBuffer();
         getDevice().submitOnGraphicsQueue(_load_cmd_buffer.getCommandBuffer());
         getDevice().waitGraphicsQueueIdle();
+        _mip_map_generator.release(mip_map_batch);
     }
 
     void cleanUp() {
 
         getDevice().waitForProcessesToFinish();
 
+        _loader.waitForImports();
         _scene.cleanUp();
+        _texture_streamer.cleanUp();
+        _mip_map_generator.cleanUp();
         _transfer_buffer.cleanUp();
         _load_cmd_buffer.cleanUp();
         _renderer.cleanUp(_swap_chain);
@@ -81,6 +97,9 @@ class AnimationTest : public BasicAppTemplate {
     void framePreperation() {
         // called before the old frame is finished on the gpu
 
+        // adds the scenes that finished loading in the background
+        _loader.updateImports();
+
         // show / hide the cursor
         if(getWindow().isKeyPressed(GLFW_KEY_LEFT_ALT))
             getWindow().setCursorEnabled(false);
@@ -120,6 +139,9 @@ class AnimationTest : public BasicAppTemplate {
 
         _renderer.loadCameraMatrices(glm::value_ptr(cam_view), glm::value_ptr(cam_proj), _transfer_buffer);
 
+        // stream the mip levels requested while drawing the previous frame
+        _texture_streamer.update(_scene, _transfer_buffer);
+
         // record transfer commands
         _transfer_buffer.completeTransfers(getTransferCmd());
     }
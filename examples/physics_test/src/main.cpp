@@ -8,6 +8,7 @@
 #include "3D/camera/free_camera.h"
 
 #include "physics.h"
+#include "job_system.h"
 
 
 using namespace undicht;
@@ -25,10 +26,13 @@ int main() {
     PhysicsRenderer renderer;
     renderer.init(app.getDevice(), app.getSwapChain(), vulkan_allocator);
 
+    JobSystem job_system;
+    job_system.init();
+
     physics::initJoltPhysics();
 
     PhysicsScene scene;
-    scene.init(app.getDevice(), vulkan_allocator, renderer.getMaterialDescriptorCache(), renderer.getNodeDescriptorCache(), renderer.getMaterialSampler());
+    scene.init(job_system, app.getDevice(), vulkan_allocator, renderer.getMaterialDescriptorCache(), renderer.getNodeDescriptorCache(), renderer.getMaterialSampler());
 
     FreeCamera cam;
     glm::mat4 camera_view, camera_proj;
@@ -72,6 +76,7 @@ int main() {
     app.getDevice().waitForProcessesToFinish();
     scene.cleanUp();
     physics::cleanUpJoltPhysics();
+    job_system.cleanUp();
     renderer.cleanUp(app.getSwapChain());
     vulkan_allocator.cleanUp();
     app.cleanUp();
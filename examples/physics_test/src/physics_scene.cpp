@@ -23,16 +23,15 @@ using namespace physics;
 using namespace JPH;
 
 PhysicsScene::PhysicsScene() :
-    _physics_allocator(10 * 1024 * 1024),
-    _physics_job_system(cMaxPhysicsJobs, cMaxPhysicsBarriers, thread::hardware_concurrency() - 1) {
+    _physics_allocator(10 * 1024 * 1024) {
 
 }
 
 
-void PhysicsScene::init(const LogicalDevice& device, vma::VulkanMemoryAllocator& allocator, DescriptorSetCache& material_descriptor_cache, DescriptorSetCache& node_descriptor_cache, const Sampler& sampler) {
+void PhysicsScene::init(undicht::JobSystem& job_system, const LogicalDevice& device, vma::VulkanMemoryAllocator& allocator, DescriptorSetCache& material_descriptor_cache, DescriptorSetCache& node_descriptor_cache, const Sampler& sampler) {
 
     initGraphics(device, allocator, material_descriptor_cache, node_descriptor_cache, sampler);
-    initPhysics();
+    initPhysics(job_system);
 
 }
 
@@ -191,7 +190,10 @@ void PhysicsScene::initGraphics(const undicht::vulkan::LogicalDevice& device, un
     transfer_command.cleanUp();
 }
 
-void PhysicsScene::initPhysics() {
+void PhysicsScene::initPhysics(undicht::JobSystem& job_system) {
+
+    // the physics jobs run on the workers of the engines job system
+    _physics_job_system.init(job_system);
 
     // init physics
     _physics_system.Init(1024, 0, 1024, 1024, _broad_phase_layer_interface, _object_vs_broadphase_layer_filter, _object_vs_object_layer_filter);
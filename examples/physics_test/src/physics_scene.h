@@ -10,8 +10,9 @@
 #include "object_layers.h"
 #include "debug_contact_listener.h"
 #include "debug_body_activation_listener.h"
+#include "jolt_job_system.h"
+#include "job_system.h"
 
-#include <Jolt/Core/JobSystemThreadPool.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 
 
@@ -22,7 +23,7 @@ class PhysicsScene {
     undicht::graphics::Scene _graphics_scene;
 
     JPH::TempAllocatorImpl _physics_allocator;
-	  JPH::JobSystemThreadPool _physics_job_system;
+	  undicht::physics::JoltJobSystem _physics_job_system;
     undicht::physics::BPLayerInterfaceImpl _broad_phase_layer_interface;
 	  undicht::physics::ObjectVsBroadPhaseLayerFilterImpl _object_vs_broadphase_layer_filter;
 	  undicht::physics::ObjectLayerPairFilterImpl _object_vs_object_layer_filter;
@@ -39,7 +40,7 @@ class PhysicsScene {
 
     PhysicsScene();
 
-    void init(const undicht::vulkan::LogicalDevice& device, undicht::vma::VulkanMemoryAllocator& allocator, undicht::vulkan::DescriptorSetCache& material_descriptor_cache, undicht::vulkan::DescriptorSetCache& node_descriptor_cache, const undicht::vulkan::Sampler& sampler);
+    void init(undicht::JobSystem& job_system, const undicht::vulkan::LogicalDevice& device, undicht::vma::VulkanMemoryAllocator& allocator, undicht::vulkan::DescriptorSetCache& material_descriptor_cache, undicht::vulkan::DescriptorSetCache& node_descriptor_cache, const undicht::vulkan::Sampler& sampler);
     void cleanUp();
 
     void updatePhysics();
@@ -54,7 +55,7 @@ class PhysicsScene {
     // internal functions
 
     void initGraphics(const undicht::vulkan::LogicalDevice& device, undicht::vma::VulkanMemoryAllocator& allocator, undicht::vulkan::DescriptorSetCache& material_descriptor_cache, undicht::vulkan::DescriptorSetCache& node_descriptor_cache, const undicht::vulkan::Sampler& sampler);
-    void initPhysics();
+    void initPhysics(undicht::JobSystem& job_system);
 
 
 };
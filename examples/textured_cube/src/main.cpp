@@ -43,18 +43,20 @@ class App : public BasicAppTemplate {
         getWindow().setSize(1000, 800);
         setClearColor({0.01f, 0.0005f, 0.002f, 0.0f});
         Profiler::enableProfiler(true);
+        Profiler::beginTrace("./profile.json");
 
         UND_LOG << "initialized the app\n";
 
         // setting up the renderer
         renderer.init(getDevice(), _swap_chain, _vulkan_allocator);
 
-        // setting up the transfer buffer
-        transfer_buffer.init(_vulkan_allocator, {getDevice().getGraphicsQueueFamily()}, 50000000 * sizeof(float));
+        // setting up the transfer buffer (larger scenes get streamed through it while loading)
+        transfer_buffer.init(_vulkan_allocator, {getDevice().getGraphicsQueueFamily()}, 16000000);
 
         scene.init();
         SceneLoader scene_loader;
         scene_loader.setInitObjects(getDevice(), _vulkan_allocator, transfer_buffer, renderer.getMaterialDescriptorCache(), renderer.getNodeDescriptorCache(), renderer.getMaterialSampler());
+        transfer_buffer.enableFlushing(getDevice());
         scene_loader.importScene("res/tex_cube.dae", scene.addGroup("cube"));
         scene_loader.importScene("res/kos.dae", scene.addGroup("kos"));
         scene_loader.importScene("res/sponza/sponza.obj", scene.addGroup("sponza"));
@@ -70,6 +72,7 @@ class App : public BasicAppTemplate {
         initial_transfer_cmd.beginCommandBuffer(true);
         transfer_buffer.completeTransfers(initial_transfer_cmd);
         transfer_buffer.reset();
+        transfer_buffer.disableFlushing(); // the per frame transfers should never wait for the gpu
         scene.genMipMaps(initial_transfer_cmd);
         initial_transfer_cmd.endCommandBuffer();
 
@@ -80,7 +83,7 @@ class App : public BasicAppTemplate {
 
     void cleanUp() {
 
-        Profiler::writeToCsvFile("./profile.csv");
+        Profiler::endTrace();
 
         getDevice().waitForProcessesToFinish();
 
@@ -5,11 +5,26 @@
 #include "vk_mem_alloc.h"
 
 #include "vulkan_memory_allocator.h"
+#include "memory_tracker.h"
 
 namespace undicht {
 
     namespace vma {
 
+        // counting the device memory blocks allocated by vma
+        // (static, since VulkanMemoryAllocator objects get copied and pUserData would dangle)
+        static void VKAPI_PTR onDeviceMemoryAllocate(VmaAllocator allocator, uint32_t memory_type, VkDeviceMemory memory, VkDeviceSize size, void* user_data) {
+
+            MemoryTracker::recordDeviceAllocation(size);
+        }
+
+        static void VKAPI_PTR onDeviceMemoryFree(VmaAllocator allocator, uint32_t memory_type, VkDeviceMemory memory, VkDeviceSize size, void* user_data) {
+
+            MemoryTracker::recordDeviceFree(size);
+        }
+
+        static const VmaDeviceMemoryCallbacks s_device_memory_callbacks = {onDeviceMemoryAllocate, onDeviceMemoryFree, nullptr};
+
         void VulkanMemoryAllocator::init(VkInstance instance, VkDevice device, VkPhysicalDevice physical_device) {
             
             VmaAllocatorCreateInfo info{};
@@ -17,7 +32,7 @@ namespace undicht {
             info.flags = {};
             info.instance = instance;
             info.pAllocationCallbacks = {}; // optional
-            info.pDeviceMemoryCallbacks = {}; // optional
+            info.pDeviceMemoryCallbacks = &s_device_memory_callbacks; // optional, used to track the allocated gpu memory
             info.pHeapSizeLimit = NULL; // as far as i understand, its fine to leave as is
             info.physicalDevice = physical_device;
             info.preferredLargeHeapBlockSize = 0; // set to 0 for default, should be fine
@@ -1,5 +1,8 @@
 #include "command_buffer.h"
 #include "debug.h"
+#include "gpu_timer.h"
+#include "profiler.h"
+#include "cstdio"
 
 namespace undicht {
 
@@ -39,6 +42,8 @@ namespace undicht {
             VkCommandBufferBeginInfo info = createCommandBufferBeginInfo(single_use);
             vkBeginCommandBuffer(_cmd_buffer, &info);
 
+            _statistics = Statistics();
+
         }
 
         void CommandBuffer::endCommandBuffer() {
@@ -57,10 +62,11 @@ namespace undicht {
             return _is_ready;
         }
 
-        void CommandBuffer::beginRenderPass(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, const std::vector<VkClearValue>& clear_values) {
+        void CommandBuffer::beginRenderPass(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, ArrayView<VkClearValue> clear_values) {
 
             VkRenderPassBeginInfo info = createRenderPassBeginInfo(render_pass, frame_buffer, extent, clear_values);
             vkCmdBeginRenderPass(_cmd_buffer, &info, VK_SUBPASS_CONTENTS_INLINE);
+            _statistics._render_passes++;
 
         }
 
@@ -77,22 +83,38 @@ namespace undicht {
         void CommandBuffer::bindGraphicsPipeline(const VkPipeline& pipeline) {
 
             vkCmdBindPipeline(_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+            _statistics._pipeline_binds++;
+        }
+
+        void CommandBuffer::bindComputePipeline(const VkPipeline& pipeline) {
+
+            vkCmdBindPipeline(_cmd_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+            _statistics._pipeline_binds++;
         }
 
         void CommandBuffer::bindVertexBuffer(const VkBuffer& buffer, uint32_t binding) {
 
             static VkDeviceSize offset = 0;
             vkCmdBindVertexBuffers(_cmd_buffer, binding, 1, &buffer, &offset);
+            _statistics._vertex_buffer_binds++;
         }
 
-        void CommandBuffer::bindIndexBuffer(const VkBuffer& buffer) {
+        void CommandBuffer::bindIndexBuffer(const VkBuffer& buffer, VkIndexType index_type) {
 
-            vkCmdBindIndexBuffer(_cmd_buffer, buffer, 0, VK_INDEX_TYPE_UINT32);
+            vkCmdBindIndexBuffer(_cmd_buffer, buffer, 0, index_type);
+            _statistics._index_buffer_binds++;
         }
 
-        void CommandBuffer::bindDescriptorSet(const VkDescriptorSet& set, const VkPipelineLayout& layout, uint32_t slot) {
+        void CommandBuffer::bindDescriptorSet(const VkDescriptorSet& set, const VkPipelineLayout& layout, uint32_t slot, VkPipelineBindPoint bind_point) {
 
-            vkCmdBindDescriptorSets(_cmd_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, slot, 1, &set, 0, nullptr);
+            vkCmdBindDescriptorSets(_cmd_buffer, bind_point, layout, slot, 1, &set, 0, nullptr);
+            _statistics._descriptor_set_binds++;
+        }
+
+        void CommandBuffer::pushConstants(const VkPipelineLayout& layout, VkShaderStageFlags stages, uint32_t byte_size, const void* data) {
+            // updates the push constants (starting at offset 0) of the pipeline layout
+
+            vkCmdPushConstants(_cmd_buffer, layout, stages, 0, byte_size, data);
         }
 
         void CommandBuffer::draw(uint32_t vertex_count, bool draw_indexed, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance) {
@@ -100,11 +122,22 @@ namespace undicht {
             if(draw_indexed) {
                 
                 vkCmdDrawIndexed(_cmd_buffer, vertex_count, instance_count, first_vertex, 0, first_instance);
+                _statistics._indexed_draw_calls++;
             } else {
 
                 vkCmdDraw(_cmd_buffer, vertex_count, instance_count, first_vertex, first_instance);
             }
 
+            _statistics._draw_calls++;
+            _statistics._vertices += uint64_t(vertex_count) * instance_count;
+
+        }
+
+        void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z) {
+            // runs the bound compute pipeline with the number of workgroups in each dimension
+
+            vkCmdDispatch(_cmd_buffer, group_count_x, group_count_y, group_count_z);
+            _statistics._dispatches++;
         }
 
         void CommandBuffer::copy(const VkBuffer& src, const VkBuffer& dst, const VkBufferCopy& copy_region) {
@@ -112,6 +145,7 @@ namespace undicht {
             // make sure the dst buffer has enough memory allocated
 
             vkCmdCopyBuffer(_cmd_buffer, src, dst, 1, &copy_region);
+            _statistics._copies++;
         }
 
         void CommandBuffer::copy(const VkBuffer& src, const VkImage& dst, VkImageLayout layout, const VkBufferImageCopy& copy_region) {
@@ -119,6 +153,7 @@ namespace undicht {
             // make sure the image has enough memory allocated
 
             vkCmdCopyBufferToImage(_cmd_buffer, src, dst, layout, 1, &copy_region);
+            _statistics._copies++;
         }
 
 
@@ -128,6 +163,16 @@ namespace undicht {
             // https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdPipelineBarrier.html
 
             vkCmdPipelineBarrier(_cmd_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+            _statistics._pipeline_barriers++;
+        }
+
+        void CommandBuffer::pipelineBarrier(ArrayView<VkImageMemoryBarrier> barriers, VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage) {
+            // records all barriers with a single command (i.e. to transition the images of multiple textures at once)
+
+            if(barriers.empty()) return;
+
+            vkCmdPipelineBarrier(_cmd_buffer, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, barriers.size(), barriers.data());
+            _statistics._pipeline_barriers++;
         }
 
         void CommandBuffer::blitImage(const VkImage& image, const VkImageBlit& blit) {
@@ -135,6 +180,82 @@ namespace undicht {
             // (https://registry.khronos.org/vulkan/specs/1.3-extensions/man/html/vkCmdBlitImage.html)
 
             vkCmdBlitImage(_cmd_buffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+            _statistics._blits++;
+        }
+
+        void CommandBuffer::resetQueryPool(const VkQueryPool& query_pool, uint32_t first_query, uint32_t query_count) {
+            // queries have to be reset before they can be used (again)
+            // has to be recorded outside of a render pass
+
+            vkCmdResetQueryPool(_cmd_buffer, query_pool, first_query, query_count);
+        }
+
+        void CommandBuffer::writeTimestamp(const VkQueryPool& query_pool, uint32_t query, VkPipelineStageFlagBits stage) {
+            // the timestamp is written once all previous commands have completed the stage
+
+            vkCmdWriteTimestamp(_cmd_buffer, stage, query_pool, query);
+        }
+
+        void CommandBuffer::beginQuery(const VkQueryPool& query_pool, uint32_t query) {
+            // if the query is begun inside a render pass, it has to end in the same subpass
+
+            vkCmdBeginQuery(_cmd_buffer, query_pool, query, 0);
+        }
+
+        void CommandBuffer::endQuery(const VkQueryPool& query_pool, uint32_t query) {
+
+            vkCmdEndQuery(_cmd_buffer, query_pool, query);
+        }
+
+        const CommandBuffer::Statistics& CommandBuffer::getStatistics() const {
+            /// @return the number of commands of each type recorded since beginCommandBuffer() was called
+
+            return _statistics;
+        }
+
+        void CommandBuffer::recordStatistics(const char* name) const {
+            /// @brief adds the statistics to the profilers trace as counters (prefixed by the name)
+
+            if(!Profiler::isEnabled()) return;
+
+            // building the counter names on the stack (the names get interned by the profiler)
+            char counter_name[Profiler::MAX_TASK_NAME_LENGTH];
+            auto record = [&](const char* counter, int64_t value) {
+                std::snprintf(counter_name, sizeof(counter_name), "%s %s", name, counter);
+                Profiler::recordCounter(counter_name, value);
+            };
+
+            record("draw calls", _statistics._draw_calls);
+            record("vertices", _statistics._vertices);
+            record("render passes", _statistics._render_passes);
+            record("pipeline binds", _statistics._pipeline_binds);
+            record("descriptor set binds", _statistics._descriptor_set_binds);
+            record("vertex buffer binds", _statistics._vertex_buffer_binds);
+            record("index buffer binds", _statistics._index_buffer_binds);
+            record("pipeline barriers", _statistics._pipeline_barriers);
+            record("copies", _statistics._copies);
+            record("blits", _statistics._blits);
+            record("dispatches", _statistics._dispatches);
+        }
+
+        void CommandBuffer::setGpuTimer(GpuTimer* timer) {
+
+            _gpu_timer = timer;
+        }
+
+        GpuTimer* CommandBuffer::getGpuTimer() const {
+
+            return _gpu_timer;
+        }
+
+        void CommandBuffer::beginTimer(const char* name) {
+
+            if(_gpu_timer) _gpu_timer->beginScope(*this, name);
+        }
+
+        void CommandBuffer::endTimer() {
+
+            if(_gpu_timer) _gpu_timer->endScope(*this);
         }
 
 
@@ -165,7 +286,7 @@ namespace undicht {
             return info;
         }
 
-        VkRenderPassBeginInfo CommandBuffer::createRenderPassBeginInfo(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, const std::vector<VkClearValue>& clear_values) {
+        VkRenderPassBeginInfo CommandBuffer::createRenderPassBeginInfo(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, ArrayView<VkClearValue> clear_values) {
 
             VkRenderPassBeginInfo info{};
             info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
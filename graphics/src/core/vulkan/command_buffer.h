@@ -7,8 +7,28 @@ namespace undicht {
 
     namespace vulkan {
 
+        class GpuTimer;
+
         class CommandBuffer {
 
+        public:
+
+            struct Statistics {
+                /// counts the commands recorded since the command buffer was begun
+                uint32_t _draw_calls = 0;
+                uint32_t _indexed_draw_calls = 0; // also counted in _draw_calls
+                uint64_t _vertices = 0; // vertices (or indices) drawn, times the instance count
+                uint32_t _render_passes = 0;
+                uint32_t _pipeline_binds = 0;
+                uint32_t _descriptor_set_binds = 0;
+                uint32_t _vertex_buffer_binds = 0;
+                uint32_t _index_buffer_binds = 0;
+                uint32_t _pipeline_barriers = 0;
+                uint32_t _copies = 0;
+                uint32_t _blits = 0;
+                uint32_t _dispatches = 0;
+            };
+
         protected:
 
             VkDevice _device_handle;
@@ -18,6 +38,10 @@ namespace undicht {
 
             bool _is_ready = false;
 
+            GpuTimer* _gpu_timer = nullptr;
+
+            Statistics _statistics;
+
         public:
 
             void init(const VkDevice& device, const VkCommandPool& command_pool);
@@ -32,27 +56,50 @@ namespace undicht {
             bool isReady() const;
 
             // graphics commands
-            void beginRenderPass(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, const std::vector<VkClearValue>& clear_values);
+            void beginRenderPass(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, ArrayView<VkClearValue> clear_values);
             void endRenderPass();
             void nextSubPass(const VkSubpassContents& subpass_contents);
             void bindGraphicsPipeline(const VkPipeline& pipeline);
+            void bindComputePipeline(const VkPipeline& pipeline);
             void bindVertexBuffer(const VkBuffer& buffer, uint32_t binding);
-            void bindIndexBuffer(const VkBuffer& buffer);
-            void bindDescriptorSet(const VkDescriptorSet& set, const VkPipelineLayout& layout, uint32_t slot = 0);
+            void bindIndexBuffer(const VkBuffer& buffer, VkIndexType index_type = VK_INDEX_TYPE_UINT32);
+            void bindDescriptorSet(const VkDescriptorSet& set, const VkPipelineLayout& layout, uint32_t slot = 0, VkPipelineBindPoint bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS);
+            void pushConstants(const VkPipelineLayout& layout, VkShaderStageFlags stages, uint32_t byte_size, const void* data);
             void draw(uint32_t vertex_count, bool draw_indexed = false, uint32_t instance_count = 1, uint32_t first_vertex = 0, uint32_t first_instance = 0);
+            void dispatch(uint32_t group_count_x, uint32_t group_count_y = 1, uint32_t group_count_z = 1); // runs the bound compute pipeline
             
             // other commands
             void copy(const VkBuffer& src, const VkBuffer& dst, const VkBufferCopy& copy_region);
             void copy(const VkBuffer& src, const VkImage& dst, VkImageLayout layout, const VkBufferImageCopy& copy_region);
             void pipelineBarrier(const VkImageMemoryBarrier& barrier, VkPipelineStageFlagBits src_stage, VkPipelineStageFlagBits dst_stage);
+            void pipelineBarrier(ArrayView<VkImageMemoryBarrier> barriers, VkPipelineStageFlags src_stage, VkPipelineStageFlags dst_stage); // records all barriers with a single command
             void blitImage(const VkImage& image, const VkImageBlit& blit);
 
+            // queries
+            void resetQueryPool(const VkQueryPool& query_pool, uint32_t first_query, uint32_t query_count);
+            void writeTimestamp(const VkQueryPool& query_pool, uint32_t query, VkPipelineStageFlagBits stage);
+            void beginQuery(const VkQueryPool& query_pool, uint32_t query);
+            void endQuery(const VkQueryPool& query_pool, uint32_t query);
+
+            /// @return the number of commands of each type recorded since beginCommandBuffer() was called
+            const Statistics& getStatistics() const;
+
+            /// @brief adds the statistics to the profilers trace as counters (prefixed by the name)
+            void recordStatistics(const char* name) const;
+
+            // gpu timing (see gpu_timer.h)
+            // the timer commands are ignored if no timer is attached to the command buffer
+            void setGpuTimer(GpuTimer* timer);
+            GpuTimer* getGpuTimer() const;
+            void beginTimer(const char* name);
+            void endTimer();
+
         protected:
             // creating command buffer related structs
 
             VkCommandBufferAllocateInfo static createCommandBufferAllocateInfo(const VkCommandPool& command_pool, uint32_t count = 1);
             VkCommandBufferBeginInfo static createCommandBufferBeginInfo(bool single_use);
-            VkRenderPassBeginInfo static createRenderPassBeginInfo(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, const std::vector<VkClearValue>& clear_values);
+            VkRenderPassBeginInfo static createRenderPassBeginInfo(const VkRenderPass& render_pass, const VkFramebuffer& frame_buffer, VkExtent2D extent, ArrayView<VkClearValue> clear_values);
             
         };
 
@@ -5,12 +5,18 @@ namespace undicht {
 
     namespace vulkan {
 
-        void DescriptorSet::init(const VkDevice& device, const VkDescriptorPool& pool, const VkDescriptorSetLayout& layout) {
+        bool DescriptorSet::init(const VkDevice& device, const VkDescriptorPool& pool, const VkDescriptorSetLayout& layout) {
+            /// @return false, if the set couldnt be allocated from the pool (i.e. because the pool is full)
 
             _device_handle = device;
 
             VkDescriptorSetAllocateInfo info = createDescriptorSetAllocateInfo(pool, layout);
-            vkAllocateDescriptorSets(device, &info, &_descriptor_set);
+            if(vkAllocateDescriptorSets(device, &info, &_descriptor_set) != VK_SUCCESS) {
+                _descriptor_set = VK_NULL_HANDLE;
+                return false;
+            }
+
+            return true;
         }
 
         void DescriptorSet::cleanUp() {
@@ -50,6 +56,17 @@ namespace undicht {
 
         }
 
+        void DescriptorSet::bindStorageImage(uint32_t binding, const VkImageView& image_view) {
+            // storage images can be written by shaders (i.e. compute shaders)
+
+            VkDescriptorImageInfo* image_info = new VkDescriptorImageInfo;
+            *image_info = createDescriptorImageInfo(image_view, VK_IMAGE_LAYOUT_GENERAL, VK_NULL_HANDLE);
+
+            VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            _pending_writes.push_back(createWriteDescriptorSet(binding, type, _descriptor_set, nullptr, image_info));
+
+        }
+
         void DescriptorSet::update() {
             // aplies all pending bind commands
 
@@ -25,13 +25,15 @@ namespace undicht {
 
         public:
 
-            void init(const VkDevice& device, const VkDescriptorPool& pool, const VkDescriptorSetLayout& layout);
+            /// @return false, if the set couldnt be allocated from the pool (i.e. because the pool is full)
+            bool init(const VkDevice& device, const VkDescriptorPool& pool, const VkDescriptorSetLayout& layout);
             void cleanUp();
 
             // stages the changes, call update to actually apply the changes
             void bindUniformBuffer(uint32_t binding, const Buffer& buffer);
             void bindImage(uint32_t binding, const VkImageView& image_view, const VkImageLayout& layout, const VkSampler& sampler);
             void bindInputAttachment(uint32_t binding, const VkImageView& image_view);
+            void bindStorageImage(uint32_t binding, const VkImageView& image_view); // the image has to be in the general layout when it is used
 
             // aplies all pending bind commands
             void update();
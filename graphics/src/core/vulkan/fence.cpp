@@ -23,6 +23,12 @@ namespace undicht {
             return _in_use;
         }
 
+        bool Fence::isSignaled() const {
+            /// @return true, if the fence is signaled (doesnt wait for it)
+
+            return vkGetFenceStatus(_device_handle, _fence) == VK_SUCCESS;
+        }
+
         const VkFence& Fence::getFence(bool set_in_use) {
 
             if(set_in_use)
@@ -25,6 +25,9 @@ namespace undicht {
 
             bool isInUse() const;
 
+            /// @return true, if the fence is signaled (doesnt wait for it)
+            bool isSignaled() const;
+
             const VkFence& getFence(bool set_in_use = true);
 
             void reset();
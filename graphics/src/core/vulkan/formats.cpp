@@ -72,6 +72,16 @@ namespace undicht {
                 {UND_R8G8B8A8_SRGB, VK_FORMAT_R8G8B8A8_SRGB},
                 {UND_B8G8R8A8_SRGB, VK_FORMAT_B8G8R8A8_SRGB},
 
+                // block compressed formats
+                {UND_BC1, VK_FORMAT_BC1_RGBA_UNORM_BLOCK},
+                {UND_BC1_SRGB, VK_FORMAT_BC1_RGBA_SRGB_BLOCK},
+                {UND_BC3, VK_FORMAT_BC3_UNORM_BLOCK},
+                {UND_BC3_SRGB, VK_FORMAT_BC3_SRGB_BLOCK},
+                {UND_BC4, VK_FORMAT_BC4_UNORM_BLOCK},
+                {UND_BC5, VK_FORMAT_BC5_UNORM_BLOCK},
+                {UND_BC7, VK_FORMAT_BC7_UNORM_BLOCK},
+                {UND_BC7_SRGB, VK_FORMAT_BC7_SRGB_BLOCK},
+
                 // depth buffer formats
                 {UND_DEPTH32F, VK_FORMAT_D32_SFLOAT},
                 {UND_DEPTH32F_STENCIL8, VK_FORMAT_D32_SFLOAT_S8_UINT},
@@ -97,6 +107,14 @@ namespace undicht {
                 case Type::COLOR_RGBA : type_str = "COLOR_RGBA";break;
                 case Type::DEPTH_BUFFER : type_str = "DEPTH_BUFFER";break;
                 case Type::DEPTH_STENCIL_BUFFER : type_str = "DEPTH_STENCIL_BUFFER";break;
+                case Type::COLOR_BC1 : type_str = "COLOR_BC1";break;
+                case Type::COLOR_BC1_SRGB : type_str = "COLOR_BC1_SRGB";break;
+                case Type::COLOR_BC3 : type_str = "COLOR_BC3";break;
+                case Type::COLOR_BC3_SRGB : type_str = "COLOR_BC3_SRGB";break;
+                case Type::COLOR_BC4 : type_str = "COLOR_BC4";break;
+                case Type::COLOR_BC5 : type_str = "COLOR_BC5";break;
+                case Type::COLOR_BC7 : type_str = "COLOR_BC7";break;
+                case Type::COLOR_BC7_SRGB : type_str = "COLOR_BC7_SRGB";break;
             }
 
             UND_ERROR << "failed to translate format: " << type.m_num_components << " component(s) of type " << type_str << ", size of components: " << type.m_size << "\n";
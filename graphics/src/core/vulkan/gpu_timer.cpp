@@ -0,0 +1,207 @@
+#include "gpu_timer.h"
+#include "command_buffer.h"
+#include "debug.h"
+#include "profiler.h"
+
+namespace undicht {
+
+    namespace vulkan {
+
+        const uint32_t INVALID_SCOPE = 0xFFFFFFFF;
+
+        void GpuTimer::init(const LogicalDevice& device, uint32_t frames_in_flight, uint32_t max_scopes_per_frame) {
+            /** @param frames_in_flight number of frames after which the results of a frame are read
+             * should be higher than the number of frames the cpu can be ahead of the gpu
+             * @param max_scopes_per_frame scopes beyond this number are ignored */
+
+            _device_handle = device.getDevice();
+
+            // checking for timestamp support
+            VkPhysicalDeviceProperties properties{};
+            vkGetPhysicalDeviceProperties(device.getPhysicalDevice(), &properties);
+
+            uint32_t queue_family_count = 0;
+            vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &queue_family_count, nullptr);
+            std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+            vkGetPhysicalDeviceQueueFamilyProperties(device.getPhysicalDevice(), &queue_family_count, queue_families.data());
+
+            uint32_t valid_bits = queue_families.at(device.getGraphicsQueueFamily()).timestampValidBits;
+            _is_supported = (properties.limits.timestampPeriod > 0.0f) && valid_bits;
+
+            if(!_is_supported) {
+                UND_WARNING << "the device does not support timestamp queries on the graphics queue, gpu timings wont be available\n";
+                return;
+            }
+
+            _timestamp_period = properties.limits.timestampPeriod;
+            _timestamp_mask = (valid_bits >= 64) ? ~0ull : ((1ull << valid_bits) - 1);
+            _max_scopes = max_scopes_per_frame;
+
+            // every scope uses two queries (begin and end)
+            _query_pools.resize(frames_in_flight);
+            _scopes.resize(frames_in_flight);
+            _frame_recorded.assign(frames_in_flight, false);
+
+            for(uint32_t i = 0; i < frames_in_flight; i++) {
+                _query_pools.at(i).init(_device_handle, VK_QUERY_TYPE_TIMESTAMP, 2 * max_scopes_per_frame);
+                _scopes.at(i).reserve(max_scopes_per_frame);
+            }
+
+            _open_scopes.reserve(max_scopes_per_frame);
+            _results.reserve(2 * max_scopes_per_frame);
+
+            _track_id = Profiler::createTrack("GPU");
+
+            calibrate(device);
+
+        }
+
+        void GpuTimer::cleanUp() {
+
+            for(QueryPool& pool : _query_pools)
+                pool.cleanUp();
+
+            _query_pools.clear();
+            _scopes.clear();
+
+            if(_dropped_scopes)
+                UND_WARNING << "the gpu timer dropped " << _dropped_scopes << " scopes (too many scopes per frame or results were not available in time)\n";
+
+        }
+
+        void GpuTimer::beginFrame(CommandBuffer& cmd) {
+            /** @brief reads the results of the frame that used the next query pool and resets the pool
+             * call once per frame on the command buffer that gets executed first in the frame (before any scope was started) */
+
+            if(!_is_supported) return;
+
+            _frame = (_frame + 1) % _query_pools.size();
+
+            if(_frame_recorded.at(_frame))
+                resolveFrame(_frame);
+
+            _scopes.at(_frame).clear();
+            _open_scopes.clear();
+
+            cmd.resetQueryPool(_query_pools.at(_frame).getQueryPool(), 0, _query_pools.at(_frame).getQueryCount());
+            _frame_recorded.at(_frame) = true;
+
+        }
+
+        void GpuTimer::beginScope(CommandBuffer& cmd, const char* name) {
+
+            if(!_is_supported) return;
+
+            std::vector<Scope>& scopes = _scopes.at(_frame);
+
+            if(scopes.size() >= _max_scopes) {
+                _open_scopes.push_back(INVALID_SCOPE); // so that the matching endScope() is ignored
+                _dropped_scopes++;
+                return;
+            }
+
+            uint32_t scope_id = scopes.size();
+            scopes.push_back({Profiler::getTaskNameID(name), (uint32_t)_open_scopes.size()});
+            _open_scopes.push_back(scope_id);
+
+            cmd.writeTimestamp(_query_pools.at(_frame).getQueryPool(), 2 * scope_id, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+
+        }
+
+        void GpuTimer::endScope(CommandBuffer& cmd) {
+
+            if(!_is_supported || _open_scopes.empty()) return;
+
+            uint32_t scope_id = _open_scopes.back();
+            _open_scopes.pop_back();
+
+            if(scope_id == INVALID_SCOPE) return;
+
+            cmd.writeTimestamp(_query_pools.at(_frame).getQueryPool(), 2 * scope_id + 1, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+        }
+
+        bool GpuTimer::isSupported() const {
+
+            return _is_supported;
+        }
+
+        uint32_t GpuTimer::getFramesInFlight() const {
+
+            return _query_pools.size();
+        }
+
+        ////////////////////////////////////// non public functions //////////////////////////////////////
+
+        void GpuTimer::resolveFrame(uint32_t frame) {
+
+            std::vector<Scope>& scopes = _scopes.at(frame);
+
+            if(scopes.empty()) return;
+
+            // not waiting for the results, if they are not available they get dropped
+            if(!_query_pools.at(frame).getResults(0, 2 * scopes.size(), _results)) {
+                _dropped_scopes += scopes.size();
+                return;
+            }
+
+            for(uint32_t i = 0; i < scopes.size(); i++) {
+
+                int64_t start = int64_t((_results.at(2 * i) & _timestamp_mask) * _timestamp_period) + _gpu_to_cpu_offset;
+                int64_t end = int64_t((_results.at(2 * i + 1) & _timestamp_mask) * _timestamp_period) + _gpu_to_cpu_offset;
+
+                if(start < 0) start = 0;
+                if(end < start) end = start;
+
+                Profiler::recordTask(_track_id, scopes.at(i)._name_id, scopes.at(i)._depth, start, end);
+            }
+
+        }
+
+        void GpuTimer::calibrate(const LogicalDevice& device) {
+            /// @brief estimates the offset between the gpu timestamps and the profilers time
+            /// by writing a single timestamp and waiting for it
+
+            QueryPool query_pool;
+            query_pool.init(_device_handle, VK_QUERY_TYPE_TIMESTAMP, 1);
+
+            CommandBuffer cmd;
+            cmd.init(_device_handle, device.getGraphicsCmdPool());
+            cmd.beginCommandBuffer(true);
+            cmd.resetQueryPool(query_pool.getQueryPool(), 0, 1);
+            cmd.writeTimestamp(query_pool.getQueryPool(), 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+            cmd.endCommandBuffer();
+
+            // the timestamp was written somewhere between submitting and the queue becoming idle
+            uint64_t cpu_before = Profiler::getTime();
+            device.submitOnGraphicsQueue(cmd.getCommandBuffer());
+            device.waitGraphicsQueueIdle();
+            uint64_t cpu_after = Profiler::getTime();
+
+            if(query_pool.getResults(0, 1, _results)) {
+                int64_t gpu_time = int64_t((_results.at(0) & _timestamp_mask) * _timestamp_period);
+                _gpu_to_cpu_offset = int64_t(cpu_before + (cpu_after - cpu_before) / 2) - gpu_time;
+            } else {
+                UND_WARNING << "failed to calibrate the gpu timer, gpu timings wont line up with the cpu timings\n";
+            }
+
+            cmd.cleanUp();
+            query_pool.cleanUp();
+
+        }
+
+        ////////////////////////////////////// GpuTimerScope //////////////////////////////////////
+
+        GpuTimerScope::GpuTimerScope(CommandBuffer& cmd, const char* name) : _cmd(cmd) {
+
+            _cmd.beginTimer(name);
+        }
+
+        GpuTimerScope::~GpuTimerScope() {
+
+            _cmd.endTimer();
+        }
+
+    } // vulkan
+
+} // undicht
@@ -0,0 +1,99 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include "vector"
+#include "cstdint"
+#include "vulkan/vulkan.h"
+
+#include "logical_device.h"
+#include "query_pool.h"
+
+namespace undicht {
+
+    namespace vulkan {
+
+        class CommandBuffer;
+
+        class GpuTimer {
+            /** measures the time the gpu spends executing sections of command buffers (using timestamp queries)
+             * the results of a frame are read back (without waiting) when its query pool gets reused,
+             * which is getFramesInFlight() frames later, and recorded into the Profiler on the "GPU" track
+             * (converted to the cpu timeline of the Profiler, so both can be viewed together)
+             * attach the timer to command buffers via CommandBuffer::setGpuTimer(),
+             * then sections can be measured via CommandBuffer::beginTimer() / endTimer() (or a GpuTimerScope) */
+        protected:
+
+            struct Scope {
+                uint32_t _name_id;
+                uint32_t _depth;
+            };
+
+            VkDevice _device_handle;
+            bool _is_supported = false;
+
+            double _timestamp_period = 1.0; // nanoseconds per timestamp tick
+            uint64_t _timestamp_mask = ~0ull; // valid bits of the timestamps
+            int64_t _gpu_to_cpu_offset = 0; // nanoseconds to add to a gpu timestamp to get to the profilers time
+            uint32_t _track_id = 0;
+            uint32_t _max_scopes = 0;
+
+            // one query pool (+ the scopes written into it) per frame in flight
+            uint32_t _frame = 0;
+            std::vector<QueryPool> _query_pools;
+            std::vector<std::vector<Scope>> _scopes;
+            std::vector<bool> _frame_recorded;
+
+            std::vector<uint32_t> _open_scopes; // stack of the currently open scopes (of the current frame)
+            std::vector<uint64_t> _results;
+            uint64_t _dropped_scopes = 0;
+
+        public:
+
+            /** @param frames_in_flight number of frames after which the results of a frame are read
+             * should be higher than the number of frames the cpu can be ahead of the gpu
+             * @param max_scopes_per_frame scopes beyond this number are ignored */
+            void init(const LogicalDevice& device, uint32_t frames_in_flight = 3, uint32_t max_scopes_per_frame = 64);
+            void cleanUp();
+
+            /** @brief reads the results of the frame that used the next query pool and resets the pool
+             * call once per frame on the command buffer that gets executed first in the frame (before any scope was started) */
+            void beginFrame(CommandBuffer& cmd);
+
+            // use CommandBuffer::beginTimer() / endTimer() instead of calling these directly
+            void beginScope(CommandBuffer& cmd, const char* name);
+            void endScope(CommandBuffer& cmd);
+
+            /// @return false, if the device (or its graphics queue) doesnt support timestamps
+            bool isSupported() const;
+            uint32_t getFramesInFlight() const;
+
+        protected:
+            // non public functions
+
+            void resolveFrame(uint32_t frame);
+
+            /// @brief estimates the offset between the gpu timestamps and the profilers time
+            /// by writing a single timestamp and waiting for it
+            void calibrate(const LogicalDevice& device);
+
+        };
+
+        class GpuTimerScope {
+            /** measures the gpu time of the commands recorded during the lifetime of the object
+             * (does nothing if the command buffer has no GpuTimer attached) */
+        protected:
+
+            CommandBuffer& _cmd;
+
+        public:
+
+            GpuTimerScope(CommandBuffer& cmd, const char* name);
+            ~GpuTimerScope();
+
+        };
+
+    } // vulkan
+
+} // undicht
+
+#endif // GPU_TIMER_H
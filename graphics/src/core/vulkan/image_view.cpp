@@ -8,7 +8,7 @@ namespace undicht {
 
     namespace vulkan {
 
-        void ImageView::init(const VkDevice& device, const VkImage& image, const VkFormat& format, uint32_t mip_levels, uint32_t layers, const VkImageViewType& view_type) {
+        void ImageView::init(const VkDevice& device, const VkImage& image, const VkFormat& format, uint32_t mip_levels, uint32_t layers, const VkImageViewType& view_type, const VkComponentMapping& components, uint32_t first_level, VkImageUsageFlags usage) {
             
             _device_handle = device;
             _image_handle = image;
@@ -20,7 +20,10 @@ namespace undicht {
             _format = format;
 
             // creating the image view
-            VkImageViewCreateInfo info = createImageViewCreateInfo(image, mip_levels, layers, view_type, format, chooseImageAspectFlags(format));
+            VkImageViewCreateInfo info = createImageViewCreateInfo(image, first_level, mip_levels, layers, view_type, format, chooseImageAspectFlags(format), components);
+            VkImageViewUsageCreateInfo usage_info = createImageViewUsageCreateInfo(usage);
+            if(usage) info.pNext = &usage_info;
+
             VK_ASSERT(vkCreateImageView(_device_handle, &info, {}, &_image_view));
 
         }
@@ -49,19 +52,16 @@ namespace undicht {
 
         //////////////////////////////////////// creating image view related structs //////////////////////////////////////
 
-        VkImageViewCreateInfo ImageView::createImageViewCreateInfo(const VkImage& image, uint32_t mip_levels, uint32_t layer_count, const VkImageViewType& view_type, const VkFormat& format, VkImageAspectFlags flags) {
+        VkImageViewCreateInfo ImageView::createImageViewCreateInfo(const VkImage& image, uint32_t first_level, uint32_t mip_levels, uint32_t layer_count, const VkImageViewType& view_type, const VkFormat& format, VkImageAspectFlags flags, const VkComponentMapping& components) {
             
             VkImageViewCreateInfo info{};
             info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
             info.image = image;
             info.viewType = view_type;
             info.format = format;
-            info.components.r = VK_COMPONENT_SWIZZLE_IDENTITY;
-            info.components.g = VK_COMPONENT_SWIZZLE_IDENTITY;
-            info.components.b = VK_COMPONENT_SWIZZLE_IDENTITY;
-            info.components.a = VK_COMPONENT_SWIZZLE_IDENTITY;
+            info.components = components;
             info.subresourceRange.aspectMask = flags;
-            info.subresourceRange.baseMipLevel = 0;
+            info.subresourceRange.baseMipLevel = first_level;
             info.subresourceRange.levelCount = mip_levels;
             info.subresourceRange.baseArrayLayer = 0;
             info.subresourceRange.layerCount = layer_count;
@@ -69,6 +69,16 @@ namespace undicht {
             return info;
         }
 
+        VkImageViewUsageCreateInfo ImageView::createImageViewUsageCreateInfo(VkImageUsageFlags usage) {
+
+            VkImageViewUsageCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_USAGE_CREATE_INFO;
+            info.pNext = nullptr;
+            info.usage = usage;
+
+            return info;
+        }
+
         VkImageAspectFlags ImageView::chooseImageAspectFlags(const VkFormat& format) {
 
             FixedType translated_type = translate(format);
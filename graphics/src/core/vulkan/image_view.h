@@ -24,7 +24,10 @@ namespace undicht {
 
           public:
 
-            void init(const VkDevice& device, const VkImage& image, const VkFormat& format = VK_FORMAT_R8G8B8A8_SRGB, uint32_t mip_levels = 1, uint32_t layers = 1, const VkImageViewType& view_type = VK_IMAGE_VIEW_TYPE_2D);
+            // components: the swizzle applied when sampling the image (i.e. to expand a single channel image to rgba), identity by default
+            // first_level: the first mip level of the image that is part of the view
+            // usage: restricts what the view is used for (needed if the format of the view doesnt support all usages of the image), 0 to use the usage of the image
+            void init(const VkDevice& device, const VkImage& image, const VkFormat& format = VK_FORMAT_R8G8B8A8_SRGB, uint32_t mip_levels = 1, uint32_t layers = 1, const VkImageViewType& view_type = VK_IMAGE_VIEW_TYPE_2D, const VkComponentMapping& components = {}, uint32_t first_level = 0, VkImageUsageFlags usage = 0);
             void cleanUp();
             
             const VkImage& getImage() const;
@@ -34,7 +37,8 @@ namespace undicht {
           protected:
             // creating image view related structs
 
-            VkImageViewCreateInfo static createImageViewCreateInfo(const VkImage& image, uint32_t mip_levels, uint32_t layer_count, const VkImageViewType& view_type, const VkFormat& format, VkImageAspectFlags flags);
+            VkImageViewCreateInfo static createImageViewCreateInfo(const VkImage& image, uint32_t first_level, uint32_t mip_levels, uint32_t layer_count, const VkImageViewType& view_type, const VkFormat& format, VkImageAspectFlags flags, const VkComponentMapping& components);
+            VkImageViewUsageCreateInfo static createImageViewUsageCreateInfo(VkImageUsageFlags usage);
             VkImageAspectFlags static chooseImageAspectFlags(const VkFormat& format);
 
         };
@@ -77,6 +77,21 @@ namespace undicht {
             return _physical_device;
         }
 
+        bool LogicalDevice::supportsFormat(VkFormat format, VkFormatFeatureFlags features) const {
+            /// @return true, if images with the format (and optimal tiling) support all of the features
+
+            VkFormatProperties properties;
+            vkGetPhysicalDeviceFormatProperties(_physical_device, format, &properties);
+
+            return (properties.optimalTilingFeatures & features) == features;
+        }
+
+        const VkPhysicalDeviceFeatures& LogicalDevice::getEnabledFeatures() const {
+            /// @return the features that were enabled when creating the device (optional features may be VK_FALSE)
+
+            return _enabled_features;
+        }
+
         uint32_t LogicalDevice::getGraphicsQueueFamily() const {
 
             return _graphics_queue_id;
@@ -92,6 +107,12 @@ namespace undicht {
             return _transfer_queue_id;
         }
 
+        bool LogicalDevice::hasUniqueTransferQueue() const {
+            /// @return true, if the transfer queue is of a different family than the graphics queue
+
+            return (_transfer_queue_id != -1) && (_transfer_queue_id != _graphics_queue_id);
+        }
+
         const VkQueue& LogicalDevice::getGraphicsQueue() const {
             
             return _graphics_queue;
@@ -127,19 +148,19 @@ namespace undicht {
             VK_ASSERT(vkResetCommandPool(_device, _transfer_cmds, {}));
         }
 
-        void LogicalDevice::submitOnGraphicsQueue(const VkCommandBuffer& cmd, VkFence signal_fen, const std::vector<VkSemaphore>& wait_on, const std::vector<VkPipelineStageFlags>& wait_stages, const std::vector<VkSemaphore>& signal_sem) const {
+        void LogicalDevice::submitOnGraphicsQueue(const VkCommandBuffer& cmd, VkFence signal_fen, ArrayView<VkSemaphore> wait_on, ArrayView<VkPipelineStageFlags> wait_stages, ArrayView<VkSemaphore> signal_sem) const {
 
             VkSubmitInfo info = createSubmitInfo(cmd, wait_on, wait_stages, signal_sem);
             VK_ASSERT(vkQueueSubmit(_graphics_queue, 1, &info, signal_fen));
         }
 
-        void LogicalDevice::submitOnTransferQueue(const VkCommandBuffer& cmd, VkFence signal_fen, const std::vector<VkSemaphore>& wait_on, const std::vector<VkPipelineStageFlags>& wait_stages, const std::vector<VkSemaphore>& signal_sem) const {
+        void LogicalDevice::submitOnTransferQueue(const VkCommandBuffer& cmd, VkFence signal_fen, ArrayView<VkSemaphore> wait_on, ArrayView<VkPipelineStageFlags> wait_stages, ArrayView<VkSemaphore> signal_sem) const {
 
             VkSubmitInfo info = createSubmitInfo(cmd, wait_on, wait_stages, signal_sem);
             VK_ASSERT(vkQueueSubmit(_transfer_queue, 1, &info, signal_fen));
         }
 
-        void LogicalDevice::presentOnPresentQueue(const VkSwapchainKHR& swap_chain, uint32_t image_index, const std::vector<VkSemaphore>& wait_on) {
+        void LogicalDevice::presentOnPresentQueue(const VkSwapchainKHR& swap_chain, uint32_t image_index, ArrayView<VkSemaphore> wait_on) {
 
             VkPresentInfoKHR info = createPresentInfo(swap_chain, image_index, wait_on);
             VK_CHECK(vkQueuePresentKHR(_present_queue, &info));
@@ -213,9 +234,9 @@ namespace undicht {
                         continue;
                     }
 
+                    return i;
                 }
 
-                return i;
             }
             
             UND_WARNING << "failed to find a unique transfer queue\n";
@@ -238,12 +259,18 @@ namespace undicht {
             std::vector<const char*> extensions = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
             // specifying the features the device is going to use
-            VkPhysicalDeviceFeatures features{};
-            features.samplerAnisotropy = VK_TRUE;
-            features.fillModeNonSolid = VK_TRUE;
+            VkPhysicalDeviceFeatures supported_features{};
+            vkGetPhysicalDeviceFeatures(_physical_device, &supported_features);
+
+            _enabled_features = {};
+            _enabled_features.samplerAnisotropy = VK_TRUE;
+            _enabled_features.fillModeNonSolid = VK_TRUE;
+            _enabled_features.pipelineStatisticsQuery = supported_features.pipelineStatisticsQuery; // optional
+            _enabled_features.textureCompressionBC = supported_features.textureCompressionBC; // optional, textures get uploaded uncompressed without it
+            _enabled_features.shaderStorageImageWriteWithoutFormat = supported_features.shaderStorageImageWriteWithoutFormat; // optional, mip maps get generated by blits without it
 
             // creating the logical device
-            VkDeviceCreateInfo info = createDeviceCreateInfo(queue_create_infos, extensions, features);
+            VkDeviceCreateInfo info = createDeviceCreateInfo(queue_create_infos, extensions, _enabled_features);
             VK_ASSERT(vkCreateDevice(_physical_device, &info, {}, &_device));
 
             // creating the queue handles
@@ -302,7 +329,7 @@ namespace undicht {
             return info;
         }
 
-        VkSubmitInfo LogicalDevice::createSubmitInfo(const VkCommandBuffer& cmd, const std::vector<VkSemaphore>& wait_on, const std::vector<VkPipelineStageFlags>& wait_stages, const std::vector<VkSemaphore>& signal) {
+        VkSubmitInfo LogicalDevice::createSubmitInfo(const VkCommandBuffer& cmd, ArrayView<VkSemaphore> wait_on, ArrayView<VkPipelineStageFlags> wait_stages, ArrayView<VkSemaphore> signal) {
 
             VkSubmitInfo info{};
             info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
@@ -318,7 +345,7 @@ namespace undicht {
             return info;
         }
 
-        VkPresentInfoKHR LogicalDevice::createPresentInfo(const VkSwapchainKHR& swap_chain, const uint32_t& image_index, const std::vector<VkSemaphore>& wait_on) {
+        VkPresentInfoKHR LogicalDevice::createPresentInfo(const VkSwapchainKHR& swap_chain, const uint32_t& image_index, ArrayView<VkSemaphore> wait_on) {
 
             VkPresentInfoKHR info{};
             info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -5,6 +5,8 @@
 #include "string"
 #include "vulkan/vulkan.h"
 
+#include "array_view.h"
+
 namespace undicht {
 
     namespace vulkan {
@@ -30,6 +32,8 @@ namespace undicht {
             VkCommandPool _graphics_cmds;
             VkCommandPool _transfer_cmds;
 
+            VkPhysicalDeviceFeatures _enabled_features;
+
         public:
 
             void init(const VkPhysicalDevice& physical_device, const VkSurfaceKHR& surface);
@@ -43,10 +47,19 @@ namespace undicht {
             const VkDevice& getDevice() const;
             const VkPhysicalDevice& getPhysicalDevice() const;
 
+            /// @return true, if images with the format (and optimal tiling) support all of the features
+            bool supportsFormat(VkFormat format, VkFormatFeatureFlags features) const;
+
+            /// @return the features that were enabled when creating the device (optional features may be VK_FALSE)
+            const VkPhysicalDeviceFeatures& getEnabledFeatures() const;
+
             uint32_t getGraphicsQueueFamily() const;
             uint32_t getPresentQueueFamily() const;
             uint32_t getTransferQueueFamily() const;
 
+            /// @return true, if the transfer queue is of a different family than the graphics queue
+            bool hasUniqueTransferQueue() const;
+
             const VkQueue& getGraphicsQueue() const;
             const VkQueue& getPresentQueue() const;
             const VkQueue& getTransferQueue() const;
@@ -57,10 +70,10 @@ namespace undicht {
             void resetGraphicsCmdPool();
             void resetTransferCmdPool();
 
-            void submitOnGraphicsQueue(const VkCommandBuffer& cmd, VkFence signal_fen = VK_NULL_HANDLE, const std::vector<VkSemaphore>& wait_on = {}, const std::vector<VkPipelineStageFlags>& wait_stages = {}, const std::vector<VkSemaphore>& signal_sem = {}) const;
-            void submitOnTransferQueue(const VkCommandBuffer& cmd, VkFence signal_fen = VK_NULL_HANDLE, const std::vector<VkSemaphore>& wait_on = {}, const std::vector<VkPipelineStageFlags>& wait_stages = {}, const std::vector<VkSemaphore>& signal_sem = {}) const;
+            void submitOnGraphicsQueue(const VkCommandBuffer& cmd, VkFence signal_fen = VK_NULL_HANDLE, ArrayView<VkSemaphore> wait_on = {}, ArrayView<VkPipelineStageFlags> wait_stages = {}, ArrayView<VkSemaphore> signal_sem = {}) const;
+            void submitOnTransferQueue(const VkCommandBuffer& cmd, VkFence signal_fen = VK_NULL_HANDLE, ArrayView<VkSemaphore> wait_on = {}, ArrayView<VkPipelineStageFlags> wait_stages = {}, ArrayView<VkSemaphore> signal_sem = {}) const;
 
-            void presentOnPresentQueue(const VkSwapchainKHR& swap_chain, uint32_t image_index, const std::vector<VkSemaphore>& wait_on = {});
+            void presentOnPresentQueue(const VkSwapchainKHR& swap_chain, uint32_t image_index, ArrayView<VkSemaphore> wait_on = {});
 
             uint32_t findMemory(VkMemoryType mem_type) const;
 
@@ -92,8 +105,8 @@ namespace undicht {
             VkDeviceCreateInfo static createDeviceCreateInfo(const std::vector<VkDeviceQueueCreateInfo>& queue_infos, const std::vector<const char*>& extensions, const VkPhysicalDeviceFeatures& features);
             VkDeviceQueueCreateInfo static createQueueCreateInfo(unsigned queue_family, float& priority);
             VkCommandPoolCreateInfo static createCommandPoolCreateInfo(unsigned queue_family);
-            VkSubmitInfo static createSubmitInfo(const VkCommandBuffer& cmd, const std::vector<VkSemaphore>& wait_on, const std::vector<VkPipelineStageFlags>& wait_stages, const std::vector<VkSemaphore>& signal);
-            VkPresentInfoKHR static createPresentInfo(const VkSwapchainKHR& swap_chain, const uint32_t& image_index, const std::vector<VkSemaphore>& wait_on);
+            VkSubmitInfo static createSubmitInfo(const VkCommandBuffer& cmd, ArrayView<VkSemaphore> wait_on, ArrayView<VkPipelineStageFlags> wait_stages, ArrayView<VkSemaphore> signal);
+            VkPresentInfoKHR static createPresentInfo(const VkSwapchainKHR& swap_chain, const uint32_t& image_index, ArrayView<VkSemaphore> wait_on);
 
         };
 
@@ -101,6 +101,18 @@ namespace undicht {
             _descriptor_set_layouts.at(slot) = layout;
         }
 
+        void Pipeline::setPushConstants(VkShaderStageFlags stages, uint32_t byte_size) {
+            /** @brief push constants are small amounts of data (at least 128 bytes) that get recorded directly into the command buffer
+             * (see CommandBuffer::pushConstants()), useful for data that changes with every draw / dispatch */
+
+            VkPushConstantRange range{};
+            range.stageFlags = stages;
+            range.offset = 0;
+            range.size = byte_size;
+
+            _push_constant_ranges = {range};
+        }
+
         void Pipeline::setDepthStencilState(bool enable_depth_test, bool write_depth_values, VkCompareOp compare_op, bool enable_stencil_test) {
             /** @brief enable or disable depth testing and stencil testing */
 
@@ -118,7 +130,7 @@ namespace undicht {
             _color_blend_state = createPipelineColorBlendStateCreateInfo(_blend_attachments);
 
             // creating the pipeline layout
-            VkPipelineLayoutCreateInfo layout_info = createPipelineLayoutCreateInfo(_descriptor_set_layouts);
+            VkPipelineLayoutCreateInfo layout_info = createPipelineLayoutCreateInfo(_descriptor_set_layouts, _push_constant_ranges);
             vkCreatePipelineLayout(device, &layout_info, {}, &_layout);
 
             // joining all pipeline info structs
@@ -144,6 +156,32 @@ namespace undicht {
 
         }
 
+        void Pipeline::initCompute(const VkDevice& device) {
+            /** @brief creates a compute pipeline (instead of a graphics pipeline)
+             * only the compute shader module, the shader input and the push constants need to be configured */
+
+            _device_handle = device;
+
+            if(_shader_stages.size() != 1) {
+                UND_ERROR << "a compute pipeline needs exactly one (compute) shader module\n";
+                return;
+            }
+
+            // creating the pipeline layout
+            VkPipelineLayoutCreateInfo layout_info = createPipelineLayoutCreateInfo(_descriptor_set_layouts, _push_constant_ranges);
+            vkCreatePipelineLayout(device, &layout_info, {}, &_layout);
+
+            VkComputePipelineCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+            info.pNext = nullptr;
+            info.stage = _shader_stages.at(0);
+            info.layout = _layout;
+            info.basePipelineHandle = VK_NULL_HANDLE;
+
+            VK_ASSERT(vkCreateComputePipelines(device, VK_NULL_HANDLE, 1, &info, {}, &_pipeline));
+
+        }
+
         void Pipeline::cleanUp() {
 
             vkDestroyPipelineLayout(_device_handle, _layout, {});
@@ -353,14 +391,14 @@ namespace undicht {
             return depth_stencil;
         }
 
-        VkPipelineLayoutCreateInfo Pipeline::createPipelineLayoutCreateInfo(const std::vector<VkDescriptorSetLayout>& layouts) {
+        VkPipelineLayoutCreateInfo Pipeline::createPipelineLayoutCreateInfo(const std::vector<VkDescriptorSetLayout>& layouts, const std::vector<VkPushConstantRange>& push_constant_ranges) {
 
             VkPipelineLayoutCreateInfo info{};
             info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
             info.pNext = nullptr;
             info.flags = 0;
-            info.pushConstantRangeCount = 0;
-            info.pPushConstantRanges = nullptr;
+            info.pushConstantRangeCount = push_constant_ranges.size();
+            info.pPushConstantRanges = push_constant_ranges.data();
             info.setLayoutCount = layouts.size();
             info.pSetLayouts = layouts.data();
 
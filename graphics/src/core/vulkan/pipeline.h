@@ -38,6 +38,7 @@ namespace undicht {
             VkPipelineDepthStencilStateCreateInfo _depth_stencil_state;            
             VkPipelineLayout _layout; // contains info about the input to the shaders (ubo and texture bindings, push constants)
             std::vector<VkDescriptorSetLayout> _descriptor_set_layouts;
+            std::vector<VkPushConstantRange> _push_constant_ranges;
         
           public:
             // functions to configure the pipeline (has to be completly done before init is called)
@@ -86,6 +87,10 @@ namespace undicht {
              * @param slot there can be more than one descriptor set for a shader, each set can be accessed via its slot id */
             void setShaderInput(const VkDescriptorSetLayout& layout, uint32_t slot = 0);
 
+            /** @brief push constants are small amounts of data (at least 128 bytes) that get recorded directly into the command buffer
+             * (see CommandBuffer::pushConstants()), useful for data that changes with every draw / dispatch */
+            void setPushConstants(VkShaderStageFlags stages, uint32_t byte_size);
+
             /** @brief enable or disable depth testing and stencil testing */
             void setDepthStencilState(bool enable_depth_test, bool write_depth_values = true, VkCompareOp compare_op = VK_COMPARE_OP_LESS, bool enable_stencil_test = false);
 
@@ -94,6 +99,10 @@ namespace undicht {
             // init / cleanup
 
             void init(const VkDevice& device, VkRenderPass render_pass, uint32_t subpass = 0);
+
+            /** @brief creates a compute pipeline (instead of a graphics pipeline)
+             * only the compute shader module, the shader input and the push constants need to be configured */
+            void initCompute(const VkDevice& device);
             void cleanUp();
 
             const VkViewport& getViewport() const;
@@ -117,7 +126,7 @@ namespace undicht {
             VkPipelineColorBlendAttachmentState static createPipelineColorBlendAttachmentState(bool enable_blending, VkBlendOp color_blend_op, VkBlendFactor src_color_factor, VkBlendFactor dst_color_factor, VkBlendOp alpha_blend_op, VkBlendFactor src_alpha_factor, VkBlendFactor dst_alpha_factor);
             VkPipelineColorBlendStateCreateInfo static createPipelineColorBlendStateCreateInfo(const std::vector<VkPipelineColorBlendAttachmentState>& blend_attachments);
             VkPipelineDepthStencilStateCreateInfo static createPipelineDepthStencilStateCreateInfo(bool depth_test, bool write_depth_values, VkCompareOp compare_op, bool enable_stencil_test);
-            VkPipelineLayoutCreateInfo static createPipelineLayoutCreateInfo(const std::vector<VkDescriptorSetLayout>& layouts = {});
+            VkPipelineLayoutCreateInfo static createPipelineLayoutCreateInfo(const std::vector<VkDescriptorSetLayout>& layouts = {}, const std::vector<VkPushConstantRange>& push_constant_ranges = {});
 
         };
 
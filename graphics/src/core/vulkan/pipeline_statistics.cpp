@@ -0,0 +1,126 @@
+#include "pipeline_statistics.h"
+#include "command_buffer.h"
+#include "debug.h"
+#include "profiler.h"
+
+namespace undicht {
+
+    namespace vulkan {
+
+        // the order of the values in the results follows the order of the bits
+        const VkQueryPipelineStatisticFlags STATISTICS =
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+            VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+        void PipelineStatistics::init(const LogicalDevice& device, uint32_t frames_in_flight) {
+
+            _is_supported = device.getEnabledFeatures().pipelineStatisticsQuery;
+
+            if(!_is_supported) {
+                UND_WARNING << "the device does not support pipeline statistics queries, they wont be available\n";
+                return;
+            }
+
+            _query_pools.resize(frames_in_flight);
+            _frame_recorded.assign(frames_in_flight, false);
+
+            for(QueryPool& pool : _query_pools)
+                pool.init(device.getDevice(), VK_QUERY_TYPE_PIPELINE_STATISTICS, 1, STATISTICS);
+
+            _values.reserve(_query_pools.at(0).getValuesPerQuery());
+
+        }
+
+        void PipelineStatistics::cleanUp() {
+
+            for(QueryPool& pool : _query_pools)
+                pool.cleanUp();
+
+            _query_pools.clear();
+
+        }
+
+        void PipelineStatistics::beginFrame(CommandBuffer& cmd) {
+            /** @brief reads the results of the frame that used the next query pool and resets the pool
+             * call once per frame on the command buffer that gets executed first in the frame */
+
+            if(!_is_supported) return;
+
+            _frame = (_frame + 1) % _query_pools.size();
+
+            if(_frame_recorded.at(_frame))
+                resolveFrame(_frame);
+
+            cmd.resetQueryPool(_query_pools.at(_frame).getQueryPool(), 0, 1);
+            _frame_recorded.at(_frame) = false;
+            _is_reset = true;
+
+        }
+
+        void PipelineStatistics::begin(CommandBuffer& cmd) {
+            /// @brief starts / ends counting (can be done once per frame, begin() and end() have to be recorded into the same command buffer)
+
+            if(!_is_supported || _is_active || !_is_reset) return;
+
+            cmd.beginQuery(_query_pools.at(_frame).getQueryPool(), 0);
+            _is_reset = false;
+            _is_active = true;
+
+        }
+
+        void PipelineStatistics::end(CommandBuffer& cmd) {
+
+            if(!_is_active) return;
+
+            cmd.endQuery(_query_pools.at(_frame).getQueryPool(), 0);
+            _frame_recorded.at(_frame) = true;
+            _is_active = false;
+
+        }
+
+        bool PipelineStatistics::isSupported() const {
+
+            return _is_supported;
+        }
+
+        uint32_t PipelineStatistics::getFramesInFlight() const {
+
+            return _query_pools.size();
+        }
+
+        const PipelineStatistics::Results& PipelineStatistics::getResults() const {
+            /// @return the results of the latest frame that were read back
+
+            return _results;
+        }
+
+        ////////////////////////////////////// non public functions //////////////////////////////////////
+
+        void PipelineStatistics::resolveFrame(uint32_t frame) {
+
+            // not waiting for the results, if they are not available the frame gets skipped
+            if(!_query_pools.at(frame).getResults(0, 1, _values)) return;
+
+            _results._input_assembly_vertices = _values.at(0);
+            _results._input_assembly_primitives = _values.at(1);
+            _results._vertex_shader_invocations = _values.at(2);
+            _results._clipping_invocations = _values.at(3);
+            _results._clipping_primitives = _values.at(4);
+            _results._fragment_shader_invocations = _values.at(5);
+
+            Profiler::recordCounter("gpu input assembly vertices", _results._input_assembly_vertices);
+            Profiler::recordCounter("gpu input assembly primitives", _results._input_assembly_primitives);
+            Profiler::recordCounter("gpu vertex shader invocations", _results._vertex_shader_invocations);
+            Profiler::recordCounter("gpu clipping invocations", _results._clipping_invocations);
+            Profiler::recordCounter("gpu clipping primitives", _results._clipping_primitives);
+            Profiler::recordCounter("gpu fragment shader invocations", _results._fragment_shader_invocations);
+
+        }
+
+    } // vulkan
+
+} // undicht
@@ -0,0 +1,79 @@
+#ifndef PIPELINE_STATISTICS_H
+#define PIPELINE_STATISTICS_H
+
+#include "vector"
+#include "cstdint"
+#include "vulkan/vulkan.h"
+
+#include "logical_device.h"
+#include "query_pool.h"
+
+namespace undicht {
+
+    namespace vulkan {
+
+        class CommandBuffer;
+
+        class PipelineStatistics {
+            /** counts the work the gpu did while executing a section of a command buffer (using a pipeline statistics query)
+             * i.e. how many vertices were processed or how many fragments were shaded
+             * like the GpuTimer, the results of a frame are read back (without waiting) getFramesInFlight() frames later
+             * and recorded as counters into the Profiler
+             * only available if the pipelineStatisticsQuery feature is enabled on the device */
+        public:
+
+            struct Results {
+                uint64_t _input_assembly_vertices = 0;
+                uint64_t _input_assembly_primitives = 0;
+                uint64_t _vertex_shader_invocations = 0;
+                uint64_t _clipping_invocations = 0;
+                uint64_t _clipping_primitives = 0;
+                uint64_t _fragment_shader_invocations = 0;
+            };
+
+        protected:
+
+            bool _is_supported = false;
+
+            // one query pool per frame in flight
+            uint32_t _frame = 0;
+            std::vector<QueryPool> _query_pools;
+            std::vector<bool> _frame_recorded;
+            bool _is_reset = false; // the query of the current frame can only be used once after it was reset
+            bool _is_active = false;
+
+            std::vector<uint64_t> _values;
+            Results _results; // the results of the latest frame that were available
+
+        public:
+
+            void init(const LogicalDevice& device, uint32_t frames_in_flight = 3);
+            void cleanUp();
+
+            /** @brief reads the results of the frame that used the next query pool and resets the pool
+             * call once per frame on the command buffer that gets executed first in the frame */
+            void beginFrame(CommandBuffer& cmd);
+
+            /// @brief starts / ends counting (can be done once per frame, begin() and end() have to be recorded into the same command buffer)
+            void begin(CommandBuffer& cmd);
+            void end(CommandBuffer& cmd);
+
+            /// @return false, if the device doesnt support pipeline statistics queries
+            bool isSupported() const;
+            uint32_t getFramesInFlight() const;
+
+            /// @return the results of the latest frame that were read back
+            const Results& getResults() const;
+
+        protected:
+            // non public functions
+
+            void resolveFrame(uint32_t frame);
+
+        };
+
+    } // vulkan
+
+} // undicht
+
+#endif // PIPELINE_STATISTICS_H
@@ -0,0 +1,84 @@
+#include "query_pool.h"
+#include "vk_debug.h"
+
+namespace undicht {
+
+    namespace vulkan {
+
+        void QueryPool::init(const VkDevice& device, VkQueryType type, uint32_t query_count, VkQueryPipelineStatisticFlags pipeline_statistics) {
+            /** @param pipeline_statistics only used with VK_QUERY_TYPE_PIPELINE_STATISTICS,
+             * every statistic enabled will add one value to the results of the query */
+
+            _device_handle = device;
+            _type = type;
+            _query_count = query_count;
+
+            // counting the values written by each query
+            _values_per_query = 1;
+            if(type == VK_QUERY_TYPE_PIPELINE_STATISTICS) {
+                _values_per_query = 0;
+                for(uint32_t i = 0; i < 32; i++)
+                    if(pipeline_statistics & (1u << i)) _values_per_query++;
+            }
+
+            VkQueryPoolCreateInfo info = createQueryPoolCreateInfo(type, query_count, pipeline_statistics);
+            VK_ASSERT(vkCreateQueryPool(device, &info, {}, &_query_pool));
+
+        }
+
+        void QueryPool::cleanUp() {
+
+            vkDestroyQueryPool(_device_handle, _query_pool, {});
+        }
+
+        bool QueryPool::getResults(uint32_t first_query, uint32_t query_count, std::vector<uint64_t>& results) const {
+            /** @brief reads the results of the queries (without waiting for them)
+             * @param results will contain getValuesPerQuery() 64 bit values per query
+             * @return false, if not all of the results were available */
+
+            results.resize(query_count * _values_per_query);
+
+            if(!query_count) return true;
+
+            VkResult result = vkGetQueryPoolResults(_device_handle, _query_pool, first_query, query_count, results.size() * sizeof(uint64_t), results.data(), _values_per_query * sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+            return result == VK_SUCCESS;
+        }
+
+        const VkQueryPool& QueryPool::getQueryPool() const {
+
+            return _query_pool;
+        }
+
+        VkQueryType QueryPool::getType() const {
+
+            return _type;
+        }
+
+        uint32_t QueryPool::getQueryCount() const {
+
+            return _query_count;
+        }
+
+        uint32_t QueryPool::getValuesPerQuery() const {
+
+            return _values_per_query;
+        }
+
+        ///////////////////////////// creating query pool related structs /////////////////////////////
+
+        VkQueryPoolCreateInfo QueryPool::createQueryPoolCreateInfo(VkQueryType type, uint32_t query_count, VkQueryPipelineStatisticFlags pipeline_statistics) {
+
+            VkQueryPoolCreateInfo info{};
+            info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+            info.pNext = nullptr;
+            info.queryType = type;
+            info.queryCount = query_count;
+            info.pipelineStatistics = pipeline_statistics;
+
+            return info;
+        }
+
+    } // vulkan
+
+} // undicht
@@ -0,0 +1,53 @@
+#ifndef QUERY_POOL_H
+#define QUERY_POOL_H
+
+#include "vector"
+#include "cstdint"
+#include "vulkan/vulkan.h"
+
+namespace undicht {
+
+    namespace vulkan {
+
+        class QueryPool {
+            /** queries can be used to get information from the gpu about the execution of commands
+             * (i.e. timestamps or pipeline statistics)
+             * the results become available once the commands writing them finished executing */
+        protected:
+
+            VkDevice _device_handle;
+
+            VkQueryPool _query_pool;
+            VkQueryType _type;
+            uint32_t _query_count = 0;
+            uint32_t _values_per_query = 1;
+
+        public:
+
+            /** @param pipeline_statistics only used with VK_QUERY_TYPE_PIPELINE_STATISTICS,
+             * every statistic enabled will add one value to the results of the query */
+            void init(const VkDevice& device, VkQueryType type, uint32_t query_count, VkQueryPipelineStatisticFlags pipeline_statistics = 0);
+            void cleanUp();
+
+            /** @brief reads the results of the queries (without waiting for them)
+             * @param results will contain getValuesPerQuery() 64 bit values per query
+             * @return false, if not all of the results were available */
+            bool getResults(uint32_t first_query, uint32_t query_count, std::vector<uint64_t>& results) const;
+
+            const VkQueryPool& getQueryPool() const;
+            VkQueryType getType() const;
+            uint32_t getQueryCount() const;
+            uint32_t getValuesPerQuery() const;
+
+        protected:
+            // creating query pool related structs
+
+            VkQueryPoolCreateInfo static createQueryPoolCreateInfo(VkQueryType type, uint32_t query_count, VkQueryPipelineStatisticFlags pipeline_statistics);
+
+        };
+
+    } // vulkan
+
+} // undicht
+
+#endif // QUERY_POOL_H
@@ -23,6 +23,7 @@
 			VkResult err = x;                                          		\
 			if (err) {                                                  	\
 				UND_ERROR << "Vulkan: " << string_VkResult(err) << "\n";	\
+				undicht::Logger::flush();                               	\
 				abort();                                                	\
 			}																\
 		}                                                           
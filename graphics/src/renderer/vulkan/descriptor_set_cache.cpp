@@ -1,6 +1,7 @@
 #include "descriptor_set_cache.h"
 
 #include "array"
+#include "debug.h"
 
 namespace undicht {
 
@@ -9,8 +10,10 @@ namespace undicht {
         void DescriptorSetCache::init(const VkDevice& device, const DescriptorSetLayout& layout, uint32_t pool_size) {
 
             _layout_handle = layout.getLayout();
+            _descriptor_types = layout.getDescriptorTypes();
+            _pool_size = pool_size;
             
-            DescriptorPool::init(device, layout.getDescriptorTypes(), pool_size);
+            DescriptorPool::init(device, _descriptor_types, pool_size);
         }
 
         void DescriptorSetCache::cleanUp() {
@@ -18,6 +21,14 @@ namespace undicht {
             for(DescriptorSet& set : _allocated_sets) 
                 set.cleanUp();
 
+            for(DescriptorPool& pool : _overflow_pools)
+                pool.cleanUp();
+
+            _allocated_sets.clear();
+            _sets_in_use.clear();
+            _unused_sets.clear();
+            _overflow_pools.clear();
+
             DescriptorPool::cleanUp();
         }
 
@@ -38,9 +49,18 @@ namespace undicht {
                 return _allocated_sets.at(set);
             }
 
-            // creating a new descriptor set
+            // creating a new descriptor set (from the most recently created pool)
             DescriptorSet new_set;
-            new_set.init(_device_handle, getDescriptorPool(), _layout_handle);
+            const VkDescriptorPool& pool = _overflow_pools.size() ? _overflow_pools.back().getDescriptorPool() : getDescriptorPool();
+
+            if(!new_set.init(_device_handle, pool, _layout_handle)) {
+                // the pool is full, continuing with a new one
+                _overflow_pools.emplace_back();
+                _overflow_pools.back().init(_device_handle, _descriptor_types, _pool_size);
+
+                if(!new_set.init(_device_handle, _overflow_pools.back().getDescriptorPool(), _layout_handle))
+                    UND_ERROR << "failed to allocate a descriptor set\n";
+            }
             
             _allocated_sets.push_back(new_set);
             uint32_t id = _allocated_sets.size() - 1;
@@ -66,6 +86,24 @@ namespace undicht {
 
         }
 
+        void DescriptorSetCache::release(const DescriptorSet& set, uint32_t group) {
+            /// tells the cache that a single descriptor set of the group is no longer in use
+            /// (before calling this function, make sure that the descriptor set actually isnt used anymore)
+
+            if(group >= _sets_in_use.size()) return;
+
+            std::vector<uint32_t>& sets_in_use = _sets_in_use.at(group);
+            for(int i = 0; i < sets_in_use.size(); i++) {
+
+                if(_allocated_sets.at(sets_in_use.at(i)).getDescriptorSet() != set.getDescriptorSet()) continue;
+
+                _unused_sets.push_back(sets_in_use.at(i));
+                sets_in_use.erase(sets_in_use.begin() + i);
+                return;
+            }
+
+        }
+
     } // vulkan
 
 } // undicht
\ No newline at end of file
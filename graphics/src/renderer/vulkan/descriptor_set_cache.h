@@ -17,10 +17,14 @@ namespace undicht {
             /// a class that should make using descriptor sets a little easier
             /// the class keeps track of the allocated descriptor sets
             /// so that they can be reused once their previous job is finished
+            /// when the pool runs out of sets, another pool of the same size gets created
 
           protected:
 
             VkDescriptorSetLayout _layout_handle;
+            std::vector<VkDescriptorType> _descriptor_types;
+            uint32_t _pool_size = 0;
+            std::vector<DescriptorPool> _overflow_pools; // created when the previous pools were full
 
             std::vector<DescriptorSet> _allocated_sets;
             std::vector<std::vector<uint32_t>> _sets_in_use; // divided into "groups"
@@ -40,6 +44,10 @@ namespace undicht {
             /// (before calling this function, make sure that the descriptor sets actually arent used anymore)
             void reset(uint32_t group = 0);
 
+            /// tells the cache that a single descriptor set of the group is no longer in use
+            /// (before calling this function, make sure that the descriptor set actually isnt used anymore)
+            void release(const DescriptorSet& set, uint32_t group = 0);
+
         };
 
     } // vulkan
@@ -1,10 +1,17 @@
 #include "transfer_buffer.h"
 #include "debug.h"
+#include "core/vulkan/gpu_timer.h"
+
+#include "algorithm"
 
 namespace undicht {
 
     namespace vulkan {
 
+        // data that doesnt fit into the transfer buffer is split into chunks of at least this size
+        const uint32_t MIN_CHUNK_SIZE = 65536;
+        const uint32_t IMAGE_DATA_ALIGNMENT = 16;
+
         void TransferBuffer::init(vma::VulkanMemoryAllocator& allocator, const std::vector<uint32_t>& queue_ids, uint32_t byte_size) {
 
             VkBufferUsageFlags buffer_usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
@@ -18,52 +25,177 @@ namespace undicht {
             
             reset();
             Buffer::cleanUp();
+            disableFlushing();
+
+        }
+
+        void TransferBuffer::enableFlushing(const LogicalDevice& device) {
+            /// @brief when the transfer buffer is full, the staged transfers get submitted on the graphics queue of the device
+            /// (waiting for them to finish) so that the memory can be reused
+
+            if(_flush_device) return;
+
+            _flush_device = &device;
+            _flush_cmd.init(device.getDevice(), device.getGraphicsCmdPool());
+            _flush_fence.init(device.getDevice(), false);
+        }
+
+        void TransferBuffer::disableFlushing() {
+            /// @brief data that doesnt fit into the transfer buffer gets rejected again (i.e. after loading, so that frames never wait for the gpu)
+
+            if(!_flush_device) return;
+
+            _flush_cmd.cleanUp();
+            _flush_fence.cleanUp();
+            _flush_device = nullptr;
+        }
+
+        void TransferBuffer::flush() {
+            /// @brief records and submits the staged transfers, waits for them to finish and resets the transfer buffer
+            /// (only possible if flushing is enabled)
+
+            if(!_flush_device) {
+                UND_ERROR << "Failed to flush the transfer buffer: flushing is not enabled\n";
+                return;
+            }
+
+            if(_buffer_copies.empty() && _image_copies.empty()) return;
+
+            _flush_cmd.beginCommandBuffer(true);
+            completeTransfers(_flush_cmd);
+            _flush_cmd.endCommandBuffer();
+
+            _flush_device->submitOnGraphicsQueue(_flush_cmd.getCommandBuffer(), _flush_fence.getFence());
+            _flush_fence.waitForProcessToFinish();
+            _flush_cmd.resetCommandBuffer();
+
+            reset();
+            _flush_count++;
+        }
+
+        uint32_t TransferBuffer::getFlushCount() const {
+            /// @return how often the transfer buffer was flushed
+
+            return _flush_count;
+        }
+
+        uint32_t TransferBuffer::getFreeSize() const {
+            /// @return how many bytes can be staged before the transfer buffer is full (and has to be flushed)
+
+            return getAllocatedSize() - _bytes_stored;
         }
 
         void TransferBuffer::stageForTransfer(VkBuffer dst, uint32_t byte_size, uint32_t offset, const uint8_t* data) {
             /// stores the data in the transfer buffer and creates the info structs necessary to
             /// tell vulkan to copy the data into the destination buffer / image
+            /// data that doesnt fit gets split into multiple copies (flushing the transfer buffer in between)
 
-            if(getAllocatedSize() < (_bytes_stored + byte_size)) {
-                UND_ERROR << "Failed to store Data in transfer buffer: not enough memory allocated\n";
-                return;
+            while(byte_size) {
+
+                uint32_t chunk_size = reserve(byte_size, std::min(byte_size, MIN_CHUNK_SIZE));
+                if(!chunk_size) {
+                    UND_ERROR << "Failed to store Data in transfer buffer: not enough memory allocated (enable flushing to stream the data)\n";
+                    return;
+                }
+
+                // store the data in the transfer buffer
+                Buffer::setData(chunk_size, _bytes_stored, data);
+
+                // create the necessary structs for the transfer
+                BufferCopyData buffer_copy;
+                buffer_copy._transfer_dst = dst;
+                buffer_copy._buffer_copy = Buffer::createBufferCopy(chunk_size, _bytes_stored, offset);
+
+                _buffer_copies.push_back(buffer_copy);
+
+                _bytes_stored += chunk_size;
+                data += chunk_size;
+                offset += chunk_size;
+                byte_size -= chunk_size;
             }
 
-            // store the data in the transfer buffer
-            Buffer::setData(byte_size, _bytes_stored, data);
+        }
+
+        uint8_t* TransferBuffer::reserveForTransfer(VkBuffer dst, uint32_t byte_size, uint32_t offset) {
+            /** @brief reserves memory in the transfer buffer for data that gets copied to the destination buffer,
+             * so that the data can be written directly into the mapped memory (instead of copying it there)
+             * the data has to be written before anything else gets staged (which might flush the transfer buffer)
+             * @return the reserved memory, nullptr if the data doesnt fit into the transfer buffer at once */
+
+            if(!byte_size) return nullptr;
+
+            // the caller can still stream the data with stageForTransfer()
+            if(reserve(byte_size, byte_size) < byte_size) return nullptr;
+
+            uint8_t* reserved_data = (uint8_t*)_allocation_info.pMappedData + _bytes_stored;
 
-            // create the necessary structs for the transfer
             BufferCopyData buffer_copy;
             buffer_copy._transfer_dst = dst;
             buffer_copy._buffer_copy = Buffer::createBufferCopy(byte_size, _bytes_stored, offset);
 
             _buffer_copies.push_back(buffer_copy);
-
             _bytes_stored += byte_size;
 
+            return reserved_data;
         }
 
-        void TransferBuffer::stageForTransfer(VkImage dst, const uint8_t* data,  uint32_t byte_size, VkExtent3D data_extent, VkOffset3D offset, uint32_t layer, uint32_t mip_level, VkImageLayout initial_layout, VkImageLayout final_layout, VkAccessFlags initial_access, VkAccessFlags final_access) {
-            
-            if(getAllocatedSize() < (_bytes_stored + byte_size)) {
-                UND_ERROR << "Failed to store Data in transfer buffer: not enough memory allocated\n";
-                return;
-            }
+        void TransferBuffer::stageForTransfer(VkImage dst, const uint8_t* data,  uint32_t byte_size, VkExtent3D data_extent, VkOffset3D offset, uint32_t layer, uint32_t mip_level, VkImageLayout initial_layout, VkImageLayout final_layout, VkAccessFlags initial_access, VkAccessFlags final_access, uint32_t block_height) {
+            // 2D images that dont fit get split into chunks of rows (flushing the transfer buffer in between)
+            // only the first chunk transitions the image to the transfer layout, only the last one to the final layout
+            // block_height: texel rows per row of data (4 for block compressed formats)
 
-            // store the data in the transfer buffer
-            Buffer::setData(byte_size, _bytes_stored, data);
+            const uint32_t row_count = (data_extent.depth == 1) ? (data_extent.height + block_height - 1) / block_height : 1;
+            const uint32_t row_size = row_count ? byte_size / row_count : 0;
+            if(!row_size) return;
 
-            // create the necessary structs for the transfer
-            ImageCopyData image_copy;
-            image_copy._transfer_dst = dst;
-            image_copy._image_copy = Image::createBufferImageCopy(data_extent, offset, VK_IMAGE_ASPECT_COLOR_BIT, layer, mip_level, _bytes_stored);
-            image_copy._image_subresource_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, mip_level, 1, layer, 1);
-            image_copy._first_image_memory_barrier = Image::createImageMemoryBarrier(dst, image_copy._image_subresource_range, initial_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, initial_access, VK_ACCESS_TRANSFER_WRITE_BIT);   
-            image_copy._second_image_memory_barrier = Image::createImageMemoryBarrier(dst, image_copy._image_subresource_range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, final_layout, VK_ACCESS_TRANSFER_WRITE_BIT, final_access);
-            
-            _image_copies.push_back(image_copy);
+            // the offset of image data in the transfer buffer has to be a multiple of the texel size
+            _bytes_stored = std::min((_bytes_stored + IMAGE_DATA_ALIGNMENT - 1) & ~(IMAGE_DATA_ALIGNMENT - 1), getAllocatedSize());
 
-            _bytes_stored += byte_size;
+            uint32_t first_row = 0;
+
+            while(first_row < row_count) {
+
+                uint32_t chunk_size = reserve((row_count - first_row) * row_size, row_size);
+                if(!chunk_size) {
+                    UND_ERROR << "Failed to store Data in transfer buffer: not enough memory allocated (enable flushing to stream the data)\n";
+                    return;
+                }
+
+                const uint32_t chunk_rows = chunk_size / row_size;
+                const bool is_first_chunk = (first_row == 0);
+                const bool is_last_chunk = (first_row + chunk_rows == row_count);
+
+                // store the data in the transfer buffer
+                Buffer::setData(chunk_rows * row_size, _bytes_stored, data + size_t(first_row) * row_size);
+
+                VkExtent3D chunk_extent = data_extent;
+                VkOffset3D chunk_offset = offset;
+                if(row_count > 1) {
+                    chunk_extent.height = std::min(chunk_rows * block_height, data_extent.height - first_row * block_height);
+                    chunk_offset.y += first_row * block_height;
+                }
+
+                // create the necessary structs for the transfer
+                ImageCopyData image_copy;
+                image_copy._transfer_dst = dst;
+                image_copy._image_copy = Image::createBufferImageCopy(chunk_extent, chunk_offset, VK_IMAGE_ASPECT_COLOR_BIT, layer, mip_level, _bytes_stored);
+                image_copy._image_subresource_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, mip_level, 1, layer, 1);
+
+                if(is_first_chunk)
+                    image_copy._first_image_memory_barrier = Image::createImageMemoryBarrier(dst, image_copy._image_subresource_range, initial_layout, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, initial_access, VK_ACCESS_TRANSFER_WRITE_BIT);
+                else // no transition (gets skipped by completeTransfers())
+                    image_copy._first_image_memory_barrier = Image::createImageMemoryBarrier(dst, image_copy._image_subresource_range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+                if(is_last_chunk)
+                    image_copy._second_image_memory_barrier = Image::createImageMemoryBarrier(dst, image_copy._image_subresource_range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, final_layout, VK_ACCESS_TRANSFER_WRITE_BIT, final_access);
+                else
+                    image_copy._second_image_memory_barrier = Image::createImageMemoryBarrier(dst, image_copy._image_subresource_range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+
+                _image_copies.push_back(image_copy);
+
+                _bytes_stored += chunk_rows * row_size;
+                first_row += chunk_rows;
+            }
 
         }
 
@@ -72,6 +204,8 @@ namespace undicht {
             /// if the destination is an image, pipeline barriers will be added to get the image in the correct layout
             /// endCommandBuffer() needs to be called on the command buffer before it can be submitted on a queue 
 
+            GpuTimerScope gpu_timer(cmd, "completeTransfers");
+
             for(BufferCopyData& buffer_copy : _buffer_copies) {
 
                 cmd.copy(Buffer::getBuffer(), buffer_copy._transfer_dst, buffer_copy._buffer_copy);
@@ -102,6 +236,32 @@ namespace undicht {
             
         }
 
+        //////////////////////////////// non public TransferBuffer functions ////////////////////////////////
+
+        uint32_t TransferBuffer::reserve(uint32_t byte_size, uint32_t min_byte_size) {
+            /// @return how many of the bytes can be stored now (at least min_byte_size, flushing if necessary), 0 if there is not enough space
+
+            uint32_t free_bytes = getAllocatedSize() - _bytes_stored;
+            if(free_bytes >= byte_size) return byte_size;
+
+            // without flushing, the data has to fit completely
+            if(!_flush_device) return 0;
+
+            // storing as much as possible before flushing
+            if(free_bytes < min_byte_size) {
+                flush();
+                free_bytes = getAllocatedSize() - _bytes_stored;
+            }
+
+            if(free_bytes < min_byte_size) return 0; // the transfer buffer is too small
+
+            // only storing whole multiples of the min size (i.e. rows of an image)
+            uint32_t reserved_bytes = std::min(byte_size, free_bytes);
+            if(min_byte_size) reserved_bytes -= reserved_bytes % min_byte_size;
+
+            return reserved_bytes;
+        }
+
     } // vulkan
 
 } // undicht
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include "core/vulkan/buffer.h"
 #include "core/vulkan/image.h"
 #include "core/vulkan/command_buffer.h"
+#include "core/vulkan/logical_device.h"
+#include "core/vulkan/fence.h"
 
 #include "vector"
 
@@ -12,6 +14,10 @@ namespace undicht {
     namespace vulkan {
 
         class TransferBuffer : public Buffer{
+            /** @brief stages data in host visible memory, so that it can be copied to device local buffers / images
+             * if flushing is enabled, data that doesnt fit into the transfer buffer anymore gets streamed:
+             * the staged transfers get submitted (and waited for) to free up the memory, large uploads are split into chunks
+             * so any amount of data can be uploaded with a small transfer buffer */
           
           protected:
 
@@ -37,15 +43,44 @@ namespace undicht {
 
             uint32_t _bytes_stored = 0;
 
+            // objects used to flush the transfer buffer (only if flushing is enabled)
+            const LogicalDevice* _flush_device = nullptr;
+            CommandBuffer _flush_cmd;
+            Fence _flush_fence;
+            uint32_t _flush_count = 0;
+
           public:
 
             void init(vma::VulkanMemoryAllocator& allocator, const std::vector<uint32_t>& queue_ids, uint32_t byte_size);
             void cleanUp();
 
+            /// @brief when the transfer buffer is full, the staged transfers get submitted on the graphics queue of the device
+            /// (waiting for them to finish) so that the memory can be reused
+            void enableFlushing(const LogicalDevice& device);
+
+            /// @brief data that doesnt fit into the transfer buffer gets rejected again (i.e. after loading, so that frames never wait for the gpu)
+            void disableFlushing();
+
+            /// @brief records and submits the staged transfers, waits for them to finish and resets the transfer buffer
+            /// (only possible if flushing is enabled)
+            void flush();
+
+            /// @return how often the transfer buffer was flushed
+            uint32_t getFlushCount() const;
+
+            /// @return how many bytes can be staged before the transfer buffer is full (and has to be flushed)
+            uint32_t getFreeSize() const;
+
             /// stores the data in the transfer buffer and creates the info structs necessary to
             /// tell vulkan to copy the data into the destination buffer / image
             void stageForTransfer(VkBuffer dst, uint32_t byte_size, uint32_t offset, const uint8_t* data);
-            void stageForTransfer(VkImage dst, const uint8_t* data,  uint32_t byte_size, VkExtent3D data_extent, VkOffset3D offset = {0,0,0}, uint32_t layer = 0, uint32_t mip_level = 0, VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED, VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VkAccessFlags initial_access = VK_ACCESS_NONE, VkAccessFlags final_access = VK_ACCESS_SHADER_READ_BIT);
+            void stageForTransfer(VkImage dst, const uint8_t* data,  uint32_t byte_size, VkExtent3D data_extent, VkOffset3D offset = {0,0,0}, uint32_t layer = 0, uint32_t mip_level = 0, VkImageLayout initial_layout = VK_IMAGE_LAYOUT_UNDEFINED, VkImageLayout final_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VkAccessFlags initial_access = VK_ACCESS_NONE, VkAccessFlags final_access = VK_ACCESS_SHADER_READ_BIT, uint32_t block_height = 1); // block_height: texel rows per row of data (4 for block compressed formats)
+
+            /** @brief reserves memory in the transfer buffer for data that gets copied to the destination buffer,
+             * so that the data can be written directly into the mapped memory (instead of copying it there)
+             * the data has to be written before anything else gets staged (which might flush the transfer buffer)
+             * @return the reserved memory, nullptr if the data doesnt fit into the transfer buffer at once */
+            uint8_t* reserveForTransfer(VkBuffer dst, uint32_t byte_size, uint32_t offset);
 
             /// records the commands needed to copy the data to the buffers / images
             /// if the destination is an image, pipeline barriers will be added to get the image in the correct layout
@@ -56,6 +91,12 @@ namespace undicht {
             /// all the transfers should be completed at this point, as the info structs for transfering the data to buffers / images will be deleted
             void reset();
 
+          protected:
+            // non public TransferBuffer functions
+
+            /// @return how many of the bytes can be stored now (at least min_byte_size, flushing if necessary), 0 if there is not enough space
+            uint32_t reserve(uint32_t byte_size, uint32_t min_byte_size);
+
         };
 
     } // vulkan
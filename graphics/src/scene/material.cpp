@@ -13,12 +13,14 @@ namespace undicht {
             _allocator_handle = allocator;
 
             _descriptor_set = descriptor_cache.allocate();
+            _descriptor_cache = &descriptor_cache;
 
         }
 
         void Material::cleanUp() {
 
-            for(Texture& t : _textures) t.cleanUp();
+            // the textures get cleaned up once the last material using them released them
+            _textures.clear();
 
         }
 
@@ -33,20 +35,29 @@ namespace undicht {
         }
 
         Texture& Material::addTexture(Texture::Type type) {
+            /// @brief creates a new texture that is only used by this material
 
-            _textures.emplace_back(Texture());
-            _textures.back().init(_device_handle, _allocator_handle, type);
+            std::shared_ptr<Texture> texture = TextureCache::createTexture();
+            texture->init(_device_handle, _allocator_handle, type);
 
-            return _textures.back();
+            _textures.push_back({type, texture});
+
+            return *texture;
+        }
+
+        void Material::addTexture(Texture::Type type, const std::shared_ptr<Texture>& texture) {
+            /// @brief uses a texture that may be shared with other materials (i.e. one from a TextureCache)
+
+            _textures.push_back({type, texture});
         }
 
         const Texture* Material::getTexture(Texture::Type type) const {
             /// @return will return nullptr, if the material doesnt have a texture of the requested type
 
-            for(const Texture& t : _textures) {
+            for(const TextureSlot& t : _textures) {
                 
-                if(t.getType() == type) {
-                    return &t;
+                if(t._type == type) {
+                    return t._texture.get();
                 }
             }
 
@@ -64,6 +75,46 @@ namespace undicht {
 
         }
 
+        void Material::genMipMaps(MipMapGenerator& generator) {
+            // adds the textures to the generator, which generates the mip maps of many textures at once
+
+            Texture* diffuse = (Texture*)getTexture(Texture::Type::DIFFUSE);
+
+            if(diffuse && (diffuse->getImage().getImage() != VK_NULL_HANDLE)) {
+                generator.addTexture(*diffuse);
+            }
+
+        }
+
+        void Material::requestTextureResolution(float pixels) {
+            /// @brief passes the size of the material on the screen (in pixels) on to its textures (see Texture::requestResolution())
+
+            for(TextureSlot& t : _textures)
+                t._texture->requestResolution(pixels);
+
+        }
+
+        bool Material::rebindStreamedTextures(vulkan::DescriptorSet& retired_set) {
+            /** @brief binds the new image of a texture that was changed by the TextureStreamer
+             * the descriptor set might still be used by frames in flight, so a new one gets allocated
+             * @param retired_set the previously used descriptor set, which has to be released once the gpu finished using it
+             * @return false, if the bound textures didnt change */
+
+            Texture* diffuse = (Texture*)getTexture(Texture::Type::DIFFUSE);
+
+            if(!diffuse || (diffuse->getImageVersion() == _bound_image_version) || (_sampler_handle == VK_NULL_HANDLE) || !_descriptor_cache)
+                return false;
+
+            retired_set = _descriptor_set;
+            _descriptor_set = _descriptor_cache->allocate();
+
+            _descriptor_set.bindImage(0, diffuse->getImageView().getImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, _sampler_handle);
+            _descriptor_set.update();
+            _bound_image_version = diffuse->getImageVersion();
+
+            return true;
+        }
+
         void Material::updateDescriptorSet(const vulkan::Sampler& sampler) {
             /// @brief should be called after changes to the resources of the material were made
 
@@ -74,6 +125,8 @@ namespace undicht {
                 _descriptor_set.bindImage(0, diffuse->getImageView().getImageView(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, sampler.getSampler());
                 _descriptor_set.update();
 
+                _sampler_handle = sampler.getSampler();
+                _bound_image_version = diffuse->getImageVersion();
             }
 
         }
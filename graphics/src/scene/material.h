@@ -2,10 +2,13 @@
 #define MATERIAL_H
 
 #include "texture.h"
+#include "texture_cache.h"
+#include "mip_map_generator.h"
 #include "core/vulkan/descriptor_set.h"
 #include "renderer/vulkan/descriptor_set_cache.h"
 #include "core/vulkan/sampler.h"
 #include "string"
+#include "memory"
 
 namespace undicht {
 
@@ -18,11 +21,21 @@ namespace undicht {
             vulkan::LogicalDevice _device_handle;
             vma::VulkanMemoryAllocator _allocator_handle;
 
+            struct TextureSlot {
+                Texture::Type _type;
+                std::shared_ptr<Texture> _texture; // may be shared with other materials
+            };
+
             // attributes of the Material
             std::string _name;
-            std::vector<Texture> _textures;
+            std::vector<TextureSlot> _textures;
 
             vulkan::DescriptorSet _descriptor_set;
+            vulkan::DescriptorSetCache* _descriptor_cache = nullptr;
+
+            // the resources bound to the descriptor set (to rebind streamed textures)
+            VkSampler _sampler_handle = VK_NULL_HANDLE;
+            uint32_t _bound_image_version = 0;
 
           public:
 
@@ -32,14 +45,30 @@ namespace undicht {
             void setName(const std::string& name);
             const std::string& getName() const;
 
+            /// @brief creates a new texture that is only used by this material
             Texture& addTexture(Texture::Type type);
 
+            /// @brief uses a texture that may be shared with other materials (i.e. one from a TextureCache)
+            void addTexture(Texture::Type type, const std::shared_ptr<Texture>& texture);
+
             /// @return will return nullptr, if the material doesnt have a texture of the requested type
             const Texture* getTexture(Texture::Type type) const;
 
             // records the commands to generate the mip maps
             void genMipMaps(vulkan::CommandBuffer& cmd);
 
+            // adds the textures to the generator, which generates the mip maps of many textures at once
+            void genMipMaps(MipMapGenerator& generator);
+
+            /// @brief passes the size of the material on the screen (in pixels) on to its textures (see Texture::requestResolution())
+            void requestTextureResolution(float pixels);
+
+            /** @brief binds the new image of a texture that was changed by the TextureStreamer
+             * the descriptor set might still be used by frames in flight, so a new one gets allocated
+             * @param retired_set the previously used descriptor set, which has to be released once the gpu finished using it
+             * @return false, if the bound textures didnt change */
+            bool rebindStreamedTextures(vulkan::DescriptorSet& retired_set);
+
             /// @brief should be called after changes to the resources of the material were made
             void updateDescriptorSet(const vulkan::Sampler& sampler);
 
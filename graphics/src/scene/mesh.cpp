@@ -28,28 +28,46 @@ namespace undicht {
 
         void Mesh::setVertexData(const uint8_t* data, uint32_t byte_size, TransferBuffer& transfer_buffer) {
 
-            // init the vertex buffer
-            VkBufferUsageFlags usage_flags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-            VmaAllocationCreateFlags vma_flags = {};
-            _vertex_buffer.init(_allocator_handle, {_device_handle.getGraphicsQueueFamily()}, byte_size, usage_flags, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, vma_flags);
+            initVertexBuffer(byte_size);
 
             // upload data to the vertex buffer
             transfer_buffer.stageForTransfer(_vertex_buffer.getBuffer(), byte_size, 0, data);
 
         }
 
-        void Mesh::setIndexData(const uint8_t* data, uint32_t byte_size, TransferBuffer& transfer_buffer) {
+        void Mesh::setIndexData(const uint8_t* data, uint32_t byte_size, TransferBuffer& transfer_buffer, VkIndexType index_type) {
 
-            // init the face buffer
-            VkBufferUsageFlags usage_flags = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
-            VmaAllocationCreateFlags vma_flags = {};
-            _index_buffer.init(_allocator_handle, {_device_handle.getGraphicsQueueFamily()}, byte_size, usage_flags, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, vma_flags);
+            initIndexBuffer(byte_size, index_type);
 
             // upload data to the vertex buffer
             transfer_buffer.stageForTransfer(_index_buffer.getBuffer(), byte_size, 0, data);
 
         }
 
+        uint8_t* Mesh::reserveVertexData(uint32_t byte_size, TransferBuffer& transfer_buffer) {
+            /** @brief creates the vertex buffer and reserves the memory for its data in the transfer buffer
+             * @return the memory to write the data to (before anything else gets staged), nullptr if it doesnt fit into the transfer buffer */
+
+            initVertexBuffer(byte_size);
+
+            uint8_t* data = transfer_buffer.reserveForTransfer(_vertex_buffer.getBuffer(), byte_size, 0);
+            if(!data) _vertex_buffer.cleanUp(); // so that setVertexData() can be used instead
+
+            return data;
+        }
+
+        uint8_t* Mesh::reserveIndexData(uint32_t byte_size, TransferBuffer& transfer_buffer, VkIndexType index_type) {
+            /** @brief creates the index buffer and reserves the memory for its data in the transfer buffer
+             * @return the memory to write the data to (before anything else gets staged), nullptr if it doesnt fit into the transfer buffer */
+
+            initIndexBuffer(byte_size, index_type);
+
+            uint8_t* data = transfer_buffer.reserveForTransfer(_index_buffer.getBuffer(), byte_size, 0);
+            if(!data) _index_buffer.cleanUp(); // so that setIndexData() can be used instead
+
+            return data;
+        }
+
         void Mesh::setVertexCount(uint32_t count) {
 
             _vertex_count = count;
@@ -79,6 +97,17 @@ namespace undicht {
             _bones = bones;
         }
 
+        void Mesh::setLODs(const std::vector<LOD>& lods) {
+
+            _lods = lods;
+        }
+
+        void Mesh::setBoundingSphere(const glm::vec3& center, float radius) {
+
+            _bounding_center = center;
+            _bounding_radius = radius;
+        }
+
         bool Mesh::getHasPositions() const {
             
             return _has_positions;
@@ -109,6 +138,31 @@ namespace undicht {
             return _vertex_count;
         }
 
+        VkIndexType Mesh::getIndexType() const {
+
+            return _index_type;
+        }
+
+        uint32_t Mesh::getLODCount() const {
+
+            return _lods.size();
+        }
+
+        const Mesh::LOD& Mesh::getLOD(uint32_t lod) const {
+
+            return _lods.at(lod);
+        }
+
+        const glm::vec3& Mesh::getBoundingCenter() const {
+
+            return _bounding_center;
+        }
+
+        float Mesh::getBoundingRadius() const {
+
+            return _bounding_radius;
+        }
+
         const std::string& Mesh::getName() const {
 
             return _name;
@@ -152,6 +206,33 @@ namespace undicht {
             return _index_buffer;
         }
 
+        ///////////////////////////////////////// non public Mesh functions /////////////////////////////////////////
+
+        std::vector<uint32_t> Mesh::getQueueFamilies() const {
+            // the data might get uploaded on the transfer queue (i.e. by background imports)
+
+            if(_device_handle.hasUniqueTransferQueue())
+                return {_device_handle.getGraphicsQueueFamily(), _device_handle.getTransferQueueFamily()};
+
+            return {_device_handle.getGraphicsQueueFamily()};
+        }
+
+        void Mesh::initVertexBuffer(uint32_t byte_size) {
+
+            VkBufferUsageFlags usage_flags = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            VmaAllocationCreateFlags vma_flags = {};
+            _vertex_buffer.init(_allocator_handle, getQueueFamilies(), byte_size, usage_flags, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, vma_flags);
+        }
+
+        void Mesh::initIndexBuffer(uint32_t byte_size, VkIndexType index_type) {
+
+            _index_type = index_type;
+
+            VkBufferUsageFlags usage_flags = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+            VmaAllocationCreateFlags vma_flags = {};
+            _index_buffer.init(_allocator_handle, getQueueFamilies(), byte_size, usage_flags, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, vma_flags);
+        }
+
     } // graphics
 
 } // undicht
\ No newline at end of file
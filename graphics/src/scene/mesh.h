@@ -7,6 +7,9 @@
 #include "renderer/vulkan/transfer_buffer.h"
 
 #include "string"
+#include "vector"
+
+#include "glm/glm.hpp"
 
 namespace undicht {
 
@@ -19,11 +22,25 @@ namespace undicht {
             /** contains vertices, which can have such attributes as a position or texture coordinate
              * and it contains faces, which define the way to create a mesh from the vertices
              * if they are present, the vertex attributes are ALWAYS ordered in the following way:
-             * Vec3f position
-             * Vec3f texture coordinate
-             * Vec3f normal
-             * Vec3f tangent
-             * Vec3f bitangent */
+             * Vec3f position (3 * float32)
+             * Vec2f texture coordinate (2 * float16)
+             * normal (octahedral encoded, 2 * unorm16)
+             * tangent (octahedral encoded, 2 * unorm16)
+             * bitangent (octahedral encoded, 2 * unorm16)
+             * bone ids (4 * uint8)
+             * bone weights (4 * unorm8)
+             * the indices are either uint16 or uint32
+             * the index buffer can contain simplified levels of detail (lods) after the indices of the full detail mesh,
+             * which use the same vertices */
+
+          public:
+
+            struct LOD {
+                uint32_t _first_index = 0;
+                uint32_t _index_count = 0;
+                float _error = 0.0f; // how much the lod differs from the full detail mesh, relative to the bounding sphere radius
+            };
+
           protected:
 
             vulkan::LogicalDevice _device_handle;
@@ -40,7 +57,13 @@ namespace undicht {
             bool _has_tangents_and_bitangents; // if there is one there is also the other
             bool _has_bones; // for skeletal animations
 
-            uint32_t _vertex_count;
+            uint32_t _vertex_count = 0;
+            VkIndexType _index_type = VK_INDEX_TYPE_UINT32;
+            std::vector<LOD> _lods; // the first lod is the full detail mesh
+
+            // bounding sphere (in the local coord. system of the mesh)
+            glm::vec3 _bounding_center = glm::vec3(0.0f);
+            float _bounding_radius = 0.0f;
 
             // other attributes
             std::string _name;
@@ -54,13 +77,21 @@ namespace undicht {
             void cleanUp();
 
             void setVertexData(const uint8_t* data, uint32_t byte_size, vulkan::TransferBuffer& transfer_buffer);
-            void setIndexData(const uint8_t* data, uint32_t byte_size, vulkan::TransferBuffer& transfer_buffer);
+            void setIndexData(const uint8_t* data, uint32_t byte_size, vulkan::TransferBuffer& transfer_buffer, VkIndexType index_type = VK_INDEX_TYPE_UINT32);
+
+            /** @brief creates the vertex / index buffer and reserves the memory for its data in the transfer buffer,
+             * so that the data can be generated directly in the mapped memory (instead of copying it there)
+             * @return the memory to write the data to (before anything else gets staged), nullptr if it doesnt fit into the transfer buffer */
+            uint8_t* reserveVertexData(uint32_t byte_size, vulkan::TransferBuffer& transfer_buffer);
+            uint8_t* reserveIndexData(uint32_t byte_size, vulkan::TransferBuffer& transfer_buffer, VkIndexType index_type = VK_INDEX_TYPE_UINT32);
 
             void setVertexCount(uint32_t count);
             void setVertexAttributes(bool has_positions, bool has_tex_coords, bool has_normals, bool has_tangents_bitangents, bool has_bones);
             void setMaterial(const std::string& material);
             void setName(const std::string& name);
             void setBones(const std::vector<std::string>& bones);
+            void setLODs(const std::vector<LOD>& lods);
+            void setBoundingSphere(const glm::vec3& center, float radius);
 
             bool getHasPositions() const;
             bool getHasTexCoords() const;
@@ -68,6 +99,11 @@ namespace undicht {
             bool getHasTangentsBitangents() const;
             bool getHasBones() const;
             uint32_t getVertexCount() const;
+            VkIndexType getIndexType() const;
+            uint32_t getLODCount() const;
+            const LOD& getLOD(uint32_t lod) const;
+            const glm::vec3& getBoundingCenter() const;
+            float getBoundingRadius() const;
             const std::string& getName() const;
             Material* getMaterial(SceneGroup& scene);
             const std::vector<std::string>& getBones() const;
@@ -79,6 +115,13 @@ namespace undicht {
             const vulkan::Buffer& getVertexBuffer() const;
             const vulkan::Buffer& getIndexBuffer() const;
 
+          protected:
+            // non public Mesh functions
+
+            std::vector<uint32_t> getQueueFamilies() const; // of the vertex / index buffer
+            void initVertexBuffer(uint32_t byte_size);
+            void initIndexBuffer(uint32_t byte_size, VkIndexType index_type);
+
         };
 
     } // graphics
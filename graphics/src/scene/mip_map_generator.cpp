@@ -0,0 +1,247 @@
+#include "mip_map_generator.h"
+#include "core/vulkan/image.h"
+#include "core/vulkan/formats.h"
+#include "file_tools.h"
+#include "debug.h"
+#include "linear_arena.h"
+
+#include "algorithm"
+
+namespace undicht {
+
+    namespace graphics {
+
+        using namespace vulkan;
+
+        namespace {
+
+            // the number of levels a single dispatch generates (a workgroup reduces a 32x32 tile of the first generated level to 1x1)
+            const uint32_t LEVELS_PER_PASS = 6;
+
+            // each dispatch uses one descriptor set, the sets of a batch are released with it
+            const uint32_t DESCRIPTOR_POOL_SIZE = 1000;
+
+            struct MipMapConstants {
+                // matches the push constants of mip_map_gen.comp
+                int32_t _source_size[2];
+                int32_t _level_count;
+                int32_t _srgb;
+                int32_t _filter;
+            };
+
+        }
+
+        void MipMapGenerator::init(const LogicalDevice& device, Filter filter) {
+
+            _device_handle = device;
+            _filter = filter;
+
+            // the source level and the levels generated by a dispatch
+            std::vector<VkDescriptorType> descriptor_types = {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER};
+            descriptor_types.resize(1 + LEVELS_PER_PASS, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+            std::vector<VkShaderStageFlagBits> shader_stages(descriptor_types.size(), VK_SHADER_STAGE_COMPUTE_BIT);
+
+            _descriptor_layout.init(device.getDevice(), descriptor_types, shader_stages);
+            _descriptor_cache.init(device.getDevice(), _descriptor_layout, DESCRIPTOR_POOL_SIZE);
+
+            // texels beyond the edges of a level get clamped to it
+            _sampler.setRepeatMode(VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE);
+            _sampler.setMipMapMode(VK_SAMPLER_MIPMAP_MODE_NEAREST);
+            _sampler.init(device.getDevice());
+
+            std::string directory = getFilePath(UND_CODE_SRC_FILE);
+            _shader.init(device.getDevice(), VK_SHADER_STAGE_COMPUTE_BIT, directory + "shader/bin/mip_map_gen.comp.spv");
+
+            _pipeline.addShaderModule(_shader);
+            _pipeline.setShaderInput(_descriptor_layout.getLayout());
+            _pipeline.setPushConstants(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(MipMapConstants));
+            _pipeline.initCompute(device.getDevice());
+
+        }
+
+        void MipMapGenerator::cleanUp() {
+            // the commands of all batches should have finished executing
+
+            for(uint32_t i = 0; i < _batches.size(); i++)
+                release(i);
+
+            _pending.clear();
+            _batches.clear();
+
+            _pipeline.cleanUp();
+            _shader.cleanUp();
+            _sampler.cleanUp();
+            _descriptor_cache.cleanUp();
+            _descriptor_layout.cleanUp();
+
+        }
+
+        void MipMapGenerator::setFilter(Filter filter) {
+
+            _filter = filter;
+        }
+
+        void MipMapGenerator::addTexture(Texture& texture) {
+            /// @brief the mip maps of the texture get generated by the next call to generate() (if they are outdated)
+
+            _pending.push_back(&texture);
+        }
+
+        uint32_t MipMapGenerator::generate(CommandBuffer& cmd) {
+            /** @brief records the commands to generate the mip maps of all added textures
+             * (the level 0 of the textures has to be uploaded before the commands are executed)
+             * @return the id of the batch, release it once the command buffer finished executing */
+
+            uint32_t batch = allocateBatch();
+
+            // textures shared by multiple materials get added more than once
+            // (the per batch temporaries are allocated from the frame arena)
+            FrameVector<Texture*> textures;
+            for(Texture* texture : _pending) {
+
+                if(!texture->_mip_maps_outdated) continue;
+
+                // the image cant be written by the shader
+                if(!texture->_storage_mip_maps) {
+                    texture->genMipMaps(cmd);
+                    continue;
+                }
+
+                texture->_mip_maps_outdated = false;
+                if(texture->_mip_levels > 1) textures.push_back(texture);
+            }
+
+            _pending.clear();
+
+            if(textures.empty()) return batch;
+
+            // transitioning the levels of all textures with one barrier
+            // (the upload of level 0 made it visible to the fragment shader stage, the levels that get generated are written in the general layout)
+            FrameVector<VkImageMemoryBarrier> barriers;
+            uint32_t pass_count = 0;
+
+            for(Texture* texture : textures) {
+
+                VkImageSubresourceRange base_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1);
+                VkImageSubresourceRange mip_levels_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, 1, texture->_mip_levels - 1, 0, 1);
+                barriers.push_back(Image::createImageMemoryBarrier(texture->_image.getImage(), base_range, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_NONE, VK_ACCESS_SHADER_READ_BIT));
+                barriers.push_back(Image::createImageMemoryBarrier(texture->_image.getImage(), mip_levels_range, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_NONE, VK_ACCESS_SHADER_WRITE_BIT));
+
+                pass_count = std::max(pass_count, (texture->_mip_levels - 2) / LEVELS_PER_PASS + 1);
+            }
+
+            cmd.pipelineBarrier(barriers, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+            cmd.bindComputePipeline(_pipeline.getPipeline());
+
+            for(uint32_t pass = 0; pass < pass_count; pass++) {
+
+                uint32_t first_level = pass * LEVELS_PER_PASS;
+
+                // the last level written by the previous pass is the source of this pass
+                barriers.clear();
+                for(Texture* texture : textures) {
+
+                    if(!pass || (first_level + 1 >= texture->_mip_levels)) continue;
+
+                    VkImageSubresourceRange source_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, first_level, 1, 0, 1);
+                    barriers.push_back(Image::createImageMemoryBarrier(texture->_image.getImage(), source_range, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_GENERAL, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+                }
+
+                cmd.pipelineBarrier(barriers, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+                for(Texture* texture : textures)
+                    if(first_level + 1 < texture->_mip_levels) dispatch(cmd, *texture, first_level, batch);
+
+            }
+
+            // the generated levels can be sampled now
+            barriers.clear();
+            for(Texture* texture : textures) {
+
+                VkImageSubresourceRange mip_levels_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, 1, texture->_mip_levels - 1, 0, 1);
+                barriers.push_back(Image::createImageMemoryBarrier(texture->_image.getImage(), mip_levels_range, VK_IMAGE_LAYOUT_GENERAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT));
+            }
+
+            cmd.pipelineBarrier(barriers, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+            return batch;
+        }
+
+        void MipMapGenerator::release(uint32_t batch) {
+            /// @brief releases the image views and descriptor sets used by the batch
+
+            if(batch >= _batches.size()) return;
+
+            for(ImageView& image_view : _batches.at(batch)._image_views)
+                image_view.cleanUp();
+
+            _batches.at(batch)._image_views.clear();
+            _batches.at(batch)._in_use = false;
+            _descriptor_cache.reset(batch);
+
+        }
+
+        ///////////////////////////////// non public MipMapGenerator functions /////////////////////////////////
+
+        uint32_t MipMapGenerator::allocateBatch() {
+            /// @return the id of a batch that isnt in use
+
+            uint32_t batch = 0;
+            while((batch < _batches.size()) && _batches.at(batch)._in_use)
+                batch++;
+
+            if(batch == _batches.size())
+                _batches.emplace_back();
+
+            _batches.at(batch)._in_use = true;
+
+            return batch;
+        }
+
+        void MipMapGenerator::dispatch(CommandBuffer& cmd, Texture& texture, uint32_t first_level, uint32_t batch) {
+            /// @brief records the dispatch that generates the levels following first_level (up to 6 levels)
+
+            uint32_t level_count = std::min(LEVELS_PER_PASS, texture._mip_levels - 1 - first_level);
+            FixedType linear_format = Texture::getLinearFormat(texture._format);
+            std::vector<ImageView>& image_views = _batches.at(batch)._image_views;
+
+            DescriptorSet& descriptor_set = _descriptor_cache.allocate(batch);
+
+            // the source level is sampled in the format of the texture (so srgb gets decoded)
+            image_views.emplace_back();
+            image_views.back().init(_device_handle.getDevice(), texture._image.getImage(), translate(texture._format), 1, 1, VK_IMAGE_VIEW_TYPE_2D, {}, first_level, VK_IMAGE_USAGE_SAMPLED_BIT);
+            descriptor_set.bindImage(0, image_views.back().getImageView(), first_level ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, _sampler.getSampler());
+
+            // the generated levels are written in the linear format (the unused bindings get the last level, which the shader doesnt write to)
+            for(uint32_t i = 0; i < LEVELS_PER_PASS; i++) {
+
+                if(i < level_count) {
+                    image_views.emplace_back();
+                    image_views.back().init(_device_handle.getDevice(), texture._image.getImage(), translate(linear_format), 1, 1, VK_IMAGE_VIEW_TYPE_2D, {}, first_level + 1 + i, VK_IMAGE_USAGE_STORAGE_BIT);
+                }
+
+                descriptor_set.bindStorageImage(1 + i, image_views.back().getImageView());
+            }
+
+            descriptor_set.update();
+
+            MipMapConstants constants;
+            constants._source_size[0] = std::max(texture._extent.width >> first_level, 1u);
+            constants._source_size[1] = std::max(texture._extent.height >> first_level, 1u);
+            constants._level_count = level_count;
+            constants._srgb = !(linear_format == texture._format);
+            constants._filter = _filter;
+
+            // a workgroup generates a 32x32 tile of the first level
+            uint32_t width = std::max(texture._extent.width >> (first_level + 1), 1u);
+            uint32_t height = std::max(texture._extent.height >> (first_level + 1), 1u);
+
+            cmd.bindDescriptorSet(descriptor_set.getDescriptorSet(), _pipeline.getPipelineLayout(), 0, VK_PIPELINE_BIND_POINT_COMPUTE);
+            cmd.pushConstants(_pipeline.getPipelineLayout(), VK_SHADER_STAGE_COMPUTE_BIT, sizeof(MipMapConstants), &constants);
+            cmd.dispatch((width + 31) / 32, (height + 31) / 32);
+
+        }
+
+    } // graphics
+
+} // undicht
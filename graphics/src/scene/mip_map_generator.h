@@ -0,0 +1,89 @@
+#ifndef MIP_MAP_GENERATOR_H
+#define MIP_MAP_GENERATOR_H
+
+#include "texture.h"
+#include "core/vulkan/logical_device.h"
+#include "core/vulkan/command_buffer.h"
+#include "core/vulkan/pipeline.h"
+#include "core/vulkan/shader_module.h"
+#include "core/vulkan/sampler.h"
+#include "core/vulkan/image_view.h"
+#include "core/vulkan/descriptor_set_layout.h"
+#include "renderer/vulkan/descriptor_set_cache.h"
+
+#include "cstdint"
+#include "vector"
+
+namespace undicht {
+
+    namespace graphics {
+
+        class MipMapGenerator {
+            /** @brief generates the mip maps of many textures at once with a compute shader (instead of a blit per level per texture)
+             * a dispatch generates up to 6 levels of a texture (a workgroup reduces its tile of the source level in shared memory),
+             * so most textures only need one or two dispatches, the barriers of all textures are recorded as one batch per pass
+             * srgb textures get filtered in linear space (they are sampled through srgb views and the results get encoded by the shader)
+             * textures that cant be written by a shader (see Texture::setData()) fall back to Texture::genMipMaps() */
+
+          public:
+
+            enum Filter {
+                BOX, // averages 2x2 texels
+                TENT, // weights 4x4 texels with (1 3 3 1) x (1 3 3 1), less aliasing (the levels generated in shared memory are averaged)
+            };
+
+          protected:
+
+            struct Batch {
+                // the per level views used by the recorded commands (the descriptor sets are stored in the cache group of the batch)
+                std::vector<vulkan::ImageView> _image_views;
+                bool _in_use = false;
+            };
+
+            vulkan::LogicalDevice _device_handle;
+
+            vulkan::ShaderModule _shader;
+            vulkan::Pipeline _pipeline;
+            vulkan::DescriptorSetLayout _descriptor_layout;
+            vulkan::DescriptorSetCache _descriptor_cache;
+            vulkan::Sampler _sampler;
+
+            Filter _filter = TENT;
+
+            std::vector<Texture*> _pending; // textures added since the last call to generate()
+            std::vector<Batch> _batches;
+
+          public:
+
+            void init(const vulkan::LogicalDevice& device, Filter filter = TENT);
+            void cleanUp();
+
+            void setFilter(Filter filter);
+
+            /// @brief the mip maps of the texture get generated by the next call to generate() (if they are outdated)
+            void addTexture(Texture& texture);
+
+            /** @brief records the commands to generate the mip maps of all added textures
+             * (the level 0 of the textures has to be uploaded before the commands are executed)
+             * @return the id of the batch, release it once the command buffer finished executing */
+            uint32_t generate(vulkan::CommandBuffer& cmd);
+
+            /// @brief releases the image views and descriptor sets used by the batch
+            void release(uint32_t batch);
+
+          protected:
+            // non public MipMapGenerator functions
+
+            /// @return the id of a batch that isnt in use
+            uint32_t allocateBatch();
+
+            /// @brief records the dispatch that generates the levels following first_level (up to 6 levels)
+            void dispatch(vulkan::CommandBuffer& cmd, Texture& texture, uint32_t first_level, uint32_t batch);
+
+        };
+
+    } // graphics
+
+} // undicht
+
+#endif // MIP_MAP_GENERATOR_H
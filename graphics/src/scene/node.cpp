@@ -3,6 +3,7 @@
 #include "debug.h"
 #include "iomanip"
 #include "file_tools.h"
+#include "linear_arena.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/type_ptr.hpp"
@@ -201,8 +202,9 @@ namespace undicht {
             Mesh* mesh = scene_group.getMesh(_mesh);
             if(!mesh) return;
 
-            // get the bone matrices from the skeletons
-            std::vector<glm::mat4> bone_matrices;
+            // get the bone matrices from the skeletons (using the frame arena, since this is done every frame)
+            FrameVector<glm::mat4> bone_matrices;
+            bone_matrices.reserve(mesh->getBones().size());
             for(const std::string& bone_name : mesh->getBones()) {
                 Bone* b = scene_group.getBone(bone_name);
                 if(b)bone_matrices.push_back(b->getBoneMatrix());
@@ -53,7 +53,7 @@ namespace undicht {
             cmd.bindDescriptorSet(mat->getDescriptorSet().getDescriptorSet(), _pipeline.getPipelineLayout(), 1);
             cmd.bindDescriptorSet(node.getDescriptorSet().getDescriptorSet(), _pipeline.getPipelineLayout(), 2);
             cmd.bindVertexBuffer(mesh->getVertexBuffer().getBuffer(), 0);
-            cmd.bindIndexBuffer(mesh->getIndexBuffer().getBuffer());
+            cmd.bindIndexBuffer(mesh->getIndexBuffer().getBuffer(), mesh->getIndexType());
 
             // draw using the index buffer
             cmd.draw(mesh->getVertexCount(), true);
@@ -84,12 +84,13 @@ namespace undicht {
 
         void BasicAnimationRenderer::setVertexAttributes() {
 
-            _pipeline.addVertexBinding(0, 17 * sizeof(float));
-            _pipeline.addVertexAttribute(0, 0, 0 * sizeof(float), translate(UND_VEC3F)); // position
-            _pipeline.addVertexAttribute(0, 1, 3 * sizeof(float), translate(UND_VEC3F)); // tex coord
-            _pipeline.addVertexAttribute(0, 2, 6 * sizeof(float), translate(UND_VEC3F)); // normal
-            _pipeline.addVertexAttribute(0, 3, 9 * sizeof(float), translate(UND_VEC4I)); // bone ids
-            _pipeline.addVertexAttribute(0, 4, 13 * sizeof(float), translate(UND_VEC4F)); // bone weights
+            // the compact vertex layout described in mesh.h
+            _pipeline.addVertexBinding(0, 28);
+            _pipeline.addVertexAttribute(0, 0, 0, translate(UND_VEC3F)); // position
+            _pipeline.addVertexAttribute(0, 1, 12, translate(UND_VEC2F16)); // tex coord
+            _pipeline.addVertexAttribute(0, 2, 16, translate(UND_R16G16)); // normal (octahedral)
+            _pipeline.addVertexAttribute(0, 3, 20, translate(UND_VEC4UI8)); // bone ids
+            _pipeline.addVertexAttribute(0, 4, 24, translate(UND_R8G8B8A8)); // bone weights
             _pipeline.setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 
         }
@@ -36,8 +36,9 @@ namespace undicht {
 
         }
 
-        uint32_t BasicRenderer::draw(vulkan::CommandBuffer& cmd, SceneGroup& scene, Node& node) {
+        uint32_t BasicRenderer::draw(vulkan::CommandBuffer& cmd, SceneGroup& scene, Node& node, uint32_t lod) {
             /// @brief draws the meshes of the node, does not draw child nodes
+            /// @param lod the level of detail of the mesh to draw (if the mesh has it)
             /// @return the number of draw calls that were made
 
             // retrieve the resources used by the node
@@ -54,10 +55,13 @@ namespace undicht {
             cmd.bindDescriptorSet(mat->getDescriptorSet().getDescriptorSet(), _pipeline.getPipelineLayout(), 1);
             cmd.bindDescriptorSet(node.getDescriptorSet().getDescriptorSet(), _pipeline.getPipelineLayout(), 2);
             cmd.bindVertexBuffer(mesh->getVertexBuffer().getBuffer(), 0);
-            cmd.bindIndexBuffer(mesh->getIndexBuffer().getBuffer());
+            cmd.bindIndexBuffer(mesh->getIndexBuffer().getBuffer(), mesh->getIndexType());
 
-            // draw using the index buffer
-            cmd.draw(mesh->getVertexCount(), true);
+            // draw using the index buffer (the lods are stored in the same index buffer)
+            if(lod < mesh->getLODCount())
+                cmd.draw(mesh->getLOD(lod)._index_count, true, 1, mesh->getLOD(lod)._first_index);
+            else
+                cmd.draw(mesh->getVertexCount(), true);
 
             return 1;
         }
@@ -85,10 +89,11 @@ namespace undicht {
 
         void BasicRenderer::setVertexAttributes() {
 
-            _pipeline.addVertexBinding(0, 9 * sizeof(float));
-            _pipeline.addVertexAttribute(0, 0, 0 * sizeof(float), translate(UND_VEC3F)); // position
-            _pipeline.addVertexAttribute(0, 1, 3 * sizeof(float), translate(UND_VEC3F)); // tex coord
-            _pipeline.addVertexAttribute(0, 2, 6 * sizeof(float), translate(UND_VEC3F)); // normal
+            // the compact vertex layout described in mesh.h
+            _pipeline.addVertexBinding(0, 20);
+            _pipeline.addVertexAttribute(0, 0, 0, translate(UND_VEC3F)); // position
+            _pipeline.addVertexAttribute(0, 1, 12, translate(UND_VEC2F16)); // tex coord
+            _pipeline.addVertexAttribute(0, 2, 16, translate(UND_R16G16)); // normal (octahedral)
             _pipeline.setInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
 
         }
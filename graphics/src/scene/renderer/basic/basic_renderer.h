@@ -25,8 +25,9 @@ namespace undicht {
             void begin(vulkan::CommandBuffer& draw_cmd, VkDescriptorSet global_descriptor_set);
 
             /// @brief draws the meshes of the node, does not draw child nodes
+            /// @param lod the level of detail of the mesh to draw (if the mesh has it)
             /// @return the number of draw calls that were made
-            uint32_t draw(vulkan::CommandBuffer& cmd, SceneGroup& scene, Node& node);
+            uint32_t draw(vulkan::CommandBuffer& cmd, SceneGroup& scene, Node& node, uint32_t lod = 0);
 
           protected:
             // functions to initialize parts of the renderer
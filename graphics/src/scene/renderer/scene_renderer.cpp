@@ -4,6 +4,10 @@
 #include "debug.h"
 #include "profiler.h"
 
+#include "glm/gtc/type_ptr.hpp"
+
+#include "cfloat"
+
 namespace undicht {
 
     namespace graphics {
@@ -23,6 +27,8 @@ namespace undicht {
             initDescriptorCaches();
             initSampler();
 
+            _viewport_height = swap_chain.getExtent().height;
+
             _basic_renderer.init(device.getDevice(), _render_pass.getRenderPass(), _global_descriptor_layout.getLayout(), _material_descriptor_layout.getLayout(), _node_descriptor_layout.getLayout(), swap_chain.getExtent());
             _basic_animation_renderer.init(device.getDevice(), _render_pass.getRenderPass(), _global_descriptor_layout.getLayout(), _material_descriptor_layout.getLayout(), _node_descriptor_layout.getLayout(), swap_chain.getExtent());
 
@@ -64,6 +70,8 @@ namespace undicht {
             initDepthImages(allocator, swap_chain.getSwapImageCount(), swap_chain.getExtent());
             initFramebuffers(_swap_images, swap_chain.getExtent());
 
+            _viewport_height = swap_chain.getExtent().height;
+
             // change the viewport of the renderers
             _basic_renderer.setViewPort(swap_chain.getExtent());
             _basic_animation_renderer.setViewPort(swap_chain.getExtent());
@@ -75,6 +83,16 @@ namespace undicht {
             _uniform_buffer.uploadData(0, (const uint8_t*)mat4_view, transfer_buffer);
             _uniform_buffer.uploadData(1, (const uint8_t*)mat4_proj, transfer_buffer);
 
+            _camera_view = glm::make_mat4(mat4_view);
+            _camera_proj = glm::make_mat4(mat4_proj);
+
+        }
+
+        void SceneRenderer::setLODThreshold(float pixels) {
+            /// @brief the simplest lod of a mesh, whose error is not bigger than the threshold on the screen gets drawn
+            /// @param pixels 0 to always draw the full detail meshes
+
+            _lod_threshold = pixels;
         }
 
         ////////////////////////////////////// drawing //////////////////////////////////////
@@ -101,20 +119,24 @@ namespace undicht {
             Profiler p;
 
             // draw all meshes that dont have skeletal animation
+            cmd.beginTimer("basic_renderer");
             p.start("    basic_renderer.begin");
             _basic_renderer.begin(cmd, _global_descriptor_set.getDescriptorSet());
             p.start("    drawStatic");
             for(SceneGroup& group : scene.getGroups()) draw_calls += drawStatic(cmd, group, group.getRootNode());
             p.start("    basic_renderer.end");
             _basic_renderer.end(cmd);
+            cmd.endTimer();
 
             // draw all meshes that do have skeletal animation
+            cmd.beginTimer("basic_animation_renderer");
             p.start("    basic_animation_renderer.begin");
             _basic_animation_renderer.begin(cmd, _global_descriptor_set.getDescriptorSet());
             p.start("    drawAnimated");
             for(SceneGroup& group : scene.getGroups()) draw_calls += drawAnimated(cmd, group, group.getRootNode());
             p.start("    basic_animation_renderer.end");
             _basic_animation_renderer.end(cmd);
+            cmd.endTimer();
 
             return draw_calls;
         }
@@ -122,8 +144,14 @@ namespace undicht {
         uint32_t SceneRenderer::drawStatic(vulkan::CommandBuffer& cmd, SceneGroup& scene_group, Node& node) {
             /// @return the number of draw calls that were made
 
+            // selecting the lod based on the size of the mesh on the screen
+            Mesh* mesh = node.getMesh(scene_group);
+            float projected_radius = mesh ? calcProjectedRadius(*mesh, node) : 0.0f;
+            uint32_t lod = mesh ? selectLOD(*mesh, projected_radius) : 0;
+            if(mesh) requestTextureResolution(scene_group, *mesh, projected_radius);
+
             // doesnt draw the nodes children
-            uint32_t draw_calls = _basic_renderer.draw(cmd, scene_group, node);
+            uint32_t draw_calls = _basic_renderer.draw(cmd, scene_group, node, lod);
 
             // recursivly draw the child nodes
             for(Node& n : node.getChildNodes()) {
@@ -136,6 +164,10 @@ namespace undicht {
         uint32_t SceneRenderer::drawAnimated(vulkan::CommandBuffer& cmd, SceneGroup& scene_group, Node& node) {
             /// @return the number of draw calls that were made
 
+            // the streamed textures need to know the size of the mesh on the screen
+            Mesh* mesh = node.getMesh(scene_group);
+            if(mesh) requestTextureResolution(scene_group, *mesh, calcProjectedRadius(*mesh, node));
+
             // doesnt draw the nodes children
             uint32_t draw_calls = _basic_animation_renderer.draw(cmd, scene_group, node);
 
@@ -267,6 +299,47 @@ namespace undicht {
 
         }
 
+        float SceneRenderer::calcProjectedRadius(const Mesh& mesh, const Node& node) const {
+            /// @return the radius of the bounding sphere of the mesh on the screen (in pixels), FLT_MAX if the camera is inside of it
+
+            // the bounding sphere of the mesh in view space
+            const glm::mat4& model = node.getGlobalTransformation();
+            glm::vec3 center = glm::vec3(_camera_view * model * glm::vec4(mesh.getBoundingCenter(), 1.0f));
+            float scale = std::max(std::max(glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1]))), glm::length(glm::vec3(model[2])));
+            float radius = mesh.getBoundingRadius() * scale;
+            float distance = glm::length(center);
+
+            if(distance <= radius) return FLT_MAX;
+
+            return radius / distance * std::abs(_camera_proj[1][1]) * 0.5f * _viewport_height;
+        }
+
+        uint32_t SceneRenderer::selectLOD(const Mesh& mesh, float projected_radius) const {
+            /// @return the lod to draw the mesh with (based on its projected size)
+
+            if((mesh.getLODCount() < 2) || (_lod_threshold <= 0.0f) || (projected_radius == FLT_MAX)) return 0;
+
+            // the lod errors are relative to the bounding sphere radius
+            for(uint32_t lod = mesh.getLODCount() - 1; lod > 0; lod--)
+                if(mesh.getLOD(lod)._error * projected_radius <= _lod_threshold)
+                    return lod;
+
+            return 0;
+        }
+
+        void SceneRenderer::requestTextureResolution(SceneGroup& scene_group, Mesh& mesh, float projected_radius) const {
+            /// @brief tells the textures of the meshes material how large they appear on the screen (for the TextureStreamer)
+            /// assuming that the texture is stretched once across the bounding sphere of the mesh
+
+            Material* material = mesh.getMaterial(scene_group);
+            if(!material) return;
+
+            // the camera is inside the bounding sphere, so the full resolution might be needed
+            if(projected_radius == FLT_MAX) projected_radius = _viewport_height;
+
+            material->requestTextureResolution(2.0f * projected_radius);
+        }
+
     } // graphics
 
 } // undicht
\ No newline at end of file
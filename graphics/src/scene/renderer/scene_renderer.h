@@ -56,6 +56,12 @@ namespace undicht {
             BasicRenderer _basic_renderer;
             BasicAnimationRenderer _basic_animation_renderer;
 
+            // used to select the lods of static meshes
+            glm::mat4 _camera_view = glm::mat4(1.0f);
+            glm::mat4 _camera_proj = glm::mat4(1.0f);
+            float _viewport_height = 0.0f;
+            float _lod_threshold = 1.0f; // the max. error of a lod on the screen (in pixels)
+
           public:
 
             void init(const vulkan::LogicalDevice& device, vulkan::SwapChain& swap_chain, vma::VulkanMemoryAllocator& allocator);
@@ -65,6 +71,10 @@ namespace undicht {
 
             void loadCameraMatrices(float* mat4_view, float* mat4_proj, vulkan::TransferBuffer& transfer_buffer);
 
+            /// @brief the simplest lod of a mesh, whose error is not bigger than the threshold on the screen gets drawn
+            /// @param pixels 0 to always draw the full detail meshes
+            void setLODThreshold(float pixels);
+
             // drawing
             void begin(vulkan::CommandBuffer& cmd, uint32_t swap_image_id);
             void end(vulkan::CommandBuffer& cmd);
@@ -92,6 +102,16 @@ namespace undicht {
             void cleanUpFramebuffers();
             void cleanUpDepthImages();
 
+            /// @return the radius of the bounding sphere of the mesh on the screen (in pixels), FLT_MAX if the camera is inside of it
+            float calcProjectedRadius(const Mesh& mesh, const Node& node) const;
+
+            /// @return the lod to draw the mesh with (based on its projected size)
+            uint32_t selectLOD(const Mesh& mesh, float projected_radius) const;
+
+            /// @brief tells the textures of the meshes material how large they appear on the screen (for the TextureStreamer)
+            /// assuming that the texture is stretched once across the bounding sphere of the mesh
+            void requestTextureResolution(SceneGroup& scene_group, Mesh& mesh, float projected_radius) const;
+
         };
 
     } // graphics
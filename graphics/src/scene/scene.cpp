@@ -1,4 +1,5 @@
 #include "scene.h"
+#include "debug.h"
 
 namespace undicht {
 
@@ -27,6 +28,16 @@ namespace undicht {
             return _groups.back();
         }
 
+        SceneGroup& Scene::addGroup(SceneGroup&& group) {
+            // adds an initialized group (i.e. one that was loaded in the background)
+
+            if(getGroup(group.getName()))
+                UND_WARNING << "scene already contains a group named " << group.getName() << "\n";
+
+            _groups.push_back(std::move(group));
+            return _groups.back();
+        }
+
 		Mesh* Scene::addMesh(const std::string& group_name, const std::string& mesh_name) {
             
             // make sure that the group exists
@@ -99,6 +110,15 @@ namespace undicht {
             for(SceneGroup& g : _groups)
                 g.genMipMaps(cmd);
 
+        }
+
+        void Scene::genMipMaps(MipMapGenerator& generator) {
+			// adds the textures of all groups to the generator
+			// (the commands get recorded by MipMapGenerator::generate(), for all added textures at once)
+
+            for(SceneGroup& g : _groups)
+                g.genMipMaps(generator);
+
         }
 
 		void Scene::updateNodeUBOs(vulkan::TransferBuffer& transfer_buffer) {
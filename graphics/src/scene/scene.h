@@ -26,6 +26,7 @@ namespace undicht {
 			void cleanUp();
 
 			SceneGroup& addGroup(const std::string& group_name); // calls init() on a newly created group
+			SceneGroup& addGroup(SceneGroup&& group); // adds an initialized group (i.e. one that was loaded in the background)
 			Mesh* addMesh(const std::string& group_name, const std::string& mesh_name); // returns nullptr, if the group doesnt exist
 			Material* addMaterial(const std::string& group_name, const std::string& mat_name);
 			Animation* addAnimation(const std::string& group_name, const std::string& anim_name);
@@ -40,6 +41,10 @@ namespace undicht {
 			// records the commands to generate the mip maps
 			// for all textures of the materials
             void genMipMaps(vulkan::CommandBuffer& cmd);
+
+			// adds the textures of all groups to the generator
+			// (the commands get recorded by MipMapGenerator::generate(), for all added textures at once)
+            void genMipMaps(MipMapGenerator& generator);
 			void updateNodeUBOs(vulkan::TransferBuffer& transfer_buffer);
             void updateBoneMatrices();
             void updateGlobalTransformations();
@@ -197,6 +197,15 @@ namespace undicht {
             for(Material& m : _materials)
                 m.genMipMaps(cmd);
 
+        }
+
+        void SceneGroup::genMipMaps(MipMapGenerator& generator) {
+            // adds the textures of the materials to the generator
+            // (the commands get recorded by MipMapGenerator::generate(), for all added textures at once)
+
+            for(Material& m : _materials)
+                m.genMipMaps(generator);
+
         }
 
 		void SceneGroup::updateNodeUBOs(vulkan::TransferBuffer& transfer_buffer) {
@@ -76,6 +76,10 @@ namespace undicht {
             // records the commands to generate the mip maps
 			// for all textures of the materials
             void genMipMaps(vulkan::CommandBuffer& cmd);
+
+            // adds the textures of the materials to the generator
+            // (the commands get recorded by MipMapGenerator::generate(), for all added textures at once)
+            void genMipMaps(MipMapGenerator& generator);
 			void updateNodeUBOs(vulkan::TransferBuffer& transfer_buffer);
             void updateBoneMatrices();
             void updateGlobalTransformations();
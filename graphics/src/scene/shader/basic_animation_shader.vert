@@ -4,9 +4,9 @@ const int MAX_BONES_PER_VERTEX = 4;
 const int MAX_BONES_PER_MESH = 100;
 
 layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aUV;
-layout(location = 2) in vec3 aNormal;
-layout(location = 3) in ivec4 aBoneIDs;
+layout(location = 1) in vec2 aUV;
+layout(location = 2) in vec2 aNormal; // octahedral encoded
+layout(location = 3) in uvec4 aBoneIDs;
 layout(location = 4) in vec4 aBoneWeights;
 
 layout(location = 0) out vec2 uv;
@@ -22,6 +22,15 @@ layout(set = 2, binding = 0) uniform NodeUBO {
 	mat4 bones[MAX_BONES_PER_MESH];
 } node;
 
+vec3 decodeOctahedral(vec2 e) {
+	// the normals are stored as unorm16x2 (see tools::VertexPacker::packOctahedral)
+	e = e * 2.0f - 1.0f;
+	vec3 n = vec3(e, 1.0f - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0f);
+	n.x += (n.x >= 0.0f) ? -t : t;
+	n.y += (n.y >= 0.0f) ? -t : t;
+	return normalize(n);
+}
 
 void main() {
 
@@ -34,9 +43,9 @@ void main() {
 	mat4 model = node.model * bone_to_bind_pose;
 
 	// calculate the outputs to the fragment shader
-    uv = aUV.xy;
+    uv = aUV;
 	mat3 rotation = mat3(model);
-    normal = rotation * aNormal;
+    normal = rotation * decodeOctahedral(aNormal);
 
 	// output the position of each vertex
 	gl_Position = cam.proj * cam.view * model * vec4(aPos, 1.0f);
@@ -1,8 +1,8 @@
 #version 450
 
 layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aUV;
-layout(location = 2) in vec3 aNormal;
+layout(location = 1) in vec2 aUV;
+layout(location = 2) in vec2 aNormal; // octahedral encoded
 
 layout(location = 0) out vec2 uv;
 layout(location = 1) out vec3 normal;
@@ -16,13 +16,22 @@ layout(set = 2, binding = 0) uniform NodeUBO {
 	mat4 model;
 } node;
 
+vec3 decodeOctahedral(vec2 e) {
+	// the normals are stored as unorm16x2 (see tools::VertexPacker::packOctahedral)
+	e = e * 2.0f - 1.0f;
+	vec3 n = vec3(e, 1.0f - abs(e.x) - abs(e.y));
+	float t = max(-n.z, 0.0f);
+	n.x += (n.x >= 0.0f) ? -t : t;
+	n.y += (n.y >= 0.0f) ? -t : t;
+	return normalize(n);
+}
 
 void main() {
 
 	mat3 rotation = mat3(node.model);
 
-    uv = aUV.xy;
-    normal = rotation * aNormal;
+    uv = aUV;
+    normal = rotation * decodeOctahedral(aNormal);
 
 	// output the position of each vertex
 	gl_Position = cam.proj * cam.view * node.model * vec4(aPos, 1.0f);
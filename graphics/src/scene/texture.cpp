@@ -3,6 +3,9 @@
 #include "core/vulkan/command_buffer.h"
 #include "core/vulkan/fence.h"
 #include "core/vulkan/formats.h"
+#include "debug.h"
+
+#include "cmath"
 
 namespace undicht {
 
@@ -26,29 +29,128 @@ namespace undicht {
         }
 
         void Texture::setData(const void* data, uint32_t width, uint32_t height, uint32_t nr_channels, TransferBuffer& transfer_buffer) {
-            // assuming that each channel is one byte
+            /** @brief assuming that each channel is one byte
+             * only diffuse textures store srgb colors, all other types store linear data
+             * grayscale images (1 or 2 channels) are kept as R8 / R8G8 and expanded to rgba when sampled,
+             * unless the device cant sample and blit those formats (then the data gets expanded to rgba before the upload) */
+
+            // diffuse textures are the only ones that contain colors (normal maps, specular maps, ... store linear data)
+            undicht::Type color_type = (_type == DIFFUSE) ? undicht::Type::COLOR_RGBA_SRGB : undicht::Type::COLOR_RGBA;
+
+            std::vector<uint8_t> expanded;
+            if((nr_channels != 4) && !_device_handle.supportsFormat(translate(FixedType(color_type, 1, nr_channels)), MIP_MAP_FORMAT_FEATURES)) {
+                // 3 channel formats are rarely supported, same goes for srgb formats with 1 or 2 channels
+                expandToRGBA((const uint8_t*)data, width * height, nr_channels, expanded);
+                data = expanded.data();
+                nr_channels = 4;
+            }
 
             _extent.width = width;
             _extent.height = height;
             _extent.depth = 1;
             _nr_channels = nr_channels;
-            _format = FixedType(undicht::Type::COLOR_RGBA_SRGB, 1, nr_channels);
+            _format = FixedType(color_type, 1, nr_channels);
+            _first_level = 0;
             _mip_levels = calcMipLevelCount(width, height);
 
             VkImageUsageFlags image_usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            VkImageCreateFlags image_flags = 0;
 
-            _image.init(_allocator_handle, translate(_format), _extent, image_usage, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, {}, 1, _mip_levels);
-            _image_view.init(_device_handle.getDevice(), _image.getImage(), translate(_format), _mip_levels);
+            // the MipMapGenerator writes the mip levels through views in the linear format (srgb formats usually cant be used as storage images)
+            _storage_mip_maps = _device_handle.getEnabledFeatures().shaderStorageImageWriteWithoutFormat && _device_handle.supportsFormat(translate(getLinearFormat(_format)), VK_FORMAT_FEATURE_STORAGE_IMAGE_BIT);
+            if(_storage_mip_maps) {
+                image_usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+                image_flags |= VK_IMAGE_CREATE_MUTABLE_FORMAT_BIT | VK_IMAGE_CREATE_EXTENDED_USAGE_BIT;
+            }
+
+            _image.init(_allocator_handle, translate(_format), _extent, image_usage, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, {}, 1, _mip_levels, 1, image_flags);
+            _image_view.init(_device_handle.getDevice(), _image.getImage(), translate(_format), _mip_levels, 1, VK_IMAGE_VIEW_TYPE_2D, chooseSwizzle(nr_channels), 0, VK_IMAGE_USAGE_SAMPLED_BIT);
+            _image_version++;
 
             // store data in image
             transfer_buffer.stageForTransfer(_image.getImage(), (const uint8_t*)data, width * height * nr_channels, _extent);
 
+            _mip_maps_outdated = true;
+
+        }
+
+        void Texture::setData(const std::vector<std::vector<uint8_t>>& mip_levels, uint32_t width, uint32_t height, const FixedType& format, TransferBuffer& transfer_buffer, uint32_t first_level) {
+            /** @brief stores data that already contains mip levels (starting with the full size level, each level is half the size of the previous one)
+             * the data is used in the given format (block compressed, i.e. UND_BC1_SRGB, or uncompressed, i.e. UND_R8G8B8A8)
+             * if less levels than a full mip chain are given, the texture only gets those levels
+             * @param first_level the finest level that gets stored in the image (used by the TextureStreamer to only keep the coarser levels resident)
+             * a new image (and image view) gets created, cleaning up the previous one is up to the caller
+             * (nothing gets created if the device cant sample the format, see isFormatSupported()) */
+
+            if(!isFormatSupported(_device_handle, format)) {
+                UND_ERROR << "failed to store the texture data: the device cant sample the format\n";
+                return;
+            }
+
+            _extent.width = width;
+            _extent.height = height;
+            _extent.depth = 1;
+            _nr_channels = getChannelCount(format);
+            _format = format;
+            _first_level = std::min(first_level, std::min(uint32_t(mip_levels.size()), calcMipLevelCount(width, height)) - 1);
+            _mip_levels = std::min(uint32_t(mip_levels.size()), calcMipLevelCount(width, height)) - _first_level;
+
+            // the mip levels dont need to be generated, so the image is only written by transfers
+            VkImageUsageFlags image_usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            VkExtent3D image_extent = {std::max(width >> _first_level, 1u), std::max(height >> _first_level, 1u), 1};
+
+            _image.init(_allocator_handle, translate(_format), image_extent, image_usage, VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE, {}, 1, _mip_levels);
+            // single channel formats (BC4 / R8) appear gray, like the R8 textures created from grayscale images
+            // (two channel formats keep the identity swizzle, since BC5 is used for normal maps)
+            VkComponentMapping swizzle = (_nr_channels == 1) ? chooseSwizzle(1) : VkComponentMapping{};
+            _image_view.init(_device_handle.getDevice(), _image.getImage(), translate(_format), _mip_levels, 1, VK_IMAGE_VIEW_TYPE_2D, swizzle);
+            _image_version++;
+            _storage_mip_maps = false;
+
+            // store the data of each mip level in the image (a row of block compressed data contains 4 rows of texels)
+            uint32_t block_height = isBlockCompressed(format) ? 4 : 1;
+            for(uint32_t i = 0; i < _mip_levels; i++) {
+
+                const std::vector<uint8_t>& level = mip_levels[_first_level + i];
+                VkExtent3D mip_extent = {std::max(image_extent.width >> i, 1u), std::max(image_extent.height >> i, 1u), 1};
+                transfer_buffer.stageForTransfer(_image.getImage(), level.data(), level.size(), mip_extent, {0,0,0}, 0, i, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_NONE, VK_ACCESS_SHADER_READ_BIT, block_height);
+            }
+
+            _mip_maps_outdated = false;
+
+        }
+
+        void Texture::requestResolution(float pixels) {
+            /** @brief tells the TextureStreamer how large the texture appears on the screen this frame (its largest side, in pixels)
+             * the finest level that is needed is the one with about one texel per pixel (the smallest request of a frame wins) */
+
+            if(pixels <= 0.0f) return;
+
+            float texels_per_pixel = std::max(_extent.width, _extent.height) / pixels;
+            uint32_t level = (texels_per_pixel > 1.0f) ? uint32_t(std::log2(texels_per_pixel)) : 0;
+
+            _requested_level = std::min(_requested_level, level);
+        }
+
+        uint32_t Texture::getRequestedLevel() const {
+            /// @return the finest level requested since the last call to clearRequestedLevel(), NOT_REQUESTED if the texture wasnt drawn
+
+            return _requested_level;
+        }
+
+        void Texture::clearRequestedLevel() {
+
+            _requested_level = NOT_REQUESTED;
         }
 
         void Texture::genMipMaps(vulkan::CommandBuffer& cmd) {
             // records the commands to generate the mip maps
+            // (if they werent generated since the last call to setData())
             // source: https://vulkan-tutorial.com/Generating_Mipmaps
-            
+
+            if(!_mip_maps_outdated) return;
+            _mip_maps_outdated = false;
+
             // transition the mip level 0 to a layout that allows reading it
             VkImageSubresourceRange base_range = Image::createImageSubresourceRange(VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1);
             VkImageMemoryBarrier base_barrier = Image::createImageMemoryBarrier(_image.getImage(), base_range, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_ACCESS_NONE, VK_ACCESS_TRANSFER_READ_BIT);
@@ -107,6 +209,26 @@ namespace undicht {
             return _nr_channels;
         }
 
+        uint32_t Texture::getMipLevels() const {
+
+            return _mip_levels;
+        }
+
+        uint32_t Texture::getFirstLevel() const {
+
+            return _first_level;
+        }
+
+        uint32_t Texture::getImageVersion() const {
+
+            return _image_version;
+        }
+
+        const FixedType& Texture::getFormat() const {
+
+            return _format;
+        }
+
         Texture::Type Texture::getType() const {
 
             return _type;
@@ -134,6 +256,100 @@ namespace undicht {
             return mip_levels;
         }
 
+        bool Texture::isBlockCompressed(const FixedType& format) {
+            /// @return true, if the format stores blocks of 4x4 texels (i.e. UND_BC1), the size of the format is the size of a block then
+
+            switch(format.m_type) {
+                case undicht::Type::COLOR_BC1:
+                case undicht::Type::COLOR_BC1_SRGB:
+                case undicht::Type::COLOR_BC3:
+                case undicht::Type::COLOR_BC3_SRGB:
+                case undicht::Type::COLOR_BC4:
+                case undicht::Type::COLOR_BC5:
+                case undicht::Type::COLOR_BC7:
+                case undicht::Type::COLOR_BC7_SRGB: return true;
+                default: return false;
+            }
+
+        }
+
+        uint32_t Texture::getChannelCount(const FixedType& format) {
+
+            switch(format.m_type) {
+                case undicht::Type::COLOR_BC4: return 1;
+                case undicht::Type::COLOR_BC5: return 2;
+                case undicht::Type::COLOR_BC1:
+                case undicht::Type::COLOR_BC1_SRGB:
+                case undicht::Type::COLOR_BC3:
+                case undicht::Type::COLOR_BC3_SRGB:
+                case undicht::Type::COLOR_BC7:
+                case undicht::Type::COLOR_BC7_SRGB: return 4;
+                default: return format.m_num_components;
+            }
+
+        }
+
+        bool Texture::isFormatSupported(const vulkan::LogicalDevice& device, const FixedType& format) {
+            /// @return true, if the device can sample images in the format (block compressed formats need the textureCompressionBC feature)
+
+            if(isBlockCompressed(format) && !device.getEnabledFeatures().textureCompressionBC) return false;
+
+            return device.supportsFormat(translate(format), VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT);
+        }
+
+        FixedType Texture::getLinearFormat(const FixedType& format) {
+            /// @return the format without the srgb encoding (i.e. UND_R8G8B8A8 for UND_R8G8B8A8_SRGB)
+
+            FixedType linear = format;
+
+            switch(format.m_type) {
+                case undicht::Type::COLOR_RGBA_SRGB: linear.m_type = undicht::Type::COLOR_RGBA; break;
+                case undicht::Type::COLOR_BGRA_SRGB: linear.m_type = undicht::Type::COLOR_BGRA; break;
+                case undicht::Type::COLOR_BC1_SRGB: linear.m_type = undicht::Type::COLOR_BC1; break;
+                case undicht::Type::COLOR_BC3_SRGB: linear.m_type = undicht::Type::COLOR_BC3; break;
+                case undicht::Type::COLOR_BC7_SRGB: linear.m_type = undicht::Type::COLOR_BC7; break;
+                default: break;
+            }
+
+            return linear;
+        }
+
+        VkComponentMapping Texture::chooseSwizzle(uint32_t nr_channels) {
+            /// @return the swizzle that makes an image with the number of channels appear as rgba to the shaders
+
+            if(nr_channels == 1) // gray
+                return {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+
+            if(nr_channels == 2) // gray + alpha
+                return {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G};
+
+            return {}; // identity
+        }
+
+        void Texture::expandToRGBA(const uint8_t* data, uint32_t texel_count, uint32_t nr_channels, std::vector<uint8_t>& load_to) {
+            /// @brief expands the texels to 4 channels (gray -> (g,g,g,255), gray + alpha -> (g,g,g,a), rgb -> (r,g,b,255))
+
+            load_to.resize(size_t(texel_count) * 4);
+
+            for(uint32_t i = 0; i < texel_count; i++) {
+
+                const uint8_t* src = data + size_t(i) * nr_channels;
+                uint8_t* dst = load_to.data() + size_t(i) * 4;
+
+                if(nr_channels < 3) {
+                    dst[0] = dst[1] = dst[2] = src[0];
+                    dst[3] = (nr_channels == 2) ? src[1] : 255;
+                } else {
+                    dst[0] = src[0];
+                    dst[1] = src[1];
+                    dst[2] = src[2];
+                    dst[3] = (nr_channels > 3) ? src[3] : 255;
+                }
+
+            }
+
+        }
+
     } // graphics
 
 } // undicht
\ No newline at end of file
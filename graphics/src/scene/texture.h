@@ -12,10 +12,17 @@
 
 #include "types.h"
 
+#include "vector"
+
 namespace undicht {
 
     namespace graphics {
 
+        // the features a format needs to support to be used by a texture (mip maps are generated by linear blits)
+        const VkFormatFeatureFlags MIP_MAP_FORMAT_FEATURES = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT | VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+
+        class MipMapGenerator;
+
         class Texture {
 
           public:
@@ -43,31 +50,82 @@ namespace undicht {
             FixedType _format;
             Type _type;
 
+            // streaming (see TextureStreamer)
+            uint32_t _first_level = 0; // the finest mip level stored in the image (0, unless the texture is streamed)
+            uint32_t _requested_level = NOT_REQUESTED; // the finest mip level needed to draw the current frame
+            uint32_t _image_version = 0; // changes whenever a new image (view) gets created, so that materials know when to update their descriptor sets
+
+            bool _mip_maps_outdated = false; // set by setData(), textures shared by multiple materials only need to generate them once
+            bool _storage_mip_maps = false; // the mip levels can be written by the MipMapGenerator (through views in the linear format)
+
+            friend MipMapGenerator;
 
           public:
 
+            const static uint32_t NOT_REQUESTED = 0xFFFFFFFF;
+
             void init(const vulkan::LogicalDevice& device, vma::VulkanMemoryAllocator& allocator, Type type);
             void cleanUp();
 
-            // assuming that each channel is one byte
+            /** @brief assuming that each channel is one byte
+             * only diffuse textures store srgb colors, all other types store linear data
+             * grayscale images (1 or 2 channels) are kept as R8 / R8G8 and expanded to rgba when sampled,
+             * unless the device cant sample and blit those formats (then the data gets expanded to rgba before the upload) */
             void setData(const void* data, uint32_t width, uint32_t height, uint32_t nr_channels, vulkan::TransferBuffer& transfer_buffer);
 
+            /** @brief stores data that already contains mip levels (starting with the full size level, each level is half the size of the previous one)
+             * the data is used in the given format (block compressed, i.e. UND_BC1_SRGB, or uncompressed, i.e. UND_R8G8B8A8)
+             * if less levels than a full mip chain are given, the texture only gets those levels
+             * @param first_level the finest level that gets stored in the image (used by the TextureStreamer to only keep the coarser levels resident)
+             * a new image (and image view) gets created, cleaning up the previous one is up to the caller
+             * (nothing gets created if the device cant sample the format, see isFormatSupported()) */
+            void setData(const std::vector<std::vector<uint8_t>>& mip_levels, uint32_t width, uint32_t height, const FixedType& format, vulkan::TransferBuffer& transfer_buffer, uint32_t first_level = 0);
+
             // records the commands to generate the mip maps
+            // (if they werent generated since the last call to setData())
             void genMipMaps(vulkan::CommandBuffer& cmd);
 
+            /** @brief tells the TextureStreamer how large the texture appears on the screen this frame (its largest side, in pixels)
+             * the finest level that is needed is the one with about one texel per pixel (the smallest request of a frame wins) */
+            void requestResolution(float pixels);
+
+            /// @return the finest level requested since the last call to clearRequestedLevel(), NOT_REQUESTED if the texture wasnt drawn
+            uint32_t getRequestedLevel() const;
+            void clearRequestedLevel();
+
             uint32_t getWidth() const;
             uint32_t getHeight() const;
             uint32_t getNrChannels() const;
+            uint32_t getMipLevels() const; // the number of levels stored in the image
+            uint32_t getFirstLevel() const;
+            uint32_t getImageVersion() const;
+            const FixedType& getFormat() const;
             Type getType() const;
 
             const vulkan::Image& getImage() const;
             const vulkan::ImageView& getImageView() const;
 
+            /// @return true, if the format stores blocks of 4x4 texels (i.e. UND_BC1), the size of the format is the size of a block then
+            bool static isBlockCompressed(const FixedType& format);
+            uint32_t static getChannelCount(const FixedType& format);
+
+            /// @return true, if the device can sample images in the format (block compressed formats need the textureCompressionBC feature)
+            bool static isFormatSupported(const vulkan::LogicalDevice& device, const FixedType& format);
+
+            /// @return the format without the srgb encoding (i.e. UND_R8G8B8A8 for UND_R8G8B8A8_SRGB)
+            FixedType static getLinearFormat(const FixedType& format);
+
           protected:
             // non public Texture functions
 
             uint32_t static calcMipLevelCount(uint32_t width, uint32_t height);
 
+            /// @return the swizzle that makes an image with the number of channels appear as rgba to the shaders
+            VkComponentMapping static chooseSwizzle(uint32_t nr_channels);
+
+            /// @brief expands the texels to 4 channels (gray -> (g,g,g,255), gray + alpha -> (g,g,g,a), rgb -> (r,g,b,255))
+            void static expandToRGBA(const uint8_t* data, uint32_t texel_count, uint32_t nr_channels, std::vector<uint8_t>& load_to);
+
         };
 
     } // graphics
@@ -0,0 +1,79 @@
+#include "texture_cache.h"
+
+#include "filesystem"
+#include "algorithm"
+
+namespace undicht {
+
+    namespace graphics {
+
+        std::shared_ptr<Texture> TextureCache::find(const std::string& file_name, Texture::Type type, const FixedType& format) {
+            /// @return the cached texture, nullptr if the file wasnt loaded as the type with the format yet (or all users of the texture released it)
+
+            auto entries = _textures.find(getCanonicalPath(file_name));
+            if(entries == _textures.end()) return nullptr;
+
+            for(const Entry& entry : entries->second)
+                if((entry._type == type) && (entry._format == format))
+                    return entry._texture.lock();
+
+            return nullptr;
+        }
+
+        void TextureCache::store(const std::string& file_name, Texture::Type type, const FixedType& format, const std::shared_ptr<Texture>& texture) {
+            /// @brief stores a (weak) reference to the texture, so that it can be found by later find() calls
+
+            std::vector<Entry>& entries = _textures[getCanonicalPath(file_name)];
+
+            for(Entry& entry : entries) {
+                if((entry._type == type) && (entry._format == format)) {
+                    entry._texture = texture; // replacing the old texture
+                    return;
+                }
+            }
+
+            entries.push_back({type, format, texture});
+        }
+
+        void TextureCache::removeExpired() {
+            /// @brief removes the entries of textures that were released
+
+            for(auto entries = _textures.begin(); entries != _textures.end();) {
+
+                std::vector<Entry>& e = entries->second;
+                e.erase(std::remove_if(e.begin(), e.end(), [](const Entry& entry){ return entry._texture.expired(); }), e.end());
+
+                if(e.empty()) entries = _textures.erase(entries);
+                else entries++;
+            }
+
+        }
+
+        void TextureCache::clear() {
+
+            _textures.clear();
+        }
+
+        std::shared_ptr<Texture> TextureCache::createTexture() {
+            /// @brief creates a texture that gets cleaned up once the last reference to it is released
+
+            return std::shared_ptr<Texture>(new Texture, [](Texture* texture) {
+                texture->cleanUp();
+                delete texture;
+            });
+        }
+
+        std::string TextureCache::getCanonicalPath(const std::string& file_name) {
+            /// @return the absolute path of the file, with symlinks and "." / ".." resolved (as far as the file exists)
+
+            std::error_code error;
+            std::filesystem::path path = std::filesystem::weakly_canonical(file_name, error);
+
+            if(error) return file_name;
+
+            return path.string();
+        }
+
+    } // graphics
+
+} // undicht
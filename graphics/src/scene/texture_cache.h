@@ -0,0 +1,57 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "texture.h"
+#include "types.h"
+
+#include "string"
+#include "vector"
+#include "map"
+#include "memory"
+
+namespace undicht {
+
+    namespace graphics {
+
+        class TextureCache {
+            /** @brief keeps track of the textures loaded from files (keyed by the canonical path of the file + the type and format of the texture)
+             * so that materials using the same image file (within one SceneGroup or across multiple ones) share one texture
+             * instead of decoding, uploading and storing it multiple times
+             * the cache doesnt own the textures, they get cleaned up once the last material using them released them */
+
+          protected:
+
+            struct Entry {
+                Texture::Type _type; // selects the format and color space the image gets loaded with
+                FixedType _format;
+                std::weak_ptr<Texture> _texture;
+            };
+
+            std::map<std::string, std::vector<Entry>> _textures; // entries for each canonical file path
+
+          public:
+
+            /// @return the cached texture, nullptr if the file wasnt loaded as the type with the format yet (or all users of the texture released it)
+            std::shared_ptr<Texture> find(const std::string& file_name, Texture::Type type, const FixedType& format);
+
+            /// @brief stores a (weak) reference to the texture, so that it can be found by later find() calls
+            void store(const std::string& file_name, Texture::Type type, const FixedType& format, const std::shared_ptr<Texture>& texture);
+
+            /// @brief removes the entries of textures that were released
+            void removeExpired();
+
+            void clear();
+
+            /// @brief creates a texture that gets cleaned up once the last reference to it is released
+            std::shared_ptr<Texture> static createTexture();
+
+            /// @return the absolute path of the file, with symlinks and "." / ".." resolved (as far as the file exists)
+            std::string static getCanonicalPath(const std::string& file_name);
+
+        };
+
+    } // graphics
+
+} // undicht
+
+#endif // TEXTURE_CACHE_H
@@ -0,0 +1,272 @@
+#include "texture_streamer.h"
+#include "debug.h"
+#include "linear_arena.h"
+
+#include "algorithm"
+#include "queue"
+#include "tuple"
+
+namespace undicht {
+
+    namespace graphics {
+
+        using namespace vulkan;
+
+        namespace {
+
+            // the levels up to this size (in texels) are always resident
+            const uint32_t MIN_RESIDENT_SIZE = 64;
+
+            // replaced images / descriptor sets are released after this many updates
+            // (the FrameManager records the next frame while the previous one is in flight)
+            const uint32_t RETIRE_DELAY = 3;
+
+        }
+
+        void TextureStreamer::init(DescriptorSetCache& material_descriptor_cache, uint64_t memory_budget, uint32_t upload_budget) {
+
+            _material_descriptor_cache = &material_descriptor_cache;
+            _memory_budget = memory_budget;
+            _upload_budget = upload_budget;
+
+        }
+
+        void TextureStreamer::cleanUp() {
+            /// @brief releases the retired images and descriptor sets (the gpu should be idle)
+
+            releaseRetired(true);
+            _textures.clear();
+            _resident_size = 0;
+
+        }
+
+        void TextureStreamer::setMemoryBudget(uint64_t bytes) {
+
+            _memory_budget = bytes;
+        }
+
+        void TextureStreamer::setUploadBudget(uint32_t bytes) {
+
+            _upload_budget = bytes;
+        }
+
+        void TextureStreamer::addTexture(const std::shared_ptr<Texture>& texture, std::vector<std::vector<uint8_t>>&& mip_levels, uint32_t width, uint32_t height, const FixedType& format, TransferBuffer& transfer_buffer) {
+            /** @brief the texture gets streamed from now on, starting with only its smallest levels resident
+             * (the texture has to be initialized, its data gets replaced) */
+
+            if(mip_levels.empty()) {
+                UND_ERROR << "cant stream a texture without mip levels\n";
+                return;
+            }
+
+            StreamedTexture streamed;
+            streamed._texture = texture;
+            streamed._mip_levels = std::move(mip_levels);
+            streamed._width = width;
+            streamed._height = height;
+            streamed._format = format;
+
+            // levels beyond the 1x1 level would be ignored by the texture
+            uint32_t max_level_count = 1;
+            while(std::max(width, height) >> max_level_count) max_level_count++;
+            if(streamed._mip_levels.size() > max_level_count) streamed._mip_levels.resize(max_level_count);
+
+            // the small levels are always resident (the texture can be drawn before any streaming happened)
+            uint32_t level_count = streamed._mip_levels.size();
+            while((streamed._min_level + 1 < level_count) && (std::max(width >> streamed._min_level, height >> streamed._min_level) > MIN_RESIDENT_SIZE))
+                streamed._min_level++;
+
+            streamed._first_level = level_count; // nothing is resident yet
+            setResidentLevels(streamed, streamed._min_level, transfer_buffer);
+            streamed._target_level = streamed._min_level;
+
+            _textures.push_back(std::move(streamed));
+        }
+
+        void TextureStreamer::update(Scene& scene, TransferBuffer& transfer_buffer) {
+            /** @brief changes the resident levels of the textures based on the levels requested while drawing the previous frame
+             * and updates the descriptor sets of the materials in the scene that use the changed textures
+             * call once per frame, before recording the draw commands (the transfers have to be completed before drawing)
+             * the transfer buffer should not be flushed, the streamer only uses the space that is left */
+
+            _frame++;
+            releaseRetired(false);
+
+            // forget the textures that were released by all materials (their images were cleaned up with them)
+            for(const StreamedTexture& t : _textures)
+                if(t._texture.expired()) _resident_size -= calcResidentSize(t, t._first_level);
+
+            _textures.erase(std::remove_if(_textures.begin(), _textures.end(), [](const StreamedTexture& t){return t._texture.expired();}), _textures.end());
+
+            chooseTargetLevels();
+
+            for(StreamedTexture& t : _textures)
+                t._texture.lock()->clearRequestedLevel();
+
+            bool changed = false;
+            uint64_t uploaded = 0;
+
+            // evicting levels first (the remaining levels get copied to the new image as well)
+            for(StreamedTexture& t : _textures) {
+
+                if(t._target_level <= t._first_level) continue;
+
+                uint64_t upload_size = calcResidentSize(t, t._target_level);
+                if(upload_size > transfer_buffer.getFreeSize()) continue; // trying again next frame
+
+                setResidentLevels(t, t._target_level, transfer_buffer);
+                uploaded += upload_size;
+                changed = true;
+            }
+
+            // streaming in one level per texture, starting with the textures that are missing the most levels
+            FrameVector<StreamedTexture*> stream_in;
+            for(StreamedTexture& t : _textures)
+                if(t._target_level < t._first_level) stream_in.push_back(&t);
+
+            std::sort(stream_in.begin(), stream_in.end(), [](const StreamedTexture* a, const StreamedTexture* b) {
+                return (a->_first_level - a->_target_level) > (b->_first_level - b->_target_level);
+            });
+
+            for(StreamedTexture* t : stream_in) {
+
+                uint32_t first_level = t->_first_level - 1;
+                uint64_t upload_size = calcResidentSize(*t, first_level);
+                uint64_t resident_size = _resident_size - calcResidentSize(*t, t->_first_level) + upload_size;
+
+                if(uploaded + upload_size > _upload_budget) continue;
+                if(upload_size > transfer_buffer.getFreeSize()) continue;
+                if(resident_size > _memory_budget) continue;
+
+                setResidentLevels(*t, first_level, transfer_buffer);
+                uploaded += upload_size;
+                changed = true;
+            }
+
+            if(!changed) return;
+
+            // the materials using the changed textures need new descriptor sets
+            for(SceneGroup& group : scene.getGroups()) {
+                for(Material& material : group.getMaterials()) {
+
+                    RetiredResources retired;
+                    retired._has_descriptor_set = material.rebindStreamedTextures(retired._descriptor_set);
+                    retired._frame = _frame;
+
+                    if(retired._has_descriptor_set) _retired.push_back(retired);
+                }
+            }
+
+        }
+
+        uint64_t TextureStreamer::getResidentSize() const {
+            /// @return the memory used by the resident levels of all textures (in bytes)
+
+            return _resident_size;
+        }
+
+        uint32_t TextureStreamer::getTextureCount() const {
+
+            return _textures.size();
+        }
+
+        //////////////////////////////////// non public TextureStreamer functions ////////////////////////////////////
+
+        void TextureStreamer::chooseTargetLevels() {
+            /// @brief chooses the target levels of all textures, so that they fit into the memory budget
+
+            // the textures that werent drawn keep their levels (unless memory is needed)
+            uint64_t total_size = 0;
+            for(StreamedTexture& t : _textures) {
+
+                uint32_t requested = t._texture.lock()->getRequestedLevel();
+                t._target_level = (requested == Texture::NOT_REQUESTED) ? t._first_level : std::min(requested, t._min_level);
+                total_size += calcResidentSize(t, t._target_level);
+            }
+
+            if(total_size <= _memory_budget) return;
+
+            // evicting the finest levels, first of the textures that werent drawn, then of the textures with the largest finest level
+            std::priority_queue<std::tuple<bool, uint64_t, uint32_t>> eviction_queue; // (not drawn, size of the finest level, texture id)
+            for(uint32_t i = 0; i < _textures.size(); i++) {
+
+                StreamedTexture& t = _textures.at(i);
+                bool drawn = t._texture.lock()->getRequestedLevel() != Texture::NOT_REQUESTED;
+
+                if(t._target_level < t._min_level)
+                    eviction_queue.push({!drawn, t._mip_levels.at(t._target_level).size(), i});
+            }
+
+            while((total_size > _memory_budget) && !eviction_queue.empty()) {
+
+                bool not_drawn = std::get<0>(eviction_queue.top());
+                uint32_t id = std::get<2>(eviction_queue.top());
+                eviction_queue.pop();
+
+                StreamedTexture& t = _textures.at(id);
+                total_size -= t._mip_levels.at(t._target_level).size();
+                t._target_level++;
+
+                if(t._target_level < t._min_level)
+                    eviction_queue.push({not_drawn, t._mip_levels.at(t._target_level).size(), id});
+            }
+
+        }
+
+        void TextureStreamer::setResidentLevels(StreamedTexture& texture, uint32_t first_level, TransferBuffer& transfer_buffer) {
+            /// @brief creates a new image for the texture with the levels starting at first_level
+
+            std::shared_ptr<Texture> t = texture._texture.lock();
+            if(!t) return;
+
+            // the old image might still be used by frames in flight
+            RetiredResources retired;
+            retired._image = t->getImage();
+            retired._image_view = t->getImageView();
+            retired._has_image = retired._image.getImage() != VK_NULL_HANDLE;
+            retired._frame = _frame;
+
+            if(retired._has_image) _retired.push_back(retired);
+
+            t->setData(texture._mip_levels, texture._width, texture._height, texture._format, transfer_buffer, first_level);
+
+            _resident_size -= calcResidentSize(texture, texture._first_level);
+            _resident_size += calcResidentSize(texture, first_level);
+            texture._first_level = first_level;
+
+        }
+
+        void TextureStreamer::releaseRetired(bool all) {
+            /// @param all if false, only resources that the frames in flight dont use anymore get released
+
+            auto released = [&](RetiredResources& r) {
+
+                if(!all && (_frame - r._frame < RETIRE_DELAY)) return false;
+
+                if(r._has_image) {
+                    r._image_view.cleanUp();
+                    r._image.cleanUp();
+                }
+
+                if(r._has_descriptor_set)
+                    _material_descriptor_cache->release(r._descriptor_set);
+
+                return true;
+            };
+
+            _retired.erase(std::remove_if(_retired.begin(), _retired.end(), released), _retired.end());
+        }
+
+        uint64_t TextureStreamer::calcResidentSize(const StreamedTexture& texture, uint32_t first_level) {
+            /// @return the size of the levels starting at first_level
+
+            uint64_t size = 0;
+            for(uint32_t i = first_level; i < texture._mip_levels.size(); i++)
+                size += texture._mip_levels.at(i).size();
+
+            return size;
+        }
+
+    } // graphics
+
+} // undicht
@@ -0,0 +1,108 @@
+#ifndef TEXTURE_STREAMER_H
+#define TEXTURE_STREAMER_H
+
+#include "texture.h"
+#include "scene.h"
+#include "core/vulkan/image.h"
+#include "core/vulkan/image_view.h"
+#include "core/vulkan/descriptor_set.h"
+#include "renderer/vulkan/descriptor_set_cache.h"
+#include "renderer/vulkan/transfer_buffer.h"
+#include "types.h"
+
+#include "cstdint"
+#include "vector"
+#include "memory"
+
+namespace undicht {
+
+    namespace graphics {
+
+        class TextureStreamer {
+            /** @brief keeps only the mip levels of textures resident, that are needed to draw the current view
+             * the streamer stores all mip levels of its textures in (cpu) memory, the textures start with only the smallest levels resident
+             * the renderer requests the finest level it needs for each drawn material (based on the size of its nodes on the screen),
+             * finer levels get streamed in one level per update, as long as the textures fit into the memory budget
+             * under memory pressure, the finest levels of textures that werent drawn (and then of the largest textures) get evicted
+             * changing the resident levels creates a new image for the texture, the old images (and the descriptor sets that used them)
+             * get released once the frames in flight finished using them
+             * the streamer doesnt own the textures, they get cleaned up once the last material using them released them */
+
+          protected:
+
+            struct StreamedTexture {
+                std::weak_ptr<Texture> _texture;
+                std::vector<std::vector<uint8_t>> _mip_levels; // all levels of the texture, starting with the full size level
+                uint32_t _width = 0;
+                uint32_t _height = 0;
+                FixedType _format;
+                uint32_t _first_level = 0; // the finest level that is resident
+                uint32_t _target_level = 0; // the finest level that should be resident
+                uint32_t _min_level = 0; // the finest level of the levels that are always resident
+            };
+
+            struct RetiredResources {
+                vulkan::Image _image;
+                vulkan::ImageView _image_view;
+                vulkan::DescriptorSet _descriptor_set;
+                bool _has_image = false;
+                bool _has_descriptor_set = false;
+                uint32_t _frame = 0; // the update in which the resources were replaced
+            };
+
+            vulkan::DescriptorSetCache* _material_descriptor_cache = nullptr;
+
+            std::vector<StreamedTexture> _textures;
+            std::vector<RetiredResources> _retired;
+
+            uint64_t _memory_budget = 0; // for the resident levels of all textures (in bytes)
+            uint32_t _upload_budget = 0; // per update (in bytes)
+            uint64_t _resident_size = 0;
+            uint32_t _frame = 0;
+
+          public:
+
+            void init(vulkan::DescriptorSetCache& material_descriptor_cache, uint64_t memory_budget, uint32_t upload_budget = 8000000);
+
+            /// @brief releases the retired images and descriptor sets (the gpu should be idle)
+            void cleanUp();
+
+            void setMemoryBudget(uint64_t bytes);
+            void setUploadBudget(uint32_t bytes);
+
+            /** @brief the texture gets streamed from now on, starting with only its smallest levels resident
+             * (the texture has to be initialized, its data gets replaced) */
+            void addTexture(const std::shared_ptr<Texture>& texture, std::vector<std::vector<uint8_t>>&& mip_levels, uint32_t width, uint32_t height, const FixedType& format, vulkan::TransferBuffer& transfer_buffer);
+
+            /** @brief changes the resident levels of the textures based on the levels requested while drawing the previous frame
+             * and updates the descriptor sets of the materials in the scene that use the changed textures
+             * call once per frame, before recording the draw commands (the transfers have to be completed before drawing)
+             * the transfer buffer should not be flushed, the streamer only uses the space that is left */
+            void update(Scene& scene, vulkan::TransferBuffer& transfer_buffer);
+
+            /// @return the memory used by the resident levels of all textures (in bytes)
+            uint64_t getResidentSize() const;
+            uint32_t getTextureCount() const;
+
+          protected:
+            // non public TextureStreamer functions
+
+            /// @brief chooses the target levels of all textures, so that they fit into the memory budget
+            void chooseTargetLevels();
+
+            /// @brief creates a new image for the texture with the levels starting at first_level
+            void setResidentLevels(StreamedTexture& texture, uint32_t first_level, vulkan::TransferBuffer& transfer_buffer);
+
+            /// @param all if false, only resources that the frames in flight dont use anymore get released
+            void releaseRetired(bool all);
+
+            /// @return the size of the levels starting at first_level
+            uint64_t static calcResidentSize(const StreamedTexture& texture, uint32_t first_level);
+
+        };
+
+    } // graphics
+
+} // undicht
+
+#endif // TEXTURE_STREAMER_H
@@ -19,7 +19,7 @@ for i in range(1, len(sys.argv)):
 	# find all glsl source files in the base_dir
 	glsl_source_files=[]
 	for file in os.listdir(base_dir):
-		if file.endswith(".vert") or file.endswith(".frag"):
+		if file.endswith(".vert") or file.endswith(".frag") or file.endswith(".comp"):
 		    glsl_source_files.append(file) # contains only the file name, not the path
 
 	# compile all the source files
@@ -0,0 +1,79 @@
+#include "jolt_job_system.h"
+
+#include "thread"
+#include "chrono"
+
+using namespace JPH;
+
+namespace undicht {
+
+    namespace physics {
+
+        void JoltJobSystem::init(undicht::JobSystem& job_system, uint max_jobs, uint max_barriers) {
+            /// @param max_jobs max number of jobs that can be allocated at the same time
+            /// @param max_barriers max number of barriers that can be allocated at the same time
+
+            JobSystemWithBarrier::Init(max_barriers);
+
+            _job_system = &job_system;
+            _jobs.Init(max_jobs, max_jobs);
+
+        }
+
+        int JoltJobSystem::GetMaxConcurrency() const {
+
+            // the thread waiting for the physics update helps executing the jobs
+            return _job_system->getWorkerCount() + 1;
+        }
+
+        JoltJobSystem::JobHandle JoltJobSystem::CreateJob(const char* inName, ColorArg inColor, const JobFunction& inJobFunction, uint32 inNumDependencies) {
+
+            // waiting until a job becomes available
+            uint32 index;
+            while(true) {
+
+                index = _jobs.ConstructObject(inName, inColor, this, inJobFunction, inNumDependencies);
+                if(index != FixedSizeFreeList<Job>::cInvalidObjectIndex) break;
+
+                JPH_ASSERT(false, "No jobs available!");
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+
+            Job* job = &_jobs.Get(index);
+
+            // the handle keeps a reference, since the job may finish right after being queued
+            JobHandle handle(job);
+
+            if(inNumDependencies == 0)
+                QueueJob(job);
+
+            return handle;
+        }
+
+        void JoltJobSystem::QueueJob(Job* inJob) {
+
+            // the reference is released once the job was executed
+            inJob->AddRef();
+
+            _job_system->run([inJob](){
+                inJob->Execute();
+                inJob->Release();
+            });
+
+        }
+
+        void JoltJobSystem::QueueJobs(Job** inJobs, uint inNumJobs) {
+
+            for(uint i = 0; i < inNumJobs; i++)
+                QueueJob(inJobs[i]);
+
+        }
+
+        void JoltJobSystem::FreeJob(Job* inJob) {
+
+            _jobs.DestructObject(inJob);
+        }
+
+    } // physics
+
+} // undicht
@@ -0,0 +1,48 @@
+#ifndef JOLT_JOB_SYSTEM_H
+#define JOLT_JOB_SYSTEM_H
+
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/JobSystemWithBarrier.h>
+#include <Jolt/Core/FixedSizeFreeList.h>
+#include <Jolt/Physics/PhysicsSettings.h>
+
+#include "job_system.h"
+
+namespace undicht {
+
+    namespace physics {
+
+        class JoltJobSystem : public JPH::JobSystemWithBarrier {
+            /** implements the job system interface of JoltPhysics,
+             * so that the physics jobs run on the workers of an undicht::JobSystem
+             * (instead of creating a separate thread pool, which would compete with the engines workers for the cores)
+             * the job objects are managed the same way as in JPH::JobSystemThreadPool */
+          protected:
+
+            undicht::JobSystem* _job_system = nullptr;
+
+            JPH::FixedSizeFreeList<Job> _jobs;
+
+          public:
+
+            /// @param max_jobs max number of jobs that can be allocated at the same time
+            /// @param max_barriers max number of barriers that can be allocated at the same time
+            void init(undicht::JobSystem& job_system, JPH::uint max_jobs = JPH::cMaxPhysicsJobs, JPH::uint max_barriers = JPH::cMaxPhysicsBarriers);
+
+            // functions of the JPH::JobSystem interface
+            virtual int GetMaxConcurrency() const override;
+            virtual JobHandle CreateJob(const char* inName, JPH::ColorArg inColor, const JobFunction& inJobFunction, JPH::uint32 inNumDependencies = 0) override;
+
+          protected:
+
+            virtual void QueueJob(Job* inJob) override;
+            virtual void QueueJobs(Job** inJobs, JPH::uint inNumJobs) override;
+            virtual void FreeJob(Job* inJob) override;
+
+        };
+
+    } // physics
+
+} // undicht
+
+#endif // JOLT_JOB_SYSTEM_H
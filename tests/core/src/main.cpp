@@ -4,6 +4,19 @@
 #include "types.h"
 #include "buffer_layout.h"
 #include "debug.h"
+#include "profiler.h"
+#include "latency_histogram.h"
+#include "job_system.h"
+#include "linear_arena.h"
+#include "memory_tracker.h"
+#include "mapped_file.h"
+
+#include "thread"
+#include "fstream"
+#include "string"
+#include "vector"
+#include "cstdio"
+#include "filesystem"
 
 using namespace undicht;
 
@@ -35,6 +48,209 @@ int main() {
     assert(test_layout.getOffset(1) == 4);
     assert(test_layout.getType(0) == UND_FLOAT32);
 
+    // Logger
+    UND_LOG << "Testing the Logger class\n";
+    {
+        // logging into a temporary file instead of stdout
+        std::FILE* log_file = std::tmpfile();
+        assert(log_file);
+        Logger::flush();
+        Logger::setOutput(log_file);
+
+        std::vector<std::thread> logging_threads;
+        for(int i = 0; i < 4; i++)
+            logging_threads.emplace_back([i](){
+                for(int j = 0; j < 100; j++)
+                    UND_LOG << "thread " << i << " message " << j << " value " << 0.5f * j << "\n";
+            });
+
+        for(std::thread& t : logging_threads) t.join();
+        Logger::flush();
+        Logger::setOutput(nullptr);
+        assert(Logger::getDroppedCount() == 0);
+
+        std::string log(std::ftell(log_file), '\0');
+        std::rewind(log_file);
+        assert(std::fread(log.data(), 1, log.size(), log_file) == log.size());
+        std::fclose(log_file);
+
+        // all messages were written, the ones of each thread in the order they were logged
+        for(int i = 0; i < 4; i++) {
+            size_t position = 0;
+            for(int j = 0; j < 100; j++) {
+                std::string message = "    thread " + std::to_string(i) + " message " + std::to_string(j) + " value ";
+                position = log.find(message, position);
+                assert(position != std::string::npos);
+            }
+        }
+    }
+
+    bool evaluated = false;
+    UND_LOG_STREAM(UND_LOG_LEVEL_NOTE - 1) << (evaluated = true); // below the minimum level, so it should be removed
+    assert(!evaluated);
+
+    // Profiler
+    UND_LOG << "Testing the Profiler class\n";
+    Profiler::enableProfiler(true);
+    const std::string trace_file_name = (std::filesystem::temp_directory_path() / "core_test_trace.json").string();
+    assert(Profiler::beginTrace(trace_file_name));
+    assert(Profiler::getTaskNameID("test task") == Profiler::getTaskNameID(std::string("test task").c_str()));
+    assert(Profiler::getTaskNameID("test task") != Profiler::getTaskNameID("other task"));
+
+    std::vector<std::thread> profiled_threads;
+    for(int i = 0; i < 4; i++)
+        profiled_threads.emplace_back([](){
+            for(int j = 0; j < 100; j++) {
+                Profiler outer("test task");
+                Profiler inner("other task");
+            }
+        });
+
+    for(std::thread& t : profiled_threads) t.join();
+
+    std::vector<Profiler::Task> profiled_tasks;
+    Profiler::collectTasks(profiled_tasks);
+    assert(profiled_tasks.size() == 800);
+    for(const Profiler::Task& t : profiled_tasks) {
+        assert(t._start_time <= t._end_time);
+        assert(t._depth == (t._name_id == Profiler::getTaskNameID("other task")));
+    }
+
+    // threads started after others exited reuse their buffers
+    std::vector<uint32_t> thread_ids;
+    for(int i = 0; i < 2; i++) {
+        std::thread([](){ Profiler p("reused task"); }).join();
+        profiled_tasks.clear();
+        Profiler::collectTasks(profiled_tasks);
+        thread_ids.push_back(profiled_tasks.back()._thread_id);
+    }
+    assert(thread_ids.at(0) == thread_ids.at(1));
+
+    Profiler::recordCounter("test counter", 42);
+    Profiler::endTrace();
+    std::ifstream trace_file(trace_file_name);
+    std::string trace((std::istreambuf_iterator<char>(trace_file)), std::istreambuf_iterator<char>());
+    trace_file.close();
+    std::filesystem::remove(trace_file_name);
+    assert(trace.find("\"traceEvents\"") != std::string::npos);
+    assert(trace.find("\"name\":\"other task\",\"ph\":\"X\"") != std::string::npos);
+    assert(trace.find("\"name\":\"test counter\",\"ph\":\"C\"") != std::string::npos);
+    assert(trace.find("{\"value\":42}") != std::string::npos);
+    assert(trace.substr(trace.size() - 3) == "]}\n");
+    Profiler::enableProfiler(false);
+
+    // LatencyHistogram
+    UND_LOG << "Testing the LatencyHistogram class\n";
+    LatencyHistogram histogram;
+    for(uint64_t i = 1; i <= 1000; i++) histogram.record(i * 1000);
+    LatencyHistogram::Stats histogram_stats = histogram.getStats();
+    assert(histogram_stats._count == 1000);
+    assert(histogram_stats._min == 1000);
+    assert(histogram_stats._max == 1000000);
+    assert(histogram_stats._mean == 500500.0);
+    assert((histogram_stats._p50 > 470000) && (histogram_stats._p50 < 530000));
+    assert((histogram_stats._p99 > 930000) && (histogram_stats._p99 <= 1000000));
+    histogram.reset();
+    assert(histogram.getStats()._count == 0);
+
+    // aggregated profiler statistics
+    Profiler::enableProfiler(true);
+    Profiler::enableAggregation(true);
+    for(int i = 0; i < 10; i++) Profiler p("aggregated task");
+    assert(Profiler::getTaskStats("aggregated task")._count == 10);
+    Profiler::enableAggregation(false);
+    Profiler::enableProfiler(false);
+
+    // JobSystem
+    UND_LOG << "Testing the JobSystem class\n";
+    JobSystem job_system;
+    job_system.init(3);
+    assert(job_system.getWorkerCount() == 3);
+
+    std::vector<uint32_t> values(10000, 1);
+    std::atomic<uint64_t> sum = 0;
+    job_system.parallelFor(values.size(), 64, [&](uint32_t begin, uint32_t end) {
+        uint64_t batch_sum = 0;
+        for(uint32_t i = begin; i < end; i++) batch_sum += values.at(i);
+        sum += batch_sum;
+    });
+    assert(sum == 10000);
+
+    // jobs depending on other jobs, and jobs starting (and waiting for) jobs
+    std::atomic<uint32_t> first_stage = 0;
+    std::atomic<bool> dependency_respected = true;
+    JobCounter first_counter, second_counter;
+    for(int i = 0; i < 16; i++)
+        job_system.run([&](){ first_stage++; }, &first_counter);
+    job_system.run([&](){
+        dependency_respected = (first_stage == 16);
+        JobCounter nested_counter;
+        for(int i = 0; i < 16; i++)
+            job_system.run([&](){ first_stage++; }, &nested_counter);
+        job_system.wait(nested_counter);
+    }, &second_counter, &first_counter);
+    job_system.wait(second_counter);
+    assert(dependency_respected);
+    assert(first_stage == 32);
+
+    job_system.cleanUp();
+
+    // LinearArena
+    UND_LOG << "Testing the LinearArena class\n";
+    LinearArena arena;
+    arena.init(1024);
+    arena.allocate(3, 1);
+    assert(((uintptr_t)arena.allocate(16, 64) % 64) == 0);
+    arena.allocate(4096); // doesnt fit into the block
+    assert(arena.getUsedSize() >= 4096 + 16);
+    arena.reset();
+    assert(arena.getUsedSize() == 0);
+    assert(arena.getCapacity() >= 4096 + 1024); // the arena grew to fit the whole frame
+    arena.cleanUp();
+
+    FrameArena::nextFrame();
+    FrameVector<uint32_t> frame_values;
+    for(uint32_t i = 0; i < 1000; i++) frame_values.push_back(i);
+    assert(frame_values.at(999) == 999);
+    assert(FrameArena::get().getUsedSize() >= 1000 * sizeof(uint32_t));
+    FrameArena::nextFrame();
+    assert(FrameArena::get().getUsedSize() == 0);
+
+    // MemoryTracker
+    UND_LOG << "Testing the MemoryTracker class\n";
+    MemoryTracker::recordDeviceAllocation(1024);
+    MemoryTracker::recordDeviceAllocation(512);
+    MemoryTracker::recordDeviceFree(1024);
+    assert(MemoryTracker::getDeviceStats()._current_bytes == 512);
+    assert(MemoryTracker::getDeviceStats()._peak_bytes == 1536);
+    MemoryTracker::recordDeviceFree(512);
+
+    if(MemoryTracker::isTrackingHeap()) {
+        MemoryTracker::markFrame();
+        uint64_t thread_allocations = MemoryTracker::getThreadStats()._allocations;
+        std::vector<uint32_t>* heap_values = new std::vector<uint32_t>(100);
+        assert(MemoryTracker::getThreadStats()._allocations == thread_allocations + 2);
+        delete heap_values;
+        MemoryTracker::markFrame();
+        assert(MemoryTracker::getFrameStats()._allocations >= 2);
+        assert(MemoryTracker::getFrameStats()._allocated_bytes >= sizeof(std::vector<uint32_t>) + 100 * sizeof(uint32_t));
+    }
+
+    // MappedFile
+    UND_LOG << "Testing the MappedFile class\n";
+    {
+        const std::string file_name = (std::filesystem::temp_directory_path() / "core_test_mapped.bin").string();
+        std::ofstream(file_name, std::ios::binary | std::ios::trunc) << "mapped file content";
+        MappedFile mapped_file;
+        assert(mapped_file.open(file_name));
+        assert(mapped_file.getSize() == 19);
+        assert(!std::string((const char*)mapped_file.getData(), mapped_file.getSize()).compare("mapped file content"));
+        mapped_file.close();
+        assert(!mapped_file.isOpen() && !mapped_file.getData());
+        std::filesystem::remove(file_name);
+        assert(!mapped_file.open(file_name));
+    }
+
     UND_LOG << "All Tests for undicht core passed!\n";
     return 0;
 }
\ No newline at end of file
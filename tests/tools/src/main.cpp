@@ -0,0 +1,155 @@
+#include <cassert>
+
+#include "debug.h"
+#include "scene_loader/texture_compressor.h"
+#include "scene_loader/vertex_packer.h"
+
+#include "cstring"
+#include "cstdlib"
+#include "vector"
+#include "filesystem"
+
+using namespace undicht;
+using namespace tools;
+
+// this little program tests parts of the tools project that dont need a gpu
+
+namespace {
+
+    void decodeBC1Block(const uint8_t* block, uint8_t* load_to) {
+        // decodes the 16 texels of a BC1 block (4 color mode) to rgb
+
+        uint16_t colors[2];
+        uint32_t indices;
+        std::memcpy(colors, block, 4);
+        std::memcpy(&indices, block + 4, 4);
+
+        int palette[4][3];
+        for(int i = 0; i < 2; i++) {
+            palette[i][0] = ((colors[i] >> 11) & 31) * 255 / 31;
+            palette[i][1] = ((colors[i] >> 5) & 63) * 255 / 63;
+            palette[i][2] = (colors[i] & 31) * 255 / 31;
+        }
+
+        for(int c = 0; c < 3; c++) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        for(int i = 0; i < 16; i++)
+            for(int c = 0; c < 3; c++)
+                load_to[3 * i + c] = palette[(indices >> (2 * i)) & 3][c];
+
+    }
+
+}
+
+int main() {
+
+    UND_LOG << "Testing undicht tools\n";
+
+    // TextureCompressor
+    UND_LOG << "Testing the TextureCompressor class\n";
+    {
+        // a red / green checker (the colors vary orthogonal to gray)
+        uint8_t block[64];
+        for(int i = 0; i < 16; i++) {
+            bool red = ((i % 4) + (i / 4)) % 2;
+            block[4 * i + 0] = red ? 255 : 0;
+            block[4 * i + 1] = red ? 0 : 255;
+            block[4 * i + 2] = 0;
+            block[4 * i + 3] = 255;
+        }
+
+        uint8_t compressed[8];
+        TextureCompressor::encodeBC1Block(block, compressed);
+
+        uint8_t decoded[48];
+        decodeBC1Block(compressed, decoded);
+
+        for(int i = 0; i < 16; i++)
+            for(int c = 0; c < 3; c++)
+                assert(std::abs(int(decoded[3 * i + c]) - int(block[4 * i + c])) <= 8);
+
+        // only diffuse maps use the srgb formats
+        assert(TextureCompressor::chooseFormat(block, 4, 4, graphics::Texture::Type::DIFFUSE) == UND_BC1_SRGB);
+        assert(TextureCompressor::chooseFormat(block, 4, 4, graphics::Texture::Type::SPECULAR) == UND_BC1);
+        assert(TextureCompressor::chooseFormat(block, 4, 4, graphics::Texture::Type::NORMAL) == UND_BC5);
+
+        block[3] = 128;
+        assert(TextureCompressor::chooseFormat(block, 4, 4, graphics::Texture::Type::DIFFUSE) == UND_BC3_SRGB);
+        assert(TextureCompressor::chooseFormat(block, 4, 4, graphics::Texture::Type::SPECULAR) == UND_BC3);
+
+        // decoding (used when the device cant sample the format) gives the same texels
+        std::vector<uint8_t> decompressed;
+        assert(TextureCompressor::decompressLevel(compressed, 4, 4, UND_BC1, decompressed));
+        for(int i = 0; i < 16; i++)
+            for(int c = 0; c < 3; c++)
+                assert(decompressed[4 * i + c] == decoded[3 * i + c]);
+
+        // a 6x6 image (the edge blocks extend beyond it) with a red / green gradient, stored as BC5
+        uint8_t gradient[6 * 6 * 4];
+        for(int i = 0; i < 36; i++) {
+            gradient[4 * i + 0] = (i % 6) * 51;
+            gradient[4 * i + 1] = (i / 6) * 51;
+            gradient[4 * i + 2] = 0;
+            gradient[4 * i + 3] = 255;
+        }
+
+        std::vector<uint8_t> bc5;
+        TextureCompressor::compressLevel(gradient, 6, 6, UND_BC5, bc5);
+        assert(TextureCompressor::decompressLevel(bc5.data(), 6, 6, UND_BC5, decompressed));
+        assert(decompressed.size() == sizeof(gradient));
+        for(int i = 0; i < 36; i++)
+            for(int c = 0; c < 4; c++)
+                assert(std::abs(int(decompressed[4 * i + c]) - int(gradient[4 * i + c])) <= 12); // 8 values per block
+
+        assert(!TextureCompressor::decompressLevel(compressed, 4, 4, UND_BC7, decompressed));
+
+        // storing a compressed image replaces the previous file (through a temporary file)
+        std::string file_name = (std::filesystem::temp_directory_path() / "undicht_tools_test.bc").string();
+
+        TextureCompressor::CompressedImage image;
+        TextureCompressor::compress(gradient, 6, 6, UND_BC5, image);
+        assert(TextureCompressor::store(file_name, 1, image));
+        assert(TextureCompressor::store(file_name, 2, image));
+        assert(!std::filesystem::exists(file_name + ".tmp"));
+
+        TextureCompressor::CompressedImage loaded;
+        assert(!TextureCompressor::load(file_name, 1, loaded));
+        assert(TextureCompressor::load(file_name, 2, loaded));
+        assert((loaded._width == 6) && (loaded._height == 6) && (loaded._mip_levels == image._mip_levels));
+
+        std::filesystem::remove(file_name);
+    }
+
+    // VertexPacker
+    UND_LOG << "Testing the VertexPacker class\n";
+    {
+        VertexPacker::Attributes attributes;
+        attributes._has_bones = true;
+
+        // 4 bone ids (uint32 stored in floats) + 4 weights per vertex
+        std::vector<float> vertices(8, 0.0f);
+        vertices[4] = 1.0f;
+
+        uint32_t bone_ids[4] = {255, 1, 2, 3};
+        std::memcpy(vertices.data(), bone_ids, sizeof(bone_ids));
+
+        std::vector<uint8_t> packed;
+        assert(VertexPacker::packVertices(vertices, attributes, packed));
+        assert(packed.size() == VertexPacker::calcPackedVertexSize(attributes));
+        assert((packed[0] == 255) && (packed[3] == 3) && (packed[4] == 255));
+
+        // bone ids that dont fit into 8 bits are rejected (instead of being remapped)
+        bone_ids[0] = 300;
+        std::memcpy(vertices.data(), bone_ids, sizeof(bone_ids));
+
+        packed.clear();
+        assert(!VertexPacker::packVertices(vertices, attributes, packed));
+        assert(packed.empty());
+    }
+
+    UND_LOG << "All Tests for undicht tools passed!\n";
+    return 0;
+}
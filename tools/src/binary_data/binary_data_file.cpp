@@ -114,8 +114,6 @@ namespace undicht {
                 writeBlockHeader(addBufferEntry(true, write_location, total_size));
             }
 
-            UND_LOG << "writing at location " << write_location << ", size: " << total_size << "\n";
-
             // write the data
             _file.write(data, byte_size);
 
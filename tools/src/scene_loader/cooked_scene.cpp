@@ -0,0 +1,488 @@
+#include "cooked_scene.h"
+#include "debug.h"
+
+#include "cstring"
+#include "fstream"
+#include "filesystem"
+
+namespace undicht {
+
+    namespace tools {
+
+        namespace {
+
+            const char COOKED_SCENE_MAGIC[8] = {'U', 'N', 'D', 'S', 'C', 'E', 'N', 'E'};
+            const uint32_t COOKED_SCENE_VERSION = 4; // increase when the format changes, so that old cooked files get recooked
+            const size_t BLOB_ALIGNMENT = 16;
+
+            class CookedSceneWriter {
+                // metadata gets written in order, the vertex / index blobs are collected in a separate section at the end of the file
+
+              public:
+
+                std::vector<uint8_t> _data;
+                std::vector<uint8_t> _blobs;
+
+                template<typename T>
+                void write(const T& value) {
+                    const uint8_t* bytes = (const uint8_t*)&value;
+                    _data.insert(_data.end(), bytes, bytes + sizeof(T));
+                }
+
+                void writeString(const std::string& str) {
+                    write(uint32_t(str.size()));
+                    _data.insert(_data.end(), str.begin(), str.end());
+                }
+
+                void writeBlob(const CookedScene::Blob& blob) {
+                    _blobs.resize((_blobs.size() + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1));
+                    write(uint64_t(_blobs.size()));
+                    write(blob._byte_size);
+                    if(blob._byte_size) _blobs.insert(_blobs.end(), blob.getData(), blob.getData() + blob._byte_size);
+                }
+
+            };
+
+            class CookedSceneReader {
+                // reads the metadata written by the CookedSceneWriter
+                // reading past the end marks the reader as invalid instead of crashing
+
+              public:
+
+                const uint8_t* _position = nullptr;
+                const uint8_t* _end = nullptr;
+                const uint8_t* _blobs = nullptr;
+                size_t _blobs_size = 0;
+                bool _valid = true;
+
+                template<typename T>
+                T read() {
+                    T value{};
+                    if(size_t(_end - _position) < sizeof(T)) {
+                        _valid = false;
+                        return value;
+                    }
+                    std::memcpy(&value, _position, sizeof(T));
+                    _position += sizeof(T);
+                    return value;
+                }
+
+                std::string readString() {
+                    uint32_t size = read<uint32_t>();
+                    if(!_valid || (size_t(_end - _position) < size)) {
+                        _valid = false;
+                        return "";
+                    }
+                    std::string str((const char*)_position, size);
+                    _position += size;
+                    return str;
+                }
+
+                uint32_t readCount() {
+                    // every element takes at least one byte, so bigger counts can only come from a corrupted file
+                    uint32_t count = read<uint32_t>();
+                    if(count > size_t(_end - _position)) {
+                        _valid = false;
+                        return 0;
+                    }
+                    return count;
+                }
+
+                void readBlob(CookedScene::Blob& blob) {
+                    uint64_t offset = read<uint64_t>();
+                    blob._byte_size = read<uint32_t>();
+                    if(!_valid || (offset > _blobs_size) || (blob._byte_size > _blobs_size - offset)) {
+                        _valid = false;
+                        blob._byte_size = 0;
+                        return;
+                    }
+                    blob._mapped_data = _blobs + offset;
+                }
+
+            };
+
+            //////////////////////////////////////// writing scene objects ////////////////////////////////////////
+
+            void writeNode(CookedSceneWriter& writer, const CookedScene::Node& node) {
+
+                writer.writeString(node._name);
+                writer.write(uint32_t(node._meshes.size()));
+                for(const std::string& mesh : node._meshes)
+                    writer.writeString(mesh);
+                writer.write(node._local_transformation);
+
+                writer.write(uint32_t(node._child_nodes.size()));
+                for(const CookedScene::Node& child : node._child_nodes)
+                    writeNode(writer, child);
+            }
+
+            void writeBone(CookedSceneWriter& writer, const CookedScene::Bone& bone) {
+
+                writer.writeString(bone._name);
+                writer.write(bone._local_matrix);
+
+                writer.write(uint32_t(bone._child_bones.size()));
+                for(const CookedScene::Bone& child : bone._child_bones)
+                    writeBone(writer, child);
+            }
+
+            template<typename T>
+            void writeKeys(CookedSceneWriter& writer, const std::vector<CookedScene::Key<T>>& keys) {
+
+                writer.write(uint32_t(keys.size()));
+                for(const CookedScene::Key<T>& key : keys) {
+                    writer.write(key._time);
+                    writer.write(key._value);
+                }
+            }
+
+            //////////////////////////////////////// reading scene objects ////////////////////////////////////////
+
+            void readNode(CookedSceneReader& reader, CookedScene::Node& node) {
+
+                node._name = reader.readString();
+                node._meshes.resize(reader.readCount());
+                for(std::string& mesh : node._meshes)
+                    mesh = reader.readString();
+                node._local_transformation = reader.read<glm::mat4>();
+
+                node._child_nodes.resize(reader.readCount());
+                for(CookedScene::Node& child : node._child_nodes)
+                    if(reader._valid) readNode(reader, child);
+            }
+
+            void readBone(CookedSceneReader& reader, CookedScene::Bone& bone) {
+
+                bone._name = reader.readString();
+                bone._local_matrix = reader.read<glm::mat4>();
+
+                bone._child_bones.resize(reader.readCount());
+                for(CookedScene::Bone& child : bone._child_bones)
+                    if(reader._valid) readBone(reader, child);
+            }
+
+            template<typename T>
+            void readKeys(CookedSceneReader& reader, std::vector<CookedScene::Key<T>>& keys) {
+
+                keys.resize(reader.readCount());
+                for(CookedScene::Key<T>& key : keys) {
+                    key._time = reader.read<double>();
+                    key._value = reader.read<T>();
+                }
+            }
+
+        } // anonymous namespace
+
+        //////////////////////////////////////////////// CookedScene::Blob ////////////////////////////////////////////////
+
+        void CookedScene::Blob::setData(const void* data, uint32_t byte_size) {
+
+            _storage.assign((const uint8_t*)data, (const uint8_t*)data + byte_size);
+            _mapped_data = nullptr;
+            _byte_size = byte_size;
+        }
+
+        uint8_t* CookedScene::Blob::resize(uint32_t byte_size) {
+            // @return the storage of the blob (to write the data to)
+
+            _storage.resize(byte_size);
+            _mapped_data = nullptr;
+            _byte_size = byte_size;
+
+            return _storage.data();
+        }
+
+        const uint8_t* CookedScene::Blob::getData() const {
+
+            return _mapped_data ? _mapped_data : _storage.data();
+        }
+
+        //////////////////////////////////////////////// CookedScene ////////////////////////////////////////////////
+
+        void CookedScene::clear() {
+            /// @brief removes all contents and unmaps the cooked file
+
+            _materials.clear();
+            _meshes.clear();
+            _skeletons.clear();
+            _animations.clear();
+            _root_node = Node();
+
+            _file.close();
+        }
+
+        bool CookedScene::load(const std::string& file_name, uint64_t source_hash, uint32_t import_flags) {
+            /** @brief maps the cooked file and reads the scene from it
+             * @return false, if the file doesnt exist, is corrupted or was cooked from a different source / with different import flags */
+
+            clear();
+
+            if(!_file.open(file_name)) return false;
+
+            CookedSceneReader reader;
+            reader._position = _file.getData();
+            reader._end = _file.getData() + _file.getSize();
+
+            // checking whether the cooked file is up to date
+            char magic[8];
+            for(char& c : magic) c = reader.read<char>();
+            uint32_t version = reader.read<uint32_t>();
+            uint32_t flags = reader.read<uint32_t>();
+            uint64_t hash = reader.read<uint64_t>();
+
+            if(!reader._valid || std::memcmp(magic, COOKED_SCENE_MAGIC, 8) || (version != COOKED_SCENE_VERSION) || (flags != import_flags) || (hash != source_hash)) {
+                clear();
+                return false;
+            }
+
+            // the blob section follows the metadata
+            uint64_t blobs_offset = reader.read<uint64_t>();
+            uint64_t blobs_size = reader.read<uint64_t>();
+            if(!reader._valid || (blobs_offset > _file.getSize()) || (blobs_size > _file.getSize() - blobs_offset) || (_file.getData() + blobs_offset < reader._position)) {
+                UND_WARNING << "cooked scene file is corrupted: " << file_name << "\n";
+                clear();
+                return false;
+            }
+
+            reader._end = _file.getData() + blobs_offset;
+            reader._blobs = _file.getData() + blobs_offset;
+            reader._blobs_size = blobs_size;
+
+            // materials
+            _materials.resize(reader.readCount());
+            for(Material& material : _materials) {
+                material._name = reader.readString();
+                material._textures.resize(reader.readCount());
+                for(Texture& texture : material._textures) {
+                    texture._type = (graphics::Texture::Type)reader.read<uint32_t>();
+                    texture._file_name = reader.readString();
+                }
+            }
+
+            // meshes
+            _meshes.resize(reader.readCount());
+            for(Mesh& mesh : _meshes) {
+                mesh._name = reader.readString();
+                mesh._material = reader.read<uint32_t>();
+                uint8_t attributes = reader.read<uint8_t>();
+                mesh._has_positions = attributes & 0x01;
+                mesh._has_tex_coords = attributes & 0x02;
+                mesh._has_normals = attributes & 0x04;
+                mesh._has_tangents_and_bitangents = attributes & 0x08;
+                mesh._has_bones = attributes & 0x10;
+                mesh._index_size = reader.read<uint8_t>();
+                if((mesh._index_size != 2) && (mesh._index_size != 4)) reader._valid = false;
+                mesh._bones.resize(reader.readCount());
+                for(std::string& bone : mesh._bones)
+                    bone = reader.readString();
+                reader.readBlob(mesh._vertex_data);
+                reader.readBlob(mesh._index_data);
+                mesh._lods.resize(reader.readCount());
+                for(graphics::Mesh::LOD& lod : mesh._lods) {
+                    lod._first_index = reader.read<uint32_t>();
+                    lod._index_count = reader.read<uint32_t>();
+                    lod._error = reader.read<float>();
+                    if(!reader._valid || (uint64_t(lod._first_index) + lod._index_count > mesh._index_data._byte_size / mesh._index_size)) reader._valid = false;
+                }
+                mesh._bounding_center = reader.read<glm::vec3>();
+                mesh._bounding_radius = reader.read<float>();
+            }
+
+            // node hierarchy
+            readNode(reader, _root_node);
+
+            // skeletons
+            _skeletons.resize(reader.readCount());
+            for(Skeleton& skeleton : _skeletons) {
+                skeleton._name = reader.readString();
+                readBone(reader, skeleton._root_bone);
+            }
+
+            // animations
+            _animations.resize(reader.readCount());
+            for(Animation& animation : _animations) {
+                animation._name = reader.readString();
+                animation._duration = reader.read<double>();
+                animation._ticks_per_second = reader.read<double>();
+                animation._node_animations.resize(reader.readCount());
+                for(NodeAnimation& node_animation : animation._node_animations) {
+                    node_animation._node = reader.readString();
+                    readKeys(reader, node_animation._position_keys);
+                    readKeys(reader, node_animation._rotation_keys);
+                    readKeys(reader, node_animation._scale_keys);
+                }
+            }
+
+            if(!reader._valid) {
+                UND_WARNING << "cooked scene file is corrupted: " << file_name << "\n";
+                clear();
+                return false;
+            }
+
+            return true;
+        }
+
+        bool CookedScene::store(const std::string& file_name, uint64_t source_hash, uint32_t import_flags) const {
+            /// @return false, if the file could not be written
+
+            CookedSceneWriter writer;
+
+            // materials
+            writer.write(uint32_t(_materials.size()));
+            for(const Material& material : _materials) {
+                writer.writeString(material._name);
+                writer.write(uint32_t(material._textures.size()));
+                for(const Texture& texture : material._textures) {
+                    writer.write(uint32_t(texture._type));
+                    writer.writeString(texture._file_name);
+                }
+            }
+
+            // meshes
+            writer.write(uint32_t(_meshes.size()));
+            for(const Mesh& mesh : _meshes) {
+                writer.writeString(mesh._name);
+                writer.write(mesh._material);
+                uint8_t attributes = 0;
+                if(mesh._has_positions) attributes |= 0x01;
+                if(mesh._has_tex_coords) attributes |= 0x02;
+                if(mesh._has_normals) attributes |= 0x04;
+                if(mesh._has_tangents_and_bitangents) attributes |= 0x08;
+                if(mesh._has_bones) attributes |= 0x10;
+                writer.write(attributes);
+                writer.write(uint8_t(mesh._index_size));
+                writer.write(uint32_t(mesh._bones.size()));
+                for(const std::string& bone : mesh._bones)
+                    writer.writeString(bone);
+                writer.writeBlob(mesh._vertex_data);
+                writer.writeBlob(mesh._index_data);
+                writer.write(uint32_t(mesh._lods.size()));
+                for(const graphics::Mesh::LOD& lod : mesh._lods) {
+                    writer.write(lod._first_index);
+                    writer.write(lod._index_count);
+                    writer.write(lod._error);
+                }
+                writer.write(mesh._bounding_center);
+                writer.write(mesh._bounding_radius);
+            }
+
+            // node hierarchy
+            writeNode(writer, _root_node);
+
+            // skeletons
+            writer.write(uint32_t(_skeletons.size()));
+            for(const Skeleton& skeleton : _skeletons) {
+                writer.writeString(skeleton._name);
+                writeBone(writer, skeleton._root_bone);
+            }
+
+            // animations
+            writer.write(uint32_t(_animations.size()));
+            for(const Animation& animation : _animations) {
+                writer.writeString(animation._name);
+                writer.write(animation._duration);
+                writer.write(animation._ticks_per_second);
+                writer.write(uint32_t(animation._node_animations.size()));
+                for(const NodeAnimation& node_animation : animation._node_animations) {
+                    writer.writeString(node_animation._node);
+                    writeKeys(writer, node_animation._position_keys);
+                    writeKeys(writer, node_animation._rotation_keys);
+                    writeKeys(writer, node_animation._scale_keys);
+                }
+            }
+
+            // header
+            const size_t header_size = 8 + 4 + 4 + 8 + 8 + 8;
+            uint64_t blobs_offset = (header_size + writer._data.size() + BLOB_ALIGNMENT - 1) & ~(BLOB_ALIGNMENT - 1);
+            uint64_t blobs_size = writer._blobs.size();
+
+            // writing to a temporary file, which replaces the old file once it is complete
+            // (the old file might be mapped by an import running on another thread, truncating it would invalidate the mapped data)
+            const std::string temp_file_name = file_name + ".tmp";
+            std::ofstream file(temp_file_name, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()) {
+                UND_WARNING << "failed to write the cooked scene file: " << file_name << "\n";
+                return false;
+            }
+
+            file.write(COOKED_SCENE_MAGIC, 8);
+            file.write((const char*)&COOKED_SCENE_VERSION, sizeof(uint32_t));
+            file.write((const char*)&import_flags, sizeof(uint32_t));
+            file.write((const char*)&source_hash, sizeof(uint64_t));
+            file.write((const char*)&blobs_offset, sizeof(uint64_t));
+            file.write((const char*)&blobs_size, sizeof(uint64_t));
+            file.write((const char*)writer._data.data(), writer._data.size());
+
+            // padding, so that the blobs are aligned in the mapped file
+            const char padding[BLOB_ALIGNMENT] = {};
+            file.write(padding, blobs_offset - header_size - writer._data.size());
+            file.write((const char*)writer._blobs.data(), writer._blobs.size());
+
+            file.close();
+
+            std::error_code error;
+            if(file.good()) std::filesystem::rename(temp_file_name, file_name, error);
+
+            if(!file.good() || error) {
+                UND_WARNING << "failed to write the cooked scene file: " << file_name << "\n";
+                std::filesystem::remove(temp_file_name, error);
+                return false;
+            }
+
+            return true;
+        }
+
+        bool CookedScene::hashFile(const std::string& file_name, uint64_t& hash) {
+            /// @brief hashes the contents of the file (to detect whether a cooked scene is stale)
+            /// @return false, if the file could not be read
+
+            MappedFile file;
+            if(!file.open(file_name)) return false;
+
+            // 64 bit FNV-1a, also hashing the size
+            hash = 14695981039346656037ull;
+            for(size_t i = 0; i < file.getSize(); i++)
+                hash = (hash ^ file.getData()[i]) * 1099511628211ull;
+
+            hash = (hash ^ file.getSize()) * 1099511628211ull;
+
+            return true;
+        }
+
+        uint64_t CookedScene::combineHash(uint64_t hash, uint64_t value) {
+            /// @brief mixes the value into the hash (for other things that the cooked scene depends on, i.e. import settings)
+
+            for(int i = 0; i < 8; i++)
+                hash = (hash ^ ((value >> (8 * i)) & 0xFF)) * 1099511628211ull;
+
+            return hash;
+        }
+
+        std::vector<CookedScene::Material>& CookedScene::getMaterials() {
+
+            return _materials;
+        }
+
+        std::vector<CookedScene::Mesh>& CookedScene::getMeshes() {
+
+            return _meshes;
+        }
+
+        std::vector<CookedScene::Skeleton>& CookedScene::getSkeletons() {
+
+            return _skeletons;
+        }
+
+        std::vector<CookedScene::Animation>& CookedScene::getAnimations() {
+
+            return _animations;
+        }
+
+        CookedScene::Node& CookedScene::getRootNode() {
+
+            return _root_node;
+        }
+
+    } // tools
+
+} // undicht
@@ -0,0 +1,146 @@
+#ifndef COOKED_SCENE_H
+#define COOKED_SCENE_H
+
+#include "cstdint"
+#include "string"
+#include "vector"
+
+#include "mapped_file.h"
+#include "scene/texture.h"
+#include "scene/mesh.h"
+
+#include "glm/glm.hpp"
+#include "glm/gtc/quaternion.hpp"
+
+namespace undicht {
+
+    namespace tools {
+
+        class CookedScene {
+            /** @brief the processed contents of a scene file, as they get loaded into a SceneGroup
+             * (vertex / index data, materials with their texture files, the node hierarchy, skeletons and animations)
+             * the SceneLoader cooks scene files with assimp once and stores the result with store(),
+             * later imports map the cooked file via load() and dont need assimp anymore
+             * the vertex and index data of a loaded scene point directly into the mapped file,
+             * so they can be handed to the transfer buffer without copying them first */
+
+          public:
+
+            struct Blob {
+                // the data is either stored in the blob (after cooking) or in the mapped cooked file
+                std::vector<uint8_t> _storage;
+                const uint8_t* _mapped_data = nullptr;
+                uint32_t _byte_size = 0;
+
+                void setData(const void* data, uint32_t byte_size);
+                uint8_t* resize(uint32_t byte_size); // @return the storage of the blob (to write the data to)
+                const uint8_t* getData() const;
+            };
+
+            struct Texture {
+                graphics::Texture::Type _type;
+                std::string _file_name; // relative to the directory of the scene file
+            };
+
+            struct Material {
+                std::string _name; // empty, if the scene file doesnt name the material
+                std::vector<Texture> _textures;
+            };
+
+            struct Mesh {
+                std::string _name;
+                uint32_t _material = 0; // index into the materials of the cooked scene
+                bool _has_positions = false;
+                bool _has_tex_coords = false;
+                bool _has_normals = false;
+                bool _has_tangents_and_bitangents = false;
+                bool _has_bones = false;
+                std::vector<std::string> _bones;
+                Blob _vertex_data; // in the compact layout described in graphics::Mesh
+                Blob _index_data;
+                uint32_t _index_size = 4; // bytes per index (2 or 4)
+                std::vector<graphics::Mesh::LOD> _lods; // ranges of the index data (empty, if the mesh has no lods)
+                glm::vec3 _bounding_center = glm::vec3(0.0f);
+                float _bounding_radius = 0.0f;
+            };
+
+            struct Node {
+                std::string _name;
+                std::vector<std::string> _meshes;
+                glm::mat4 _local_transformation = glm::mat4(1.0f);
+                std::vector<Node> _child_nodes;
+            };
+
+            struct Bone {
+                std::string _name;
+                glm::mat4 _local_matrix = glm::mat4(1.0f);
+                std::vector<Bone> _child_bones;
+            };
+
+            struct Skeleton {
+                std::string _name;
+                Bone _root_bone;
+            };
+
+            template<typename T>
+            struct Key {
+                double _time;
+                T _value;
+            };
+
+            struct NodeAnimation {
+                std::string _node;
+                std::vector<Key<glm::vec3>> _position_keys;
+                std::vector<Key<glm::quat>> _rotation_keys;
+                std::vector<Key<glm::vec3>> _scale_keys;
+            };
+
+            struct Animation {
+                std::string _name;
+                double _duration = 0.0;
+                double _ticks_per_second = 0.0;
+                std::vector<NodeAnimation> _node_animations;
+            };
+
+          protected:
+
+            std::vector<Material> _materials;
+            std::vector<Mesh> _meshes;
+            std::vector<Skeleton> _skeletons;
+            std::vector<Animation> _animations;
+            Node _root_node;
+
+            MappedFile _file; // the cooked file the scene was loaded from
+
+          public:
+
+            /// @brief removes all contents and unmaps the cooked file
+            void clear();
+
+            /** @brief maps the cooked file and reads the scene from it
+             * @return false, if the file doesnt exist, is corrupted or was cooked from a different source / with different import flags */
+            bool load(const std::string& file_name, uint64_t source_hash, uint32_t import_flags);
+
+            /// @return false, if the file could not be written
+            bool store(const std::string& file_name, uint64_t source_hash, uint32_t import_flags) const;
+
+            /// @brief hashes the contents of the file (to detect whether a cooked scene is stale)
+            /// @return false, if the file could not be read
+            bool static hashFile(const std::string& file_name, uint64_t& hash);
+
+            /// @brief mixes the value into the hash (for other things that the cooked scene depends on, i.e. import settings)
+            uint64_t static combineHash(uint64_t hash, uint64_t value);
+
+            std::vector<Material>& getMaterials();
+            std::vector<Mesh>& getMeshes();
+            std::vector<Skeleton>& getSkeletons();
+            std::vector<Animation>& getAnimations();
+            Node& getRootNode();
+
+        };
+
+    } // tools
+
+} // undicht
+
+#endif // COOKED_SCENE_H
@@ -0,0 +1,440 @@
+#include "mesh_optimizer.h"
+
+#include "cstring"
+#include "algorithm"
+
+#include "glm/glm.hpp"
+
+namespace undicht {
+
+    namespace tools {
+
+        namespace {
+
+            const uint32_t INVALID_ID = 0xFFFFFFFF;
+
+            uint64_t hashBytes(const void* data, size_t byte_size) {
+                // 64 bit FNV-1a
+
+                const uint8_t* bytes = (const uint8_t*)data;
+                uint64_t hash = 14695981039346656037ull;
+
+                for(size_t i = 0; i < byte_size; i++)
+                    hash = (hash ^ bytes[i]) * 1099511628211ull;
+
+                return hash;
+            }
+
+            class VertexCache {
+                // simulates a fifo post transform vertex cache
+                // a vertex is in the cache, if it was one of the last _cache_size vertices that were added
+
+              public:
+
+                std::vector<uint32_t> _time_stamps; // when each vertex was added to the cache
+                uint32_t _time;
+                uint32_t _cache_size;
+
+                VertexCache(uint32_t vertex_count, uint32_t cache_size) : _time_stamps(vertex_count, 0), _time(cache_size + 1), _cache_size(cache_size) {}
+
+                /// @return the number of cache misses caused by the triangle
+                uint32_t accessTriangle(const uint32_t* triangle) {
+
+                    uint32_t misses = 0;
+
+                    for(int i = 0; i < 3; i++) {
+                        if(_time - _time_stamps[triangle[i]] > _cache_size) {
+                            _time_stamps[triangle[i]] = _time++;
+                            misses++;
+                        }
+                    }
+
+                    return misses;
+                }
+
+                void reset() {
+
+                    _time += _cache_size + 1;
+                }
+
+            };
+
+        }
+
+        uint64_t MeshOptimizer::Settings::getKey() const {
+            /// @return a value that changes with the settings (to detect cooked scenes that were optimized differently)
+
+            uint32_t threshold_bits;
+            std::memcpy(&threshold_bits, &_overdraw_threshold, sizeof(float));
+
+            uint64_t key = uint64_t(_deduplicate_vertices) | (uint64_t(_optimize_vertex_cache) << 1) | (uint64_t(_optimize_overdraw) << 2) | (uint64_t(_optimize_vertex_fetch) << 3);
+            key |= uint64_t(_cache_size & 0xFFFFFF) << 8;
+            key |= uint64_t(threshold_bits) << 32;
+
+            return key;
+        }
+
+        void MeshOptimizer::setSettings(const Settings& settings) {
+
+            _settings = settings;
+        }
+
+        const MeshOptimizer::Settings& MeshOptimizer::getSettings() const {
+
+            return _settings;
+        }
+
+        MeshOptimizer::Stats MeshOptimizer::optimize(std::vector<float>& vertices, uint32_t vertex_size, std::vector<uint32_t>& indices, bool has_positions) const {
+            /** @brief optimizes the mesh in place
+             * @param vertex_size number of floats per vertex
+             * @param has_positions if false, the overdraw optimization gets skipped
+             * @return the stats of the mesh before and after the optimization */
+
+            Stats stats;
+            if(!vertex_size) return stats;
+
+            const uint32_t cache_size = std::max(_settings._cache_size, 3u);
+            uint32_t vertex_count = vertices.size() / vertex_size;
+
+            stats._vertices_before = vertex_count;
+            stats._vertices_after = vertex_count;
+            stats._triangles = indices.size() / 3;
+
+            // only triangle lists with valid indices can be optimized
+            if(indices.size() % 3) return stats;
+            for(uint32_t index : indices)
+                if(index >= vertex_count) return stats;
+
+            stats._acmr_before = calcACMR(indices, vertex_count, cache_size);
+
+            if(_settings._deduplicate_vertices) {
+                deduplicateVertices(vertices, vertex_size, indices);
+                vertex_count = vertices.size() / vertex_size;
+            }
+
+            std::vector<uint32_t> clusters = {0};
+            if(_settings._optimize_vertex_cache)
+                optimizeVertexCache(indices, vertex_count, cache_size, clusters);
+
+            if(_settings._optimize_overdraw && has_positions && (vertex_size >= 3))
+                optimizeOverdraw(indices, vertices, vertex_size, cache_size, _settings._overdraw_threshold, clusters);
+
+            if(_settings._optimize_vertex_fetch) {
+                optimizeVertexFetch(vertices, vertex_size, indices);
+                vertex_count = vertices.size() / vertex_size;
+            }
+
+            stats._vertices_after = vertex_count;
+            stats._acmr_after = calcACMR(indices, vertex_count, cache_size);
+
+            return stats;
+        }
+
+        float MeshOptimizer::calcACMR(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size) {
+            /// @return the average number of vertex cache misses per triangle (for a fifo cache with the given size)
+
+            const uint32_t triangle_count = indices.size() / 3;
+            if(!triangle_count) return 0.0f;
+
+            VertexCache cache(vertex_count, cache_size);
+            uint64_t misses = 0;
+
+            for(uint32_t i = 0; i < triangle_count; i++)
+                misses += cache.accessTriangle(&indices[3 * i]);
+
+            return float(misses) / float(triangle_count);
+        }
+
+        ///////////////////////////////// non public MeshOptimizer functions /////////////////////////////////
+
+        void MeshOptimizer::deduplicateVertices(std::vector<float>& vertices, uint32_t vertex_size, std::vector<uint32_t>& indices) {
+
+            const uint32_t vertex_count = vertices.size() / vertex_size;
+            const size_t vertex_bytes = vertex_size * sizeof(float);
+
+            // hash table (open addressing), storing the ids of the unique vertices
+            size_t table_size = 1;
+            while(table_size < size_t(vertex_count) * 2) table_size *= 2;
+            std::vector<uint32_t> table(table_size, INVALID_ID);
+
+            std::vector<uint32_t> remap(vertex_count);
+            uint32_t unique_count = 0;
+
+            for(uint32_t i = 0; i < vertex_count; i++) {
+
+                const float* vertex = &vertices[size_t(i) * vertex_size];
+                size_t slot = hashBytes(vertex, vertex_bytes) & (table_size - 1);
+
+                while(true) {
+
+                    uint32_t unique_id = table[slot];
+
+                    if(unique_id == INVALID_ID) {
+                        // first occurrence of the vertex, moving it to the end of the unique vertices
+                        if(unique_count != i) std::memcpy(&vertices[size_t(unique_count) * vertex_size], vertex, vertex_bytes);
+                        table[slot] = unique_count;
+                        remap[i] = unique_count++;
+                        break;
+                    }
+
+                    if(!std::memcmp(&vertices[size_t(unique_id) * vertex_size], vertex, vertex_bytes)) {
+                        remap[i] = unique_id;
+                        break;
+                    }
+
+                    slot = (slot + 1) & (table_size - 1);
+                }
+
+            }
+
+            vertices.resize(size_t(unique_count) * vertex_size);
+
+            for(uint32_t& index : indices)
+                index = remap[index];
+
+        }
+
+        void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size, std::vector<uint32_t>& clusters) {
+            /// @param clusters the first triangle of each cluster of triangles that starts at a dead end (the first cluster starts at 0)
+            // Tipsify: Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw" (2007)
+            // triangles are emitted in fans around a vertex, the next fanning vertex is picked among the vertices
+            // of the last fan, preferring the ones that will still be in the cache when all their triangles got emitted
+
+            const uint32_t triangle_count = indices.size() / 3;
+
+            // the triangles using each vertex (the triangles of vertex i are stored in adjacency[offsets[i]] to adjacency[offsets[i + 1] - 1])
+            std::vector<uint32_t> offsets(vertex_count + 1, 0);
+            for(uint32_t index : indices) offsets[index + 1]++;
+            for(uint32_t i = 0; i < vertex_count; i++) offsets[i + 1] += offsets[i];
+
+            std::vector<uint32_t> adjacency(indices.size());
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for(uint32_t i = 0; i < indices.size(); i++)
+                adjacency[fill[indices[i]]++] = i / 3;
+
+            // number of triangles of each vertex that were not emitted yet
+            std::vector<uint32_t> live_triangles(vertex_count);
+            for(uint32_t i = 0; i < vertex_count; i++)
+                live_triangles[i] = offsets[i + 1] - offsets[i];
+
+            std::vector<uint32_t> time_stamps(vertex_count, 0);
+            uint32_t time = cache_size + 1;
+
+            std::vector<bool> emitted(triangle_count, false);
+            std::vector<uint32_t> dead_ends; // recently used vertices, to continue with when a fan can not be continued
+            std::vector<uint32_t> candidates;
+            uint32_t input_cursor = 0;
+
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+            clusters.clear();
+
+            // finds a vertex with live triangles when the current fan reached a dead end
+            auto skipDeadEnd = [&]() -> int64_t {
+
+                while(!dead_ends.empty()) {
+                    uint32_t vertex = dead_ends.back();
+                    dead_ends.pop_back();
+                    if(live_triangles[vertex]) return vertex;
+                }
+
+                for(; input_cursor < vertex_count; input_cursor++)
+                    if(live_triangles[input_cursor]) return input_cursor;
+
+                return -1;
+            };
+
+            int64_t fanning_vertex = skipDeadEnd();
+            if(fanning_vertex >= 0) clusters.push_back(0);
+
+            while(fanning_vertex >= 0) {
+
+                // emitting all remaining triangles around the fanning vertex
+                candidates.clear();
+                for(uint32_t i = offsets[fanning_vertex]; i < offsets[fanning_vertex + 1]; i++) {
+
+                    uint32_t triangle = adjacency[i];
+                    if(emitted[triangle]) continue;
+
+                    for(int j = 0; j < 3; j++) {
+
+                        uint32_t vertex = indices[3 * triangle + j];
+                        dead_ends.push_back(vertex);
+                        candidates.push_back(vertex);
+                        live_triangles[vertex]--;
+                        result.push_back(vertex);
+
+                        if(time - time_stamps[vertex] > cache_size)
+                            time_stamps[vertex] = time++;
+                    }
+
+                    emitted[triangle] = true;
+                }
+
+                // choosing the next fanning vertex (the oldest candidate that will still be in the cache after its fan was emitted)
+                int64_t next_vertex = -1;
+                uint32_t best_priority = 0;
+                for(uint32_t vertex : candidates) {
+
+                    if(!live_triangles[vertex]) continue;
+
+                    uint32_t priority = 0;
+                    if(time - time_stamps[vertex] + 2 * live_triangles[vertex] <= cache_size)
+                        priority = time - time_stamps[vertex];
+
+                    if(priority > best_priority) {
+                        best_priority = priority;
+                        next_vertex = vertex;
+                    }
+                }
+
+                if(next_vertex < 0) {
+                    next_vertex = skipDeadEnd();
+                    if(next_vertex >= 0) clusters.push_back(result.size() / 3);
+                }
+
+                fanning_vertex = next_vertex;
+            }
+
+            indices.swap(result);
+
+            if(clusters.empty()) clusters.push_back(0);
+        }
+
+        void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float>& vertices, uint32_t vertex_size, uint32_t cache_size, float threshold, const std::vector<uint32_t>& clusters) {
+            // the clusters are split further at points where that doesnt make the acmr (much) worse
+            // then the clusters get sorted, so that the ones that face away from the center of the mesh are drawn first
+            // (these are likely to occlude the other clusters)
+
+            const uint32_t triangle_count = indices.size() / 3;
+            const uint32_t vertex_count = vertices.size() / vertex_size;
+            if(!triangle_count) return;
+
+            // splitting the clusters
+            std::vector<uint32_t> soft_clusters;
+            VertexCache cache(vertex_count, cache_size);
+
+            for(uint32_t i = 0; i < clusters.size(); i++) {
+
+                const uint32_t begin = clusters[i];
+                const uint32_t end = (i + 1 < clusters.size()) ? clusters[i + 1] : triangle_count;
+                if(begin >= end) continue;
+
+                // acmr of the whole cluster
+                uint32_t cluster_misses = 0;
+                cache.reset();
+                for(uint32_t t = begin; t < end; t++)
+                    cluster_misses += cache.accessTriangle(&indices[3 * t]);
+
+                const float cluster_threshold = threshold * float(cluster_misses) / float(end - begin);
+
+                // starting a new cluster whenever the acmr of the current one is good enough
+                soft_clusters.push_back(begin);
+                uint32_t soft_begin = begin;
+                uint32_t soft_misses = 0;
+                cache.reset();
+
+                for(uint32_t t = begin; t < end; t++) {
+
+                    soft_misses += cache.accessTriangle(&indices[3 * t]);
+
+                    if((t + 1 < end) && (float(soft_misses) / float(t - soft_begin + 1) <= cluster_threshold)) {
+                        soft_clusters.push_back(t + 1);
+                        soft_begin = t + 1;
+                        soft_misses = 0;
+                        cache.reset();
+                    }
+                }
+
+            }
+
+            // the center of the mesh
+            glm::vec3 mesh_center(0.0f);
+            for(uint32_t i = 0; i < vertex_count; i++)
+                mesh_center += glm::vec3(vertices[size_t(i) * vertex_size], vertices[size_t(i) * vertex_size + 1], vertices[size_t(i) * vertex_size + 2]);
+
+            if(vertex_count) mesh_center = mesh_center / float(vertex_count);
+
+            // how much each cluster faces away from the center of the mesh
+            std::vector<float> cluster_keys(soft_clusters.size());
+            for(uint32_t i = 0; i < soft_clusters.size(); i++) {
+
+                const uint32_t begin = soft_clusters[i];
+                const uint32_t end = (i + 1 < soft_clusters.size()) ? soft_clusters[i + 1] : triangle_count;
+
+                glm::vec3 normal(0.0f); // area weighted
+                glm::vec3 center(0.0f);
+                float area = 0.0f;
+
+                for(uint32_t t = begin; t < end; t++) {
+
+                    const float* p0 = &vertices[size_t(indices[3 * t + 0]) * vertex_size];
+                    const float* p1 = &vertices[size_t(indices[3 * t + 1]) * vertex_size];
+                    const float* p2 = &vertices[size_t(indices[3 * t + 2]) * vertex_size];
+
+                    glm::vec3 v0(p0[0], p0[1], p0[2]);
+                    glm::vec3 v1(p1[0], p1[1], p1[2]);
+                    glm::vec3 v2(p2[0], p2[1], p2[2]);
+
+                    glm::vec3 triangle_normal = glm::cross(v1 - v0, v2 - v0);
+                    float triangle_area = glm::length(triangle_normal);
+
+                    normal += triangle_normal;
+                    center += (v0 + v1 + v2) * (triangle_area / 3.0f);
+                    area += triangle_area;
+                }
+
+                float normal_length = glm::length(normal);
+                if((area <= 0.0f) || (normal_length <= 0.0f)) continue; // degenerate cluster, key stays 0
+
+                cluster_keys[i] = glm::dot(center / area - mesh_center, normal / normal_length);
+            }
+
+            // sorting the clusters (outwards facing first)
+            std::vector<uint32_t> cluster_order(soft_clusters.size());
+            for(uint32_t i = 0; i < cluster_order.size(); i++) cluster_order[i] = i;
+
+            std::stable_sort(cluster_order.begin(), cluster_order.end(), [&cluster_keys](uint32_t a, uint32_t b) {
+                return cluster_keys[a] > cluster_keys[b];
+            });
+
+            std::vector<uint32_t> result;
+            result.reserve(indices.size());
+
+            for(uint32_t cluster : cluster_order) {
+
+                const uint32_t begin = soft_clusters[cluster];
+                const uint32_t end = (cluster + 1 < soft_clusters.size()) ? soft_clusters[cluster + 1] : triangle_count;
+                result.insert(result.end(), indices.begin() + 3 * size_t(begin), indices.begin() + 3 * size_t(end));
+            }
+
+            indices.swap(result);
+        }
+
+        void MeshOptimizer::optimizeVertexFetch(std::vector<float>& vertices, uint32_t vertex_size, std::vector<uint32_t>& indices) {
+            // the vertices get stored in the order in which they are first used by the indices
+            // (vertices that are not used by any triangle get removed)
+
+            const uint32_t vertex_count = vertices.size() / vertex_size;
+
+            std::vector<uint32_t> remap(vertex_count, INVALID_ID);
+            std::vector<float> result;
+            result.reserve(vertices.size());
+            uint32_t next_id = 0;
+
+            for(uint32_t& index : indices) {
+
+                if(remap[index] == INVALID_ID) {
+                    remap[index] = next_id++;
+                    result.insert(result.end(), vertices.begin() + size_t(index) * vertex_size, vertices.begin() + size_t(index + 1) * vertex_size);
+                }
+
+                index = remap[index];
+            }
+
+            vertices.swap(result);
+        }
+
+    } // tools
+
+} // undicht
@@ -0,0 +1,78 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include "cstdint"
+#include "vector"
+
+namespace undicht {
+
+    namespace tools {
+
+        class MeshOptimizer {
+            /** @brief reorders the vertex and index data of indexed triangle meshes,
+             * so that the gpu has to run the vertex shader for fewer vertices and reads the vertex data more linearly
+             * the steps (each can be disabled via the settings):
+             * - exact vertex deduplication (vertices with identical bytes get merged)
+             * - post transform vertex cache optimization (Tipsify, Sander et al. 2007)
+             * - overdraw optimization (the triangles are split into clusters, outwards facing clusters get drawn first)
+             * - vertex fetch optimization (the vertices get sorted by their first use in the index data)
+             * the vertices are expected to be interleaved floats, starting with the position (if it has one) */
+
+          public:
+
+            struct Settings {
+                bool _deduplicate_vertices = true;
+                bool _optimize_vertex_cache = true;
+                bool _optimize_overdraw = true;
+                bool _optimize_vertex_fetch = true;
+
+                uint32_t _cache_size = 16; // size of the simulated post transform vertex cache
+                float _overdraw_threshold = 1.05f; // how much the acmr may get worse by splitting the mesh into more clusters
+
+                /// @return a value that changes with the settings (to detect cooked scenes that were optimized differently)
+                uint64_t getKey() const;
+            };
+
+            struct Stats {
+                uint32_t _vertices_before = 0;
+                uint32_t _vertices_after = 0;
+                uint32_t _triangles = 0;
+                float _acmr_before = 0.0f; // average cache miss ratio (vertex shader invocations per triangle)
+                float _acmr_after = 0.0f;
+            };
+
+          protected:
+
+            Settings _settings;
+
+          public:
+
+            void setSettings(const Settings& settings);
+            const Settings& getSettings() const;
+
+            /** @brief optimizes the mesh in place
+             * @param vertex_size number of floats per vertex
+             * @param has_positions if false, the overdraw optimization gets skipped
+             * @return the stats of the mesh before and after the optimization */
+            Stats optimize(std::vector<float>& vertices, uint32_t vertex_size, std::vector<uint32_t>& indices, bool has_positions) const;
+
+            /// @return the average number of vertex cache misses per triangle (for a fifo cache with the given size)
+            float static calcACMR(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size);
+
+          protected:
+            // non public MeshOptimizer functions
+
+            void static deduplicateVertices(std::vector<float>& vertices, uint32_t vertex_size, std::vector<uint32_t>& indices);
+
+            /// @param clusters the first triangle of each cluster of triangles that starts at a dead end (the first cluster starts at 0)
+            void static optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size, std::vector<uint32_t>& clusters);
+            void static optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<float>& vertices, uint32_t vertex_size, uint32_t cache_size, float threshold, const std::vector<uint32_t>& clusters);
+            void static optimizeVertexFetch(std::vector<float>& vertices, uint32_t vertex_size, std::vector<uint32_t>& indices);
+
+        };
+
+    } // tools
+
+} // undicht
+
+#endif // MESH_OPTIMIZER_H
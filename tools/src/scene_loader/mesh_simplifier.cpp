@@ -0,0 +1,408 @@
+#include "mesh_simplifier.h"
+
+#include "cstring"
+#include "cmath"
+#include "algorithm"
+#include "numeric"
+#include "unordered_set"
+
+#include "glm/glm.hpp"
+
+namespace undicht {
+
+    namespace tools {
+
+        namespace {
+
+            struct Quadric {
+                // the sum of the squared distances to the planes of the triangles around a vertex (weighted by their area)
+                // stores the upper half of the symmetric 4x4 matrix
+                double _a00 = 0.0, _a01 = 0.0, _a02 = 0.0, _a11 = 0.0, _a12 = 0.0, _a22 = 0.0;
+                double _b0 = 0.0, _b1 = 0.0, _b2 = 0.0;
+                double _c = 0.0;
+                double _weight = 0.0;
+
+                void addPlane(const glm::dvec3& n, double d, double weight) {
+
+                    _a00 += weight * n.x * n.x; _a01 += weight * n.x * n.y; _a02 += weight * n.x * n.z;
+                    _a11 += weight * n.y * n.y; _a12 += weight * n.y * n.z; _a22 += weight * n.z * n.z;
+                    _b0 += weight * n.x * d; _b1 += weight * n.y * d; _b2 += weight * n.z * d;
+                    _c += weight * d * d;
+                    _weight += weight;
+                }
+
+                void add(const Quadric& q) {
+
+                    _a00 += q._a00; _a01 += q._a01; _a02 += q._a02;
+                    _a11 += q._a11; _a12 += q._a12; _a22 += q._a22;
+                    _b0 += q._b0; _b1 += q._b1; _b2 += q._b2;
+                    _c += q._c;
+                    _weight += q._weight;
+                }
+
+                /// @return the average squared distance of the point to the planes
+                double evaluate(const glm::dvec3& p) const {
+
+                    if(_weight <= 0.0) return 0.0;
+
+                    double error = _a00 * p.x * p.x + _a11 * p.y * p.y + _a22 * p.z * p.z;
+                    error += 2.0 * (_a01 * p.x * p.y + _a02 * p.x * p.z + _a12 * p.y * p.z);
+                    error += 2.0 * (_b0 * p.x + _b1 * p.y + _b2 * p.z);
+                    error += _c;
+
+                    return std::abs(error) / _weight;
+                }
+
+            };
+
+            struct Collapse {
+                uint32_t _from; // the vertex that gets removed
+                uint32_t _to;
+                double _cost;
+            };
+
+            void hashValue(uint64_t& hash, uint32_t value) {
+                // 64 bit FNV-1a (on the whole value instead of every byte)
+
+                hash = (hash ^ value) * 1099511628211ull;
+            }
+
+            uint32_t getFloatBits(float value) {
+
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(float));
+                return bits;
+            }
+
+        }
+
+        uint64_t MeshSimplifier::Settings::getKey() const {
+            /// @return a value that changes with the settings (to detect cooked scenes that were simplified differently)
+
+            uint64_t key = 14695981039346656037ull;
+            hashValue(key, _generate_lods);
+            hashValue(key, _max_lod_count);
+            hashValue(key, getFloatBits(_lod_reduction));
+            hashValue(key, getFloatBits(_max_error));
+            hashValue(key, getFloatBits(_attribute_weight));
+            hashValue(key, _min_triangles);
+
+            return key;
+        }
+
+        void MeshSimplifier::setSettings(const Settings& settings) {
+
+            _settings = settings;
+        }
+
+        const MeshSimplifier::Settings& MeshSimplifier::getSettings() const {
+
+            return _settings;
+        }
+
+        std::vector<MeshSimplifier::LOD> MeshSimplifier::generateLODs(const std::vector<float>& vertices, uint32_t vertex_size, uint32_t attribute_count, std::vector<uint32_t>& indices) const {
+            /** @brief appends the indices of the simplified lods to the indices of the original mesh
+             * @param vertex_size number of floats per vertex
+             * @param attribute_count number of floats following the position that are considered when picking collapses (i.e. tex coords and normals)
+             * @return the lods, starting with the original mesh (empty, if the mesh is not a valid triangle list) */
+
+            std::vector<LOD> lods;
+
+            // only triangle lists with valid indices can be simplified
+            if((vertex_size < 3) || indices.empty() || (indices.size() % 3)) return lods;
+            const uint32_t vertex_count = vertices.size() / vertex_size;
+            for(uint32_t index : indices)
+                if(index >= vertex_count) return lods;
+
+            LOD original_lod;
+            original_lod._index_count = indices.size();
+            lods.push_back(original_lod);
+
+            if(!_settings._generate_lods) return lods;
+
+            float center[3];
+            float radius;
+            calcBoundingSphere(vertices, vertex_size, center, radius);
+            if(radius <= 0.0f) return lods;
+
+            // every lod gets simplified from the original mesh, so that its error is measured against the original
+            const std::vector<uint32_t> original_indices = indices;
+            const float reduction = std::clamp(_settings._lod_reduction, 0.05f, 0.95f);
+            float target_triangles = original_indices.size() / 3;
+            std::vector<uint32_t> lod_indices;
+
+            for(uint32_t i = 0; i < _settings._max_lod_count; i++) {
+
+                if(lods.back()._index_count / 3 <= _settings._min_triangles) break;
+
+                target_triangles *= reduction;
+                float error = simplify(vertices, vertex_size, attribute_count, original_indices, uint32_t(target_triangles) * 3, _settings._max_error, radius, lod_indices);
+
+                // the simplification got stuck (at the max error or because of locked vertices)
+                if(lod_indices.empty() || (lod_indices.size() > lods.back()._index_count * 0.9f)) break;
+
+                LOD lod;
+                lod._first_index = indices.size();
+                lod._index_count = lod_indices.size();
+                lod._error = error;
+                lods.push_back(lod);
+
+                indices.insert(indices.end(), lod_indices.begin(), lod_indices.end());
+            }
+
+            return lods;
+        }
+
+        float MeshSimplifier::simplify(const std::vector<float>& vertices, uint32_t vertex_size, uint32_t attribute_count, const std::vector<uint32_t>& indices, uint32_t target_index_count, float max_error, float radius, std::vector<uint32_t>& load_to) const {
+            /** @brief simplifies the mesh until it has no more than target_index_count indices or no collapse with an error below max_error is left
+             * @param max_error relative to the radius
+             * @return the error of the simplified mesh (relative to the radius) */
+
+            load_to = indices;
+            if((vertex_size < 3) || (radius <= 0.0f) || (load_to.size() % 3)) return 0.0f;
+
+            const uint32_t vertex_count = vertices.size() / vertex_size;
+            attribute_count = std::min(attribute_count, vertex_size - 3);
+
+            // positions relative to the radius, so that the errors are relative as well
+            const double scale = 1.0 / radius;
+            auto getPosition = [&](uint32_t vertex) {
+                const float* v = vertices.data() + size_t(vertex) * vertex_size;
+                return glm::dvec3(v[0], v[1], v[2]) * scale;
+            };
+
+            // vertices that share their position with other vertices are on a seam of the attributes
+            std::vector<uint32_t> sorted_vertices(vertex_count);
+            std::iota(sorted_vertices.begin(), sorted_vertices.end(), 0);
+            std::sort(sorted_vertices.begin(), sorted_vertices.end(), [&](uint32_t a, uint32_t b) {
+                const float* pa = vertices.data() + size_t(a) * vertex_size;
+                const float* pb = vertices.data() + size_t(b) * vertex_size;
+                return std::lexicographical_compare(pa, pa + 3, pb, pb + 3);
+            });
+
+            std::vector<uint32_t> position_ids(vertex_count); // the first vertex with the same position
+            std::vector<uint8_t> locked(vertex_count, 0);
+
+            for(uint32_t i = 0; i < vertex_count;) {
+
+                uint32_t group_end = i + 1;
+                const float* pi = vertices.data() + size_t(sorted_vertices[i]) * vertex_size;
+                while((group_end < vertex_count) && std::equal(pi, pi + 3, vertices.data() + size_t(sorted_vertices[group_end]) * vertex_size))
+                    group_end++;
+
+                for(uint32_t j = i; j < group_end; j++) {
+                    position_ids[sorted_vertices[j]] = sorted_vertices[i];
+                    locked[sorted_vertices[j]] = (group_end - i) > 1;
+                }
+
+                i = group_end;
+            }
+
+            // vertices on open borders (edges without an opposite edge)
+            std::unordered_set<uint64_t> edges;
+            edges.reserve(load_to.size());
+            for(size_t i = 0; i < load_to.size(); i += 3)
+                for(int e = 0; e < 3; e++)
+                    edges.insert((uint64_t(position_ids[load_to[i + e]]) << 32) | position_ids[load_to[i + (e + 1) % 3]]);
+
+            for(size_t i = 0; i < load_to.size(); i += 3) {
+                for(int e = 0; e < 3; e++) {
+                    uint32_t a = load_to[i + e];
+                    uint32_t b = load_to[i + (e + 1) % 3];
+                    if(!edges.count((uint64_t(position_ids[b]) << 32) | position_ids[a]))
+                        locked[a] = locked[b] = 1;
+                }
+            }
+
+            // the quadrics of the planes around every vertex
+            std::vector<Quadric> quadrics(vertex_count);
+            for(size_t i = 0; i < load_to.size(); i += 3) {
+
+                glm::dvec3 p0 = getPosition(load_to[i + 0]);
+                glm::dvec3 normal = glm::cross(getPosition(load_to[i + 1]) - p0, getPosition(load_to[i + 2]) - p0);
+                double length = glm::length(normal);
+                if(length <= 0.0) continue;
+
+                normal /= length;
+                for(int j = 0; j < 3; j++)
+                    quadrics[load_to[i + j]].addPlane(normal, -glm::dot(normal, p0), 0.5 * length);
+            }
+
+            auto calcCost = [&](uint32_t from, uint32_t to) {
+                // the distance to the planes of from, after moving it to the position of to
+                // plus the squared difference of the attributes that from looses
+
+                double cost = quadrics[from].evaluate(getPosition(to));
+
+                const float* a = vertices.data() + size_t(from) * vertex_size + 3;
+                const float* b = vertices.data() + size_t(to) * vertex_size + 3;
+                double attribute_error = 0.0;
+                for(uint32_t i = 0; i < attribute_count; i++)
+                    attribute_error += double(a[i] - b[i]) * double(a[i] - b[i]);
+
+                return cost + _settings._attribute_weight * attribute_error;
+            };
+
+            auto flipsTriangle = [&](const uint32_t* triangle, uint32_t from, uint32_t to) {
+                // @return true, if moving from to the position of to rotates the triangle by too much (or collapses it)
+
+                glm::dvec3 before[3];
+                glm::dvec3 after[3];
+                for(int i = 0; i < 3; i++) {
+                    before[i] = getPosition(triangle[i]);
+                    after[i] = (triangle[i] == from) ? getPosition(to) : before[i];
+                }
+
+                glm::dvec3 normal_before = glm::cross(before[1] - before[0], before[2] - before[0]);
+                glm::dvec3 normal_after = glm::cross(after[1] - after[0], after[2] - after[0]);
+
+                return glm::dot(normal_before, normal_after) <= 0.25 * glm::length(normal_before) * glm::length(normal_after);
+            };
+
+            const double max_cost = double(max_error) * double(max_error);
+            double error = 0.0;
+
+            std::vector<uint32_t> remap(vertex_count);
+            std::vector<uint8_t> touched(vertex_count);
+            std::vector<uint32_t> triangle_offsets;
+            std::vector<uint32_t> vertex_triangles;
+            std::vector<Collapse> collapses;
+
+            // every pass collapses a set of independent edges (in the order of their cost)
+            while(load_to.size() > target_index_count) {
+
+                // the triangles around every vertex
+                triangle_offsets.assign(vertex_count + 1, 0);
+                for(uint32_t index : load_to) triangle_offsets[index + 1]++;
+                for(uint32_t i = 0; i < vertex_count; i++) triangle_offsets[i + 1] += triangle_offsets[i];
+
+                std::vector<uint32_t> write_positions(triangle_offsets.begin(), triangle_offsets.end() - 1);
+                vertex_triangles.resize(load_to.size());
+                for(size_t i = 0; i < load_to.size(); i++)
+                    vertex_triangles[write_positions[load_to[i]]++] = i / 3;
+
+                // finding the possible collapses
+                collapses.clear();
+                for(size_t i = 0; i < load_to.size(); i += 3) {
+                    for(int e = 0; e < 3; e++) {
+                        uint32_t a = load_to[i + e];
+                        uint32_t b = load_to[i + (e + 1) % 3];
+                        if(!locked[a]) collapses.push_back({a, b, calcCost(a, b)});
+                        if(!locked[b]) collapses.push_back({b, a, calcCost(b, a)});
+                    }
+                }
+
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a._cost < b._cost; });
+
+                // collapsing the cheapest edges, whose triangles were not changed in this pass
+                std::iota(remap.begin(), remap.end(), 0);
+                std::fill(touched.begin(), touched.end(), 0);
+                const size_t indices_to_remove = load_to.size() - target_index_count;
+                size_t removed_indices = 0;
+                uint32_t collapse_count = 0;
+
+                for(const Collapse& collapse : collapses) {
+
+                    if((collapse._cost > max_cost) || (removed_indices >= indices_to_remove)) break;
+                    if(touched[collapse._from] || touched[collapse._to]) continue;
+
+                    bool valid = true;
+                    uint32_t removed_triangles = 0;
+                    for(uint32_t i = triangle_offsets[collapse._from]; valid && (i < triangle_offsets[collapse._from + 1]); i++) {
+
+                        const uint32_t* triangle = load_to.data() + 3 * size_t(vertex_triangles[i]);
+                        if((triangle[0] == collapse._to) || (triangle[1] == collapse._to) || (triangle[2] == collapse._to))
+                            removed_triangles++;
+                        else
+                            valid = !flipsTriangle(triangle, collapse._from, collapse._to);
+                    }
+
+                    if(!valid) continue;
+
+                    remap[collapse._from] = collapse._to;
+                    quadrics[collapse._to].add(quadrics[collapse._from]);
+
+                    for(uint32_t i = triangle_offsets[collapse._from]; i < triangle_offsets[collapse._from + 1]; i++)
+                        for(int j = 0; j < 3; j++)
+                            touched[load_to[3 * size_t(vertex_triangles[i]) + j]] = 1;
+
+                    removed_indices += 3 * removed_triangles;
+                    error = std::max(error, collapse._cost);
+                    collapse_count++;
+                }
+
+                if(!collapse_count) break;
+
+                // removing the triangles that collapsed
+                size_t index_count = 0;
+                for(size_t i = 0; i < load_to.size(); i += 3) {
+
+                    uint32_t a = remap[load_to[i + 0]];
+                    uint32_t b = remap[load_to[i + 1]];
+                    uint32_t c = remap[load_to[i + 2]];
+                    if((a == b) || (b == c) || (a == c)) continue;
+
+                    load_to[index_count++] = a;
+                    load_to[index_count++] = b;
+                    load_to[index_count++] = c;
+                }
+
+                load_to.resize(index_count);
+            }
+
+            return float(std::sqrt(error));
+        }
+
+        void MeshSimplifier::calcBoundingSphere(const std::vector<float>& vertices, uint32_t vertex_size, float* center, float& radius) {
+            /// @brief calculates a sphere that contains all vertex positions (not the smallest one, but close to it)
+            // Ritter's algorithm: starting with the two vertices that are far apart, growing the sphere for every vertex outside of it
+
+            center[0] = center[1] = center[2] = 0.0f;
+            radius = 0.0f;
+
+            const uint32_t vertex_count = (vertex_size >= 3) ? vertices.size() / vertex_size : 0;
+            if(!vertex_count) return;
+
+            auto getPosition = [&](uint32_t vertex) {
+                const float* v = vertices.data() + size_t(vertex) * vertex_size;
+                return glm::vec3(v[0], v[1], v[2]);
+            };
+
+            auto findFarthest = [&](const glm::vec3& p) {
+                uint32_t farthest = 0;
+                float max_distance = -1.0f;
+                for(uint32_t i = 0; i < vertex_count; i++) {
+                    float distance = glm::dot(getPosition(i) - p, getPosition(i) - p);
+                    if(distance > max_distance) {
+                        max_distance = distance;
+                        farthest = i;
+                    }
+                }
+                return getPosition(farthest);
+            };
+
+            glm::vec3 a = findFarthest(getPosition(0));
+            glm::vec3 b = findFarthest(a);
+            glm::vec3 sphere_center = (a + b) * 0.5f;
+            float sphere_radius = glm::length(b - a) * 0.5f;
+
+            for(uint32_t i = 0; i < vertex_count; i++) {
+
+                float distance = glm::length(getPosition(i) - sphere_center);
+                if(distance <= sphere_radius) continue;
+
+                // moving the sphere towards the vertex, so that it touches the old sphere and the vertex
+                float new_radius = (sphere_radius + distance) * 0.5f;
+                sphere_center += (getPosition(i) - sphere_center) * ((new_radius - sphere_radius) / distance);
+                sphere_radius = new_radius;
+            }
+
+            center[0] = sphere_center.x;
+            center[1] = sphere_center.y;
+            center[2] = sphere_center.z;
+            radius = sphere_radius;
+        }
+
+    } // tools
+
+} // undicht
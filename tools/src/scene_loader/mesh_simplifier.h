@@ -0,0 +1,69 @@
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "cstdint"
+#include "vector"
+
+namespace undicht {
+
+    namespace tools {
+
+        class MeshSimplifier {
+            /** @brief generates simplified levels of detail (lods) for indexed triangle meshes
+             * the triangles get simplified by collapsing vertices into neighbouring vertices (half edge collapses),
+             * which are picked by their quadric error (Garland & Heckbert 1997) plus the difference of their attributes
+             * since no new vertices get created, all lods can share the vertex buffer of the original mesh
+             * vertices on open borders and on attribute seams (vertices that share their position with other vertices) are locked,
+             * so that the simplified meshes dont get holes
+             * the vertices are expected to be interleaved floats, starting with the position */
+
+          public:
+
+            struct Settings {
+                bool _generate_lods = true;
+                uint32_t _max_lod_count = 4; // not counting the original mesh
+                float _lod_reduction = 0.5f; // target triangle count of each lod, relative to the previous lod
+                float _max_error = 0.05f; // lods with a bigger error (relative to the bounding sphere radius) dont get generated
+                float _attribute_weight = 0.25f; // how much differences in the attributes add to the error of a collapse
+                uint32_t _min_triangles = 64; // meshes with fewer triangles dont get simplified further
+
+                /// @return a value that changes with the settings (to detect cooked scenes that were simplified differently)
+                uint64_t getKey() const;
+            };
+
+            struct LOD {
+                uint32_t _first_index = 0;
+                uint32_t _index_count = 0;
+                float _error = 0.0f; // relative to the bounding sphere radius of the mesh
+            };
+
+          protected:
+
+            Settings _settings;
+
+          public:
+
+            void setSettings(const Settings& settings);
+            const Settings& getSettings() const;
+
+            /** @brief appends the indices of the simplified lods to the indices of the original mesh
+             * @param vertex_size number of floats per vertex
+             * @param attribute_count number of floats following the position that are considered when picking collapses (i.e. tex coords and normals)
+             * @return the lods, starting with the original mesh (empty, if the mesh is not a valid triangle list) */
+            std::vector<LOD> generateLODs(const std::vector<float>& vertices, uint32_t vertex_size, uint32_t attribute_count, std::vector<uint32_t>& indices) const;
+
+            /** @brief simplifies the mesh until it has no more than target_index_count indices or no collapse with an error below max_error is left
+             * @param max_error relative to the radius
+             * @return the error of the simplified mesh (relative to the radius) */
+            float simplify(const std::vector<float>& vertices, uint32_t vertex_size, uint32_t attribute_count, const std::vector<uint32_t>& indices, uint32_t target_index_count, float max_error, float radius, std::vector<uint32_t>& load_to) const;
+
+            /// @brief calculates a sphere that contains all vertex positions (not the smallest one, but close to it)
+            void static calcBoundingSphere(const std::vector<float>& vertices, uint32_t vertex_size, float* center, float& radius);
+
+        };
+
+    } // tools
+
+} // undicht
+
+#endif // MESH_SIMPLIFIER_H
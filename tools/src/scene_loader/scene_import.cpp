@@ -0,0 +1,31 @@
+#include "scene_import.h"
+
+namespace undicht {
+
+	namespace tools {
+
+        SceneImport::State SceneImport::getState() const {
+
+            return _state;
+        }
+
+        bool SceneImport::isDone() const {
+            /// @return true, if the import finished (the group is resident or the import failed)
+
+            State state = _state;
+            return (state == State::RESIDENT) || (state == State::FAILED);
+        }
+
+        const std::string& SceneImport::getFileName() const {
+
+            return _file_name;
+        }
+
+        const std::string& SceneImport::getGroupName() const {
+
+            return _group_name;
+        }
+
+	} // tools
+
+} // undicht
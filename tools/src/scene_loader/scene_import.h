@@ -0,0 +1,92 @@
+#ifndef SCENE_IMPORT_H
+#define SCENE_IMPORT_H
+
+#include "scene/scene.h"
+#include "scene/scene_group.h"
+#include "scene/texture.h"
+#include "renderer/vulkan/transfer_buffer.h"
+#include "core/vulkan/command_buffer.h"
+#include "core/vulkan/fence.h"
+#include "job_system.h"
+#include "cooked_scene.h"
+#include "texture_loader.h"
+
+#include "string"
+#include "vector"
+#include "memory"
+#include "atomic"
+
+namespace undicht {
+
+	namespace tools {
+
+        class SceneLoader;
+
+        class SceneImport {
+            /** @brief handle of a scene that gets imported in the background (SceneLoader::importSceneAsync())
+             * the scene file gets loaded / cooked and its textures get decoded on the job system,
+             * then the data is staged by SceneLoader::updateImports() (on the main thread) in chunks spread over multiple frames,
+             * each chunk gets submitted with its own fence (without waiting for the gpu)
+             * once all chunks finished, the SceneGroup gets added to the scene */
+
+          public:
+
+            enum class State {
+                LOADING, // loading the scene file and decoding the textures (on the job system)
+                STAGING, // staging the images / meshes (a few per frame), the submitted chunks might still be running
+                UPLOADING, // all chunks were submitted, waiting for them to finish
+                RESIDENT, // the SceneGroup was added to the scene
+                FAILED, // the scene file could not be loaded
+            };
+
+          protected:
+
+            friend SceneLoader;
+
+            struct UploadChunk {
+                // the objects used to upload a part of the scene
+                vulkan::TransferBuffer _transfer_buffer;
+                vulkan::CommandBuffer _cmd;
+                vulkan::Fence _fence;
+            };
+
+            std::atomic<State> _state{State::LOADING};
+
+            std::string _file_name;
+            std::string _group_name;
+            graphics::Scene* _scene = nullptr;
+
+            // data loaded on the job system
+            JobCounter _loading;
+            bool _loaded = false;
+            CookedScene _cooked_scene;
+            std::vector<TextureLoader::DecodedImage> _images;
+            std::vector<graphics::Texture::Type> _image_types;
+
+            // objects used to upload the data
+            graphics::SceneGroup _group;
+            uint32_t _staged_images = 0;
+            uint32_t _staged_meshes = 0;
+            bool _materials_loaded = false; // once all images are staged
+            std::vector<std::string> _material_names; // referenced by the meshes
+            std::vector<std::shared_ptr<graphics::Texture>> _new_textures; // kept alive until the materials reference them
+            std::vector<std::unique_ptr<UploadChunk>> _upload_chunks; // submitted, but maybe not finished yet
+            uint32_t _mip_map_batch = 0; // of the SceneLoaders MipMapGenerator (if it has one)
+
+          public:
+
+            State getState() const;
+
+            /// @return true, if the import finished (the group is resident or the import failed)
+            bool isDone() const;
+
+            const std::string& getFileName() const;
+            const std::string& getGroupName() const;
+
+        };
+
+	} // tools
+
+} // undicht
+
+#endif // SCENE_IMPORT_H
@@ -1,10 +1,16 @@
 #include "scene_loader.h"
 #include "texture_loader.h"
+#include "mesh_optimizer.h"
+#include "mesh_simplifier.h"
+#include "vertex_packer.h"
 
 #include "debug.h"
 #include "file_tools.h"
 
 #include "cassert"
+#include "cstring"
+#include "functional"
+#include "algorithm"
 #include "glm/gtc/type_ptr.hpp"
 
 namespace undicht {
@@ -14,6 +20,45 @@ namespace undicht {
         using namespace graphics;
         using namespace vulkan;
 
+        const int MAX_BONES_PER_VERTEX = 4;
+
+        // meshes with fewer vertices are processed on the calling thread
+        const uint32_t PARALLEL_VERTEX_COUNT = 16384;
+        const uint32_t VERTEX_BATCH_SIZE = 4096;
+
+        // cooked scenes are only valid for the flags they were imported with
+        const uint32_t ASSIMP_IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals;
+        const std::string COOKED_FILE_ENDING = ".cooked";
+
+        namespace {
+
+            void interleaveVec3s(const aiVector3D* src, uint32_t count, uint32_t stride, ai_real* load_to) {
+                // copies the vectors of an assimp attribute array into every stride-th float of load_to
+
+                for(uint32_t i = 0; i < count; i++) {
+                    load_to[0] = src[i].x;
+                    load_to[1] = src[i].y;
+                    load_to[2] = src[i].z;
+                    load_to += stride;
+                }
+
+            }
+
+        }
+
+        // the key of uncompressed textures in the texture cache (the actual format depends on the channels of the image and the texture type,
+        // which is part of the key as well)
+        const FixedType DECODED_TEXTURE_FORMAT = UND_R8G8B8A8_SRGB;
+
+        // the key of block compressed textures in the texture cache (the actual format (BC1 / BC3 / BC5) depends on the image and the texture type)
+        // textures loaded from ktx2 files (which contain their mip levels) use this key as well
+        const FixedType COMPRESSED_TEXTURE_FORMAT = UND_BC3_SRGB;
+
+        // background imports stage their data in chunks with their own transfer buffers
+        // the last chunk of an import holds the node ubos
+        const uint32_t IMPORT_TRANSFER_MARGIN = 1024 * 1024;
+        const uint32_t IMAGE_DATA_ALIGNMENT = 16;
+
         void SceneLoader::setInitObjects(const vulkan::LogicalDevice& device, vma::VulkanMemoryAllocator& allocator, vulkan::TransferBuffer& transfer_buffer, vulkan::DescriptorSetCache& material_descriptor_cache, vulkan::DescriptorSetCache& node_descriptor_cache, const vulkan::Sampler& sampler) {
             
             _device = &device;
@@ -24,6 +69,64 @@ namespace undicht {
             _allocator = &allocator;
         }
 
+        void SceneLoader::setJobSystem(JobSystem& job_system) {
+            // optional, large meshes get processed in parallel if a job system is set
+
+            _job_system = &job_system;
+        }
+
+        void SceneLoader::setUseSceneCache(bool use_cache) {
+            // if disabled, scenes always get imported with assimp (and no cooked files get written)
+
+            _use_scene_cache = use_cache;
+        }
+
+        void SceneLoader::setMeshOptimizerSettings(const MeshOptimizer::Settings& settings) {
+            // applies to the following imports
+
+            _mesh_optimizer.setSettings(settings);
+        }
+
+        void SceneLoader::setMeshSimplifierSettings(const MeshSimplifier::Settings& settings) {
+            // applies to the following imports
+
+            _mesh_simplifier.setSettings(settings);
+        }
+
+        void SceneLoader::setCompressTextures(bool compress) {
+            // if enabled (and supported by the device), textures get block compressed (BC1 / BC3 / BC5) with pre-built mip levels
+            // the compressed images are stored next to the image files, so they only get compressed once
+
+            _compress_textures = compress;
+        }
+
+        void SceneLoader::setTextureStreamer(TextureStreamer& streamer) {
+            // optional, textures with pre-built mip levels (compressed or ktx2 textures) get streamed by the streamer
+            // (starting with only their smallest levels resident)
+
+            _texture_streamer = &streamer;
+        }
+
+        void SceneLoader::setMipMapGenerator(MipMapGenerator& generator) {
+            // optional, the mip maps of the textures of background imports get generated by the generator (compute shader)
+            // instead of recording blits for every level of every texture
+
+            _mip_map_generator = &generator;
+        }
+
+        void SceneLoader::setImportUploadBudget(uint32_t byte_size) {
+            // the number of bytes background imports stage per call of updateImports()
+            // (at least one image / mesh gets staged, even if it is larger)
+
+            _import_upload_budget = byte_size;
+        }
+
+        TextureCache& SceneLoader::getTextureCache() {
+            /// @brief the textures loaded by the scene loader (which are still in use)
+
+            return _texture_cache;
+        }
+
         void SceneLoader::importScene(const std::string& file_name, SceneGroup& load_to) {
             // following the tutorial: https://learnopengl.com/Model-Loading/Model
 
@@ -32,36 +135,215 @@ namespace undicht {
                 return;
             }
 
-            // reset the names of nodes that are bones
-            _bone_names.clear();
-
             // getting the working directory from the file_name
             std::string directory = getFilePath(file_name);
-            
-            // creating the assimp importer
-            Assimp::Importer importer;
 
-            // reading the file using the assimp library
-            const aiScene *assimp_scene = importAssimpScene(importer, file_name);
-            if(assimp_scene == nullptr) {
+            // without the scene cache, the cooked scene doesnt get stored,
+            // so the meshes get packed straight into the transfer buffer while cooking
+            CookedScene cooked_scene;
+            std::vector<Mesh> uploaded_meshes;
+            bool loaded = _use_scene_cache ? loadOrCookScene(file_name, cooked_scene) : cookScene(file_name, cooked_scene, &uploaded_meshes);
+            if(!loaded) {
                 UND_ERROR << "failed to load assimp scene: " << file_name << "\n";
                 return;
             }
 
-            // loading the data from the assimp scene into the load_to scene
-            processAssimpScene(assimp_scene, load_to, directory);
-            
+            // decode the textures that are not in the texture cache yet (in parallel, if a job system is set)
+            std::vector<TextureLoader::DecodedImage> images;
+            std::vector<Texture::Type> image_types;
+            collectCookedImages(cooked_scene, directory, images, image_types);
+            if(useTextureCompression())
+                TextureLoader::compressImages(images, image_types, _job_system);
+            else
+                TextureLoader::decodeImages(images, _job_system);
+
+            std::vector<std::shared_ptr<Texture>> new_textures = loadCookedImages(images, image_types, *_transfer_buffer);
+
+            // loading the data from the cooked scene into the load_to scene
+            loadCookedScene(cooked_scene, load_to, directory, *_transfer_buffer, uploaded_meshes);
+
             load_to.updateGlobalTransformations();
             load_to.updateBoneMatrices();
             load_to.updateNodeUBOs(*_transfer_buffer);
 
         }
 
+        std::shared_ptr<SceneImport> SceneLoader::importSceneAsync(const std::string& file_name, Scene& scene, const std::string& group_name) {
+            /** @brief imports the scene in the background (requires a job system)
+             * the scene file gets loaded / cooked and the textures get decoded on the job system,
+             * the upload gets staged by updateImports() in chunks (with their own transfer buffers and fences),
+             * so that each frame only stages a limited amount of data and never waits for the gpu
+             * once all chunks finished, the imported group gets added to the scene
+             * @return a handle to check on the state of the import */
+
+            std::shared_ptr<SceneImport> import = std::make_shared<SceneImport>();
+            import->_file_name = file_name;
+            import->_group_name = group_name;
+            import->_scene = &scene;
+
+            if(!_device || !_job_system) {
+                UND_ERROR << "SceneLoader is not initialized (call setInitObjects() and setJobSystem() before importing scenes in the background)\n";
+                import->_state = SceneImport::State::FAILED;
+                return import;
+            }
+
+            // the job gets its own loader to cook the scene (the bone names and optimizer stats are stored in the loader)
+            // its texture cache is empty, so all images get decoded (the cached ones are skipped when uploading)
+            MeshOptimizer::Settings optimizer_settings = _mesh_optimizer.getSettings();
+            MeshSimplifier::Settings simplifier_settings = _mesh_simplifier.getSettings();
+            bool use_scene_cache = _use_scene_cache;
+            bool compress_textures = useTextureCompression();
+            JobSystem* job_system = _job_system;
+
+            _job_system->run([=]() {
+
+                SceneLoader cooker;
+                cooker.setJobSystem(*job_system);
+                cooker.setUseSceneCache(use_scene_cache);
+                cooker.setMeshOptimizerSettings(optimizer_settings);
+                cooker.setMeshSimplifierSettings(simplifier_settings);
+                cooker.setCompressTextures(compress_textures);
+
+                import->_loaded = cooker.loadOrCookScene(import->_file_name, import->_cooked_scene);
+                if(!import->_loaded) return;
+
+                cooker.collectCookedImages(import->_cooked_scene, getFilePath(import->_file_name), import->_images, import->_image_types);
+                if(compress_textures)
+                    TextureLoader::compressImages(import->_images, import->_image_types, job_system);
+                else
+                    TextureLoader::decodeImages(import->_images, job_system);
+
+            }, &import->_loading);
+
+            _imports.push_back(import);
+
+            return import;
+        }
+
+        void SceneLoader::updateImports() {
+            /// @brief advances the background imports (call once per frame, on the thread that uses the scene)
+
+            // the budget is shared by all imports (the older ones get staged first)
+            uint32_t budget = _import_upload_budget;
+
+            for(std::shared_ptr<SceneImport>& import : _imports) {
+
+                if((import->_state == SceneImport::State::LOADING) && import->_loading.isDone())
+                    beginUpload(*import);
+
+                bool chunks_finished = releaseUploadChunks(*import);
+
+                if((import->_state == SceneImport::State::STAGING) && budget)
+                    stageImport(*import, budget);
+
+                if((import->_state == SceneImport::State::UPLOADING) && chunks_finished)
+                    finishImport(*import);
+            }
+
+            // the handles returned by importSceneAsync() stay valid
+            _imports.erase(std::remove_if(_imports.begin(), _imports.end(), [](const std::shared_ptr<SceneImport>& import){return import->isDone();}), _imports.end());
+        }
+
+        void SceneLoader::waitForImports() {
+            /// @brief waits for all background imports to finish (i.e. before cleaning up the scene)
+
+            for(std::shared_ptr<SceneImport>& import : _imports) {
+
+                if(import->_state == SceneImport::State::LOADING) {
+                    _job_system->wait(import->_loading);
+                    beginUpload(*import);
+                }
+
+                uint32_t budget = UINT32_MAX; // staging everything that is left
+                while(import->_state == SceneImport::State::STAGING)
+                    stageImport(*import, budget);
+
+                if(import->_state == SceneImport::State::UPLOADING) {
+                    for(std::unique_ptr<SceneImport::UploadChunk>& chunk : import->_upload_chunks)
+                        chunk->_fence.waitForProcessToFinish();
+
+                    releaseUploadChunks(*import);
+                    finishImport(*import);
+                }
+            }
+
+            _imports.clear();
+        }
+
+        uint32_t SceneLoader::getPendingImportCount() const {
+
+            return _imports.size();
+        }
+
         ///////////////////////////////// non public SceneLoader functions /////////////////////////////////
 
+        bool SceneLoader::useTextureCompression() const {
+            // without a device (i.e. when cooking in the background), the setting is used as it is
+
+            return _compress_textures && (!_device || _device->getEnabledFeatures().textureCompressionBC);
+        }
+
+        const FixedType& SceneLoader::getTextureCacheFormat() const {
+            // the key of the textures loaded by the next import in the texture cache
+
+            return useTextureCompression() ? COMPRESSED_TEXTURE_FORMAT : DECODED_TEXTURE_FORMAT;
+        }
+
+        bool SceneLoader::loadOrCookScene(const std::string& file_name, CookedScene& load_to) {
+            // trying to load the cooked scene, assimp only has to run if it is missing or stale
+            // (doesnt touch any vulkan objects, so it can run on any thread)
+
+            std::string cooked_file_name = file_name + COOKED_FILE_ENDING;
+            uint64_t source_hash = 0;
+            bool use_cache = _use_scene_cache && CookedScene::hashFile(file_name, source_hash);
+
+            // the cooked scene also depends on how the meshes were optimized and simplified
+            source_hash = CookedScene::combineHash(source_hash, _mesh_optimizer.getSettings().getKey());
+            source_hash = CookedScene::combineHash(source_hash, _mesh_simplifier.getSettings().getKey());
+
+            if(use_cache && load_to.load(cooked_file_name, source_hash, ASSIMP_IMPORT_FLAGS))
+                return true;
+
+            if(!cookScene(file_name, load_to))
+                return false;
+
+            if(use_cache) load_to.store(cooked_file_name, source_hash, ASSIMP_IMPORT_FLAGS);
+
+            return true;
+        }
+
+        bool SceneLoader::cookScene(const std::string& file_name, CookedScene& load_to, std::vector<Mesh>* upload_meshes_to) {
+            // upload_meshes_to: optional, the meshes get created and their data gets staged in the transfer buffer (see processAssimpMesh())
+
+            load_to.clear();
+
+            // reset the names of nodes that are bones
+            _bone_names.clear();
+
+            // creating the assimp importer
+            Assimp::Importer importer;
+
+            // reading the file using the assimp library
+            const aiScene *assimp_scene = importAssimpScene(importer, file_name);
+            if(assimp_scene == nullptr) return false;
+
+            _optimizer_stats = MeshOptimizer::Stats();
+            processAssimpScene(assimp_scene, load_to, upload_meshes_to);
+
+            // reporting the effect of the mesh optimizer (the acmr of all meshes, weighted by their triangle count)
+            if(_optimizer_stats._triangles) {
+
+                UND_LOG << "optimized meshes of " << file_name << ": "
+                        << "vertices: " << _optimizer_stats._vertices_before << " -> " << _optimizer_stats._vertices_after << ", "
+                        << "ACMR: " << _optimizer_stats._acmr_before / _optimizer_stats._triangles << " -> " << _optimizer_stats._acmr_after / _optimizer_stats._triangles << "\n";
+            }
+
+            return true;
+        }
+
         const aiScene* SceneLoader::importAssimpScene(Assimp::Importer& importer, const std::string& file_name) const {
 
-            const aiScene *scene = importer.ReadFile(file_name, aiProcess_Triangulate | aiProcess_FlipUVs | aiProcess_GenNormals);	
+            const aiScene *scene = importer.ReadFile(file_name, ASSIMP_IMPORT_FLAGS);
             
             if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
 
@@ -72,22 +354,28 @@ namespace undicht {
             return scene;
         }
 
-        void SceneLoader::processAssimpScene(const aiScene* assimp_scene, SceneGroup& load_to, const std::string& directory) {
+        void SceneLoader::processAssimpScene(const aiScene* assimp_scene, CookedScene& load_to, std::vector<Mesh>* upload_meshes_to) {
 
             // process all materials
             for(int i = 0; i < assimp_scene->mNumMaterials; i++) {
 
-                const aiMaterial* ai_material = assimp_scene->mMaterials[i];
-                std::string mat_name = ai_material->GetName().C_Str(); // has to be unique (referenced by meshes)
-                if(!mat_name.length()) mat_name = "Material " + toStr(load_to.getMaterials().size()); 
-                processAssimpMaterial(ai_material, load_to.addMaterial(mat_name), directory);
+                load_to.getMaterials().emplace_back();
+                processAssimpMaterial(assimp_scene->mMaterials[i], load_to.getMaterials().back());
             }
 
             // process all meshes
+            if(upload_meshes_to) upload_meshes_to->reserve(assimp_scene->mNumMeshes);
             for(int i = 0; i < assimp_scene->mNumMeshes; i++) {
 
-                const aiMesh* ai_mesh = assimp_scene->mMeshes[i];
-                processAssimpMesh(ai_mesh, load_to.addMesh(ai_mesh->mName.C_Str()), load_to.getMaterials().end() - assimp_scene->mNumMaterials);
+                Mesh* upload_to = nullptr;
+                if(upload_meshes_to) {
+                    upload_meshes_to->emplace_back();
+                    upload_to = &upload_meshes_to->back();
+                    upload_to->init(*_device, *_allocator);
+                }
+
+                load_to.getMeshes().emplace_back();
+                processAssimpMesh(assimp_scene->mMeshes[i], load_to.getMeshes().back(), upload_to);
             }
 
             // process all nodes (recursive)
@@ -96,142 +384,260 @@ namespace undicht {
             // process all animations
             for(int i = 0; i < assimp_scene->mNumAnimations; i++) {
 
-                const aiAnimation* ai_animation = assimp_scene->mAnimations[i];
-                processAssimpAnimation(assimp_scene->mAnimations[i], load_to.addAnimation(ai_animation->mName.C_Str()));
-            }
-
-            // setting the bind pose for all skeletons
-            for(Skeleton& s : load_to.getSkeletons()) {
-                s.updateBoneMatrices();
-                s.storeBindPose();
+                load_to.getAnimations().emplace_back();
+                processAssimpAnimation(assimp_scene->mAnimations[i], load_to.getAnimations().back());
             }
 
         }
 
         //////////////////////////////////// functions to process meshes //////////////////////////////////////
 
-        void SceneLoader::processAssimpMesh(const aiMesh* assimp_mesh, Mesh& load_to, const std::vector<Material>::iterator& materials) {
-            
-            // init the mesh
-            load_to.init(*_device, *_allocator);
+        void SceneLoader::processAssimpMesh(const aiMesh* assimp_mesh, CookedScene::Mesh& load_to, Mesh* upload_to) {
+            // upload_to: optional, the packed data gets written straight into the transfer buffer (the blobs of the cooked mesh stay empty)
+            // data that doesnt fit into the transfer buffer at once gets packed into the blobs (and staged by loadCookedMesh())
+
+            // the packed vertices store the bone ids as uint8 (the bone ids are the indices of the bones of the mesh)
+            const bool has_bones = assimp_mesh->HasBones() && (assimp_mesh->mNumBones <= VertexPacker::MAX_BONE_COUNT);
+            if(assimp_mesh->HasBones() && !has_bones)
+                UND_ERROR << "mesh has more than " << VertexPacker::MAX_BONE_COUNT << " bones, loading it without its skeletal animation: " << assimp_mesh->mName.C_Str() << "\n";
 
             // processing vertices and faces of the mesh
-            processAssimpVertices(assimp_mesh, load_to);
-            processAssimpFaces(assimp_mesh, load_to);
+            std::vector<ai_real> vertex_data;
+            std::vector<uint32_t> index_data;
+            processAssimpVertices(assimp_mesh, has_bones, vertex_data);
+            processAssimpFaces(assimp_mesh, index_data);
+
+            const uint32_t vertex_size = assimp_mesh->mNumVertices ? vertex_data.size() / assimp_mesh->mNumVertices : 0;
+            const bool is_triangle_mesh = assimp_mesh->mNumVertices && (index_data.size() == 3 * size_t(assimp_mesh->mNumFaces));
+
+            // reordering the vertices and triangles (only for meshes made of triangles only)
+            if(is_triangle_mesh) {
+
+                MeshOptimizer::Stats stats = _mesh_optimizer.optimize(vertex_data, vertex_size, index_data, assimp_mesh->HasPositions());
+
+                _optimizer_stats._vertices_before += stats._vertices_before;
+                _optimizer_stats._vertices_after += stats._vertices_after;
+                _optimizer_stats._acmr_before += stats._acmr_before * stats._triangles;
+                _optimizer_stats._acmr_after += stats._acmr_after * stats._triangles;
+                _optimizer_stats._triangles += stats._triangles;
+            }
+
+            // the bounding sphere is used to select the lod when drawing the mesh
+            if(assimp_mesh->HasPositions())
+                MeshSimplifier::calcBoundingSphere(vertex_data, vertex_size, glm::value_ptr(load_to._bounding_center), load_to._bounding_radius);
+
+            // appending simplified lods to the index data (only for meshes without skeletal animation)
+            if(is_triangle_mesh && assimp_mesh->HasPositions() && !has_bones) {
+
+                // the tex coords and normals directly follow the position
+                uint32_t attribute_count = 0;
+                if(assimp_mesh->HasTextureCoords(0)) attribute_count += 3;
+                if(assimp_mesh->HasNormals()) attribute_count += 3;
+
+                for(const MeshSimplifier::LOD& lod : _mesh_simplifier.generateLODs(vertex_data, vertex_size, attribute_count, index_data))
+                    load_to._lods.push_back({lod._first_index, lod._index_count, lod._error});
+            }
 
             // storing mesh attributes
-            load_to.setVertexAttributes(assimp_mesh->HasPositions(), assimp_mesh->HasTextureCoords(0), assimp_mesh->HasNormals(), assimp_mesh->HasTangentsAndBitangents(), assimp_mesh->HasBones());
-            load_to.setName(assimp_mesh->mName.C_Str());
-            // load_to.setMaterialID(assimp_mesh->mMaterialIndex + material_id_offset);
-            load_to.setMaterial(materials[assimp_mesh->mMaterialIndex].getName());
+            load_to._has_positions = assimp_mesh->HasPositions();
+            load_to._has_tex_coords = assimp_mesh->HasTextureCoords(0);
+            load_to._has_normals = assimp_mesh->HasNormals();
+            load_to._has_tangents_and_bitangents = assimp_mesh->HasTangentsAndBitangents();
+            load_to._has_bones = has_bones;
+
+            // converting the vertices and indices to the compact formats used by the renderers
+            VertexPacker::Attributes attributes;
+            attributes._has_positions = load_to._has_positions;
+            attributes._has_tex_coords = load_to._has_tex_coords;
+            attributes._has_normals = load_to._has_normals;
+            attributes._has_tangents_and_bitangents = load_to._has_tangents_and_bitangents;
+            attributes._has_bones = load_to._has_bones;
+
+            // packing straight into the transfer buffer or the blobs of the cooked mesh
+            const uint32_t unpacked_size = VertexPacker::calcUnpackedVertexSize(attributes);
+            const uint32_t vertex_count = unpacked_size ? vertex_data.size() / unpacked_size : 0;
+            const uint32_t vertex_byte_size = vertex_count * VertexPacker::calcPackedVertexSize(attributes);
+            uint8_t* packed_vertices = upload_to ? upload_to->reserveVertexData(vertex_byte_size, *_transfer_buffer) : nullptr;
+            if(!packed_vertices) packed_vertices = load_to._vertex_data.resize(vertex_byte_size);
+            if(!VertexPacker::packVertices(vertex_data, attributes, packed_vertices))
+                UND_ERROR << "failed to pack the vertices of mesh (bone id out of range): " << assimp_mesh->mName.C_Str() << "\n";
+
+            load_to._index_size = VertexPacker::calcIndexSize(index_data);
+            const uint32_t index_byte_size = index_data.size() * load_to._index_size;
+            const VkIndexType index_type = (load_to._index_size == sizeof(uint16_t)) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+            uint8_t* packed_indices = upload_to ? upload_to->reserveIndexData(index_byte_size, *_transfer_buffer, index_type) : nullptr;
+            if(!packed_indices) packed_indices = load_to._index_data.resize(index_byte_size);
+            VertexPacker::packIndices(index_data, load_to._index_size, packed_indices);
+            if(upload_to) upload_to->setVertexCount(load_to._lods.empty() ? index_data.size() : load_to._lods.front()._index_count);
+            load_to._name = assimp_mesh->mName.C_Str();
+            load_to._material = assimp_mesh->mMaterialIndex;
 
             // storing the bone names in the mesh
-            processAssimpMeshBones(assimp_mesh, load_to);
+            if(has_bones) processAssimpMeshBones(assimp_mesh, load_to._bones);
 
         }
 
-        void SceneLoader::processAssimpVertices(const aiMesh* assimp_mesh, Mesh& load_to) {
+        void SceneLoader::processAssimpVertices(const aiMesh* assimp_mesh, bool with_bones, std::vector<ai_real>& load_to) {
+            // interleaves the vertex attributes (no vulkan objects needed)
+            // with_bones: whether the bone ids and weights get stored (meshes with too many bones are loaded without them)
+
+            const uint32_t vertex_count = assimp_mesh->mNumVertices;
+
+            // sorting the bone weights by vertex once (instead of searching all bones for every vertex)
+            VertexBoneWeights bone_weights;
+            if(with_bones) gatherAssimpVertexBones(assimp_mesh, bone_weights);
+
+            // number of floats per vertex (in the order specified in mesh.h)
+            uint32_t vertex_size = 0;
+            if(assimp_mesh->HasPositions()) vertex_size += 3;
+            if(assimp_mesh->HasTextureCoords(0)) vertex_size += 3;
+            if(assimp_mesh->HasNormals()) vertex_size += 3;
+            if(assimp_mesh->HasTangentsAndBitangents()) vertex_size += 6;
+            if(with_bones) vertex_size += 2 * MAX_BONES_PER_VERTEX;
+
+            const size_t first_vertex = load_to.size();
+            load_to.resize(first_vertex + size_t(vertex_count) * vertex_size);
+
+            // the attribute arrays of assimp that get interleaved (only one texture coord per vertex for now)
+            std::vector<const aiVector3D*> attribute_arrays;
+            if(assimp_mesh->HasPositions()) attribute_arrays.push_back(assimp_mesh->mVertices);
+            if(assimp_mesh->HasTextureCoords(0)) attribute_arrays.push_back(assimp_mesh->mTextureCoords[0]);
+            if(assimp_mesh->HasNormals()) attribute_arrays.push_back(assimp_mesh->mNormals);
+            if(assimp_mesh->HasTangentsAndBitangents()) {
+                attribute_arrays.push_back(assimp_mesh->mTangents);
+                attribute_arrays.push_back(assimp_mesh->mBitangents);
+            }
+
+            // every vertex writes to its own part of load_to, so the vertices can be processed in parallel
+            std::function<void(uint32_t, uint32_t)> process_vertices = [&](uint32_t begin, uint32_t end) {
 
-            std::vector<ai_real> vertex_data;
+                ai_real* first = load_to.data() + first_vertex + size_t(begin) * vertex_size;
+
+                // copying one attribute array at a time (a tight strided loop without branches, which the compiler can vectorize)
+                for(uint32_t a = 0; a < attribute_arrays.size(); a++)
+                    interleaveVec3s(attribute_arrays[a] + begin, end - begin, vertex_size, first + 3 * a);
 
-            // processing all vertices of the mesh
-            for(int i = 0; i < assimp_mesh->mNumVertices; i++) {
+                if(with_bones) {
 
-                // processing all possible vertex attributes in the order specified in mesh.h
-                if(assimp_mesh->HasPositions()) processAssimpVec3(assimp_mesh->mVertices[i], vertex_data);
-                if(assimp_mesh->HasTextureCoords(0)) processAssimpVec3(assimp_mesh->mTextureCoords[0][i], vertex_data); // only one texture coord per vertex for now
-                if(assimp_mesh->HasNormals()) processAssimpVec3(assimp_mesh->mNormals[i], vertex_data);
-                if(assimp_mesh->HasTangentsAndBitangents()) {
-                    processAssimpVec3(assimp_mesh->mTangents[i], vertex_data);
-                    processAssimpVec3(assimp_mesh->mBitangents[i], vertex_data);
+                    const uint32_t bone_offset = 3 * attribute_arrays.size();
+                    for(uint32_t i = begin; i < end; i++)
+                        processAssimpVertexBones(bone_weights, i, load_to.data() + first_vertex + size_t(i) * vertex_size + bone_offset);
                 }
-                if(assimp_mesh->HasBones()) processAssimpVertexBones(assimp_mesh, i, vertex_data);
 
+            };
+
+            if(_job_system && (vertex_count >= PARALLEL_VERTEX_COUNT))
+                _job_system->parallelFor(vertex_count, VERTEX_BATCH_SIZE, process_vertices);
+            else
+                process_vertices(0, vertex_count);
+
+        }
+
+        void SceneLoader::gatherAssimpVertexBones(const aiMesh* assimp_mesh, VertexBoneWeights& load_to) {
+            // inverts the per bone weight lists of assimp into per vertex lists (compressed sparse rows)
+            // runs in O(vertices + weights)
+
+            const uint32_t vertex_count = assimp_mesh->mNumVertices;
+
+            // counting the weights of every vertex
+            load_to._offsets.assign(vertex_count + 1, 0);
+            for(uint32_t bone_id = 0; bone_id < assimp_mesh->mNumBones; bone_id++) {
+                const aiBone* bone = assimp_mesh->mBones[bone_id];
+                for(uint32_t i = 0; i < bone->mNumWeights; i++)
+                    if(bone->mWeights[i].mVertexId < vertex_count)
+                        load_to._offsets[bone->mWeights[i].mVertexId + 1]++;
+            }
+
+            // the offset of a vertex is the sum of the weight counts of the previous vertices
+            for(uint32_t i = 0; i < vertex_count; i++)
+                load_to._offsets[i + 1] += load_to._offsets[i];
+
+            // storing the weights (using the offsets as write positions for now)
+            load_to._weights.resize(load_to._offsets.back());
+            for(uint32_t bone_id = 0; bone_id < assimp_mesh->mNumBones; bone_id++) {
+                const aiBone* bone = assimp_mesh->mBones[bone_id];
+                for(uint32_t i = 0; i < bone->mNumWeights; i++) {
+                    const aiVertexWeight& weight = bone->mWeights[i];
+                    if(weight.mVertexId < vertex_count)
+                        load_to._weights[load_to._offsets[weight.mVertexId]++] = {bone_id, float(weight.mWeight)};
+                }
             }
 
-            load_to.setVertexData((const uint8_t*)vertex_data.data(), vertex_data.size() * sizeof(ai_real), *_transfer_buffer);
+            // after storing, every offset points to the beginning of the next vertex
+            for(uint32_t i = vertex_count; i > 0; i--)
+                load_to._offsets[i] = load_to._offsets[i - 1];
+
+            load_to._offsets[0] = 0;
         }
 
-        void SceneLoader::processAssimpFaces(const aiMesh* assimp_mesh, Mesh& load_to) {
+        void SceneLoader::processAssimpFaces(const aiMesh* assimp_mesh, std::vector<uint32_t>& load_to) {
+
+            // counting the indices first, so that they can be copied without reallocating
+            size_t index_count = 0;
+            for(unsigned int i = 0; i < assimp_mesh->mNumFaces; i++)
+                index_count += assimp_mesh->mFaces[i].mNumIndices;
 
-            std::vector<uint32_t> face_ids;
+            const size_t first_index = load_to.size();
+            load_to.resize(first_index + index_count);
+            uint32_t* dst = load_to.data() + first_index;
 
             // going through all faces that make up the mesh
             for(unsigned int i = 0; i < assimp_mesh->mNumFaces; i++) {
 
                 const aiFace& assimp_face = assimp_mesh->mFaces[i];
-
-                // going through all the indices that make up a face
-                for(unsigned int j = 0; j < assimp_face.mNumIndices; j++) {
-
-                    face_ids.push_back(assimp_face.mIndices[j]);
-                }
-
+                dst = std::copy(assimp_face.mIndices, assimp_face.mIndices + assimp_face.mNumIndices, dst);
             }
 
-            load_to.setIndexData((const uint8_t*)face_ids.data(), face_ids.size() * sizeof(uint32_t), *_transfer_buffer);
-            load_to.setVertexCount(face_ids.size());
         }
 
-        void SceneLoader::processAssimpMeshBones(const aiMesh* assimp_mesh, Mesh& load_to) {
-
-            std::vector<std::string> bone_names;
+        void SceneLoader::processAssimpMeshBones(const aiMesh* assimp_mesh, std::vector<std::string>& load_to) {
 
             // converting the assimp array to a std::vector
             for(int i = 0; i < assimp_mesh->mNumBones; i++)
-                bone_names.push_back(assimp_mesh->mBones[i]->mName.C_Str());
+                load_to.push_back(assimp_mesh->mBones[i]->mName.C_Str());
 
             // register the bone names
-            _bone_names.insert(bone_names.begin(), bone_names.end());
-
-            // store the bone names in the mesh
-            load_to.setBones(bone_names);
+            _bone_names.insert(load_to.begin(), load_to.end());
 
         }
 
-        void SceneLoader::processAssimpVertexBones(const aiMesh* assimp_mesh, int vertex_id, std::vector<ai_real>& load_to) {
-            
-            const int MAX_BONES_PER_VERTEX = 4;
-            std::vector<int> bone_ids;
-            std::vector<aiVertexWeight*> weights; // weights of the bones that effect the vertex
+        void SceneLoader::processAssimpVertexBones(const VertexBoneWeights& bone_weights, uint32_t vertex_id, ai_real* load_to) {
+            /// stores the MAX_BONES_PER_VERTEX bones with the biggest influence on the vertex
+            /// their weights get renormalized, so that they add up to 1 again
 
-            // find all (or MAX_BONES_PER_VERTEX, whichever number is greater) bones that effect the vertex
-            for(int bone_id = 0; bone_id < assimp_mesh->mNumBones; bone_id++) {
+            uint32_t bone_ids[MAX_BONES_PER_VERTEX] = {}; // fallback, for when not enough bones effect the vertex
+            float weights[MAX_BONES_PER_VERTEX] = {};
 
-                aiBone* bone = assimp_mesh->mBones[bone_id];
+            // keeping the biggest weights (sorted in descending order)
+            for(uint32_t i = bone_weights._offsets[vertex_id]; i < bone_weights._offsets[vertex_id + 1]; i++) {
 
-                // does the bone effect the vertex ?
-                for(int bone_vertex = 0; bone_vertex < bone->mNumWeights; bone_vertex++) {
-                    if(bone->mWeights[bone_vertex].mVertexId == vertex_id) {
-                        bone_ids.push_back(bone_id);
-                        weights.push_back(bone->mWeights + bone_vertex); // yes, the bone effects the vertex
-                        break;
-                    }
-                }
+                const VertexBoneWeights::Weight& weight = bone_weights._weights[i];
+                if(weight._weight <= weights[MAX_BONES_PER_VERTEX - 1]) continue;
 
-            }
+                int slot = MAX_BONES_PER_VERTEX - 1;
+                while((slot > 0) && (weights[slot - 1] < weight._weight)) {
+                    bone_ids[slot] = bone_ids[slot - 1];
+                    weights[slot] = weights[slot - 1];
+                    slot--;
+                }
 
-            // store the bone indices
-            const int no_index = 0; // fallback, for when not enough bones effect the vertex
-            for(int i = 0; i < MAX_BONES_PER_VERTEX; i++) {
-                if(i < weights.size()) load_to.push_back(*(float*)&bone_ids[i]); // storing the int disguised as a float
-                else load_to.push_back(*(float*)&no_index);
+                bone_ids[slot] = weight._bone_id;
+                weights[slot] = weight._weight;
             }
 
-            // store the bone weights
-            const float no_weight = 0; // fallback, for when not enough bones effect the vertex
-            for(int i = 0; i < MAX_BONES_PER_VERTEX; i++) {
-                if(i < weights.size()) load_to.push_back(weights[i]->mWeight);
-                else load_to.push_back(no_weight);
-            }
+            float weight_sum = 0.0f;
+            for(float weight : weights) weight_sum += weight;
+            if(weight_sum > 0.0f)
+                for(float& weight : weights) weight /= weight_sum;
 
-        }
+            // store the bone indices (the ints disguised as floats)
+            for(int i = 0; i < MAX_BONES_PER_VERTEX; i++)
+                std::memcpy(load_to + i, bone_ids + i, sizeof(float));
 
-        void SceneLoader::processAssimpVec3(const aiVector3D& assimp_vec, std::vector<ai_real>& load_to) {
+            // store the bone weights
+            for(int i = 0; i < MAX_BONES_PER_VERTEX; i++)
+                load_to[MAX_BONES_PER_VERTEX + i] = weights[i];
 
-            load_to.push_back(assimp_vec.x);
-            load_to.push_back(assimp_vec.y);
-            load_to.push_back(assimp_vec.z);
         }
 
         void SceneLoader::processAssimpMat4(const aiMatrix4x4& assimp_mat, glm::mat4& load_to) {
@@ -246,57 +652,40 @@ namespace undicht {
 
 		/////////////////////////////////////// functions to process Materials ///////////////////////////////////////
 
-        void SceneLoader::processAssimpMaterial(const aiMaterial* assimp_material, Material& load_to, const std::string& directory) {
-            
-            // init the material
-            load_to.init(*_device, *_allocator, *_material_descriptor_cache);
+        void SceneLoader::processAssimpMaterial(const aiMaterial* assimp_material, CookedScene::Material& load_to) {
+
+            load_to._name = assimp_material->GetName().C_Str(); // has to be unique (referenced by meshes)
 
             // string to store the textures file name
             aiString file_name;
 
-            // try to load a diffuse texture
+            // try to find a diffuse texture
             if(assimp_material->GetTextureCount(aiTextureType_DIFFUSE) >= 1) {
                 assimp_material->GetTexture(aiTextureType_DIFFUSE, 0, &file_name);
-                Texture& diffuse = load_to.addTexture(Texture::Type::DIFFUSE);
-                TextureLoader(directory + file_name.C_Str(), diffuse, *_transfer_buffer);
-
-                UND_LOG << "loaded diffuse texture: " << file_name.C_Str() << "\n";
+                load_to._textures.push_back({Texture::Type::DIFFUSE, file_name.C_Str()});
             }
 
-            // try to load a specular texture
+            // try to find a specular texture
             if(assimp_material->GetTextureCount(aiTextureType_SPECULAR) >= 1) {
                 assimp_material->GetTexture(aiTextureType_SPECULAR, 0, &file_name);
-                Texture& specular = load_to.addTexture(Texture::Type::SPECULAR);
-                TextureLoader(directory + file_name.C_Str(), specular, *_transfer_buffer);
-
-                UND_LOG << "loaded specular texture: " << file_name.C_Str() << "\n";
+                load_to._textures.push_back({Texture::Type::SPECULAR, file_name.C_Str()});
             }
 
-            load_to.updateDescriptorSet(*_sampler);
-
         }
 
         //////////////////////////////////////////// functions to process nodes ////////////////////////////////////////////
 
-		void SceneLoader::processAssimpNode(const aiNode* assimp_node, Node& load_to, SceneGroup& scene_group) {
+		void SceneLoader::processAssimpNode(const aiNode* assimp_node, CookedScene::Node& load_to, CookedScene& scene) {
             
+            load_to._name = assimp_node->mName.C_Str();
+
             // store the nodes meshes
-            std::vector<std::string> meshes;
             for(int i = 0; i < assimp_node->mNumMeshes; i++) {
-                meshes.push_back(scene_group.getMeshes()[assimp_node->mMeshes[i]].getName());
-            }
-
-            if(meshes.size() == 1) {
-                if(!load_to.getHasVulkanObjects()) load_to.init(*_device, *_allocator, *_node_descriptor_cache);
-                load_to.setMesh(meshes[0]);
-            } else {
-                load_to.addMeshes(meshes, *_device, *_allocator, *_node_descriptor_cache);
+                load_to._meshes.push_back(scene.getMeshes()[assimp_node->mMeshes[i]]._name);
             }
 
             // store the model matrix
-            glm::mat4 local;
-            processAssimpMat4(assimp_node->mTransformation, local);
-            load_to.setLocalTransformation(local);
+            processAssimpMat4(assimp_node->mTransformation, load_to._local_transformation);
 
             // recursivly processing the child nodes
             for(unsigned int i = 0; i < assimp_node->mNumChildren; i++) {
@@ -304,82 +693,493 @@ namespace undicht {
                 // is it a bone node?
                 if(_bone_names.find(assimp_node->mChildren[i]->mName.C_Str()) != _bone_names.end()) {
                     // this node is the root node of a skeleton
-                    Skeleton* skeleton = scene_group.getSkeleton(assimp_node->mName.C_Str());
-                    if(!skeleton) skeleton = &scene_group.addSkeleton(assimp_node->mName.C_Str());
-                    processAssimpBoneNode(assimp_node, skeleton->getRootBone());
+                    std::string skeleton_name = assimp_node->mName.C_Str();
+                    bool is_new_skeleton = true;
+                    for(const CookedScene::Skeleton& skeleton : scene.getSkeletons())
+                        if(!skeleton._name.compare(skeleton_name)) is_new_skeleton = false;
+
+                    if(is_new_skeleton) {
+                        scene.getSkeletons().emplace_back();
+                        scene.getSkeletons().back()._name = skeleton_name;
+                        processAssimpBoneNode(assimp_node, scene.getSkeletons().back()._root_bone);
+                    }
+
                     continue;
                 }
 
-                // if a mesh gets stored, the node will be reinitialized with vulkan objects
-                // making sure that the node has a unique name
-                std::string node_name = assimp_node->mChildren[i]->mName.C_Str();
-                if(load_to.getChildNode(node_name)) { node_name = node_name + " " + toStr(i);}
-
-                processAssimpNode(assimp_node->mChildren[i], load_to.addChildNode(node_name), scene_group);
+                load_to._child_nodes.emplace_back();
+                processAssimpNode(assimp_node->mChildren[i], load_to._child_nodes.back(), scene);
 
             }
 
         }
 
-        void SceneLoader::processAssimpBoneNode(const aiNode* assimp_node, graphics::Bone& load_to) {
+        void SceneLoader::processAssimpBoneNode(const aiNode* assimp_node, CookedScene::Bone& load_to) {
             
             // store the name
-            load_to.setName(assimp_node->mName.C_Str());
+            load_to._name = assimp_node->mName.C_Str();
 
             // store the local transform
-            glm::mat4 local_transf;
-            processAssimpMat4(assimp_node->mTransformation, local_transf);
-            load_to.setLocalMatrix(local_transf);
+            processAssimpMat4(assimp_node->mTransformation, load_to._local_matrix);
 
             // recursivly processing the child bones
             for(unsigned int i = 0; i < assimp_node->mNumChildren; i++) {
 
-                std::string bone_name = assimp_node->mChildren[i]->mName.C_Str();
-                processAssimpBoneNode(assimp_node->mChildren[i], *load_to.addChildBone(bone_name));
+                load_to._child_bones.emplace_back();
+                processAssimpBoneNode(assimp_node->mChildren[i], load_to._child_bones.back());
             }
 
         }
 
         ///////////////////////////////////////// functions to process animations /////////////////////////////////////////
 
-        void SceneLoader::processAssimpAnimation(const aiAnimation* assimp_animation, graphics::Animation& load_to) {
+        void SceneLoader::processAssimpAnimation(const aiAnimation* assimp_animation, CookedScene::Animation& load_to) {
 
-            load_to.init();
-            load_to.setName(std::string(assimp_animation->mName.C_Str()));
-            load_to.setDuration(assimp_animation->mDuration);
-            load_to.setTicksPerSecond(assimp_animation->mTicksPerSecond);
+            load_to._name = assimp_animation->mName.C_Str();
+            load_to._duration = assimp_animation->mDuration;
+            load_to._ticks_per_second = assimp_animation->mTicksPerSecond;
 
             for(int i = 0; i < assimp_animation->mNumChannels; i++) {
                 
-                aiNodeAnim* assimp_node_anim = assimp_animation->mChannels[i];
-                processAssimpNodeAnimation(assimp_node_anim, load_to.addNodeAnimation(assimp_node_anim->mNodeName.C_Str()));
+                load_to._node_animations.emplace_back();
+                processAssimpNodeAnimation(assimp_animation->mChannels[i], load_to._node_animations.back());
             }
 
-            UND_LOG << "loaded animation " << '"' << load_to.getName() << '"' << "\n";
-
         }
 
-        void SceneLoader::processAssimpNodeAnimation(const aiNodeAnim* assimp_node_animation, graphics::NodeAnimation& load_to) {
+        void SceneLoader::processAssimpNodeAnimation(const aiNodeAnim* assimp_node_animation, CookedScene::NodeAnimation& load_to) {
+
+            load_to._node = assimp_node_animation->mNodeName.C_Str();
 
             for(int i = 0; i < assimp_node_animation->mNumPositionKeys; i++) {
                 
                 aiVectorKey pos_key = assimp_node_animation->mPositionKeys[i];
-                load_to.addPositionKey(pos_key.mTime, glm::vec3(pos_key.mValue.x, pos_key.mValue.y, pos_key.mValue.z));
+                load_to._position_keys.push_back({pos_key.mTime, glm::vec3(pos_key.mValue.x, pos_key.mValue.y, pos_key.mValue.z)});
             }
 
             for(int i = 0; i < assimp_node_animation->mNumRotationKeys; i++) {
                 
                 aiQuatKey rot_key = assimp_node_animation->mRotationKeys[i];
-                load_to.addRotationKey(rot_key.mTime, glm::quat(rot_key.mValue.w, rot_key.mValue.x, rot_key.mValue.y, rot_key.mValue.z));
+                load_to._rotation_keys.push_back({rot_key.mTime, glm::quat(rot_key.mValue.w, rot_key.mValue.x, rot_key.mValue.y, rot_key.mValue.z)});
             }            
             
             for(int i = 0; i < assimp_node_animation->mNumScalingKeys; i++) {
                 
                 aiVectorKey scl_key = assimp_node_animation->mPositionKeys[i];
-                load_to.addScaleKey(scl_key.mTime, glm::vec3(scl_key.mValue.x, scl_key.mValue.y, scl_key.mValue.z));
+                load_to._scale_keys.push_back({scl_key.mTime, glm::vec3(scl_key.mValue.x, scl_key.mValue.y, scl_key.mValue.z)});
+            }
+        }
+
+        ///////////////////////////////////////// functions to load a cooked scene /////////////////////////////////////////
+
+        void SceneLoader::collectCookedImages(CookedScene& scene, const std::string& directory, std::vector<TextureLoader::DecodedImage>& images, std::vector<Texture::Type>& image_types) {
+            // the images that are not in the texture cache yet (so that they can be decoded)
+            // each image file is only collected once per texture type, even if multiple materials use it
+            // (the type selects the format, so an image used as diffuse and specular map gets loaded twice)
+
+            std::set<std::pair<std::string, Texture::Type>> image_keys;
+            for(const CookedScene::Material& material : scene.getMaterials()) {
+                for(const CookedScene::Texture& texture : material._textures) {
+
+                    std::string path = TextureCache::getCanonicalPath(directory + texture._file_name);
+                    if(_texture_cache.find(path, texture._type, getTextureCacheFormat()) || !image_keys.insert({path, texture._type}).second) continue;
+
+                    images.push_back({path});
+                    image_types.push_back(texture._type);
+                }
+            }
+
+        }
+
+        std::vector<std::shared_ptr<Texture>> SceneLoader::loadCookedImages(std::vector<TextureLoader::DecodedImage>& images, const std::vector<Texture::Type>& image_types, TransferBuffer& transfer_buffer) {
+            // upload the decoded images (in the order in which the materials reference them)
+            // and store them in the cache, the materials hold the only (strong) references to them
+            // images that were loaded into the cache in the meantime (by another import) only get freed
+            // @return the new textures (keep them alive until the materials reference them)
+
+            std::vector<std::shared_ptr<Texture>> new_textures;
+            for(int i = 0; i < images.size(); i++) {
+
+                std::shared_ptr<Texture> texture = loadCookedImage(images[i], image_types[i], transfer_buffer);
+                if(texture) new_textures.push_back(texture);
+            }
+
+            return new_textures;
+        }
+
+        std::shared_ptr<Texture> SceneLoader::loadCookedImage(TextureLoader::DecodedImage& image, Texture::Type image_type, TransferBuffer& transfer_buffer) {
+            // @return the new texture (nullptr if none was created)
+
+            // compressed data the device cant sample gets decoded (i.e. ktx2 files with formats it doesnt support)
+            if(!TextureLoader::isLoaded(image) || !TextureLoader::checkFormat(image, *_device)) return nullptr;
+
+            // compressed and uncompressed textures are cached separately
+            const FixedType& format = image._pixels ? DECODED_TEXTURE_FORMAT : COMPRESSED_TEXTURE_FORMAT;
+
+            if(_texture_cache.find(image._file_name, image_type, format)) {
+                TextureLoader::freeImage(image);
+                return nullptr;
+            }
+
+            std::shared_ptr<Texture> texture = TextureCache::createTexture();
+            texture->init(*_device, *_allocator, image_type);
+
+            // images with pre-built mip levels can be streamed (starting with only the small levels resident)
+            if(_texture_streamer && (image._compressed._mip_levels.size() > 1)) {
+                TextureCompressor::CompressedImage& compressed = image._compressed;
+                _texture_streamer->addTexture(texture, std::move(compressed._mip_levels), compressed._width, compressed._height, compressed._format, transfer_buffer);
+                TextureLoader::freeImage(image);
+            } else {
+                TextureLoader::uploadImage(image, *texture, transfer_buffer);
+            }
+
+            _texture_cache.store(image._file_name, image_type, format, texture);
+
+            return texture;
+        }
+
+        void SceneLoader::loadCookedScene(CookedScene& scene, SceneGroup& load_to, const std::string& directory, TransferBuffer& transfer_buffer, const std::vector<Mesh>& uploaded_meshes) {
+            // the textures have to be in the texture cache already (see loadCookedImages())
+            // uploaded_meshes: the meshes whose data was staged while cooking (see processAssimpMesh())
+
+            std::vector<std::string> material_names = loadCookedMaterials(scene, load_to, directory);
+
+            // load all meshes
+            for(int i = 0; i < scene.getMeshes().size(); i++) {
+
+                const CookedScene::Mesh& mesh = scene.getMeshes()[i];
+                Mesh& load_to_mesh = load_to.addMesh(mesh._name);
+                if(i < uploaded_meshes.size()) load_to_mesh = uploaded_meshes[i];
+
+                std::string material = (mesh._material < material_names.size()) ? material_names[mesh._material] : "";
+                loadCookedMesh(mesh, load_to_mesh, material, transfer_buffer);
+            }
+
+            loadCookedHierarchy(scene, load_to);
+
+        }
+
+        std::vector<std::string> SceneLoader::loadCookedMaterials(CookedScene& scene, SceneGroup& load_to, const std::string& directory) {
+            // the textures have to be in the texture cache already
+            // @return the names of the materials (referenced by the meshes)
+
+            std::vector<std::string> material_names;
+            for(const CookedScene::Material& material : scene.getMaterials()) {
+
+                std::string mat_name = material._name; // has to be unique (referenced by meshes)
+                if(!mat_name.length()) mat_name = "Material " + toStr(load_to.getMaterials().size());
+                loadCookedMaterial(material, load_to.addMaterial(mat_name), directory);
+                material_names.push_back(mat_name);
+            }
+
+            return material_names;
+        }
+
+        void SceneLoader::loadCookedHierarchy(CookedScene& scene, SceneGroup& load_to) {
+            // the nodes, skeletons and animations (after the meshes were loaded)
+
+            // load all nodes (recursive)
+            loadCookedNode(scene.getRootNode(), load_to.getRootNode());
+
+            // load all skeletons
+            for(const CookedScene::Skeleton& skeleton : scene.getSkeletons()) {
+
+                Skeleton* load_to_skeleton = load_to.getSkeleton(skeleton._name);
+                if(!load_to_skeleton) load_to_skeleton = &load_to.addSkeleton(skeleton._name);
+                loadCookedBone(skeleton._root_bone, load_to_skeleton->getRootBone());
+            }
+
+            // load all animations
+            for(const CookedScene::Animation& animation : scene.getAnimations()) {
+
+                loadCookedAnimation(animation, load_to.addAnimation(animation._name));
+            }
+
+            // setting the bind pose for all skeletons
+            for(Skeleton& s : load_to.getSkeletons()) {
+                s.updateBoneMatrices();
+                s.storeBindPose();
+            }
+
+        }
+
+        void SceneLoader::loadCookedMaterial(const CookedScene::Material& material, Material& load_to, const std::string& directory) {
+            // the textures of the material have to be in the texture cache already
+
+            // init the material
+            load_to.init(*_device, *_allocator, *_material_descriptor_cache);
+
+            for(const CookedScene::Texture& texture : material._textures) {
+
+                // preferring the format the loader currently uses
+                std::shared_ptr<Texture> cached_texture = _texture_cache.find(directory + texture._file_name, texture._type, getTextureCacheFormat());
+                if(!cached_texture) cached_texture = _texture_cache.find(directory + texture._file_name, texture._type, useTextureCompression() ? DECODED_TEXTURE_FORMAT : COMPRESSED_TEXTURE_FORMAT);
+                if(!cached_texture) continue; // failed to load the texture
+
+                load_to.addTexture(texture._type, cached_texture);
+
+                if(texture._type == Texture::Type::DIFFUSE) UND_LOG << "loaded diffuse texture: " << texture._file_name << "\n";
+                if(texture._type == Texture::Type::SPECULAR) UND_LOG << "loaded specular texture: " << texture._file_name << "\n";
+            }
+
+            load_to.updateDescriptorSet(*_sampler);
+
+        }
+
+        void SceneLoader::loadCookedMesh(const CookedScene::Mesh& mesh, Mesh& load_to, const std::string& material, TransferBuffer& transfer_buffer) {
+
+            // init the mesh
+            load_to.init(*_device, *_allocator);
+
+            // the data of a loaded cooked scene points into the mapped file, so it gets copied straight into the transfer buffer
+            // (empty blobs: the data was already packed into the transfer buffer while cooking, see processAssimpMesh())
+            if(mesh._vertex_data._byte_size)
+                load_to.setVertexData(mesh._vertex_data.getData(), mesh._vertex_data._byte_size, transfer_buffer);
+
+            if(mesh._index_data._byte_size) {
+                load_to.setIndexData(mesh._index_data.getData(), mesh._index_data._byte_size, transfer_buffer, (mesh._index_size == sizeof(uint16_t)) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32);
+                load_to.setVertexCount(mesh._lods.empty() ? mesh._index_data._byte_size / mesh._index_size : mesh._lods.front()._index_count);
+            }
+            load_to.setLODs(mesh._lods);
+            load_to.setBoundingSphere(mesh._bounding_center, mesh._bounding_radius);
+
+            // storing mesh attributes
+            load_to.setVertexAttributes(mesh._has_positions, mesh._has_tex_coords, mesh._has_normals, mesh._has_tangents_and_bitangents, mesh._has_bones);
+            load_to.setName(mesh._name);
+            load_to.setMaterial(material);
+            load_to.setBones(mesh._bones);
+
+        }
+
+        void SceneLoader::loadCookedNode(const CookedScene::Node& node, Node& load_to) {
+
+            if(node._meshes.size() == 1) {
+                if(!load_to.getHasVulkanObjects()) load_to.init(*_device, *_allocator, *_node_descriptor_cache);
+                load_to.setMesh(node._meshes[0]);
+            } else {
+                load_to.addMeshes(node._meshes, *_device, *_allocator, *_node_descriptor_cache);
+            }
+
+            load_to.setLocalTransformation(node._local_transformation);
+
+            for(unsigned int i = 0; i < node._child_nodes.size(); i++) {
+
+                // if a mesh gets stored, the node will be reinitialized with vulkan objects
+                // making sure that the node has a unique name
+                std::string node_name = node._child_nodes[i]._name;
+                if(load_to.getChildNode(node_name)) { node_name = node_name + " " + toStr(i);}
+
+                loadCookedNode(node._child_nodes[i], load_to.addChildNode(node_name));
+            }
+
+        }
+
+        void SceneLoader::loadCookedBone(const CookedScene::Bone& bone, Bone& load_to) {
+
+            load_to.setName(bone._name);
+            load_to.setLocalMatrix(bone._local_matrix);
+
+            for(const CookedScene::Bone& child : bone._child_bones)
+                loadCookedBone(child, *load_to.addChildBone(child._name));
+
+        }
+
+        void SceneLoader::loadCookedAnimation(const CookedScene::Animation& animation, Animation& load_to) {
+
+            load_to.init();
+            load_to.setName(animation._name);
+            load_to.setDuration(animation._duration);
+            load_to.setTicksPerSecond(animation._ticks_per_second);
+
+            for(const CookedScene::NodeAnimation& node_animation : animation._node_animations) {
+
+                NodeAnimation& load_to_node = load_to.addNodeAnimation(node_animation._node);
+
+                for(const CookedScene::Key<glm::vec3>& key : node_animation._position_keys)
+                    load_to_node.addPositionKey(key._time, key._value);
+
+                for(const CookedScene::Key<glm::quat>& key : node_animation._rotation_keys)
+                    load_to_node.addRotationKey(key._time, key._value);
+
+                for(const CookedScene::Key<glm::vec3>& key : node_animation._scale_keys)
+                    load_to_node.addScaleKey(key._time, key._value);
             }
+
+            UND_LOG << "loaded animation " << '"' << load_to.getName() << '"' << "\n";
+
+        }
+
+        void SceneLoader::beginUpload(SceneImport& import) {
+            // the data was loaded on the job system, so it can get staged from now on
+
+            if(!import._loaded) {
+                UND_ERROR << "failed to load assimp scene: " << import._file_name << "\n";
+                for(TextureLoader::DecodedImage& image : import._images) TextureLoader::freeImage(image);
+                import._images.clear();
+                import._state = SceneImport::State::FAILED;
+                return;
+            }
+
+            import._group.setName(import._group_name);
+            import._group.init();
+
+            import._state = SceneImport::State::STAGING;
+        }
+
+        void SceneLoader::stageImport(SceneImport& import, uint32_t& budget) {
+            /** @brief stages the next images or meshes of the import (as many as fit into the budget, but at least one)
+             * into a new chunk and submits it (without waiting for it)
+             * images are uploaded on the graphics queue (their layouts get transitioned),
+             * meshes on the transfer queue (if the device has a unique one)
+             * the last chunk holds the node ubos and generates the mip maps, after which the import is UPLOADING */
+
+            const std::vector<CookedScene::Mesh>& meshes = import._cooked_scene.getMeshes();
+            const uint32_t image_count = import._images.size();
+            const uint32_t mesh_count = meshes.size();
+
+            // choosing the data of the chunk
+            uint32_t image_end = import._staged_images;
+            uint32_t mesh_end = import._staged_meshes;
+            uint64_t chunk_size = 0;
+
+            if(image_end < image_count) {
+                while(image_end < image_count) {
+                    const TextureLoader::DecodedImage& image = import._images[image_end];
+                    uint64_t image_size = uint64_t(TextureLoader::getUploadSize(image)) + (image._compressed._mip_levels.size() + 1) * IMAGE_DATA_ALIGNMENT;
+                    if(chunk_size && (chunk_size + image_size > budget)) break;
+                    chunk_size += image_size;
+                    image_end++;
+                }
+            } else if(mesh_end < mesh_count) {
+                while(mesh_end < mesh_count) {
+                    uint64_t mesh_size = uint64_t(meshes[mesh_end]._vertex_data._byte_size) + meshes[mesh_end]._index_data._byte_size;
+                    if(chunk_size && (chunk_size + mesh_size > budget)) break;
+                    chunk_size += mesh_size;
+                    mesh_end++;
+                }
+            } else {
+                chunk_size = IMPORT_TRANSFER_MARGIN;
+            }
+
+            bool stages_images = import._staged_images < image_end;
+            bool stages_meshes = import._staged_meshes < mesh_end;
+            bool use_transfer_queue = stages_meshes && _device->hasUniqueTransferQueue();
+
+            budget -= std::min(uint64_t(budget), chunk_size);
+
+            // creating the objects of the chunk (the transfer buffer fits all of its data, so it never has to be flushed)
+            std::unique_ptr<SceneImport::UploadChunk> chunk = std::make_unique<SceneImport::UploadChunk>();
+            uint32_t queue_family = use_transfer_queue ? _device->getTransferQueueFamily() : _device->getGraphicsQueueFamily();
+            chunk->_transfer_buffer.init(*_allocator, {queue_family}, std::max<uint64_t>(chunk_size, 1));
+            chunk->_cmd.init(_device->getDevice(), use_transfer_queue ? _device->getTransferCmdPool() : _device->getGraphicsCmdPool());
+            chunk->_fence.init(_device->getDevice(), false);
+
+            // the materials are loaded once all textures are in the cache
+            if(!stages_images && !import._materials_loaded) {
+                import._material_names = loadCookedMaterials(import._cooked_scene, import._group, getFilePath(import._file_name));
+                import._materials_loaded = true;
+            }
+
+            // staging the data
+            if(stages_images) {
+
+                for(uint32_t i = import._staged_images; i < image_end; i++) {
+                    std::shared_ptr<Texture> texture = loadCookedImage(import._images[i], import._image_types[i], chunk->_transfer_buffer);
+                    if(texture) import._new_textures.push_back(texture);
+                }
+
+                import._staged_images = image_end;
+            } else if(stages_meshes) {
+
+                for(uint32_t i = import._staged_meshes; i < mesh_end; i++) {
+                    std::string material = (meshes[i]._material < import._material_names.size()) ? import._material_names[meshes[i]._material] : "";
+                    loadCookedMesh(meshes[i], import._group.addMesh(meshes[i]._name), material, chunk->_transfer_buffer);
+                }
+
+                import._staged_meshes = mesh_end;
+            } else {
+
+                loadCookedHierarchy(import._cooked_scene, import._group);
+
+                import._group.updateGlobalTransformations();
+                import._group.updateBoneMatrices();
+                import._group.updateNodeUBOs(chunk->_transfer_buffer);
+            }
+
+            // the image chunks are submitted on the graphics queue (after the transfers of previous frames)
+            // so textures that are shared with other groups are fully uploaded once they get used by the new group
+            chunk->_cmd.beginCommandBuffer(true);
+            chunk->_transfer_buffer.completeTransfers(chunk->_cmd);
+
+            bool final_chunk = !stages_images && !stages_meshes;
+            if(final_chunk) {
+                // the textures were uploaded by earlier chunks on the same queue
+                if(_mip_map_generator) {
+                    import._group.genMipMaps(*_mip_map_generator);
+                    import._mip_map_batch = _mip_map_generator->generate(chunk->_cmd);
+                } else {
+                    import._group.genMipMaps(chunk->_cmd);
+                }
+            }
+
+            chunk->_cmd.endCommandBuffer();
+
+            if(use_transfer_queue)
+                _device->submitOnTransferQueue(chunk->_cmd.getCommandBuffer(), chunk->_fence.getFence());
+            else
+                _device->submitOnGraphicsQueue(chunk->_cmd.getCommandBuffer(), chunk->_fence.getFence());
+
+            import._upload_chunks.push_back(std::move(chunk));
+
+            if(final_chunk) {
+                // the cooked data was copied into the transfer buffers
+                import._cooked_scene.clear();
+                import._images.clear();
+                import._image_types.clear();
+                import._material_names.clear();
+                import._new_textures.clear(); // referenced by the materials now
+
+                import._state = SceneImport::State::UPLOADING;
+            }
+
+        }
+
+        bool SceneLoader::releaseUploadChunks(SceneImport& import) {
+            // releases the chunks whose transfers finished
+            // @return true, if all submitted chunks finished
+
+            for(std::unique_ptr<SceneImport::UploadChunk>& chunk : import._upload_chunks) {
+
+                if(!chunk->_fence.isSignaled()) continue;
+
+                chunk->_transfer_buffer.cleanUp();
+                chunk->_cmd.cleanUp();
+                chunk->_fence.cleanUp();
+                chunk.reset();
+            }
+
+            import._upload_chunks.erase(std::remove(import._upload_chunks.begin(), import._upload_chunks.end(), nullptr), import._upload_chunks.end());
+
+            return import._upload_chunks.empty();
+        }
+
+        void SceneLoader::finishImport(SceneImport& import) {
+            // all chunks finished, so the group can be added to the scene
+
+            if(_mip_map_generator)
+                _mip_map_generator->release(import._mip_map_batch);
+
+            // the texture streamer might have replaced the images of textures while the upload was running
+            if(_texture_streamer)
+                for(Material& material : import._group.getMaterials())
+                    material.updateDescriptorSet(*_sampler);
+
+            import._scene->addGroup(std::move(import._group));
+            import._state = SceneImport::State::RESIDENT;
+
+            UND_LOG << "finished importing " << import._file_name << " in the background\n";
         }
 
     } // tools
 
-} // undicht
\ No newline at end of file
+} // undicht
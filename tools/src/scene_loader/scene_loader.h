@@ -9,10 +9,20 @@
 #include "scene/animation.h"
 #include "scene/skeleton.h"
 #include "scene/node_animation.h"
+#include "scene/texture_cache.h"
+#include "scene/texture_streamer.h"
+#include "scene/mip_map_generator.h"
+#include "job_system.h"
+#include "cooked_scene.h"
+#include "texture_loader.h"
+#include "mesh_optimizer.h"
+#include "mesh_simplifier.h"
+#include "scene_import.h"
 
 #include "string"
 #include "vector"
 #include "set"
+#include "memory"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -23,6 +33,9 @@ namespace undicht {
 	namespace tools {
 
         class SceneLoader {
+            /** @brief loads scene files (via assimp) into a SceneGroup
+             * the processed scene gets cooked into a binary file next to the scene file (file_name + ".cooked"),
+             * which is used instead of assimp on later imports, as long as the scene file and the import flags didnt change */
 
           protected:
 
@@ -34,6 +47,32 @@ namespace undicht {
             const vulkan::Sampler* _sampler = nullptr;
             vma::VulkanMemoryAllocator* _allocator = nullptr;
 
+            // optional, used to process the vertices of large meshes in parallel
+            JobSystem* _job_system = nullptr;
+
+            // optional, streams the mip levels of textures that have pre-built ones
+            graphics::TextureStreamer* _texture_streamer = nullptr;
+
+            // optional, generates the mip maps of the textures of background imports with one batch of dispatches per import
+            graphics::MipMapGenerator* _mip_map_generator = nullptr;
+
+            bool _use_scene_cache = true;
+            bool _compress_textures = true;
+
+            // textures loaded by previous imports, which are still used by materials
+            graphics::TextureCache _texture_cache;
+
+            // reorders the vertices / indices of the meshes while cooking a scene
+            MeshOptimizer _mesh_optimizer;
+            MeshOptimizer::Stats _optimizer_stats; // of the scene that is being cooked (acmr weighted by triangle count)
+
+            // generates the lods of static meshes while cooking a scene
+            MeshSimplifier _mesh_simplifier;
+
+            // scenes that are imported in the background (see importSceneAsync())
+            std::vector<std::shared_ptr<SceneImport>> _imports;
+            uint32_t _import_upload_budget = 16 * 1024 * 1024; // bytes staged per call of updateImports()
+
             // storing the names of bones referenced by meshes
             // to identify and seperate normal nodes from bone nodes
             std::set<std::string> _bone_names;
@@ -42,35 +81,119 @@ namespace undicht {
 
             // store references to the objects
             // that the loader should use when initializing vulkan objects
+            // scenes that dont fit into the transfer buffer can only be imported if flushing is enabled on it (see TransferBuffer::enableFlushing())
             void setInitObjects(const vulkan::LogicalDevice& device, vma::VulkanMemoryAllocator& allocator, vulkan::TransferBuffer& transfer_buffer, vulkan::DescriptorSetCache& material_descriptor_cache, vulkan::DescriptorSetCache& node_descriptor_cache, const vulkan::Sampler& sampler);
 
+            // optional, large meshes get processed in parallel if a job system is set
+            void setJobSystem(JobSystem& job_system);
+
+            // if disabled, scenes always get imported with assimp (and no cooked files get written)
+            void setUseSceneCache(bool use_cache);
+
+            // applies to the following imports (scenes that were cooked with different settings get recooked)
+            void setMeshOptimizerSettings(const MeshOptimizer::Settings& settings);
+            void setMeshSimplifierSettings(const MeshSimplifier::Settings& settings);
+
+            // if enabled (and supported by the device), textures get block compressed (BC1 / BC3 / BC5) with pre-built mip levels
+            // the compressed images are stored next to the image files, so they only get compressed once
+            void setCompressTextures(bool compress);
+
+            // optional, textures with pre-built mip levels (compressed or ktx2 textures) get streamed by the streamer
+            // (starting with only their smallest levels resident)
+            void setTextureStreamer(graphics::TextureStreamer& streamer);
+
+            // optional, the mip maps of the textures of background imports get generated by the generator (compute shader)
+            // instead of recording blits for every level of every texture
+            void setMipMapGenerator(graphics::MipMapGenerator& generator);
+
+            // the number of bytes background imports stage per call of updateImports()
+            // (at least one image / mesh gets staged, even if it is larger)
+            void setImportUploadBudget(uint32_t byte_size);
+
             void importScene(const std::string& file_name, graphics::SceneGroup& load_to);
 
+            /** @brief imports the scene in the background (requires a job system)
+             * the scene file gets loaded / cooked and the textures get decoded on the job system,
+             * the upload gets staged by updateImports() in chunks (with their own transfer buffers and fences),
+             * so that each frame only stages a limited amount of data and never waits for the gpu
+             * once all chunks finished, the imported group gets added to the scene
+             * @return a handle to check on the state of the import */
+            std::shared_ptr<SceneImport> importSceneAsync(const std::string& file_name, graphics::Scene& scene, const std::string& group_name);
+
+            /// @brief advances the background imports (call once per frame, on the thread that uses the scene)
+            void updateImports();
+
+            /// @brief waits for all background imports to finish (i.e. before cleaning up the scene)
+            void waitForImports();
+
+            uint32_t getPendingImportCount() const;
+
+            /// @brief the textures loaded by the scene loader (which are still in use)
+            graphics::TextureCache& getTextureCache();
+
+          protected:
+
+            struct VertexBoneWeights {
+                // the bone weights of a mesh sorted by vertex (instead of by bone as in assimp)
+                // the weights of vertex i are stored in _weights[_offsets[i]] to _weights[_offsets[i + 1] - 1]
+                struct Weight {
+                    uint32_t _bone_id;
+                    float _weight;
+                };
+
+                std::vector<uint32_t> _offsets;
+                std::vector<Weight> _weights;
+            };
+
           protected:
             // non public SceneLoader functions
 
+            // functions to cook a scene with assimp
+            bool useTextureCompression() const;
+            const FixedType& getTextureCacheFormat() const; // the key of the textures loaded by the next import in the texture cache
+            bool loadOrCookScene(const std::string& file_name, CookedScene& load_to); // loads the cooked scene, if it is up to date
+            bool cookScene(const std::string& file_name, CookedScene& load_to, std::vector<graphics::Mesh>* upload_meshes_to = nullptr); // upload_meshes_to: see processAssimpMesh()
             const aiScene* importAssimpScene(Assimp::Importer& importer, const std::string& file_name) const;
-            void processAssimpScene(const aiScene* assimp_scene, graphics::SceneGroup& load_to, const std::string& directory);
+            void processAssimpScene(const aiScene* assimp_scene, CookedScene& load_to, std::vector<graphics::Mesh>* upload_meshes_to = nullptr);
 
 		        // functions to process meshes
-            void processAssimpMesh(const aiMesh* assimp_mesh, graphics::Mesh& load_to, const std::vector<graphics::Material>::iterator& materials);
-            void processAssimpVertices(const aiMesh* assimp_mesh, graphics::Mesh& load_to);        
-            void processAssimpFaces(const aiMesh* assimp_mesh, graphics::Mesh& load_to);
-            void processAssimpMeshBones(const aiMesh* assimp_mesh, graphics::Mesh& load_to);
-            void processAssimpVertexBones(const aiMesh* assimp_mesh, int vertex_id, std::vector<ai_real>& load_to);
-            void processAssimpVec3(const aiVector3D& assimp_vec, std::vector<ai_real>& load_to);
+            void processAssimpMesh(const aiMesh* assimp_mesh, CookedScene::Mesh& load_to, graphics::Mesh* upload_to = nullptr); // upload_to: the data gets packed straight into the transfer buffer (instead of the blobs)
+            void processAssimpVertices(const aiMesh* assimp_mesh, bool with_bones, std::vector<ai_real>& load_to); // interleaves the vertex attributes
+            void gatherAssimpVertexBones(const aiMesh* assimp_mesh, VertexBoneWeights& load_to);
+            void processAssimpVertexBones(const VertexBoneWeights& bone_weights, uint32_t vertex_id, ai_real* load_to);
+            void processAssimpFaces(const aiMesh* assimp_mesh, std::vector<uint32_t>& load_to);
+            void processAssimpMeshBones(const aiMesh* assimp_mesh, std::vector<std::string>& load_to);
             void processAssimpMat4(const aiMatrix4x4& assimp_mat, glm::mat4& load_to);
 
             // functions to process materials
-            void processAssimpMaterial(const aiMaterial* assimp_material, graphics::Material& load_to, const std::string& directory);
+            void processAssimpMaterial(const aiMaterial* assimp_material, CookedScene::Material& load_to);
 
             // functions to process nodes
-            void processAssimpNode(const aiNode* assimp_node, graphics::Node& load_to, graphics::SceneGroup& scene_group);
-            void processAssimpBoneNode(const aiNode* assimp_node, graphics::Bone& load_to);
+            void processAssimpNode(const aiNode* assimp_node, CookedScene::Node& load_to, CookedScene& scene);
+            void processAssimpBoneNode(const aiNode* assimp_node, CookedScene::Bone& load_to);
 
             // functions to process animations
-            void processAssimpAnimation(const aiAnimation* assimp_animation, graphics::Animation& load_to);
-            void processAssimpNodeAnimation(const aiNodeAnim* assimp_node_animation, graphics::NodeAnimation& load_to);
+            void processAssimpAnimation(const aiAnimation* assimp_animation, CookedScene::Animation& load_to);
+            void processAssimpNodeAnimation(const aiNodeAnim* assimp_node_animation, CookedScene::NodeAnimation& load_to);
+
+            // functions to load a cooked scene into a SceneGroup (creating the vulkan objects)
+            void collectCookedImages(CookedScene& scene, const std::string& directory, std::vector<TextureLoader::DecodedImage>& images, std::vector<graphics::Texture::Type>& image_types); // the images that are not in the texture cache yet
+            std::vector<std::shared_ptr<graphics::Texture>> loadCookedImages(std::vector<TextureLoader::DecodedImage>& images, const std::vector<graphics::Texture::Type>& image_types, vulkan::TransferBuffer& transfer_buffer); // @return the new textures (keep them alive until the materials reference them)
+            std::shared_ptr<graphics::Texture> loadCookedImage(TextureLoader::DecodedImage& image, graphics::Texture::Type image_type, vulkan::TransferBuffer& transfer_buffer); // @return the new texture (nullptr if none was created)
+            void loadCookedScene(CookedScene& scene, graphics::SceneGroup& load_to, const std::string& directory, vulkan::TransferBuffer& transfer_buffer, const std::vector<graphics::Mesh>& uploaded_meshes = {}); // the textures have to be in the texture cache already
+            std::vector<std::string> loadCookedMaterials(CookedScene& scene, graphics::SceneGroup& load_to, const std::string& directory); // @return the names of the materials (referenced by the meshes)
+            void loadCookedHierarchy(CookedScene& scene, graphics::SceneGroup& load_to); // the nodes, skeletons and animations
+            void loadCookedMaterial(const CookedScene::Material& material, graphics::Material& load_to, const std::string& directory); // the textures have to be in the texture cache already
+            void loadCookedMesh(const CookedScene::Mesh& mesh, graphics::Mesh& load_to, const std::string& material, vulkan::TransferBuffer& transfer_buffer);
+            void loadCookedNode(const CookedScene::Node& node, graphics::Node& load_to);
+            void loadCookedBone(const CookedScene::Bone& bone, graphics::Bone& load_to);
+            void loadCookedAnimation(const CookedScene::Animation& animation, graphics::Animation& load_to);
+
+            // functions to finish background imports (on the main thread)
+            void beginUpload(SceneImport& import);
+            void stageImport(SceneImport& import, uint32_t& budget);
+            bool releaseUploadChunks(SceneImport& import);
+            void finishImport(SceneImport& import);
         };
 
 	} // tools
@@ -0,0 +1,660 @@
+#include "texture_compressor.h"
+#include "mapped_file.h"
+#include "debug.h"
+
+#include "cmath"
+#include "cstring"
+#include "algorithm"
+#include "fstream"
+#include "filesystem"
+
+namespace undicht {
+
+    namespace tools {
+
+        namespace {
+
+            const char COMPRESSED_IMAGE_MAGIC[8] = {'U', 'N', 'D', 'T', 'E', 'X', 'B', 'C'};
+            const uint32_t COMPRESSED_IMAGE_VERSION = 2; // increase when the encoders change, so that old files get recompressed
+
+            // levels with fewer blocks are encoded on the calling thread
+            const uint32_t PARALLEL_BLOCK_COUNT = 1024;
+            const uint32_t BLOCKS_PER_BATCH = 1024;
+
+            struct SRGBTables {
+                float _to_linear[256];
+                uint8_t _to_srgb[4096]; // indexed by the linear value * 4095
+
+                SRGBTables() {
+
+                    for(int i = 0; i < 256; i++) {
+                        float c = i / 255.0f;
+                        _to_linear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+                    }
+
+                    for(int i = 0; i < 4096; i++) {
+                        float c = i / 4095.0f;
+                        float s = (c <= 0.0031308f) ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                        _to_srgb[i] = uint8_t(std::clamp(s * 255.0f + 0.5f, 0.0f, 255.0f));
+                    }
+                }
+            };
+
+            const SRGBTables& getSRGBTables() {
+
+                static const SRGBTables tables;
+                return tables;
+            }
+
+            uint16_t packRGB565(const float* color) {
+
+                uint32_t r = uint32_t(std::clamp(color[0] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f));
+                uint32_t g = uint32_t(std::clamp(color[1] * (63.0f / 255.0f) + 0.5f, 0.0f, 63.0f));
+                uint32_t b = uint32_t(std::clamp(color[2] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f));
+
+                return uint16_t((r << 11) | (g << 5) | b);
+            }
+
+            void unpackRGB565(uint16_t packed, float* color) {
+                // the same expansion the gpu uses (replicating the high bits)
+
+                uint32_t r = (packed >> 11) & 31;
+                uint32_t g = (packed >> 5) & 63;
+                uint32_t b = packed & 31;
+
+                color[0] = float((r << 3) | (r >> 2));
+                color[1] = float((g << 2) | (g >> 4));
+                color[2] = float((b << 3) | (b >> 2));
+            }
+
+            void fetchBlock(const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t block_x, uint32_t block_y, uint8_t* load_to) {
+                // texels outside of the image repeat the last row / column
+
+                for(uint32_t y = 0; y < 4; y++) {
+
+                    const uint32_t src_y = std::min(block_y * 4 + y, height - 1);
+
+                    for(uint32_t x = 0; x < 4; x++) {
+
+                        const uint32_t src_x = std::min(block_x * 4 + x, width - 1);
+                        std::memcpy(load_to + 4 * (4 * y + x), pixels + 4 * (size_t(src_y) * width + src_x), 4);
+                    }
+                }
+
+            }
+
+            void decodeColorBlock(const uint8_t* block, bool allow_transparency, uint8_t* load_to) {
+                // decodes the colors of a BC1 block to 4x4 rgba texels
+                // (BC1 blocks with color0 <= color1 use the 3 color mode with transparent black, the color blocks of BC3 dont)
+
+                uint16_t color0, color1;
+                uint32_t indices;
+                std::memcpy(&color0, block + 0, 2);
+                std::memcpy(&color1, block + 2, 2);
+                std::memcpy(&indices, block + 4, 4);
+
+                float palette[4][4];
+                unpackRGB565(color0, palette[0]);
+                unpackRGB565(color1, palette[1]);
+                palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255.0f;
+
+                for(int c = 0; c < 3; c++) {
+                    if((color0 > color1) || !allow_transparency) {
+                        palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                        palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+                    } else {
+                        palette[2][c] = (palette[0][c] + palette[1][c]) / 2.0f;
+                        palette[3][c] = 0.0f;
+                    }
+                }
+
+                if((color0 <= color1) && allow_transparency) palette[3][3] = 0.0f;
+
+                for(int i = 0; i < 16; i++)
+                    for(int c = 0; c < 4; c++)
+                        load_to[4 * i + c] = uint8_t(palette[(indices >> (2 * i)) & 3][c] + 0.5f);
+
+            }
+
+            void decodeValueBlock(const uint8_t* block, uint32_t channel, uint8_t* load_to) {
+                // decodes a BC4 block into one channel of 4x4 rgba texels
+                // (blocks with value0 <= value1 interpolate 4 values and use 0 and 255 for the remaining indices)
+
+                const float value0 = block[0];
+                const float value1 = block[1];
+
+                float palette[8] = {value0, value1};
+                if(value0 > value1) {
+                    for(int p = 2; p < 8; p++)
+                        palette[p] = ((8 - p) * value0 + (p - 1) * value1) / 7.0f;
+                } else {
+                    for(int p = 2; p < 6; p++)
+                        palette[p] = ((6 - p) * value0 + (p - 1) * value1) / 5.0f;
+                    palette[6] = 0.0f;
+                    palette[7] = 255.0f;
+                }
+
+                // 16 indices with 3 bits each
+                uint64_t indices = 0;
+                for(int i = 0; i < 6; i++)
+                    indices |= uint64_t(block[2 + i]) << (8 * i);
+
+                for(int i = 0; i < 16; i++)
+                    load_to[4 * i + channel] = uint8_t(palette[(indices >> (3 * i)) & 7] + 0.5f);
+
+            }
+
+        } // anonymous namespace
+
+        FixedType TextureCompressor::chooseFormat(const uint8_t* pixels, uint32_t width, uint32_t height, graphics::Texture::Type type) {
+            /** @return BC5 for normal maps, BC3 if the image has transparent texels, BC1 otherwise
+             * only diffuse maps store colors, so only they use the srgb formats */
+
+            if(type == graphics::Texture::Type::NORMAL) return UND_BC5;
+
+            const bool srgb = (type == graphics::Texture::Type::DIFFUSE);
+
+            const size_t texel_count = size_t(width) * height;
+            for(size_t i = 0; i < texel_count; i++)
+                if(pixels[4 * i + 3] != 255) return srgb ? UND_BC3_SRGB : UND_BC3;
+
+            return srgb ? UND_BC1_SRGB : UND_BC1;
+        }
+
+        void TextureCompressor::compress(const uint8_t* pixels, uint32_t width, uint32_t height, const FixedType& format, CompressedImage& load_to, JobSystem* job_system) {
+            /// @brief compresses the rgba image and all of its mip levels
+
+            load_to._format = format;
+            load_to._width = width;
+            load_to._height = height;
+            load_to._mip_levels.clear();
+
+            if(!width || !height) return;
+
+            // the full size level is compressed directly from the source pixels
+            const uint8_t* level_pixels = pixels;
+            std::vector<uint8_t> level;
+            std::vector<uint8_t> next_level;
+
+            while(true) {
+
+                load_to._mip_levels.emplace_back();
+                compressLevel(level_pixels, width, height, format, load_to._mip_levels.back(), job_system);
+
+                if((width == 1) && (height == 1)) break;
+
+                downsample(level_pixels, width, height, isSRGB(format), next_level);
+                level.swap(next_level);
+                level_pixels = level.data();
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+
+        }
+
+        void TextureCompressor::compressLevel(const uint8_t* pixels, uint32_t width, uint32_t height, const FixedType& format, std::vector<uint8_t>& load_to, JobSystem* job_system) {
+            /// @brief compresses a single level of the rgba image
+
+            const uint32_t blocks_x = (width + 3) / 4;
+            const uint32_t blocks_y = (height + 3) / 4;
+            const uint32_t block_size = getBlockSize(format);
+            load_to.resize(size_t(blocks_x) * blocks_y * block_size);
+
+            // every row of blocks writes to its own part of load_to, so they can be encoded in parallel
+            std::function<void(uint32_t, uint32_t)> encode_rows = [&](uint32_t begin, uint32_t end) {
+
+                uint8_t block[64];
+
+                for(uint32_t y = begin; y < end; y++) {
+                    for(uint32_t x = 0; x < blocks_x; x++) {
+
+                        fetchBlock(pixels, width, height, x, y, block);
+                        uint8_t* dst = load_to.data() + (size_t(y) * blocks_x + x) * block_size;
+
+                        switch(format.m_type) {
+                            case Type::COLOR_BC1:
+                            case Type::COLOR_BC1_SRGB: encodeBC1Block(block, dst); break;
+                            case Type::COLOR_BC3:
+                            case Type::COLOR_BC3_SRGB: encodeBC3Block(block, dst); break;
+                            case Type::COLOR_BC5: encodeBC5Block(block, dst); break;
+                            default: break;
+                        }
+                    }
+                }
+
+            };
+
+            if(job_system && (blocks_x * blocks_y >= PARALLEL_BLOCK_COUNT))
+                job_system->parallelFor(blocks_y, std::max(BLOCKS_PER_BATCH / blocks_x, 1u), encode_rows);
+            else
+                encode_rows(0, blocks_y);
+
+        }
+
+        void TextureCompressor::downsample(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& load_to) {
+            /// @brief halves the size of the rgba image (the color channels are averaged in linear space, if srgb is true)
+
+            const SRGBTables& tables = getSRGBTables();
+            const uint32_t new_width = std::max(width / 2, 1u);
+            const uint32_t new_height = std::max(height / 2, 1u);
+            load_to.resize(size_t(new_width) * new_height * 4);
+
+            for(uint32_t y = 0; y < new_height; y++) {
+
+                const uint8_t* row0 = pixels + size_t(std::min(2 * y, height - 1)) * width * 4;
+                const uint8_t* row1 = pixels + size_t(std::min(2 * y + 1, height - 1)) * width * 4;
+
+                for(uint32_t x = 0; x < new_width; x++) {
+
+                    const uint32_t x0 = std::min(2 * x, width - 1) * 4;
+                    const uint32_t x1 = std::min(2 * x + 1, width - 1) * 4;
+                    uint8_t* dst = load_to.data() + (size_t(y) * new_width + x) * 4;
+
+                    for(uint32_t c = 0; c < 4; c++) {
+
+                        if(srgb && (c < 3)) {
+                            float sum = tables._to_linear[row0[x0 + c]] + tables._to_linear[row0[x1 + c]] + tables._to_linear[row1[x0 + c]] + tables._to_linear[row1[x1 + c]];
+                            dst[c] = tables._to_srgb[uint32_t(sum * 0.25f * 4095.0f + 0.5f)];
+                        } else {
+                            dst[c] = uint8_t((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+                        }
+                    }
+
+                }
+            }
+
+        }
+
+        bool TextureCompressor::decompressLevel(const uint8_t* data, uint32_t width, uint32_t height, const FixedType& format, std::vector<uint8_t>& load_to) {
+            /** @brief decodes a block compressed level to rgba texels (i.e. when the device cant sample the format)
+             * BC4 is decoded to (r,r,r,255) and BC5 to (r,g,0,255)
+             * @return false, if the format cant be decoded (BC7) */
+
+            const uint32_t block_size = getBlockSize(format);
+            if(!block_size) return false;
+
+            const uint32_t blocks_x = (width + 3) / 4;
+            const uint32_t blocks_y = (height + 3) / 4;
+            load_to.resize(size_t(width) * height * 4);
+
+            uint8_t block[64];
+
+            for(uint32_t block_y = 0; block_y < blocks_y; block_y++) {
+                for(uint32_t block_x = 0; block_x < blocks_x; block_x++) {
+
+                    const uint8_t* src = data + (size_t(block_y) * blocks_x + block_x) * block_size;
+
+                    switch(format.m_type) {
+                        case Type::COLOR_BC1:
+                        case Type::COLOR_BC1_SRGB:
+                            decodeColorBlock(src, true, block);
+                            break;
+                        case Type::COLOR_BC3:
+                        case Type::COLOR_BC3_SRGB:
+                            decodeColorBlock(src + 8, false, block);
+                            decodeValueBlock(src, 3, block);
+                            break;
+                        case Type::COLOR_BC4:
+                            decodeValueBlock(src, 0, block);
+                            for(int i = 0; i < 16; i++) {
+                                block[4 * i + 1] = block[4 * i + 2] = block[4 * i];
+                                block[4 * i + 3] = 255;
+                            }
+                            break;
+                        case Type::COLOR_BC5:
+                            decodeValueBlock(src, 0, block);
+                            decodeValueBlock(src + 8, 1, block);
+                            for(int i = 0; i < 16; i++) {
+                                block[4 * i + 2] = 0;
+                                block[4 * i + 3] = 255;
+                            }
+                            break;
+                        default: break;
+                    }
+
+                    // the blocks at the edges can extend beyond the image
+                    for(uint32_t y = 0; (y < 4) && (block_y * 4 + y < height); y++) {
+
+                        const uint32_t texel_count = std::min(4u, width - block_x * 4);
+                        std::memcpy(load_to.data() + 4 * ((size_t(block_y) * 4 + y) * width + block_x * 4), block + 16 * y, 4 * texel_count);
+                    }
+
+                }
+            }
+
+            return true;
+        }
+
+        bool TextureCompressor::load(const std::string& file_name, uint64_t source_hash, CompressedImage& load_to) {
+            /** @brief reads a compressed image stored with store()
+             * @return false, if the file doesnt exist, is corrupted or was compressed from a different source */
+
+            MappedFile file;
+            if(!file.open(file_name)) return false;
+
+            const uint8_t* position = file.getData();
+            const uint8_t* end = position + file.getSize();
+
+            // reading past the end of the file means that it is corrupted
+            auto read = [&](void* value, size_t size) {
+                if(size_t(end - position) < size) return false;
+                std::memcpy(value, position, size);
+                position += size;
+                return true;
+            };
+
+            char magic[8];
+            uint32_t version = 0;
+            uint64_t stored_hash = 0;
+            uint32_t format_type = 0;
+            uint32_t block_size = 0;
+            uint32_t level_count = 0;
+
+            bool valid = read(magic, 8) && read(&version, 4) && read(&stored_hash, 8);
+            if(!valid || std::memcmp(magic, COMPRESSED_IMAGE_MAGIC, 8) || (version != COMPRESSED_IMAGE_VERSION) || (stored_hash != source_hash))
+                return false;
+
+            valid = read(&format_type, 4) && read(&block_size, 4) && read(&load_to._width, 4) && read(&load_to._height, 4) && read(&level_count, 4);
+            load_to._format = FixedType(Type(format_type), block_size, 1);
+
+            if(!valid || !block_size || (block_size != getBlockSize(load_to._format)) || (level_count > 32)) {
+                UND_WARNING << "compressed image file is corrupted: " << file_name << "\n";
+                return false;
+            }
+
+            load_to._mip_levels.resize(level_count);
+            uint32_t width = load_to._width;
+            uint32_t height = load_to._height;
+
+            for(std::vector<uint8_t>& level : load_to._mip_levels) {
+
+                uint32_t byte_size = 0;
+                const size_t expected_size = size_t((width + 3) / 4) * ((height + 3) / 4) * block_size;
+
+                if(!read(&byte_size, 4) || (byte_size != expected_size) || (size_t(end - position) < byte_size)) {
+                    UND_WARNING << "compressed image file is corrupted: " << file_name << "\n";
+                    load_to._mip_levels.clear();
+                    return false;
+                }
+
+                level.assign(position, position + byte_size);
+                position += byte_size;
+
+                width = std::max(width / 2, 1u);
+                height = std::max(height / 2, 1u);
+            }
+
+            return true;
+        }
+
+        bool TextureCompressor::store(const std::string& file_name, uint64_t source_hash, const CompressedImage& image) {
+            /// @return false, if the file could not be written
+
+            // the file gets replaced once it is complete, since load() maps it
+            // (truncating a file that is mapped by a background import would crash the import with SIGBUS)
+            const std::string temp_file_name = file_name + ".tmp";
+            std::ofstream file(temp_file_name, std::ios::binary | std::ios::trunc);
+            if(!file.is_open()) {
+                UND_WARNING << "failed to write the compressed image file: " << file_name << "\n";
+                return false;
+            }
+
+            const uint32_t format_type = uint32_t(image._format.m_type);
+            const uint32_t block_size = getBlockSize(image._format);
+            const uint32_t level_count = image._mip_levels.size();
+
+            file.write(COMPRESSED_IMAGE_MAGIC, 8);
+            file.write((const char*)&COMPRESSED_IMAGE_VERSION, sizeof(uint32_t));
+            file.write((const char*)&source_hash, sizeof(uint64_t));
+            file.write((const char*)&format_type, sizeof(uint32_t));
+            file.write((const char*)&block_size, sizeof(uint32_t));
+            file.write((const char*)&image._width, sizeof(uint32_t));
+            file.write((const char*)&image._height, sizeof(uint32_t));
+            file.write((const char*)&level_count, sizeof(uint32_t));
+
+            for(const std::vector<uint8_t>& level : image._mip_levels) {
+
+                const uint32_t byte_size = level.size();
+                file.write((const char*)&byte_size, sizeof(uint32_t));
+                file.write((const char*)level.data(), level.size());
+            }
+
+            file.close();
+
+            std::error_code error;
+            if(file.good()) std::filesystem::rename(temp_file_name, file_name, error);
+
+            if(!file.good() || error) {
+                UND_WARNING << "failed to write the compressed image file: " << file_name << "\n";
+                std::filesystem::remove(temp_file_name, error);
+                return false;
+            }
+
+            return true;
+        }
+
+        void TextureCompressor::encodeBC1Block(const uint8_t* block, uint8_t* load_to) {
+            // picks the endpoints at the extremes of the colors along their principal axis
+            // and assigns the closest of the 4 interpolated colors to each texel
+
+            float r[16], g[16], b[16];
+            for(int i = 0; i < 16; i++) {
+                r[i] = block[4 * i + 0];
+                g[i] = block[4 * i + 1];
+                b[i] = block[4 * i + 2];
+            }
+
+            // mean and covariance of the colors
+            float mean[3] = {0.0f, 0.0f, 0.0f};
+            for(int i = 0; i < 16; i++) {
+                mean[0] += r[i];
+                mean[1] += g[i];
+                mean[2] += b[i];
+            }
+            mean[0] /= 16.0f;
+            mean[1] /= 16.0f;
+            mean[2] /= 16.0f;
+
+            float cov[6] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f}; // rr, rg, rb, gg, gb, bb
+            for(int i = 0; i < 16; i++) {
+                const float dr = r[i] - mean[0];
+                const float dg = g[i] - mean[1];
+                const float db = b[i] - mean[2];
+                cov[0] += dr * dr;
+                cov[1] += dr * dg;
+                cov[2] += dr * db;
+                cov[3] += dg * dg;
+                cov[4] += dg * db;
+                cov[5] += db * db;
+            }
+
+            // the principal axis (power iteration)
+            // starting with the row of the covariance matrix with the largest norm,
+            // a fixed start vector could be orthogonal to the axis (i.e. (1,1,1) for a red / green edge)
+            const float rows[3][3] = {{cov[0], cov[1], cov[2]}, {cov[1], cov[3], cov[4]}, {cov[2], cov[4], cov[5]}};
+            float axis[3] = {0.0f, 0.0f, 0.0f};
+            float max_norm = 0.0f;
+            for(int row = 0; row < 3; row++) {
+                const float norm = rows[row][0] * rows[row][0] + rows[row][1] * rows[row][1] + rows[row][2] * rows[row][2];
+                if(norm <= max_norm) continue;
+                max_norm = norm;
+                std::memcpy(axis, rows[row], sizeof(axis));
+            }
+
+            bool degenerate = max_norm < 1e-6f;
+            for(int iteration = 0; (iteration < 8) && !degenerate; iteration++) {
+
+                const float x = cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2];
+                const float y = cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2];
+                const float z = cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2];
+                const float length = std::max(std::max(std::abs(x), std::abs(y)), std::abs(z));
+                degenerate = length < 1e-6f;
+                if(degenerate) break;
+
+                axis[0] = x / length;
+                axis[1] = y / length;
+                axis[2] = z / length;
+            }
+
+            // falling back to the diagonal of the bounding box of the colors
+            if(degenerate) {
+
+                float min_color[3] = {255.0f, 255.0f, 255.0f};
+                float max_color[3] = {0.0f, 0.0f, 0.0f};
+                for(int i = 0; i < 16; i++) {
+                    min_color[0] = std::min(min_color[0], r[i]);
+                    min_color[1] = std::min(min_color[1], g[i]);
+                    min_color[2] = std::min(min_color[2], b[i]);
+                    max_color[0] = std::max(max_color[0], r[i]);
+                    max_color[1] = std::max(max_color[1], g[i]);
+                    max_color[2] = std::max(max_color[2], b[i]);
+                }
+
+                for(int c = 0; c < 3; c++) axis[c] = max_color[c] - min_color[c];
+            }
+
+            // all texels have the same color (any axis works)
+            if(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2] < 1e-6f)
+                axis[0] = axis[1] = axis[2] = 1.0f;
+
+            const float axis_length_sq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+
+            // the range of the colors along the axis
+            float min_t = 0.0f;
+            float max_t = 0.0f;
+            for(int i = 0; i < 16; i++) {
+                const float t = (r[i] - mean[0]) * axis[0] + (g[i] - mean[1]) * axis[1] + (b[i] - mean[2]) * axis[2];
+                min_t = std::min(min_t, t);
+                max_t = std::max(max_t, t);
+            }
+
+            min_t /= axis_length_sq;
+            max_t /= axis_length_sq;
+
+            float max_color[3] = {mean[0] + axis[0] * max_t, mean[1] + axis[1] * max_t, mean[2] + axis[2] * max_t};
+            float min_color[3] = {mean[0] + axis[0] * min_t, mean[1] + axis[1] * min_t, mean[2] + axis[2] * min_t};
+
+            uint16_t color0 = packRGB565(max_color);
+            uint16_t color1 = packRGB565(min_color);
+
+            // color0 has to be bigger than color1, otherwise the block would use the 3 color mode
+            if(color0 < color1) std::swap(color0, color1);
+
+            uint32_t indices = 0;
+
+            if(color0 != color1) {
+
+                float palette[4][3];
+                unpackRGB565(color0, palette[0]);
+                unpackRGB565(color1, palette[1]);
+                for(int c = 0; c < 3; c++) {
+                    palette[2][c] = (2.0f * palette[0][c] + palette[1][c]) / 3.0f;
+                    palette[3][c] = (palette[0][c] + 2.0f * palette[1][c]) / 3.0f;
+                }
+
+                for(int i = 0; i < 16; i++) {
+
+                    uint32_t best_index = 0;
+                    float best_distance = 1e30f;
+
+                    for(uint32_t p = 0; p < 4; p++) {
+                        const float dr = r[i] - palette[p][0];
+                        const float dg = g[i] - palette[p][1];
+                        const float db = b[i] - palette[p][2];
+                        const float distance = dr * dr + dg * dg + db * db;
+                        best_index = (distance < best_distance) ? p : best_index;
+                        best_distance = std::min(distance, best_distance);
+                    }
+
+                    indices |= best_index << (2 * i);
+                }
+            }
+
+            std::memcpy(load_to + 0, &color0, 2);
+            std::memcpy(load_to + 2, &color1, 2);
+            std::memcpy(load_to + 4, &indices, 4);
+        }
+
+        void TextureCompressor::encodeBC3Block(const uint8_t* block, uint8_t* load_to) {
+            // the alpha channel is stored like a BC4 block, followed by a BC1 block with the colors
+
+            encodeBC4Block(block, 3, load_to);
+            encodeBC1Block(block, load_to + 8);
+        }
+
+        void TextureCompressor::encodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* load_to) {
+            // the endpoints are the min and max value of the channel, with 6 values interpolated between them
+
+            uint8_t values[16];
+            uint8_t min_value = 255;
+            uint8_t max_value = 0;
+            for(int i = 0; i < 16; i++) {
+                values[i] = block[4 * i + channel];
+                min_value = std::min(min_value, values[i]);
+                max_value = std::max(max_value, values[i]);
+            }
+
+            load_to[0] = max_value;
+            load_to[1] = min_value;
+
+            uint64_t indices = 0;
+
+            if(max_value != min_value) {
+
+                // the first two entries are the endpoints, the others are interpolated from max to min
+                float palette[8];
+                palette[0] = max_value;
+                palette[1] = min_value;
+                for(int p = 2; p < 8; p++)
+                    palette[p] = ((8 - p) * float(max_value) + (p - 1) * float(min_value)) / 7.0f;
+
+                for(int i = 0; i < 16; i++) {
+
+                    uint64_t best_index = 0;
+                    float best_distance = 1e30f;
+
+                    for(uint64_t p = 0; p < 8; p++) {
+                        const float distance = std::abs(values[i] - palette[p]);
+                        best_index = (distance < best_distance) ? p : best_index;
+                        best_distance = std::min(distance, best_distance);
+                    }
+
+                    indices |= best_index << (3 * i);
+                }
+            }
+
+            // 16 indices with 3 bits each
+            for(int i = 0; i < 6; i++)
+                load_to[2 + i] = uint8_t(indices >> (8 * i));
+
+        }
+
+        void TextureCompressor::encodeBC5Block(const uint8_t* block, uint8_t* load_to) {
+            // the red and green channel are stored as separate BC4 blocks
+
+            encodeBC4Block(block, 0, load_to);
+            encodeBC4Block(block, 1, load_to + 8);
+        }
+
+        uint32_t TextureCompressor::getBlockSize(const FixedType& format) {
+
+            switch(format.m_type) {
+                case Type::COLOR_BC1:
+                case Type::COLOR_BC1_SRGB:
+                case Type::COLOR_BC4: return 8;
+                case Type::COLOR_BC3:
+                case Type::COLOR_BC3_SRGB:
+                case Type::COLOR_BC5: return 16;
+                default: return 0;
+            }
+
+        }
+
+        bool TextureCompressor::isSRGB(const FixedType& format) {
+
+            return (format.m_type == Type::COLOR_BC1_SRGB) || (format.m_type == Type::COLOR_BC3_SRGB);
+        }
+
+    } // tools
+
+} // undicht
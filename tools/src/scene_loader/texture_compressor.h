@@ -0,0 +1,74 @@
+#ifndef TEXTURE_COMPRESSOR_H
+#define TEXTURE_COMPRESSOR_H
+
+#include "cstdint"
+#include "string"
+#include "vector"
+
+#include "types.h"
+#include "job_system.h"
+#include "scene/texture.h"
+
+namespace undicht {
+
+    namespace tools {
+
+        class TextureCompressor {
+            /** @brief encodes rgba images into block compressed formats (BC1, BC3, BC5) on the cpu
+             * block compressed images cant be blitted on the gpu, so all mip levels get generated before compressing them
+             * the blocks of each level are encoded in parallel (if a job system is given),
+             * the encoders process the 16 texels of a block in branchless loops that the compiler can vectorize
+             * endpoints are picked along the principal axis of the colors of a block (range fit) */
+
+          public:
+
+            struct CompressedImage {
+                FixedType _format = UND_UNDEFINED_TYPE; // UND_BC1_SRGB, UND_BC3_SRGB or UND_BC5 (images loaded from ktx2 files can have any format)
+                uint32_t _width = 0;
+                uint32_t _height = 0;
+                std::vector<std::vector<uint8_t>> _mip_levels; // starting with the full size level
+            };
+
+          public:
+
+            /** @return BC5 for normal maps, BC3 if the image has transparent texels, BC1 otherwise
+             * only diffuse maps store colors, so only they use the srgb formats */
+            FixedType static chooseFormat(const uint8_t* pixels, uint32_t width, uint32_t height, graphics::Texture::Type type);
+
+            /// @brief compresses the rgba image and all of its mip levels
+            void static compress(const uint8_t* pixels, uint32_t width, uint32_t height, const FixedType& format, CompressedImage& load_to, JobSystem* job_system = nullptr);
+
+            /// @brief compresses a single level of the rgba image
+            void static compressLevel(const uint8_t* pixels, uint32_t width, uint32_t height, const FixedType& format, std::vector<uint8_t>& load_to, JobSystem* job_system = nullptr);
+
+            /// @brief halves the size of the rgba image (the color channels are averaged in linear space, if srgb is true)
+            void static downsample(const uint8_t* pixels, uint32_t width, uint32_t height, bool srgb, std::vector<uint8_t>& load_to);
+
+            /** @brief decodes a block compressed level to rgba texels (i.e. when the device cant sample the format)
+             * BC4 is decoded to (r,r,r,255) and BC5 to (r,g,0,255)
+             * @return false, if the format cant be decoded (BC7) */
+            bool static decompressLevel(const uint8_t* data, uint32_t width, uint32_t height, const FixedType& format, std::vector<uint8_t>& load_to);
+
+            /** @brief reads a compressed image stored with store()
+             * @return false, if the file doesnt exist, is corrupted or was compressed from a different source */
+            bool static load(const std::string& file_name, uint64_t source_hash, CompressedImage& load_to);
+
+            /// @return false, if the file could not be written
+            bool static store(const std::string& file_name, uint64_t source_hash, const CompressedImage& image);
+
+            // block encoders (block: 4x4 rgba texels, row by row)
+            void static encodeBC1Block(const uint8_t* block, uint8_t* load_to); // 8 bytes
+            void static encodeBC3Block(const uint8_t* block, uint8_t* load_to); // 16 bytes
+            void static encodeBC4Block(const uint8_t* block, uint32_t channel, uint8_t* load_to); // 8 bytes, one channel of the texels
+            void static encodeBC5Block(const uint8_t* block, uint8_t* load_to); // 16 bytes, red and green channel
+
+            uint32_t static getBlockSize(const FixedType& format);
+            bool static isSRGB(const FixedType& format);
+
+        };
+
+    } // tools
+
+} // undicht
+
+#endif // TEXTURE_COMPRESSOR_H
@@ -1,7 +1,14 @@
 #include "texture_loader.h"
+#include "cooked_scene.h"
+#include "core/vulkan/formats.h"
+#include "mapped_file.h"
 #include "stb_image.h"
 #include "debug.h"
 
+#include "cstring"
+#include "cstdlib"
+#include "algorithm"
+
 namespace undicht {
 
     namespace tools {
@@ -9,6 +16,30 @@ namespace undicht {
         using namespace graphics;
         using namespace vulkan;
 
+        // the compressed versions of images are stored next to them
+        const std::string COMPRESSED_FILE_ENDING = ".bc";
+
+        const std::string KTX2_FILE_ENDING = ".ktx2";
+
+        namespace {
+
+            // every ktx2 file starts with these bytes ("KTX 20" framed by non ascii characters and line endings)
+            const uint8_t KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+            // size of the identifier, header and index, the level index starts after them
+            const size_t KTX2_LEVEL_INDEX_OFFSET = 80;
+
+            size_t calcLevelSize(const FixedType& format, uint32_t width, uint32_t height) {
+                // the size of a block compressed format is the size of a 4x4 block
+
+                if(Texture::isBlockCompressed(format))
+                    return size_t((width + 3) / 4) * ((height + 3) / 4) * format.m_size;
+
+                return size_t(width) * height * format.m_size * format.m_num_components;
+            }
+
+        }
+
         TextureLoader::TextureLoader(const std::string& file_name, Texture& load_to, TransferBuffer& transfer_buffer) {
 
             importTexture(file_name, load_to, transfer_buffer);
@@ -16,22 +47,291 @@ namespace undicht {
 
         void TextureLoader::importTexture(const std::string& file_name, Texture& load_to, TransferBuffer& transfer_buffer) {
 
+            stbi_set_flip_vertically_on_load(false);
+
+            DecodedImage image;
+            if(!decodeImage(file_name, image)) return;
+
+            uploadImage(image, load_to, transfer_buffer);
+        }
+
+        bool TextureLoader::decodeImage(const std::string& file_name, DecodedImage& load_to, bool keep_channels) {
+            /** @brief decodes the image file into memory (doesnt touch any vulkan objects, so it can run on any thread)
+             * @param keep_channels: grayscale images (with or without alpha) keep their 1 or 2 channels, all other images are decoded to rgba
+             * (rgb isnt kept, since 3 channel formats are rarely supported by the gpu)
+             * ktx2 files are loaded with loadKTX2() instead (block compressed data gets decoded, since it is only used as it is when compressing textures)
+             * @return false, if the file could not be decoded */
+
+            if(isKTX2File(file_name))
+                return loadKTX2(file_name, load_to) && (!Texture::isBlockCompressed(load_to._compressed._format) || decompressImage(load_to));
+
             int width, height, nr_channels;
+            int desired_channels = STBI_rgb_alpha;
+
+            if(keep_channels && stbi_info(file_name.data(), &width, &height, &nr_channels))
+                if((nr_channels == STBI_grey) || (nr_channels == STBI_grey_alpha))
+                    desired_channels = nr_channels;
+
+            load_to._file_name = file_name;
+            load_to._pixels = stbi_load(file_name.data(), &width, &height, &nr_channels, desired_channels);
+
+            if(!load_to._pixels) {
+                UND_ERROR << "failed to read image file: " << file_name << "\n";
+                return false;
+            }
 
+            load_to._width = width;
+            load_to._height = height;
+            load_to._nr_channels = desired_channels;
+
+            return true;
+        }
+
+        void TextureLoader::decodeImages(std::vector<DecodedImage>& images, JobSystem* job_system) {
+            /** @brief decodes all images, using the job system (if one is given) to decode them in parallel
+             * the _file_name of each image has to be set */
+
+            // the flip setting is global in stb_image, so it has to be set before the decoding starts
             stbi_set_flip_vertically_on_load(false);
-            unsigned char* tmp = stbi_load(file_name.data(), &width, &height, &nr_channels, STBI_rgb_alpha);
-            nr_channels = 4; // forced by STBI_rgb_alpha
 
-            if(!tmp) {
+            if(!job_system || (images.size() < 2)) {
+
+                for(DecodedImage& image : images)
+                    decodeImage(image._file_name, image);
+
+                return;
+            }
+
+            // one job per image, decoding a single image is expensive enough
+            job_system->parallelFor(images.size(), 1, [&images](uint32_t begin, uint32_t end) {
+
+                for(uint32_t i = begin; i < end; i++)
+                    decodeImage(images[i]._file_name, images[i]);
+
+            });
+
+        }
+
+        bool TextureLoader::compressImage(const std::string& file_name, Texture::Type type, DecodedImage& load_to, JobSystem* job_system) {
+            /** @brief loads the block compressed version of the image from the file next to it (file_name + ".bc")
+             * if that file is missing or stale, the image gets decoded, compressed and the result gets stored in that file
+             * ktx2 files already contain their mip levels in the final format, so they are only loaded (see loadKTX2())
+             * @return false, if the image file could not be decoded */
+
+            if(isKTX2File(file_name)) return loadKTX2(file_name, load_to);
+
+            load_to._file_name = file_name;
+
+            // the compressed file is only valid for the contents of the image file and the texture type (which selects the format)
+            uint64_t source_hash = 0;
+            std::string compressed_file_name = file_name + COMPRESSED_FILE_ENDING;
+            bool use_cache = CookedScene::hashFile(file_name, source_hash);
+            source_hash = CookedScene::combineHash(source_hash, type);
+
+            if(use_cache && TextureCompressor::load(compressed_file_name, source_hash, load_to._compressed)) {
+                load_to._width = load_to._compressed._width;
+                load_to._height = load_to._compressed._height;
+                load_to._nr_channels = 4;
+                return true;
+            }
+
+            // the compressor works on rgba texels
+            if(!decodeImage(file_name, load_to, false)) return false;
+
+            FixedType format = TextureCompressor::chooseFormat(load_to._pixels, load_to._width, load_to._height, type);
+            TextureCompressor::compress(load_to._pixels, load_to._width, load_to._height, format, load_to._compressed, job_system);
+
+            stbi_image_free(load_to._pixels);
+            load_to._pixels = nullptr;
+
+            if(use_cache) TextureCompressor::store(compressed_file_name, source_hash, load_to._compressed);
+
+            return true;
+        }
+
+        bool TextureLoader::loadKTX2(const std::string& file_name, DecodedImage& load_to) {
+            /** @brief reads all mip levels stored in the ktx2 file into load_to._compressed (block compressed or uncompressed)
+             * the levels get uploaded as they are, so neither decoding nor generating the mip maps is needed
+             * only 2D textures without supercompression (i.e. BasisLZ or zstd) are supported
+             * @return false, if the file could not be read or isnt supported */
+
+            load_to._file_name = file_name;
+
+            MappedFile file;
+            if(!file.open(file_name)) {
                 UND_ERROR << "failed to read image file: " << file_name << "\n";
+                return false;
+            }
+
+            const uint8_t* data = file.getData();
+            const size_t file_size = file.getSize();
+
+            if((file_size < KTX2_LEVEL_INDEX_OFFSET) || std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER))) {
+                UND_ERROR << "not a valid ktx2 file: " << file_name << "\n";
+                return false;
+            }
+
+            // the header (little endian, same as the supported platforms)
+            uint32_t header[9]; // vkFormat, typeSize, pixelWidth, pixelHeight, pixelDepth, layerCount, faceCount, levelCount, supercompressionScheme
+            std::memcpy(header, data + sizeof(KTX2_IDENTIFIER), sizeof(header));
+
+            const uint32_t width = header[2];
+            const uint32_t height = header[3];
+            const uint32_t level_count = std::max(header[7], 1u); // 0 means that the mip maps should be generated, only the base level is stored then
+
+            if((header[0] == VK_FORMAT_UNDEFINED) || (header[8] != 0)) {
+                UND_ERROR << "ktx2 file uses basis universal or supercompression (not supported): " << file_name << "\n";
+                return false;
+            }
+
+            if(!width || !height || (header[4] > 1) || (header[5] > 1) || (header[6] != 1) || (level_count > 32)) {
+                UND_ERROR << "ktx2 file is not a 2D texture: " << file_name << "\n";
+                return false;
+            }
+
+            FixedType format = vulkan::translate(VkFormat(header[0]));
+            if((format == UND_UNDEFINED_TYPE) || (format.m_type == undicht::Type::DEPTH_BUFFER) || (format.m_type == undicht::Type::DEPTH_STENCIL_BUFFER)) {
+                UND_ERROR << "ktx2 file has an unsupported format: " << file_name << "\n";
+                return false;
+            }
+
+            if(file_size < KTX2_LEVEL_INDEX_OFFSET + size_t(level_count) * 3 * sizeof(uint64_t)) {
+                UND_ERROR << "ktx2 file is corrupted: " << file_name << "\n";
+                return false;
+            }
+
+            // the level index starts with the full size level (the data of the smallest level comes first in the file though)
+            std::vector<std::vector<uint8_t>> mip_levels(level_count);
+            for(uint32_t i = 0; i < level_count; i++) {
+
+                uint64_t level_index[3]; // byteOffset, byteLength, uncompressedByteLength
+                std::memcpy(level_index, data + KTX2_LEVEL_INDEX_OFFSET + size_t(i) * sizeof(level_index), sizeof(level_index));
+
+                const size_t expected_size = calcLevelSize(format, std::max(width >> i, 1u), std::max(height >> i, 1u));
+
+                if((level_index[1] != expected_size) || (level_index[0] > file_size) || (file_size - level_index[0] < level_index[1])) {
+                    UND_ERROR << "ktx2 file is corrupted: " << file_name << "\n";
+                    return false;
+                }
+
+                mip_levels[i].assign(data + level_index[0], data + level_index[0] + level_index[1]);
+            }
+
+            load_to._width = width;
+            load_to._height = height;
+            load_to._nr_channels = Texture::getChannelCount(format);
+            load_to._compressed._format = format;
+            load_to._compressed._width = width;
+            load_to._compressed._height = height;
+            load_to._compressed._mip_levels = std::move(mip_levels);
+
+            return true;
+        }
+
+        bool TextureLoader::decompressImage(DecodedImage& image) {
+            /** @brief decodes the full size level of the block compressed data to rgba pixels (the mip maps get generated after the upload then)
+             * @return false, if the format cant be decoded (the image gets freed then) */
+
+            const TextureCompressor::CompressedImage& compressed = image._compressed;
+
+            std::vector<uint8_t> pixels;
+            if(compressed._mip_levels.empty() || !TextureCompressor::decompressLevel(compressed._mip_levels.front().data(), compressed._width, compressed._height, compressed._format, pixels)) {
+                UND_ERROR << "failed to decode the block compressed image: " << image._file_name << "\n";
+                freeImage(image);
+                return false;
+            }
+
+            freeImage(image);
+
+            // the pixels get freed with stbi_image_free(), like the ones decoded by stb_image
+            image._pixels = (unsigned char*)std::malloc(pixels.size());
+            std::memcpy(image._pixels, pixels.data(), pixels.size());
+            image._nr_channels = 4;
+
+            return true;
+        }
+
+        bool TextureLoader::checkFormat(DecodedImage& image, const vulkan::LogicalDevice& device) {
+            /** @brief makes sure that the device can sample the image, compressed data in a format it doesnt support gets decoded to rgba pixels
+             * @return false, if the format isnt supported and cant be decoded (the image gets freed then) */
+
+            if(image._pixels || image._compressed._mip_levels.empty()) return true;
+            if(Texture::isFormatSupported(device, image._compressed._format)) return true;
+
+            UND_ERROR << "the device doesnt support the format of the image, decoding it: " << image._file_name << "\n";
+
+            return decompressImage(image);
+        }
+
+        bool TextureLoader::isKTX2File(const std::string& file_name) {
+            /// @return true, if the file name has the ktx2 ending
+
+            if(file_name.size() < KTX2_FILE_ENDING.size()) return false;
+
+            return !file_name.compare(file_name.size() - KTX2_FILE_ENDING.size(), KTX2_FILE_ENDING.size(), KTX2_FILE_ENDING);
+        }
+
+        void TextureLoader::compressImages(std::vector<DecodedImage>& images, const std::vector<Texture::Type>& types, JobSystem* job_system) {
+            /// @brief compresses all images (see compressImage()), using the job system (if one is given) to process them in parallel
+
+            stbi_set_flip_vertically_on_load(false);
+
+            if(!job_system || (images.size() < 2)) {
+
+                for(int i = 0; i < images.size(); i++)
+                    compressImage(images[i]._file_name, types[i], images[i], job_system);
+
                 return;
             }
 
-            load_to.setData((char*)tmp, width, height, nr_channels, transfer_buffer);
+            // one job per image (the blocks of large images get encoded in parallel as well)
+            job_system->parallelFor(images.size(), 1, [&](uint32_t begin, uint32_t end) {
+
+                for(uint32_t i = begin; i < end; i++)
+                    compressImage(images[i]._file_name, types[i], images[i], job_system);
+
+            });
+
+        }
+
+        bool TextureLoader::isLoaded(const DecodedImage& image) {
+            /// @return true, if the image was decoded or compressed successfully
+
+            return image._pixels || !image._compressed._mip_levels.empty();
+        }
+
+        uint32_t TextureLoader::getUploadSize(const DecodedImage& image) {
+            /** @return the number of bytes that get staged when uploading the image
+             * (grayscale images are counted as rgba, since the texture might have to expand them) */
+
+            if(image._pixels) return image._width * image._height * 4;
+
+            uint32_t upload_size = 0;
+            for(const std::vector<uint8_t>& level : image._compressed._mip_levels)
+                upload_size += level.size();
+
+            return upload_size;
+        }
+
+        void TextureLoader::uploadImage(DecodedImage& image, Texture& load_to, TransferBuffer& transfer_buffer) {
+            /// @brief stages the decoded pixels (or the compressed mip levels) for the upload to the texture and frees them
+
+            if(image._pixels)
+                load_to.setData((char*)image._pixels, image._width, image._height, image._nr_channels, transfer_buffer);
+            else if(!image._compressed._mip_levels.empty())
+                load_to.setData(image._compressed._mip_levels, image._width, image._height, image._compressed._format, transfer_buffer);
+
+            freeImage(image);
+        }
+
+        void TextureLoader::freeImage(DecodedImage& image) {
+            /// @brief frees the decoded pixels / compressed data (if the image doesnt get uploaded)
 
-            stbi_image_free(tmp);
+            if(image._pixels) stbi_image_free(image._pixels);
+            image._pixels = nullptr;
+            image._compressed = TextureCompressor::CompressedImage();
         }
 
     } // tools
 
-} // undicht
\ No newline at end of file
+} // undicht
@@ -2,8 +2,11 @@
 #define TEXTURE_LOADER_H
 
 #include "string"
+#include "vector"
 #include "scene/texture.h"
 #include "renderer/vulkan/transfer_buffer.h"
+#include "job_system.h"
+#include "texture_compressor.h"
 
 namespace undicht {
 
@@ -11,7 +14,16 @@ namespace undicht {
 
         class TextureLoader {
           
-          protected:
+          public:
+
+            struct DecodedImage {
+                std::string _file_name;
+                unsigned char* _pixels = nullptr; // gray, gray + alpha or rgba, nullptr if the image could not be decoded
+                uint32_t _width = 0;
+                uint32_t _height = 0;
+                uint32_t _nr_channels = 0;
+                TextureCompressor::CompressedImage _compressed; // filled by compressImages() (the pixels are freed then) and when loading ktx2 files
+            };
 
           public:
 
@@ -20,6 +32,56 @@ namespace undicht {
 
             void importTexture(const std::string& file_name, graphics::Texture& load_to, vulkan::TransferBuffer& transfer_buffer);
 
+            /** @brief decodes the image file into memory (doesnt touch any vulkan objects, so it can run on any thread)
+             * ktx2 files are loaded with loadKTX2() instead (block compressed data gets decoded, since it is only used as it is when compressing textures)
+             * @param keep_channels: grayscale images (with or without alpha) keep their 1 or 2 channels, all other images are decoded to rgba
+             * (rgb isnt kept, since 3 channel formats are rarely supported by the gpu)
+             * @return false, if the file could not be decoded */
+            bool static decodeImage(const std::string& file_name, DecodedImage& load_to, bool keep_channels = true);
+
+            /** @brief decodes all images, using the job system (if one is given) to decode them in parallel
+             * the _file_name of each image has to be set */
+            void static decodeImages(std::vector<DecodedImage>& images, JobSystem* job_system = nullptr);
+
+            /** @brief loads the block compressed version of the image from the file next to it (file_name + ".bc")
+             * if that file is missing or stale, the image gets decoded, compressed and the result gets stored in that file
+             * ktx2 files already contain their mip levels in the final format, so they are only loaded (see loadKTX2())
+             * @return false, if the image file could not be decoded */
+            bool static compressImage(const std::string& file_name, graphics::Texture::Type type, DecodedImage& load_to, JobSystem* job_system = nullptr);
+
+            /** @brief reads all mip levels stored in the ktx2 file into load_to._compressed (block compressed or uncompressed)
+             * the levels get uploaded as they are, so neither decoding nor generating the mip maps is needed
+             * only 2D textures without supercompression (i.e. BasisLZ or zstd) are supported
+             * @return false, if the file could not be read or isnt supported */
+            bool static loadKTX2(const std::string& file_name, DecodedImage& load_to);
+
+            /** @brief decodes the full size level of the block compressed data to rgba pixels (the mip maps get generated after the upload then)
+             * @return false, if the format cant be decoded (the image gets freed then) */
+            bool static decompressImage(DecodedImage& image);
+
+            /** @brief makes sure that the device can sample the image, compressed data in a format it doesnt support gets decoded to rgba pixels
+             * @return false, if the format isnt supported and cant be decoded (the image gets freed then) */
+            bool static checkFormat(DecodedImage& image, const vulkan::LogicalDevice& device);
+
+            /// @return true, if the file name has the ktx2 ending
+            bool static isKTX2File(const std::string& file_name);
+
+            /// @brief compresses all images (see compressImage()), using the job system (if one is given) to process them in parallel
+            void static compressImages(std::vector<DecodedImage>& images, const std::vector<graphics::Texture::Type>& types, JobSystem* job_system = nullptr);
+
+            /// @return true, if the image was decoded or compressed successfully
+            bool static isLoaded(const DecodedImage& image);
+
+            /** @return the number of bytes that get staged when uploading the image
+             * (grayscale images are counted as rgba, since the texture might have to expand them) */
+            uint32_t static getUploadSize(const DecodedImage& image);
+
+            /// @brief stages the decoded pixels (or the compressed mip levels) for the upload to the texture and frees them
+            void static uploadImage(DecodedImage& image, graphics::Texture& load_to, vulkan::TransferBuffer& transfer_buffer);
+
+            /// @brief frees the decoded pixels / compressed data (if the image doesnt get uploaded)
+            void static freeImage(DecodedImage& image);
+
           protected:
             // non public TextureLoader functions
 
@@ -0,0 +1,260 @@
+#include "vertex_packer.h"
+
+#include "cstring"
+#include "cmath"
+#include "algorithm"
+
+namespace undicht {
+
+    namespace tools {
+
+        namespace {
+
+            const uint32_t BONES_PER_VERTEX = 4; // same as in the SceneLoader
+
+            template<typename T>
+            uint8_t* writeValue(uint8_t* load_to, const T& value) {
+                // @return the position after the stored value
+
+                std::memcpy(load_to, &value, sizeof(T));
+                return load_to + sizeof(T);
+            }
+
+        }
+
+        uint32_t VertexPacker::calcUnpackedVertexSize(const Attributes& attributes) {
+            /// @return the number of floats per vertex in the unpacked layout (as created by the SceneLoader)
+
+            uint32_t vertex_size = 0;
+            if(attributes._has_positions) vertex_size += 3;
+            if(attributes._has_tex_coords) vertex_size += 3;
+            if(attributes._has_normals) vertex_size += 3;
+            if(attributes._has_tangents_and_bitangents) vertex_size += 6;
+            if(attributes._has_bones) vertex_size += 2 * BONES_PER_VERTEX;
+
+            return vertex_size;
+        }
+
+        uint32_t VertexPacker::calcPackedVertexSize(const Attributes& attributes) {
+            /// @return the number of bytes per vertex in the packed layout
+
+            uint32_t vertex_size = 0;
+            if(attributes._has_positions) vertex_size += 3 * sizeof(float);
+            if(attributes._has_tex_coords) vertex_size += 2 * sizeof(uint16_t);
+            if(attributes._has_normals) vertex_size += sizeof(uint32_t);
+            if(attributes._has_tangents_and_bitangents) vertex_size += 2 * sizeof(uint32_t);
+            if(attributes._has_bones) vertex_size += 2 * BONES_PER_VERTEX;
+
+            return vertex_size;
+        }
+
+        bool VertexPacker::packVertices(const std::vector<float>& vertices, const Attributes& attributes, std::vector<uint8_t>& load_to) {
+            /** @brief packs the vertices (which have to be in the unpacked layout, with 4 bones per vertex)
+             * in the unpacked layout, the texture coordinates are Vec3f and the bone ids are uint32 stored in floats
+             * @return false, if a bone id doesnt fit into the packed layout (see MAX_BONE_COUNT), nothing gets packed then */
+
+            const uint32_t unpacked_size = calcUnpackedVertexSize(attributes);
+            if(!unpacked_size) return true;
+
+            const size_t vertex_count = vertices.size() / unpacked_size;
+            const size_t first_byte = load_to.size();
+            load_to.resize(first_byte + vertex_count * calcPackedVertexSize(attributes));
+
+            if(packVertices(vertices, attributes, load_to.data() + first_byte)) return true;
+
+            load_to.resize(first_byte);
+            return false;
+        }
+
+        bool VertexPacker::packVertices(const std::vector<float>& vertices, const Attributes& attributes, uint8_t* load_to) {
+            /** @brief packs the vertices into the memory (which has to fit vertex count * calcPackedVertexSize() bytes)
+             * @return false, if a bone id doesnt fit into the packed layout (see MAX_BONE_COUNT), nothing gets packed then */
+
+            const uint32_t unpacked_size = calcUnpackedVertexSize(attributes);
+            if(!unpacked_size) return true;
+
+            const size_t vertex_count = vertices.size() / unpacked_size;
+
+            // the bone ids are the last attribute of a vertex
+            if(attributes._has_bones) {
+                for(size_t i = 0; i < vertex_count; i++) {
+                    for(uint32_t j = 0; j < BONES_PER_VERTEX; j++) {
+
+                        uint32_t bone_id;
+                        std::memcpy(&bone_id, vertices.data() + (i + 1) * unpacked_size - 2 * BONES_PER_VERTEX + j, sizeof(uint32_t));
+                        if(bone_id >= MAX_BONE_COUNT) return false;
+                    }
+                }
+            }
+
+            const float* src = vertices.data();
+            uint8_t* dst = load_to;
+
+            for(size_t i = 0; i < vertex_count; i++) {
+
+                if(attributes._has_positions) {
+                    dst = writeValue(dst, src[0]);
+                    dst = writeValue(dst, src[1]);
+                    dst = writeValue(dst, src[2]);
+                    src += 3;
+                }
+
+                if(attributes._has_tex_coords) {
+                    dst = writeValue(dst, packHalf(src[0]));
+                    dst = writeValue(dst, packHalf(src[1]));
+                    src += 3; // the third component is not used
+                }
+
+                if(attributes._has_normals) {
+                    dst = writeValue(dst, packOctahedral(src[0], src[1], src[2]));
+                    src += 3;
+                }
+
+                if(attributes._has_tangents_and_bitangents) {
+                    dst = writeValue(dst, packOctahedral(src[0], src[1], src[2]));
+                    dst = writeValue(dst, packOctahedral(src[3], src[4], src[5]));
+                    src += 6;
+                }
+
+                if(attributes._has_bones) {
+
+                    for(uint32_t j = 0; j < BONES_PER_VERTEX; j++) {
+                        uint32_t bone_id;
+                        std::memcpy(&bone_id, src + j, sizeof(uint32_t));
+                        dst = writeValue(dst, uint8_t(bone_id));
+                    }
+
+                    dst = writeValue(dst, packWeights(src + BONES_PER_VERTEX));
+                    src += 2 * BONES_PER_VERTEX;
+                }
+
+            }
+
+            return true;
+        }
+
+        uint32_t VertexPacker::packIndices(const std::vector<uint32_t>& indices, std::vector<uint8_t>& load_to) {
+            /** @brief stores the indices as uint16, if all of them fit, as uint32 otherwise
+             * @return the size of each stored index in bytes (2 or 4) */
+
+            const uint32_t index_size = calcIndexSize(indices);
+            const size_t first_byte = load_to.size();
+            load_to.resize(first_byte + indices.size() * index_size);
+
+            packIndices(indices, index_size, load_to.data() + first_byte);
+
+            return index_size;
+        }
+
+        uint32_t VertexPacker::calcIndexSize(const std::vector<uint32_t>& indices) {
+            /// @return the size of each index in bytes (2, if all indices fit into an uint16, 4 otherwise)
+
+            uint32_t max_index = 0;
+            for(uint32_t index : indices) max_index = std::max(max_index, index);
+
+            return (max_index <= 0xFFFF) ? sizeof(uint16_t) : sizeof(uint32_t);
+        }
+
+        void VertexPacker::packIndices(const std::vector<uint32_t>& indices, uint32_t index_size, uint8_t* load_to) {
+            /// @brief stores the indices with the index size in the memory (which has to fit index count * index_size bytes)
+
+            if(index_size == sizeof(uint32_t)) {
+                std::memcpy(load_to, indices.data(), indices.size() * sizeof(uint32_t));
+                return;
+            }
+
+            uint8_t* dst = load_to;
+            for(uint32_t index : indices)
+                dst = writeValue(dst, uint16_t(index));
+
+        }
+
+        uint16_t VertexPacker::packHalf(float value) {
+            /// @return the value as a 16 bit float (rounded to the nearest value)
+
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(float));
+
+            const uint16_t sign = (bits >> 16) & 0x8000;
+            const uint32_t abs_bits = bits & 0x7FFFFFFF;
+
+            // infinity and nan
+            if(abs_bits >= 0x7F800000) return sign | 0x7C00 | ((abs_bits > 0x7F800000) ? 0x0200 : 0);
+
+            // too big for a half float (rounds to infinity)
+            if(abs_bits >= 0x477FF000) return sign | 0x7C00;
+
+            // too small to be a normalized half float (stored as denormalized half float, the mantissa is value * 2^24)
+            if(abs_bits < 0x38800000) {
+                float abs_value;
+                std::memcpy(&abs_value, &abs_bits, sizeof(float));
+                return sign | uint16_t(std::nearbyint(abs_value * 16777216.0f));
+            }
+
+            // rebiasing the exponent (from 127 to 15) and rounding the mantissa to the nearest even value
+            uint32_t half = (abs_bits - 0x38000000) >> 13;
+            const uint32_t remainder = abs_bits & 0x1FFF;
+            if((remainder > 0x1000) || ((remainder == 0x1000) && (half & 1))) half++;
+
+            return sign | uint16_t(half);
+        }
+
+        uint32_t VertexPacker::packOctahedral(float x, float y, float z) {
+            /// @return the direction encoded as 2 unorm16 values (x in the lower 16 bits), using an octahedral mapping
+            // projecting the direction onto an octahedron, the lower half gets folded over the upper one
+            // decoding (in the shaders): n = (e.x, e.y, 1 - |e.x| - |e.y|), n.xy -= sign(n.xy) * max(-n.z, 0)
+
+            float length = std::abs(x) + std::abs(y) + std::abs(z);
+            float u = 0.0f;
+            float v = 0.0f;
+
+            if(length > 0.0f) {
+
+                u = x / length;
+                v = y / length;
+
+                if(z < 0.0f) {
+                    float folded_u = (1.0f - std::abs(v)) * ((u >= 0.0f) ? 1.0f : -1.0f);
+                    float folded_v = (1.0f - std::abs(u)) * ((v >= 0.0f) ? 1.0f : -1.0f);
+                    u = folded_u;
+                    v = folded_v;
+                }
+            }
+
+            // from [-1, 1] to unorm16
+            uint32_t packed_u = uint32_t(std::round(std::clamp(u * 0.5f + 0.5f, 0.0f, 1.0f) * 65535.0f));
+            uint32_t packed_v = uint32_t(std::round(std::clamp(v * 0.5f + 0.5f, 0.0f, 1.0f) * 65535.0f));
+
+            return packed_u | (packed_v << 16);
+        }
+
+        uint32_t VertexPacker::packWeights(const float* weights) {
+            /// @return the weights (which should add up to 1) as 4 unorm8 values, adding up to exactly 255
+
+            uint32_t packed[BONES_PER_VERTEX];
+            uint32_t packed_sum = 0;
+            float weight_sum = 0.0f;
+            uint32_t biggest = 0;
+
+            for(uint32_t i = 0; i < BONES_PER_VERTEX; i++) {
+
+                float weight = std::clamp(weights[i], 0.0f, 1.0f);
+                packed[i] = uint32_t(std::round(weight * 255.0f));
+                packed_sum += packed[i];
+                weight_sum += weight;
+
+                if(packed[i] > packed[biggest]) biggest = i;
+            }
+
+            // the rounding errors are corrected on the biggest weight, so that the weights still add up to 1
+            if(weight_sum > 0.0f) {
+                int32_t corrected = int32_t(packed[biggest]) + 255 - int32_t(packed_sum);
+                packed[biggest] = uint32_t(std::clamp(corrected, 0, 255));
+            }
+
+            return packed[0] | (packed[1] << 8) | (packed[2] << 16) | (packed[3] << 24);
+        }
+
+    } // tools
+
+} // undicht
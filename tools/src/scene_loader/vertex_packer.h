@@ -0,0 +1,74 @@
+#ifndef VERTEX_PACKER_H
+#define VERTEX_PACKER_H
+
+#include "cstdint"
+#include "vector"
+
+namespace undicht {
+
+    namespace tools {
+
+        class VertexPacker {
+            /** @brief converts the interleaved float vertices created by the SceneLoader
+             * into the compact vertex layout used by graphics::Mesh (and the renderers):
+             * Vec3f position (3 * float32)
+             * Vec2f texture coordinate (2 * float16)
+             * normal, tangent, bitangent (octahedral encoded, 2 * unorm16 each)
+             * bone ids (4 * uint8), bone weights (4 * unorm8) */
+
+          public:
+
+            // the bone ids are stored as uint8
+            const static uint32_t MAX_BONE_COUNT = 256;
+
+            struct Attributes {
+                bool _has_positions = false;
+                bool _has_tex_coords = false;
+                bool _has_normals = false;
+                bool _has_tangents_and_bitangents = false;
+                bool _has_bones = false;
+            };
+
+          public:
+
+            /// @return the number of floats per vertex in the unpacked layout (as created by the SceneLoader)
+            uint32_t static calcUnpackedVertexSize(const Attributes& attributes);
+
+            /// @return the number of bytes per vertex in the packed layout
+            uint32_t static calcPackedVertexSize(const Attributes& attributes);
+
+            /** @brief packs the vertices (which have to be in the unpacked layout, with 4 bones per vertex)
+             * in the unpacked layout, the texture coordinates are Vec3f and the bone ids are uint32 stored in floats
+             * @return false, if a bone id doesnt fit into the packed layout (see MAX_BONE_COUNT), nothing gets packed then */
+            bool static packVertices(const std::vector<float>& vertices, const Attributes& attributes, std::vector<uint8_t>& load_to);
+
+            /** @brief packs the vertices into the memory (which has to fit vertex count * calcPackedVertexSize() bytes)
+             * @return false, if a bone id doesnt fit into the packed layout (see MAX_BONE_COUNT), nothing gets packed then */
+            bool static packVertices(const std::vector<float>& vertices, const Attributes& attributes, uint8_t* load_to);
+
+            /** @brief stores the indices as uint16, if all of them fit, as uint32 otherwise
+             * @return the size of each stored index in bytes (2 or 4) */
+            uint32_t static packIndices(const std::vector<uint32_t>& indices, std::vector<uint8_t>& load_to);
+
+            /// @return the size of each index in bytes (2, if all indices fit into an uint16, 4 otherwise)
+            uint32_t static calcIndexSize(const std::vector<uint32_t>& indices);
+
+            /// @brief stores the indices with the index size in the memory (which has to fit index count * index_size bytes)
+            void static packIndices(const std::vector<uint32_t>& indices, uint32_t index_size, uint8_t* load_to);
+
+            /// @return the value as a 16 bit float (rounded to the nearest value)
+            uint16_t static packHalf(float value);
+
+            /// @return the direction encoded as 2 unorm16 values (x in the lower 16 bits), using an octahedral mapping
+            uint32_t static packOctahedral(float x, float y, float z);
+
+            /// @return the weights (which should add up to 1) as 4 unorm8 values, adding up to exactly 255
+            uint32_t static packWeights(const float* weights);
+
+        };
+
+    } // tools
+
+} // undicht
+
+#endif // VERTEX_PACKER_H